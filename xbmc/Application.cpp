@@ -612,6 +612,37 @@ static void CopyUserDataIfNeeded(const CStdString &strPath, const CStdString &fi
   }
 }
 
+//
+// Startup stages run on the job pool by CApplication::Create(), see CStartupGraph.
+//
+static bool LoadKeymaps()
+{
+  CLog::Log(LOGINFO, "load keymapping");
+  return CButtonTranslator::GetInstance().Load();
+}
+
+static bool StartAddons()
+{
+  // initialize the addon database (must be before the addon manager is init'd)
+  CDatabaseManager::Get().Initialize(true);
+
+  // start-up Addons Framework
+  // currently bails out if either cpluff Dll is unavailable or system dir can not be scanned
+  if (!CAddonMgr::Get().Init())
+  {
+    CLog::Log(LOGFATAL, "CApplication::Create: Unable to start CAddonMgr");
+    return false;
+  }
+  return true;
+}
+
+static bool UpdateDatabases()
+{
+  // initialize (and update as needed) our databases
+  CDatabaseManager::Get().Initialize();
+  return true;
+}
+
 void CApplication::Preflight()
 {
 #ifdef HAS_DBUS
@@ -816,6 +847,7 @@ if (!strstr(FFMPEG_VERSION, FFMPEG_VER_SHA))
 
   // Initialize default Settings - don't move
   CLog::Log(LOGNOTICE, "load settings...");
+  m_startup.Begin("settings");
   if (!CSettings::Get().Initialize())
     return false;
 
@@ -828,6 +860,7 @@ if (!strstr(FFMPEG_VERSION, FFMPEG_VER_SHA))
     return false;
   }
   CSettings::Get().SetLoaded();
+  m_startup.End("settings");
 
   CLog::Log(LOGINFO, "creating subdirectories");
   CLog::Log(LOGINFO, "userdata folder: %s", CProfilesManager::Get().GetProfileUserDataFolder().c_str());
@@ -846,6 +879,7 @@ if (!strstr(FFMPEG_VERSION, FFMPEG_VER_SHA))
   CStdString strLangInfoPath = StringUtils::Format("special://xbmc/language/%s/langinfo.xml", strLanguage.c_str());
 
   CLog::Log(LOGINFO, "load language info file: %s", strLangInfoPath.c_str());
+  m_startup.Begin("language");
   g_langInfo.Load(strLangInfoPath);
   g_langInfo.SetAudioLanguage(CSettings::Get().GetString("locale.audiolanguage"));
   g_langInfo.SetSubtitleLanguage(CSettings::Get().GetString("locale.subtitlelanguage"));
@@ -858,13 +892,38 @@ if (!strstr(FFMPEG_VERSION, FFMPEG_VER_SHA))
     CLog::Log(LOGFATAL, "%s: Failed to load %s language file, from path: %s", __FUNCTION__, strLanguage.c_str(), strLanguagePath.c_str());
     return false;
   }
+  m_startup.End("language");
+
+  // Load curl so curl_global_init gets called before any service threads
+  // are started. Unloading will have no effect as curl is never fully unloaded.
+  // To quote man curl_global_init:
+  //  "This function is not thread safe. You must not call it when any other
+  //  thread in the program (i.e. a thread sharing the same memory) is running.
+  //  This doesn't just mean no other thread that is using libcurl. Because
+  //  curl_global_init() calls functions of other libraries that are similarly
+  //  thread unsafe, it could conflict with any other thread that
+  //  uses these other libraries."
+  g_curlInterface.Load();
+  g_curlInterface.Unload();
+
+#ifdef HAS_PYTHON
+  CScriptInvocationManager::Get().RegisterLanguageInvocationHandler(&g_pythonParser, ".py");
+#endif // HAS_PYTHON
+
+  // the keymaps, addons and databases load on the job pool while we carry on here.
+  // The strings and langinfo must be loaded before, as they are read without a lock.
+  m_startup.Add("keymaps", LoadKeymaps);
+  m_startup.Add("addons", StartAddons);
+  m_startup.Add("databases", UpdateDatabases, "addons");
 
   // start the AudioEngine
+  m_startup.Begin("audioengine");
   if (!CAEFactory::StartEngine())
   {
     CLog::Log(LOGFATAL, "CApplication::Create: Failed to start the AudioEngine");
     return false;
   }
+  m_startup.End("audioengine");
 
   // restore AE's previous volume state
   SetHardwareVolume(m_volumeLevel);
@@ -877,20 +936,7 @@ if (!strstr(FFMPEG_VERSION, FFMPEG_VER_SHA))
   m_replayGainSettings.iNoGainPreAmp = CSettings::Get().GetInt("musicplayer.replaygainnogainpreamp");
   m_replayGainSettings.bAvoidClipping = CSettings::Get().GetBool("musicplayer.replaygainavoidclipping");
 
-  // initialize the addon database (must be before the addon manager is init'd)
-  CDatabaseManager::Get().Initialize(true);
-
-#ifdef HAS_PYTHON
-  CScriptInvocationManager::Get().RegisterLanguageInvocationHandler(&g_pythonParser, ".py");
-#endif // HAS_PYTHON
-
-  // start-up Addons Framework
-  // currently bails out if either cpluff Dll is unavailable or system dir can not be scanned
-  if (!CAddonMgr::Get().Init())
-  {
-    CLog::Log(LOGFATAL, "CApplication::Create: Unable to start CAddonMgr");
-    return false;
-  }
+  m_startup.Begin("peripherals");
 #if defined(HAS_LIRC) || defined(HAS_IRSERVERSUITE)
   g_RemoteControl.Initialize();
 #endif
@@ -912,6 +958,7 @@ if (!strstr(FFMPEG_VERSION, FFMPEG_VER_SHA))
   CUtil::InitRandomSeed();
 
   g_mediaManager.Initialize();
+  m_startup.End("peripherals");
 
   m_lastFrameTime = XbmcThreads::SystemClockMillis();
   m_lastRenderTime = m_lastFrameTime;
@@ -920,6 +967,7 @@ if (!strstr(FFMPEG_VERSION, FFMPEG_VER_SHA))
 
 bool CApplication::CreateGUI()
 {
+  m_startup.Begin("gui");
   m_renderGUI = true;
 #ifdef HAS_SDL
   CLog::Log(LOGNOTICE, "Setup SDL");
@@ -1020,8 +1068,7 @@ bool CApplication::CreateGUI()
   }
 
   // The key mappings may already have been loaded by a peripheral
-  CLog::Log(LOGINFO, "load keymapping");
-  if (!CButtonTranslator::GetInstance().Load())
+  if (!m_startup.Wait("keymaps"))
     return false;
 
   RESOLUTION_INFO info = g_graphicsContext.GetResInfo();
@@ -1030,6 +1077,7 @@ bool CApplication::CreateGUI()
             info.iHeight,
             info.strMode.c_str());
   g_windowManager.Initialize();
+  m_startup.End("gui");
 
   return true;
 }
@@ -1322,22 +1370,16 @@ bool CApplication::Initialize()
     CDirectory::Create("special://xbmc/sounds");
   }
 
-  // Load curl so curl_global_init gets called before any service threads
-  // are started. Unloading will have no effect as curl is never fully unloaded.
-  // To quote man curl_global_init:
-  //  "This function is not thread safe. You must not call it when any other
-  //  thread in the program (i.e. a thread sharing the same memory) is running.
-  //  This doesn't just mean no other thread that is using libcurl. Because
-  //  curl_global_init() calls functions of other libraries that are similarly
-  //  thread unsafe, it could conflict with any other thread that
-  //  uses these other libraries."
-  g_curlInterface.Load();
-  g_curlInterface.Unload();
-
-  // initialize (and update as needed) our databases
-  CDatabaseManager::Get().Initialize();
+  // wait for the addons and our databases, which were started in Create()
+  if (!m_startup.Wait("addons,databases"))
+  {
+    CLog::Log(LOGFATAL, "CApplication::Initialize: Unable to start the addons");
+    return false;
+  }
 
+  m_startup.Begin("services");
   StartServices();
+  m_startup.End("services");
 
   // Init DPMS, before creating the corresponding setting control.
   m_dpms = new DPMSSupport();
@@ -1463,11 +1505,13 @@ bool CApplication::Initialize()
 
     // Make sure we have at least the default skin
     string defaultSkin = ((const CSettingString*)CSettings::Get().GetSetting("lookandfeel.skin"))->GetDefault();
+    m_startup.Begin("skin");
     if (!LoadSkin(CSettings::Get().GetString("lookandfeel.skin")) && !LoadSkin(defaultSkin))
     {
       CLog::Log(LOGERROR, "Default skin '%s' not found! Terminating..", defaultSkin.c_str());
       return false;
     }
+    m_startup.End("skin");
 
     if (g_advancedSettings.m_splashImage)
       SAFE_DELETE(m_splash);
@@ -1530,6 +1574,10 @@ bool CApplication::Initialize()
 
   CAddonMgr::Get().StartServices(true);
 
+  m_startup.Log();
+  if (g_advancedSettings.m_startupTrace)
+    m_startup.WriteTrace(URIUtils::AddFileToFolder(g_advancedSettings.m_logFolder, "xbmc-startup.json"));
+
   CLog::Log(LOGNOTICE, "initialize done");
 
   m_bInitializing = false;
@@ -1973,6 +2021,14 @@ bool CApplication::LoadSkin(const SkinPtr& skin)
 
   g_SkinInfo->LoadIncludes();
 
+  // decode the textures of the first window while the others are loaded
+  if (g_advancedSettings.m_guiPredecodeTextures)
+  {
+    CGUIWindow *startWindow = g_windowManager.GetWindow(currentWindow != WINDOW_INVALID ? currentWindow : g_SkinInfo->GetFirstWindow());
+    if (startWindow)
+      startWindow->PredecodeTextures();
+  }
+
   int64_t start;
   start = CurrentHostCounter();
 
@@ -2297,8 +2353,8 @@ void CApplication::Render()
 
   // reset our info cache - we do this at the end of Render so that it is
   // fresh for the next process(), or after a windowclose animation (where process()
-  // isn't called)
-  g_infoManager.ResetCache();
+  // isn't called). Only infos whose sources changed are re-evaluated.
+  g_infoManager.ResetFrameCache();
   lock.Leave();
 
   unsigned int now = XbmcThreads::SystemClockMillis();
@@ -2981,6 +3037,7 @@ void CApplication::FrameMove(bool processEvents, bool processGUI)
     if (!m_bStop)
       g_windowManager.Process(CTimeUtils::GetFrameTime());
     g_windowManager.FrameMove();
+    g_largeTextureManager.ProcessQueue();
   }
 }
 
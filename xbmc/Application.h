@@ -59,6 +59,7 @@ class CPlayerController;
 #include "win32/WIN32Util.h"
 #endif
 #include "utils/Stopwatch.h"
+#include "utils/StartupGraph.h"
 #ifdef HAS_PERFORMANCE_SAMPLE
 #include "utils/PerformanceStats.h"
 #endif
@@ -390,6 +391,7 @@ protected:
   CStopWatch m_navigationTimer;
   CStopWatch m_slowTimer;
   CStopWatch m_shutdownTimer;
+  CStartupGraph m_startup;           // runs the startup stages and traces them
 
   bool m_bInhibitIdleShutdown;
 
@@ -307,6 +307,13 @@ int CApplicationPlayer::GetCacheLevel() const
     return 0;
 }
 
+void CApplicationPlayer::GetBufferInfo(SPlayerBufferInfo &info)
+{
+  boost::shared_ptr<IPlayer> player = GetInternal();
+  if (player)
+    player->GetBufferInfo(info);
+}
+
 int CApplicationPlayer::GetSubtitleCount()
 {
   boost::shared_ptr<IPlayer> player = GetInternal();
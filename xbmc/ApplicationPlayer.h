@@ -43,6 +43,7 @@ class CStreamDetails;
 
 struct SPlayerAudioStreamInfo;
 struct SPlayerVideoStreamInfo;
+struct SPlayerBufferInfo;
 struct SPlayerSubtitleStreamInfo;
 struct TextCacheStruct_t;
 
@@ -85,6 +86,7 @@ public:
   int   GetAudioStreamCount();
   void  GetAudioStreamInfo(int index, SPlayerAudioStreamInfo &info);
   int   GetCacheLevel() const;
+  void  GetBufferInfo(SPlayerBufferInfo &info);
   float GetCachePercentage() const;
   int   GetChapterCount();
   int   GetChapter();  
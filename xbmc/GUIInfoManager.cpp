@@ -125,6 +125,12 @@ CGUIInfoManager::CGUIInfoManager(void) :
   m_playerShowInfo = false;
   m_fps = 0.0f;
   m_AVInfoValid = false;
+  m_invalidSources = 0;
+  memset(m_sourceStamps, 0, sizeof(m_sourceStamps));
+  m_playerState = 0;
+  m_minute = 0;
+  m_boolEvaluations = 0;
+  m_labelEvaluations = 0;
   ResetLibraryBools();
 }
 
@@ -1351,6 +1357,8 @@ TIME_FORMAT CGUIInfoManager::TranslateTimeFormat(const CStdString &format)
 
 CStdString CGUIInfoManager::GetLabel(int info, int contextWindow, CStdString *fallback)
 {
+  m_labelEvaluations++;
+
   if (info >= CONDITIONAL_LABEL_START && info <= CONDITIONAL_LABEL_END)
     return GetSkinVariableString(info, false);
 
@@ -5214,10 +5222,137 @@ void CGUIInfoManager::ResetCache()
   m_containerMoves.clear();
   // mark our infobools as dirty
   CSingleLock lock(m_critInfo);
+  m_invalidSources = 0;
+  for (unsigned int i = 0; i < INFO_SOURCE_COUNT; i++)
+    m_sourceStamps[i]++;
   for (vector<InfoPtr>::iterator i = m_bools.begin(); i != m_bools.end(); ++i)
     (*i)->SetDirty();
 }
 
+void CGUIInfoManager::ResetFrameCache()
+{
+  // reset any animation triggers as well
+  m_containerMoves.clear();
+
+  // the player and the clock don't publish their changes, so compare them to the last frame
+  int playerState = 0;
+  if (g_application.m_pPlayer->IsPlaying())
+  {
+    playerState = 1;
+    if (g_application.m_pPlayer->IsPlayingAudio())
+      playerState |= 2;
+    if (g_application.m_pPlayer->IsPlayingVideo())
+      playerState |= 4;
+    if (g_application.m_pPlayer->IsPausedPlayback())
+      playerState |= 8;
+    playerState |= (g_application.m_pPlayer->GetPlaySpeed() + 64) << 4;
+  }
+  if (playerState != m_playerState)
+  {
+    m_playerState = playerState;
+    Invalidate(INFO_SOURCE_PLAYER);
+  }
+  time_t minute = time(NULL) / 60;
+  if (minute != m_minute)
+  {
+    m_minute = minute;
+    Invalidate(INFO_SOURCE_TIME);
+  }
+
+  // mark the infobools of the changed sources as dirty
+  CSingleLock lock(m_critInfo);
+  unsigned int sources = m_invalidSources | INFO_SOURCE_FRAME;
+  m_invalidSources = 0;
+  for (unsigned int i = 0; i < INFO_SOURCE_COUNT; i++)
+  {
+    if (sources & (1 << i))
+      m_sourceStamps[i]++;
+  }
+  for (vector<InfoPtr>::iterator i = m_bools.begin(); i != m_bools.end(); ++i)
+  {
+    if ((*i)->GetSources() & sources)
+      (*i)->SetDirty();
+  }
+}
+
+void CGUIInfoManager::Invalidate(unsigned int sources)
+{
+  CSingleLock lock(m_critInfo);
+  m_invalidSources |= sources;
+}
+
+unsigned int CGUIInfoManager::GetInfoSources(int info) const
+{
+  int condition = abs(info);
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    const GUIInfo &multiInfo = m_multiInfo[condition - MULTI_INFO_START];
+    switch (abs(multiInfo.m_info))
+    {
+    case SKIN_BOOL:
+    case SKIN_STRING:
+    case SKIN_HAS_THEME:
+      return INFO_SOURCE_SKIN;
+    case SYSTEM_TIME:
+      // only time ranges, the labels may show seconds
+      return multiInfo.GetData2() ? INFO_SOURCE_TIME : INFO_SOURCE_FRAME;
+    case SYSTEM_DATE:
+      return INFO_SOURCE_TIME;
+    default:
+      return INFO_SOURCE_FRAME;
+    }
+  }
+  if (condition >= PVR_CONDITIONS_START && condition <= PVR_CONDITIONS_END)
+    return INFO_SOURCE_PVR;
+  if (condition >= LIBRARY_HAS_MUSIC && condition <= LIBRARY_HAS_MUSICVIDEOS)
+    return INFO_SOURCE_LIBRARY;
+  if (condition >= PLAYER_HAS_MEDIA && condition <= PLAYER_FORWARDING_32x)
+    return INFO_SOURCE_PLAYER;
+
+  switch (condition)
+  {
+  case SYSTEM_ALWAYS_TRUE:
+  case SYSTEM_ALWAYS_FALSE:
+  case SYSTEM_ETHERNET_LINK_ACTIVE:
+  case SYSTEM_HAS_PVR:
+  case SYSTEM_BUILD_VERSION:
+  case SYSTEM_BUILD_DATE:
+  case SYSTEM_PLATFORM_LINUX:
+  case SYSTEM_PLATFORM_WINDOWS:
+  case SYSTEM_PLATFORM_DARWIN:
+  case SYSTEM_PLATFORM_DARWIN_OSX:
+  case SYSTEM_PLATFORM_DARWIN_IOS:
+  case SYSTEM_PLATFORM_DARWIN_ATV2:
+  case SYSTEM_PLATFORM_ANDROID:
+  case SYSTEM_PLATFORM_LINUX_RASPBERRY_PI:
+    return INFO_SOURCE_NONE;
+  case SYSTEM_DATE:
+    return INFO_SOURCE_TIME;
+  default:
+    return INFO_SOURCE_FRAME;
+  }
+}
+
+unsigned int CGUIInfoManager::GetSourceStamp(unsigned int sources) const
+{
+  // stamps only ever increase, so their sum changes with any of them
+  unsigned int stamp = 0;
+  for (unsigned int i = 0; i < INFO_SOURCE_COUNT; i++)
+  {
+    if (sources & (1 << i))
+      stamp += m_sourceStamps[i];
+  }
+  return stamp;
+}
+
+void CGUIInfoManager::GetEvaluations(unsigned int &bools, unsigned int &labels)
+{
+  bools = m_boolEvaluations;
+  labels = m_labelEvaluations;
+  m_boolEvaluations = 0;
+  m_labelEvaluations = 0;
+}
+
 // Called from tuxbox service thread to update current status
 void CGUIInfoManager::UpdateFromTuxBox()
 {
@@ -5415,6 +5550,7 @@ void CGUIInfoManager::SetLibraryBool(int condition, bool value)
     default:
       break;
   }
+  Invalidate(INFO_SOURCE_LIBRARY);
 }
 
 void CGUIInfoManager::ResetLibraryBools()
@@ -5424,6 +5560,7 @@ void CGUIInfoManager::ResetLibraryBools()
   m_libraryHasTVShows = -1;
   m_libraryHasMusicVideos = -1;
   m_libraryHasMovieSets = -1;
+  Invalidate(INFO_SOURCE_LIBRARY);
 }
 
 bool CGUIInfoManager::GetLibraryBool(int condition)
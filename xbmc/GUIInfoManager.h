@@ -807,7 +807,42 @@ public:
   void SetNextWindow(int windowID) { m_nextWindowID = windowID; };
   void SetPreviousWindow(int windowID) { m_prevWindowID = windowID; };
 
+  /*! \brief Set all info bools dirty and drop the cached labels
+   */
   void ResetCache();
+
+  /*! \brief Set the info bools dirty that may have changed since the last frame
+   Called at the end of every frame. Bools depending on INFO::INFO_SOURCE_FRAME are
+   always set dirty, all others only if one of their sources was invalidated.
+   \sa Invalidate
+   */
+  void ResetFrameCache();
+
+  /*! \brief Publish a change of one or more info sources
+   Infos depending on the sources are re-evaluated from the next frame on. May be
+   called from any thread.
+   \param sources a combination of INFO::InfoSource flags
+   */
+  void Invalidate(unsigned int sources);
+
+  /*! \brief Get the sources an info depends on
+   \param info the info, as returned by TranslateString or TranslateSingleString
+   \return a combination of INFO::InfoSource flags
+   */
+  unsigned int GetInfoSources(int info) const;
+
+  /*! \brief Get a stamp of the state of some sources
+   The stamp changes whenever one of the sources is invalidated, so it can be used to
+   cache labels built from infos of these sources.
+   \param sources a combination of INFO::InfoSource flags
+   */
+  unsigned int GetSourceStamp(unsigned int sources) const;
+
+  /*! \brief Get the number of info bools and labels evaluated since the last call
+   \sa CGUIControlProfiler
+   */
+  void GetEvaluations(unsigned int &bools, unsigned int &labels);
+
   bool GetItemInt(int &value, const CGUIListItem *item, int info) const;
   CStdString GetItemLabel(const CFileItem *item, int info, CStdString *fallback = NULL);
   CStdString GetItemImage(const CFileItem *item, int info, CStdString *fallback = NULL);
@@ -939,6 +974,16 @@ protected:
   std::vector<INFO::InfoPtr> m_bools;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
 
+  // sources invalidated since the last frame and a stamp per source
+  unsigned int m_invalidSources;
+  unsigned int m_sourceStamps[INFO::INFO_SOURCE_COUNT];
+  int m_playerState;
+  time_t m_minute;
+
+  // evaluations for the control profiler
+  unsigned int m_boolEvaluations;
+  unsigned int m_labelEvaluations;
+
   int m_libraryHasMusic;
   int m_libraryHasMovies;
   int m_libraryHasTVShows;
@@ -20,6 +20,7 @@
 
 #include "threads/SystemClock.h"
 #include "GUILargeTextureManager.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "guilib/Texture.h"
 #include "threads/SingleLock.h"
@@ -29,14 +30,24 @@
 #include "utils/log.h"
 #include "TextureCache.h"
 
+#include <math.h>
+
 using namespace std;
 
+// number of images loaded at the same time
+#define MAX_LOADING        4
+// added to the priority of images off screen, so they're loaded after those on screen
+#define OFFSCREEN_PRIORITY 1000000.0f
+// smallest size images are decoded at
+#define MIN_LOAD_SIZE      128
+
 
-CImageLoader::CImageLoader(const CStdString &path, const bool useCache)
+CImageLoader::CImageLoader(const CStdString &path, const bool useCache, unsigned int size)
 {
   m_path = path;
   m_texture = NULL;
   m_use_cache = useCache;
+  m_size = size;
 }
 
 CImageLoader::~CImageLoader()
@@ -60,13 +71,21 @@ bool CImageLoader::DoWork()
     // not in our texture cache, so try and load directly and then cache the result
     loadPath = CTextureCache::Get().CacheImage(texturePath, &m_texture);
     if (m_texture)
-      return true; // we're done
+    {
+      // the cache decodes at its own size, load the cached image again if we need it smaller
+      if (!m_size || loadPath.empty() || max(m_texture->GetWidth(), m_texture->GetHeight()) <= m_size)
+        return true; // we're done
+      delete m_texture;
+      m_texture = NULL;
+    }
   }
   if (!m_use_cache || !loadPath.empty())
   {
     // direct route - load the image
     unsigned int start = XbmcThreads::SystemClockMillis();
-    m_texture = CBaseTexture::LoadFromFile(loadPath, g_graphicsContext.GetWidth(), g_graphicsContext.GetHeight(), CSettings::Get().GetBool("pictures.useexifrotation"));
+    unsigned int width = m_size ? m_size : g_graphicsContext.GetWidth();
+    unsigned int height = m_size ? m_size : g_graphicsContext.GetHeight();
+    m_texture = CBaseTexture::LoadFromFile(loadPath, width, height, CSettings::Get().GetBool("pictures.useexifrotation"));
     if (!m_texture)
       return false;
     if (XbmcThreads::SystemClockMillis() - start > 100)
@@ -78,10 +97,14 @@ bool CImageLoader::DoWork()
   return true;
 }
 
-CGUILargeTextureManager::CLargeTexture::CLargeTexture(const CStdString &path)
+CGUILargeTextureManager::CLargeTexture::CLargeTexture(const CStdString &path, unsigned int size, bool useCache)
 {
   m_path = path;
+  m_size = size;
+  m_useCache = useCache;
+  m_priority = 0.0f;
   m_refCount = 1;
+  m_bytes = 0;
   m_timeToDelete = 0;
 }
 
@@ -125,11 +148,18 @@ void CGUILargeTextureManager::CLargeTexture::SetTexture(CBaseTexture* texture)
 {
   assert(!m_texture.size());
   if (texture)
+  {
     m_texture.Set(texture, texture->GetWidth(), texture->GetHeight());
+    m_bytes = (uint64_t)texture->GetPitch() * texture->GetRows();
+  }
 }
 
 CGUILargeTextureManager::CGUILargeTextureManager()
 {
+  m_budget = 0;
+  m_loadedBytes = 0;
+  m_cancelled = 0;
+  m_evicted = 0;
 }
 
 CGUILargeTextureManager::~CGUILargeTextureManager()
@@ -144,22 +174,29 @@ void CGUILargeTextureManager::CleanupUnusedImages(bool immediately)
   while (it != m_allocated.end())
   {
     CLargeTexture *image = *it;
+    uint64_t bytes = image->GetBytes();
     if (image->DeleteIfRequired(immediately))
+    {
+      m_loadedBytes -= bytes;
       it = m_allocated.erase(it);
+    }
     else
       ++it;
   }
+  FreeOverBudget();
+  StartLoads();
 }
 
 // if available, increment reference count, and return the image.
 // else, add to the queue list if appropriate.
-bool CGUILargeTextureManager::GetImage(const CStdString &path, CTextureArray &texture, bool firstRequest, const bool useCache)
+bool CGUILargeTextureManager::GetImage(const CStdString &path, CTextureArray &texture, bool firstRequest, const bool useCache,
+                                       unsigned int size, float priority)
 {
   CSingleLock lock(m_listSection);
   for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
   {
     CLargeTexture *image = *it;
-    if (image->GetPath() == path)
+    if (image->Matches(path, size))
     {
       if (firstRequest)
         image->AddRef();
@@ -169,63 +206,170 @@ bool CGUILargeTextureManager::GetImage(const CStdString &path, CTextureArray &te
   }
 
   if (firstRequest)
-    QueueImage(path, useCache);
+    QueueImage(path, useCache, size, priority);
+  else
+  {
+    // still waiting, so keep the priority up to date with where the image is now
+    for (listIterator it = m_queued.begin(); it != m_queued.end(); ++it)
+    {
+      if ((*it)->Matches(path, size))
+      {
+        (*it)->m_priority = priority;
+        break;
+      }
+    }
+  }
 
   return true;
 }
 
-void CGUILargeTextureManager::ReleaseImage(const CStdString &path, bool immediately)
+void CGUILargeTextureManager::ReleaseImage(const CStdString &path, bool immediately, unsigned int size)
 {
   CSingleLock lock(m_listSection);
   for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
   {
     CLargeTexture *image = *it;
-    if (image->GetPath() == path)
+    if (image->Matches(path, size))
     {
+      uint64_t bytes = image->GetBytes();
       if (image->DecrRef(immediately) && immediately)
+      {
+        m_loadedBytes -= bytes;
         m_allocated.erase(it);
+      }
+      return;
+    }
+  }
+  for (listIterator it = m_queued.begin(); it != m_queued.end(); ++it)
+  {
+    CLargeTexture *image = *it;
+    if (image->Matches(path, size))
+    {
+      // not started yet, so nothing to cancel but our entry
+      if (image->DecrRef(true))
+      {
+        m_queued.erase(it);
+        m_cancelled++;
+      }
       return;
     }
   }
-  for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
+  for (queueIterator it = m_loading.begin(); it != m_loading.end(); ++it)
   {
     unsigned int id = it->first;
     CLargeTexture *image = it->second;
-    if (image->GetPath() == path && image->DecrRef(true))
+    if (image->Matches(path, size))
     {
-      // cancel this job
-      CJobManager::GetInstance().CancelJob(id);
-      m_queued.erase(it);
+      if (image->DecrRef(true))
+      {
+        // cancel this job
+        CancelLoader(id);
+        m_loading.erase(it);
+        m_cancelled++;
+        StartLoads();
+      }
       return;
     }
   }
 }
 
-// queue the image, and start the background loader if necessary
-void CGUILargeTextureManager::QueueImage(const CStdString &path, bool useCache)
+// queue the image, to be started by ProcessQueue()
+void CGUILargeTextureManager::QueueImage(const CStdString &path, bool useCache, unsigned int size, float priority)
 {
   CSingleLock lock(m_listSection);
-  for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
+  for (listIterator it = m_queued.begin(); it != m_queued.end(); ++it)
   {
-    CLargeTexture *image = it->second;
-    if (image->GetPath() == path)
+    CLargeTexture *image = *it;
+    if (image->Matches(path, size))
     {
       image->AddRef();
+      image->m_priority = min(image->m_priority, priority);
       return; // already queued
     }
   }
+  for (queueIterator it = m_loading.begin(); it != m_loading.end(); ++it)
+  {
+    CLargeTexture *image = it->second;
+    if (image->Matches(path, size))
+    {
+      image->AddRef();
+      return; // already loading
+    }
+  }
 
   // queue the item
-  CLargeTexture *image = new CLargeTexture(path);
-  unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path, useCache), this, CJob::PRIORITY_NORMAL);
-  m_queued.push_back(make_pair(jobID, image));
+  CLargeTexture *image = new CLargeTexture(path, size, useCache);
+  image->m_priority = priority;
+  m_queued.push_back(image);
+}
+
+void CGUILargeTextureManager::ProcessQueue()
+{
+  CSingleLock lock(m_listSection);
+  if (m_loadedBytes > GetBudget())
+    FreeOverBudget();
+  StartLoads();
+}
+
+void CGUILargeTextureManager::StartLoads()
+{
+  CSingleLock lock(m_listSection);
+
+  // with the images in use taking up the budget, only images on screen are loaded
+  uint64_t inUse = 0;
+  for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  {
+    if ((*it)->InUse())
+      inUse += (*it)->GetBytes();
+  }
+  bool overBudget = inUse >= GetBudget();
+
+  while (m_loading.size() < MAX_LOADING && !m_queued.empty())
+  {
+    listIterator next = m_queued.begin();
+    for (listIterator it = m_queued.begin() + 1; it != m_queued.end(); ++it)
+    {
+      if ((*it)->m_priority < (*next)->m_priority)
+        next = it;
+    }
+    CLargeTexture *image = *next;
+    if (overBudget && image->m_priority >= OFFSCREEN_PRIORITY)
+      break;
+
+    m_queued.erase(next);
+    unsigned int jobID = StartLoader(new CImageLoader(image->GetPath(), image->UseCache(), image->GetSize()));
+    m_loading.push_back(make_pair(jobID, image));
+  }
+}
+
+void CGUILargeTextureManager::FreeOverBudget()
+{
+  CSingleLock lock(m_listSection);
+  uint64_t budget = GetBudget();
+  while (m_loadedBytes > budget)
+  {
+    // free the image that has been unused the longest
+    listIterator oldest = m_allocated.end();
+    for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+    {
+      if (!(*it)->InUse() && (oldest == m_allocated.end() || (*it)->GetTimeToDelete() < (*oldest)->GetTimeToDelete()))
+        oldest = it;
+    }
+    if (oldest == m_allocated.end())
+      break; // everything left is in use
+
+    m_loadedBytes -= (*oldest)->GetBytes();
+    (*oldest)->DeleteIfRequired(true);
+    m_allocated.erase(oldest);
+    m_evicted++;
+  }
 }
 
 void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJob *job)
 {
   // see if we still have this job id
   CSingleLock lock(m_listSection);
-  for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
+  for (queueIterator it = m_loading.begin(); it != m_loading.end(); ++it)
   {
     if (it->first == jobID)
     { // found our job
@@ -233,12 +377,89 @@ void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJ
       CLargeTexture *image = it->second;
       image->SetTexture(loader->m_texture);
       loader->m_texture = NULL; // we want to keep the texture, and jobs are auto-deleted.
-      m_queued.erase(it);
+      m_loadedBytes += image->GetBytes();
+      m_loading.erase(it);
       m_allocated.push_back(image);
+      StartLoads();
       return;
     }
   }
 }
 
+void CGUILargeTextureManager::SetFocus(const CRect &rect)
+{
+  CSingleLock lock(m_listSection);
+  m_focus = CPoint((rect.x1 + rect.x2) * 0.5f, (rect.y1 + rect.y2) * 0.5f);
+}
+
+float CGUILargeTextureManager::GetPriority(const CRect &rect) const
+{
+  float x = (rect.x1 + rect.x2) * 0.5f - m_focus.x;
+  float y = (rect.y1 + rect.y2) * 0.5f - m_focus.y;
+  float priority = sqrt(x * x + y * y);
+
+  float width = (float)g_graphicsContext.GetWidth();
+  float height = (float)g_graphicsContext.GetHeight();
+  if (max(rect.x1, rect.x2) <= 0 || min(rect.x1, rect.x2) >= width ||
+      max(rect.y1, rect.y2) <= 0 || min(rect.y1, rect.y2) >= height)
+    priority += OFFSCREEN_PRIORITY;
+  return priority;
+}
+
+unsigned int CGUILargeTextureManager::GetLoadSize(float width, float height)
+{
+  // auto sized controls only know their size once the image is loaded
+  if (width == 0.0f || height == 0.0f)
+    return 0;
+
+  float largest = max(fabs(width), fabs(height));
+  unsigned int size = MIN_LOAD_SIZE;
+  while (size < largest)
+    size <<= 1;
+
+  // as large as the screen is as large as we load anyway
+  if (size >= (unsigned int)max(g_graphicsContext.GetWidth(), g_graphicsContext.GetHeight()))
+    return 0;
+  return size;
+}
+
+void CGUILargeTextureManager::SetBudget(uint64_t bytes)
+{
+  CSingleLock lock(m_listSection);
+  m_budget = bytes;
+}
 
+uint64_t CGUILargeTextureManager::GetBudget() const
+{
+  if (m_budget)
+    return m_budget;
+  return (uint64_t)g_advancedSettings.m_guiLargeTextureMemory * 1024 * 1024;
+}
 
+void CGUILargeTextureManager::GetStats(SLargeTextureStats &stats)
+{
+  CSingleLock lock(m_listSection);
+  stats.loadedBytes = m_loadedBytes;
+  stats.budgetBytes = GetBudget();
+  stats.loaded = m_allocated.size();
+  stats.unused = 0;
+  for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  {
+    if (!(*it)->InUse())
+      stats.unused++;
+  }
+  stats.queued = m_queued.size();
+  stats.loading = m_loading.size();
+  stats.cancelled = m_cancelled;
+  stats.evicted = m_evicted;
+}
+
+unsigned int CGUILargeTextureManager::StartLoader(CImageLoader *loader)
+{
+  return CJobManager::GetInstance().AddJob(loader, this, CJob::PRIORITY_NORMAL);
+}
+
+void CGUILargeTextureManager::CancelLoader(unsigned int jobID)
+{
+  CJobManager::GetInstance().CancelJob(jobID);
+}
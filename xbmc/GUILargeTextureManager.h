@@ -22,6 +22,7 @@
 
 #include "threads/CriticalSection.h"
 #include "utils/Job.h"
+#include "guilib/Geometry.h"
 #include "guilib/TextureManager.h"
 
 /*!
@@ -35,7 +36,7 @@
 class CImageLoader : public CJob
 {
 public:
-  CImageLoader(const CStdString &path, const bool useCache);
+  CImageLoader(const CStdString &path, const bool useCache, unsigned int size = 0);
   virtual ~CImageLoader();
 
   /*!
@@ -45,9 +46,26 @@ public:
 
   bool          m_use_cache; ///< Whether or not to use any caching with this image
   CStdString    m_path; ///< path of image to load
+  unsigned int  m_size; ///< size to decode the image at, 0 for the screen size \sa CGUILargeTextureManager::GetLoadSize
   CBaseTexture *m_texture; ///< Texture object to load the image into \sa CBaseTexture.
 };
 
+/*!
+ \ingroup textures
+ \brief Statistics of the large texture manager
+ */
+struct SLargeTextureStats
+{
+  uint64_t     loadedBytes;   ///< memory taken by the loaded images
+  uint64_t     budgetBytes;   ///< memory the loaded images should fit in
+  unsigned int loaded;        ///< number of loaded images
+  unsigned int unused;        ///< loaded images no longer in use, kept in case they're needed again
+  unsigned int queued;        ///< images waiting to be loaded
+  unsigned int loading;       ///< images being loaded
+  unsigned int cancelled;     ///< loads cancelled because the image was released before it was loaded
+  unsigned int evicted;       ///< unused images freed early to stay within the budget
+};
+
 /*!
  \ingroup textures
  \brief Background texture loading manager
@@ -55,6 +73,12 @@ public:
  Used to load textures for the user interface asynchronously, allowing fluid framerates
  while background loading textures.
 
+ Images are loaded a few at a time, most important first: images on screen before those
+ that are not, and those closest to the focused item first. Images that are released
+ before their turn comes are never loaded. Loaded images no longer in use are kept for
+ a while in case they're needed again, but are freed early, least recently used first,
+ when the loaded images take more memory than the budget allows.
+
  \sa IJobCallback, CGUITexture
  */
 class CGUILargeTextureManager : public IJobCallback
@@ -81,12 +105,15 @@ public:
 
    \param path path of the image to load.
    \param texture texture object to hold the resulting texture
-   \param orientation orientation of resulting texture
    \param firstRequest true if this is the first time we are requesting this texture
+   \param useCache whether to load the image through the texture cache
+   \param size size to decode the image at, 0 for the screen size \sa GetLoadSize
+   \param priority how soon the image is needed, lower is sooner \sa GetPriority
    \return true if the image exists, else false.
    \sa CGUITextureArray and CGUITexture
    */
-  bool GetImage(const CStdString &path, CTextureArray &texture, bool firstRequest, bool useCache = true);
+  bool GetImage(const CStdString &path, CTextureArray &texture, bool firstRequest, bool useCache = true,
+                unsigned int size = 0, float priority = 0.0f);
 
   /*!
    \brief Request a texture to be unloaded.
@@ -98,8 +125,9 @@ public:
    \param path path of the image to release.
    \param immediately if set true the image is immediately unloaded once its reference count reaches zero
                       rather than being unloaded after a delay.
+   \param size size the image was requested at
    */
-  void ReleaseImage(const CStdString &path, bool immediately = false);
+  void ReleaseImage(const CStdString &path, bool immediately = false, unsigned int size = 0);
 
   /*!
    \brief Cleanup images that are no longer in use.
@@ -112,11 +140,64 @@ public:
    */
   void CleanupUnusedImages(bool immediately = false);
 
+  /*!
+   \brief Start loading the most important of the queued images.
+
+   Called once a frame, after the GUI has been processed and requested the images it needs, so
+   that the images are loaded in order of priority rather than in the order they were requested.
+   */
+  void ProcessQueue();
+
+  /*!
+   \brief Set the focused item, which images are loaded outwards from
+   \param rect the focused item in screen coordinates
+   */
+  void SetFocus(const CRect &rect);
+
+  /*!
+   \brief Priority of an image drawn at the given place
+   \param rect where the image is drawn, in screen coordinates
+   \return the distance from the focused item, offset so that images off screen come last
+   */
+  float GetPriority(const CRect &rect) const;
+
+  /*!
+   \brief Size to decode an image at to draw it at the given size
+
+   Sizes are rounded up to a power of two, so an image drawn at slightly different sizes
+   is only loaded once.
+
+   \param width width the image is drawn at, in screen pixels, 0 if it is sized to the image
+   \param height height the image is drawn at, in screen pixels, 0 if it is sized to the image
+   \return the largest dimension to decode the image at, 0 for the screen size
+   */
+  static unsigned int GetLoadSize(float width, float height);
+
+  /*!
+   \brief Set the memory the loaded images should fit in
+   \param bytes the budget, 0 for the one from the advanced settings
+   */
+  void SetBudget(uint64_t bytes);
+
+  void GetStats(SLargeTextureStats &stats);
+
+protected:
+  /*!
+   \brief Start a loader job
+   \return the id of the job
+   */
+  virtual unsigned int StartLoader(CImageLoader *loader);
+
+  /*!
+   \brief Cancel a loader job started by StartLoader()
+   */
+  virtual void CancelLoader(unsigned int jobID);
+
 private:
   class CLargeTexture
   {
   public:
-    CLargeTexture(const CStdString &path);
+    CLargeTexture(const CStdString &path, unsigned int size, bool useCache);
     virtual ~CLargeTexture();
 
     void AddRef();
@@ -124,28 +205,48 @@ private:
     bool DeleteIfRequired(bool deleteImmediately = false);
     void SetTexture(CBaseTexture* texture);
 
+    bool Matches(const CStdString &path, unsigned int size) const { return m_size == size && m_path == path; };
+    bool InUse() const { return m_refCount > 0; };
+
     const CStdString &GetPath() const { return m_path; };
     const CTextureArray &GetTexture() const { return m_texture; };
+    unsigned int GetSize() const { return m_size; };
+    bool UseCache() const { return m_useCache; };
+    uint64_t GetBytes() const { return m_bytes; };
+    unsigned int GetTimeToDelete() const { return m_timeToDelete; };
+
+    float m_priority;
 
   private:
     static const unsigned int TIME_TO_DELETE = 2000;
 
     unsigned int m_refCount;
     CStdString m_path;
+    unsigned int m_size;
+    bool m_useCache;
     CTextureArray m_texture;
+    uint64_t m_bytes;
     unsigned int m_timeToDelete;
   };
 
-  void QueueImage(const CStdString &path, bool useCache = true);
+  void QueueImage(const CStdString &path, bool useCache, unsigned int size, float priority);
+  void StartLoads();
+  void FreeOverBudget();
+  uint64_t GetBudget() const;
 
-  std::vector< std::pair<unsigned int, CLargeTexture *> > m_queued;
+  std::vector<CLargeTexture *> m_queued;
+  std::vector< std::pair<unsigned int, CLargeTexture *> > m_loading;
   std::vector<CLargeTexture *> m_allocated;
   typedef std::vector<CLargeTexture *>::iterator listIterator;
   typedef std::vector< std::pair<unsigned int, CLargeTexture *> >::iterator queueIterator;
 
+  CPoint m_focus;
+  uint64_t m_budget;
+  uint64_t m_loadedBytes;
+  unsigned int m_cancelled;
+  unsigned int m_evicted;
+
   CCriticalSection m_listSection;
 };
 
 extern CGUILargeTextureManager g_largeTextureManager;
-
-
@@ -115,6 +115,16 @@ public:
   void LoadIncludes();
   const INFO::CSkinVariableString* CreateSkinVariable(const CStdString& name, int context);
 
+  /*! \brief Load an include file, unless it's loaded already
+   \param file full path to the include file
+   */
+  void LoadIncludeFile(const CStdString &file) { m_includes.LoadIncludes(file); };
+
+  /*! \brief Retrieve the include files loaded so far
+   \param files [out] full paths of the include files
+   */
+  void GetIncludeFiles(std::vector<CStdString> &files) const { files = m_includes.GetFiles(); };
+
   static void SettingOptionsSkinColorsFiller(const CSetting *setting, std::vector< std::pair<std::string, std::string> > &list, std::string &current, void *data);
   static void SettingOptionsSkinFontsFiller(const CSetting *setting, std::vector< std::pair<std::string, std::string> > &list, std::string &current, void *data);
   static void SettingOptionsSkinSoundFiller(const CSetting *setting, std::vector< std::pair<std::string, std::string> > &list, std::string &current, void *data);
@@ -19,7 +19,6 @@
  */
 #include "system.h"
 #include "Visualisation.h"
-#include "utils/fft.h"
 #include "GUIInfoManager.h"
 #include "Application.h"
 #include "guilib/GraphicContext.h"
@@ -281,13 +280,13 @@ void CVisualisation::OnAudioData(const float* pAudioData, int iAudioDataLength)
   if (m_bWantsFreq)
   {
     const float *psAudioData = ptrAudioBuffer->Get();
-    memcpy(m_fFreq, psAudioData, AUDIO_BUFFER_SIZE * sizeof(float));
 
-    // FFT the data
-    twochanwithwindow(m_fFreq, AUDIO_BUFFER_SIZE);
+    // FFT the data, the buffer holds AUDIO_BUFFER_SIZE / 2 stereo frames
+    // which are zero padded to AUDIO_BUFFER_SIZE bins
+    m_spectrum.TwoChannelPower(psAudioData, AUDIO_BUFFER_SIZE / 2, m_fFreq);
 
     // Normalize the data
-    float fMinData = (float)AUDIO_BUFFER_SIZE * AUDIO_BUFFER_SIZE * 3 / 8 * 0.5 * 0.5; // 3/8 for the Hann window, 0.5 as minimum amplitude
+    float fMinData = (float)AUDIO_BUFFER_SIZE * AUDIO_BUFFER_SIZE / 4 * 3 / 8 * 0.5 * 0.5; // 3/8 for the Hann window over half the transform, 0.5 as minimum amplitude
     float fInvMinData = 1.0f/fMinData;
     for (int i = 0; i < AUDIO_BUFFER_SIZE + 2; i++)
     {
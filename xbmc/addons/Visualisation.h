@@ -23,6 +23,7 @@
 #include "cores/IAudioCallback.h"
 #include "include/xbmc_vis_types.h"
 #include "guilib/IRenderingCallback.h"
+#include "utils/SpectrumAnalyser.h"
 
 #include <map>
 #include <list>
@@ -55,8 +56,8 @@ namespace ADDON
                        , public IRenderingCallback
   {
   public:
-    CVisualisation(const ADDON::AddonProps &props) : CAddonDll<DllVisualisation, Visualisation, VIS_PROPS>(props) {}
-    CVisualisation(const cp_extension_t *ext) : CAddonDll<DllVisualisation, Visualisation, VIS_PROPS>(ext) {}
+    CVisualisation(const ADDON::AddonProps &props) : CAddonDll<DllVisualisation, Visualisation, VIS_PROPS>(props), m_spectrum(AUDIO_BUFFER_SIZE) {}
+    CVisualisation(const cp_extension_t *ext) : CAddonDll<DllVisualisation, Visualisation, VIS_PROPS>(ext), m_spectrum(AUDIO_BUFFER_SIZE) {}
     virtual void OnInitialize(int iChannels, int iSamplesPerSec, int iBitsPerSample);
     virtual void OnAudioData(const float* pAudioData, int iAudioDataLength);
     bool Create(int x, int y, int w, int h, void *device);
@@ -103,6 +104,7 @@ namespace ADDON
     int m_iNumBuffers;        // Number of Audio buffers
     bool m_bWantsFreq;
     float m_fFreq[2*AUDIO_BUFFER_SIZE];         // Frequency data
+    CSpectrumAnalyser m_spectrum;
     bool m_bCalculate_Freq;       // True if the vis wants freq data
 
     // track information
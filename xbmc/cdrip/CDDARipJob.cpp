@@ -19,6 +19,7 @@
  */
 
 #include "CDDARipJob.h"
+#include "CDDARipReader.h"
 #include "system.h"
 #ifdef HAVE_LIBMP3LAME
 #include "EncoderLame.h"
@@ -39,11 +40,20 @@
 #include "guilib/LocalizeStrings.h"
 #include "settings/AdvancedSettings.h"
 #include "utils/StringUtils.h"
-#include "storage/MediaManager.h"
 
 using namespace MUSIC_INFO;
 using namespace XFILE;
 
+// bytes a job may read ahead of its encoder, about 25 seconds of cd audio
+#define RIP_READAHEAD_SIZE (4 * 1024 * 1024)
+
+// how long to wait for the drive or the reader before checking for cancellation
+#define RIP_WAIT_SLICE 100
+
+// hands the drive to parallel rip jobs in the order they asked for it,
+// only the local drive is ripped from
+static CCDDARipDrive g_drive;
+
 CCDDARipJob::CCDDARipJob(const CStdString& input,
                          const CStdString& output,
                          const CMusicInfoTag& tag, 
@@ -77,12 +87,25 @@ bool CCDDARipJob::DoWork()
     return false;
   }
 
-  // init ripper
+  // wait for the drive, opening the track seeks on it as well
+  unsigned int ticket = g_drive.TakeTicket();
+  while (!g_drive.WaitTurn(ticket, RIP_WAIT_SLICE))
+  {
+    if (ShouldCancel(0, 100))
+    {
+      g_drive.ReturnTicket(ticket);
+      return false;
+    }
+  }
+
+  // init ripper, uncached as the read ahead below is all the caching
+  // needed and a cache would read on without holding the drive
   CFile reader;
   CEncoder* encoder;
-  if (!reader.Open(m_input,READ_CACHED) || !(encoder=SetupEncoder(reader)))
+  if (!reader.Open(m_input,READ_NO_CACHE) || !(encoder=SetupEncoder(reader)))
   {
     CLog::Log(LOGERROR, "Error: CCDDARipper::Init failed");
+    g_drive.ReturnTicket(ticket);
     return false;
   }
 
@@ -97,12 +120,18 @@ bool CCDDARipJob::DoWork()
                                             m_tag.GetTitle().c_str());
   handle->SetText(strLine0);
 
-  // start ripping
+  // start ripping, the input is read ahead on its own thread so the
+  // drive is released for the next track while this one is encoded
+  CCDDARipReader readAhead(reader, g_drive, ticket, RIP_READAHEAD_SIZE);
+  readAhead.Start();
+
+  int64_t length = reader.GetLength();
+  int64_t encoded = 0;
   int percent=0;
   int oldpercent=0;
   bool cancelled(false);
   int result;
-  while (!cancelled && (result=RipChunk(reader, encoder, percent)) == 0)
+  while (!cancelled && (result=RipChunk(readAhead, encoder, length, encoded, percent)) == 0)
   {
     cancelled = ShouldCancel(percent,100);
     if (percent > oldpercent)
@@ -113,6 +142,7 @@ bool CCDDARipJob::DoWork()
   }
 
   // close encoder ripper
+  readAhead.Stop();
   encoder->Close();
   delete encoder;
   reader.Close();
@@ -141,41 +171,39 @@ bool CCDDARipJob::DoWork()
   else if (result < 0)
     CLog::Log(LOGERROR, "CDDARipper: Error encoding %s", m_input.c_str());
   else
-  {
     CLog::Log(LOGINFO, "Finished ripping %s", m_input.c_str());
-    if (m_eject)
-    {
-      CLog::Log(LOGINFO, "Ejecting CD");
-      g_mediaManager.EjectTray();
-    }
-  }
 
   handle->MarkFinished();
 
   return !cancelled && result == 2;
 }
 
-int CCDDARipJob::RipChunk(CFile& reader, CEncoder* encoder, int& percent)
+int CCDDARipJob::RipChunk(CCDDARipReader& reader, CEncoder* encoder,
+                          int64_t length, int64_t& encoded, int& percent)
 {
+  // Get progress indication, based on what has been encoded as
+  // reading may be ahead
   percent = 0;
+  if (length > 0)
+    percent = static_cast<int>(encoded*100/length);
 
-  uint8_t stream[1024];
-
-  // get data
-  int result = reader.Read(stream, 1024);
-
-  // return if rip is done or on some kind of error
-  if (!result)
-    return 1;
+  // get data, return if rip is done or on some kind of error, or
+  // to check for cancellation if the reader is slow
+  std::vector<uint8_t> stream;
+  if (!reader.GetChunk(stream, RIP_WAIT_SLICE))
+  {
+    if (!reader.IsFinished())
+      return 0;
+    return reader.HasError() || encoded == 0 ? 1 : 2;
+  }
 
   // encode data
-  int encres=encoder->Encode(result, stream);
-
-  // Get progress indication
-  percent = static_cast<int>(reader.GetPosition()*100/reader.GetLength());
+  int encres=encoder->Encode(stream.size(), &stream[0]);
+  encoded += stream.size();
+  reader.ReleaseChunk(stream);
 
-  if (reader.GetPosition() == reader.GetLength())
-    return 2;
+  if (length > 0)
+    percent = static_cast<int>(encoded*100/length);
 
   return -(1-encres);
 }
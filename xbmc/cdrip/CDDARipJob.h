@@ -24,6 +24,7 @@
 #include "music/tags/MusicInfoTag.h"
 
 class CEncoder;
+class CCDDARipReader;
 
 namespace XFILE
 {
@@ -53,6 +54,7 @@ public:
   virtual bool operator==(const CJob *job) const;
   virtual bool DoWork();
   CStdString GetOutput() const { return m_output; }
+  bool GetEject() const { return m_eject; }
 protected:
   //! \brief Setup the audio encoder
   CEncoder* SetupEncoder(XFILE::CFile& reader);
@@ -60,15 +62,18 @@ protected:
   //! \brief Helper used if output is a remote url
   CStdString SetupTempFile();
 
-  //! \brief Rip a chunk of audio
-  //! \param reader The input reader
+  //! \brief Encode a chunk of audio from the read ahead buffer
+  //! \param reader The read ahead reader
   //! \param encoder The audio encoder
+  //! \param length The length of the input in bytes
+  //! \param encoded The number of bytes encoded so far, updated on return
   //! \param percent The percentage completed on return
-  //! \return 0 (CDDARIP_OK) if everything went okay, or
+  //! \return 0 (CDDARIP_OK) if everything went okay or no chunk was ready yet, or
   //!         a positive error code from the reader, or
   //!         -1 if the encoder failed
-  //! \sa CCDDARipper::GetData, CEncoder::Encode
-  int RipChunk(XFILE::CFile& reader, CEncoder* encoder, int& percent);
+  //! \sa CCDDARipReader::GetChunk, CEncoder::Encode
+  int RipChunk(CCDDARipReader& reader, CEncoder* encoder,
+               int64_t length, int64_t& encoded, int& percent);
 
   unsigned int m_rate; //< The sample rate of the input file 
   unsigned int m_channels; //< The number of channels in input file
@@ -76,7 +81,7 @@ protected:
   MUSIC_INFO::CMusicInfoTag m_tag; //< Music tag to attach to output file
   CStdString m_input; //< The input url
   CStdString m_output; //< The output url
-  bool m_eject; //< Should we eject tray when we are finished?
+  bool m_eject; //< Should we eject tray when all tracks are finished?
   int m_encoder; //< The audio encoder
 };
 
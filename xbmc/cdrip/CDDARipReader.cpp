@@ -0,0 +1,190 @@
+/*
+ *      Copyright (C) 2012-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "CDDARipReader.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+using namespace XFILE;
+
+CCDDARipDrive::CCDDARipDrive() : m_nextTicket(0)
+{
+}
+
+unsigned int CCDDARipDrive::TakeTicket()
+{
+  CSingleLock lock(m_section);
+  unsigned int ticket = m_nextTicket++;
+  m_tickets.push_back(ticket);
+  return ticket;
+}
+
+bool CCDDARipDrive::WaitTurn(unsigned int ticket, unsigned int milliseconds)
+{
+  XbmcThreads::EndTime timeout(milliseconds);
+  CSingleLock lock(m_section);
+  while (m_tickets.empty() || m_tickets.front() != ticket)
+  {
+    if (timeout.IsTimePast())
+      return false;
+    m_turnCond.wait(lock, timeout.MillisLeft());
+  }
+  return true;
+}
+
+void CCDDARipDrive::ReturnTicket(unsigned int ticket)
+{
+  CSingleLock lock(m_section);
+  std::deque<unsigned int>::iterator it = std::find(m_tickets.begin(), m_tickets.end(), ticket);
+  if (it == m_tickets.end())
+    return;
+  m_tickets.erase(it);
+  m_turnCond.notifyAll();
+}
+
+CCDDARipReader::CCDDARipReader(CFile& reader, CCDDARipDrive& drive, unsigned int ticket,
+                               unsigned int maxBuffered) :
+  CThread("CDDARipReader"),
+  m_reader(reader), m_drive(drive), m_ticket(ticket), m_maxBuffered(maxBuffered),
+  m_buffered(0), m_bytesRead(0), m_eof(false), m_error(false)
+{
+}
+
+CCDDARipReader::~CCDDARipReader()
+{
+  Stop();
+}
+
+void CCDDARipReader::Start()
+{
+  Create();
+}
+
+void CCDDARipReader::Stop()
+{
+  StopThread(false);
+  {
+    CSingleLock lock(m_section);
+    m_spaceCond.notifyAll();
+  }
+  StopThread(true);
+  m_drive.ReturnTicket(m_ticket);
+}
+
+void CCDDARipReader::Process()
+{
+  // the drive is ours until the track is read, reading the tracks one
+  // after the other is faster than seeking between them
+  int64_t length = m_reader.GetLength();
+  bool error = false;
+  while (!m_bStop)
+  {
+    std::vector<uint8_t> chunk;
+    {
+      CSingleLock lock(m_section);
+      while (m_buffered >= m_maxBuffered && !m_bStop)
+        m_spaceCond.wait(lock);
+      if (m_bStop)
+        break;
+      if (!m_free.empty())
+      {
+        chunk.swap(m_free.back());
+        m_free.pop_back();
+      }
+    }
+
+    chunk.resize(CHUNK_SIZE);
+    unsigned int read = m_reader.Read(&chunk[0], CHUNK_SIZE);
+    if (read == 0)
+    {
+      error = m_reader.GetPosition() != length;
+      break;
+    }
+    chunk.resize(read);
+
+    CSingleLock lock(m_section);
+    m_buffered += read;
+    m_bytesRead += read;
+    m_chunks.push_back(std::vector<uint8_t>());
+    m_chunks.back().swap(chunk);
+    m_dataCond.notifyAll();
+
+    if (m_reader.GetPosition() >= length)
+      break;
+  }
+  m_drive.ReturnTicket(m_ticket);
+
+  if (error)
+    CLog::Log(LOGERROR, "CCDDARipReader::Process - read failed at %" PRId64 " of %" PRId64,
+              m_reader.GetPosition(), length);
+
+  CSingleLock lock(m_section);
+  m_error = error;
+  m_eof = true;
+  m_dataCond.notifyAll();
+}
+
+bool CCDDARipReader::GetChunk(std::vector<uint8_t>& chunk, unsigned int milliseconds)
+{
+  XbmcThreads::EndTime timeout(milliseconds);
+  CSingleLock lock(m_section);
+  while (m_chunks.empty() && !m_eof)
+  {
+    if (timeout.IsTimePast())
+      return false;
+    m_dataCond.wait(lock, timeout.MillisLeft());
+  }
+  if (m_chunks.empty())
+    return false;
+
+  chunk.swap(m_chunks.front());
+  m_chunks.pop_front();
+  m_buffered -= chunk.size();
+  m_spaceCond.notifyAll();
+  return true;
+}
+
+void CCDDARipReader::ReleaseChunk(std::vector<uint8_t>& chunk)
+{
+  CSingleLock lock(m_section);
+  m_free.push_back(std::vector<uint8_t>());
+  m_free.back().swap(chunk);
+}
+
+bool CCDDARipReader::IsFinished() const
+{
+  CSingleLock lock(m_section);
+  return m_eof && m_chunks.empty();
+}
+
+bool CCDDARipReader::HasError() const
+{
+  CSingleLock lock(m_section);
+  return m_error;
+}
+
+int64_t CCDDARipReader::GetBytesRead() const
+{
+  CSingleLock lock(m_section);
+  return m_bytesRead;
+}
@@ -0,0 +1,132 @@
+#pragma once
+/*
+*      Copyright (C) 2012-2013 Team XBMC
+*      http://xbmc.org
+*
+*  This Program is free software; you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 2, or (at your option)
+*  any later version.
+*
+*  This Program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with XBMC; see the file COPYING.  If not, see
+*  <http://www.gnu.org/licenses/>.
+*
+*/
+
+#include <deque>
+#include <vector>
+#include <stdint.h>
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+namespace XFILE
+{
+class CFile;
+}
+
+//! \brief First come, first served access to a drive
+//!
+//! Rip jobs take a ticket before they open the drive and are let in in
+//! the order they took them, so a job can't be passed over by the ones
+//! queued after it the way it could when waiting on a plain lock. A
+//! ticket may be given back from another thread than the one that took
+//! it, and waiting for the turn is done in slices so the job can check
+//! for cancellation in between.
+class CCDDARipDrive
+{
+public:
+  CCDDARipDrive();
+
+  //! \brief Join the queue for the drive
+  //! \return The ticket to wait on
+  unsigned int TakeTicket();
+
+  //! \brief Wait for the turn of a ticket
+  //! \param ticket The ticket from TakeTicket
+  //! \param milliseconds The most time to wait
+  //! \return true once the ticket has the drive
+  bool WaitTurn(unsigned int ticket, unsigned int milliseconds);
+
+  //! \brief Give up a ticket, whether it has the drive or is still waiting
+  //! \param ticket The ticket from TakeTicket, returning it again is harmless
+  void ReturnTicket(unsigned int ticket);
+
+private:
+  CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_turnCond; //< signalled when a ticket was given up
+  std::deque<unsigned int> m_tickets; //< the waiting tickets, the first one has the drive
+  unsigned int m_nextTicket;
+};
+
+//! \brief Reads a track ahead of the encoder
+//!
+//! The reader thread copies the input into a queue of chunks so that
+//! encoding never stalls the drive. The drive is held for the time the
+//! track is read only, which lets the next rip job start reading while
+//! this one is still encoding.
+class CCDDARipReader : private CThread
+{
+public:
+  //! \brief Construct a read ahead reader
+  //! \param reader The opened input file, must outlive the reader
+  //! \param drive The drive the input is read from
+  //! \param ticket The ticket that has the drive, returned once the track is read
+  //! \param maxBuffered Number of bytes to read ahead before waiting for the encoder
+  CCDDARipReader(XFILE::CFile& reader, CCDDARipDrive& drive, unsigned int ticket,
+                 unsigned int maxBuffered);
+  virtual ~CCDDARipReader();
+
+  //! \brief Start reading in the background
+  void Start();
+
+  //! \brief Stop reading and wait for the thread to exit
+  void Stop();
+
+  //! \brief Get the next chunk of input, waiting for it if necessary
+  //! \param chunk Receives the data
+  //! \param milliseconds The most time to wait for a chunk
+  //! \return false if no chunk came in time or the input is exhausted
+  //! \sa IsFinished
+  bool GetChunk(std::vector<uint8_t>& chunk, unsigned int milliseconds);
+
+  //! \brief Return a chunk handed out by GetChunk for reuse
+  void ReleaseChunk(std::vector<uint8_t>& chunk);
+
+  //! \return true once all chunks were handed out and no more will come
+  bool IsFinished() const;
+
+  //! \return true if the input could not be read to the end
+  bool HasError() const;
+
+  //! \return number of bytes read from the input so far
+  int64_t GetBytesRead() const;
+
+  //! \brief Size of the chunks read from the input
+  static const unsigned int CHUNK_SIZE = 2352 * 16;
+
+protected:
+  virtual void Process();
+
+private:
+  XFILE::CFile& m_reader;
+  CCDDARipDrive& m_drive;
+  unsigned int m_ticket;
+  unsigned int m_maxBuffered;
+
+  mutable CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_dataCond; //< signalled when a chunk was queued or reading ended
+  XbmcThreads::ConditionVariable m_spaceCond; //< signalled when a chunk was consumed
+  std::deque< std::vector<uint8_t> > m_chunks;
+  std::vector< std::vector<uint8_t> > m_free;
+  unsigned int m_buffered;
+  int64_t m_bytesRead;
+  bool m_eof;
+  bool m_error;
+};
@@ -47,11 +47,18 @@
 #include "settings/MediaSourceSettings.h"
 #include "Application.h"
 #include "music/MusicDatabase.h"
+#include <algorithm>
+#include "threads/SingleLock.h"
+#include "utils/CPUInfo.h"
 
 using namespace std;
 using namespace XFILE;
 using namespace MUSIC_INFO;
 
+// the drive is read by one job at a time, more jobs only help to
+// keep encoding in parallel and cost read ahead memory each
+#define RIP_MAX_PARALLEL_JOBS 4
+
 CCDDARipper& CCDDARipper::GetInstance()
 {
   static CCDDARipper sRipper;
@@ -59,7 +66,8 @@ CCDDARipper& CCDDARipper::GetInstance()
 }
 
 CCDDARipper::CCDDARipper()
-  : CJobQueue(false, 1) //enforce fifo and non-parallel processing
+  : CJobQueue(false, std::max(1, std::min(g_cpuInfo.getCPUCount(), RIP_MAX_PARALLEL_JOBS))) //enforce fifo, encode tracks in parallel
+  , m_eject(false)
 {
 }
 
@@ -308,21 +316,40 @@ void CCDDARipper::OnJobComplete(unsigned int jobID, bool success, CJob* job)
 {
   if (success)
   {
-    if(CJobQueue::QueueEmpty())
+    CCDDARipJob* ripJob = (CCDDARipJob*)job;
+    CStdString dir = URIUtils::GetDirectory(ripJob->GetOutput());
+
+    // tracks finish out of order, only the last one to finish may
+    // eject the tray and start the scan
+    CSingleLock lock(m_completeSection);
+    if (ripJob->GetEject())
+      m_eject = true;
+    CJobQueue::OnJobComplete(jobID, success, job);
+    if (IsProcessing())
+      return;
+    bool eject = m_eject;
+    m_eject = false;
+    lock.Leave();
+
+    if (eject)
     {
-      CStdString dir = URIUtils::GetDirectory(((CCDDARipJob*)job)->GetOutput());
-      bool unimportant;
-      int source = CUtil::GetMatchingSource(dir, *CMediaSourceSettings::Get().CMediaSourceSettings::GetSources("music"), unimportant);
-
-      CMusicDatabase database;
-      database.Open();
-      if (source>=0 && database.InsideScannedPath(dir))
-        g_application.StartMusicScan(dir);
-      database.Close();
+      CLog::Log(LOGINFO, "Ejecting CD");
+      g_mediaManager.EjectTray();
     }
-    return CJobQueue::OnJobComplete(jobID, success, job);
+
+    bool unimportant;
+    int source = CUtil::GetMatchingSource(dir, *CMediaSourceSettings::Get().CMediaSourceSettings::GetSources("music"), unimportant);
+
+    CMusicDatabase database;
+    database.Open();
+    if (source>=0 && database.InsideScannedPath(dir))
+      g_application.StartMusicScan(dir);
+    database.Close();
+    return;
   }
 
+  CSingleLock lock(m_completeSection);
+  m_eject = false;
   CancelJobs();
 }
 
@@ -23,6 +23,7 @@
 
 #include "Encoder.h"
 #include "utils/JobManager.h"
+#include "threads/CriticalSection.h"
 
 class CFileItem;
 
@@ -40,6 +41,7 @@ namespace MUSIC_INFO
  for the track file name.
  Format used to encode ripped tracks is defined by the audiocds.encoder user setting, and 
  there are several choices: wav, ogg vorbis and mp3.
+ Tracks are read from the drive one after the other, but encoded in parallel.
  */
 class CCDDARipper : public CJobQueue
 {
@@ -95,6 +97,9 @@ private:
    \return track file name
    */
   CStdString GetTrackName(CFileItem *item);
+
+  CCriticalSection m_completeSection;
+  bool m_eject; ///< eject the tray once all jobs are done
 };
 
 #endif // _CCDDARIPPERMP3_H
@@ -0,0 +1,185 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cdrip/CDDARipReader.h"
+#include "cdrip/EncoderWav.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+
+/* Writes size bytes of cdda like pcm to a temp file */
+static XFILE::CFile *CreatePCMFile(unsigned int size)
+{
+  XFILE::CFile *file = XBMC_CREATETEMPFILE(".cdda");
+  std::vector<uint8_t> block(CCDDARipReader::CHUNK_SIZE);
+  for (unsigned int done = 0; done < size; done += block.size())
+  {
+    unsigned int bytes = std::min((unsigned int)block.size(), size - done);
+    for (unsigned int i = 0; i < bytes; i++)
+      block[i] = (uint8_t)((done + i) * 31 + 7);
+    file->Write(&block[0], bytes);
+  }
+  file->Close();
+  return file;
+}
+
+TEST(TestCDDARipReader, ReadAll)
+{
+  const unsigned int size = 1000000; // not a multiple of the chunk size
+  XFILE::CFile *pcm = CreatePCMFile(size);
+  CStdString path = XBMC_TEMPFILEPATH(pcm);
+
+  XFILE::CFile input;
+  ASSERT_TRUE(input.Open(path));
+  CCDDARipDrive drive;
+  // only a few chunks may be read ahead
+  CCDDARipReader reader(input, drive, drive.TakeTicket(), CCDDARipReader::CHUNK_SIZE * 3);
+  reader.Start();
+
+  unsigned int total = 0;
+  bool match = true;
+  std::vector<uint8_t> chunk;
+  while (!reader.IsFinished())
+  {
+    if (!reader.GetChunk(chunk, 100))
+      continue;
+    for (unsigned int i = 0; i < chunk.size(); i++)
+      match &= chunk[i] == (uint8_t)((total + i) * 31 + 7);
+    total += chunk.size();
+    reader.ReleaseChunk(chunk);
+  }
+  EXPECT_TRUE(match);
+  EXPECT_EQ(size, total);
+  EXPECT_EQ(size, reader.GetBytesRead());
+  EXPECT_FALSE(reader.HasError());
+
+  reader.Stop();
+  input.Close();
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(pcm));
+}
+
+TEST(TestCDDARipReader, StopWhileFull)
+{
+  XFILE::CFile *pcm = CreatePCMFile(CCDDARipReader::CHUNK_SIZE * 8);
+
+  XFILE::CFile input;
+  ASSERT_TRUE(input.Open(XBMC_TEMPFILEPATH(pcm)));
+  CCDDARipDrive drive;
+  {
+    CCDDARipReader reader(input, drive, drive.TakeTicket(), CCDDARipReader::CHUNK_SIZE);
+    reader.Start();
+
+    std::vector<uint8_t> chunk;
+    EXPECT_TRUE(reader.GetChunk(chunk, 10000));
+    // the reader is now waiting for room, or done. Stopping must not hang
+    reader.Stop();
+  }
+  // the drive is free again
+  EXPECT_TRUE(drive.WaitTurn(drive.TakeTicket(), 0));
+  input.Close();
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(pcm));
+}
+
+TEST(TestCDDARipReader, DriveOrder)
+{
+  CCDDARipDrive drive;
+  unsigned int first = drive.TakeTicket();
+  unsigned int second = drive.TakeTicket();
+  unsigned int third = drive.TakeTicket();
+  EXPECT_TRUE(drive.WaitTurn(first, 0));
+  EXPECT_FALSE(drive.WaitTurn(second, 10));
+  EXPECT_FALSE(drive.WaitTurn(third, 0));
+
+  // a job cancelled while waiting gives up its place
+  drive.ReturnTicket(second);
+  EXPECT_FALSE(drive.WaitTurn(third, 0));
+  drive.ReturnTicket(first);
+  EXPECT_TRUE(drive.WaitTurn(third, 0));
+
+  // and the ones taken later queue behind
+  unsigned int fourth = drive.TakeTicket();
+  EXPECT_FALSE(drive.WaitTurn(fourth, 0));
+  drive.ReturnTicket(third);
+  drive.ReturnTicket(third);
+  EXPECT_TRUE(drive.WaitTurn(fourth, 0));
+}
+
+/* run with --gtest_also_run_disabled_tests */
+TEST(TestCDDARipReader, DISABLED_Benchmark)
+{
+  // about four minutes of cd audio
+  const unsigned int size = 44100 * 4 * 240;
+  XFILE::CFile *pcm = CreatePCMFile(size);
+  CStdString path = XBMC_TEMPFILEPATH(pcm);
+  CStdString output = path + ".wav";
+
+  // the old way, read and encode on the same thread
+  {
+    XFILE::CFile input;
+    ASSERT_TRUE(input.Open(path));
+    CEncoderWav encoder;
+    ASSERT_TRUE(encoder.Init(output.c_str(), 2, 44100, 16));
+
+    int64_t start = CurrentHostCounter();
+    uint8_t stream[1024];
+    unsigned int read;
+    while ((read = input.Read(stream, sizeof(stream))) > 0)
+      encoder.Encode(read, stream);
+    encoder.Close();
+    double seconds = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+    printf("serial     %8.1f MB/s\n", size / seconds / (1024 * 1024));
+    input.Close();
+  }
+
+  // read ahead
+  {
+    XFILE::CFile input;
+    ASSERT_TRUE(input.Open(path));
+    CEncoderWav encoder;
+    ASSERT_TRUE(encoder.Init(output.c_str(), 2, 44100, 16));
+
+    int64_t start = CurrentHostCounter();
+    CCDDARipDrive drive;
+    CCDDARipReader reader(input, drive, drive.TakeTicket(), 4 * 1024 * 1024);
+    reader.Start();
+    std::vector<uint8_t> chunk;
+    while (!reader.IsFinished())
+    {
+      if (!reader.GetChunk(chunk, 100))
+        continue;
+      encoder.Encode(chunk.size(), &chunk[0]);
+      reader.ReleaseChunk(chunk);
+    }
+    encoder.Close();
+    double seconds = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+    printf("read ahead %8.1f MB/s\n", size / seconds / (1024 * 1024));
+    reader.Stop();
+    input.Close();
+  }
+
+  XFILE::CFile::Delete(output);
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(pcm));
+}
@@ -22,12 +22,14 @@
 
 using namespace ActiveAE;
 #include "ActiveAESound.h"
+#include "ActiveAESoundBank.h"
 #include "ActiveAEStream.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/Encoders/AEEncoderFFmpeg.h"
 
 #include "settings/Settings.h"
 #include "settings/AdvancedSettings.h"
+#include "utils/JobManager.h"
 #include "windowing/WindowingFactory.h"
 
 #define MAX_CACHE_LEVEL 0.5   // total cache time of stream in seconds
@@ -159,6 +161,11 @@ CActiveAE::CActiveAE() :
   m_audioCallback = NULL;
   m_vizInitialized = false;
   m_sinkHasVolume = false;
+  m_soundBank = NULL;
+  m_soundBankDirty = false;
+  m_soundBankJob = 0;
+  // playing a sound must not allocate on the engine thread
+  m_sounds_playing.reserve(32);
 }
 
 CActiveAE::~CActiveAE()
@@ -175,9 +182,32 @@ void CActiveAE::Dispose()
   m_bStop = true;
   m_outMsgEvent.Set();
   StopThread();
+
+  // a running sound bank job reads the sounds, so wait for it
+  // and free the bank it may have posted
+  if (m_soundBankJob)
+  {
+    m_soundBankJobDone.Wait();
+    m_soundBankJob = 0;
+  }
+  Message *msg;
+  while (m_dataPort.ReceiveOutMessage(&msg))
+  {
+    if (msg->signal == CActiveAEDataProtocol::SOUNDBANK)
+      delete *(CActiveAESoundBank**)msg->data;
+    msg->Release();
+  }
+
   m_controlPort.Purge();
   m_dataPort.Purge();
   m_sink.Dispose();
+
+  delete m_soundBank;
+  m_soundBank = NULL;
+  std::vector<CActiveAESound*>::iterator it;
+  for (it = m_discardedSounds.begin(); it != m_discardedSounds.end(); ++it)
+    delete *it;
+  m_discardedSounds.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -252,7 +282,8 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
           if (sound)
           {
             m_sounds.push_back(sound);
-            ResampleSounds();
+            m_soundBankDirty = true;
+            UpdateSoundBank();
           }
           return;
         case CActiveAEDataProtocol::FREESTREAM:
@@ -271,6 +302,9 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
           msg->Reply(CActiveAEDataProtocol::ACC);
           stream->m_streamPort->SendInMessage(CActiveAEDataProtocol::STREAMDRAINED);
           return;
+        case CActiveAEDataProtocol::SOUNDBANK:
+          SetSoundBank(*(CActiveAESoundBank**)msg->data);
+          return;
         default:
           break;
         }
@@ -721,7 +755,7 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
         switch (signal)
         {
         case CActiveAEControlProtocol::TIMEOUT:
-          ResampleSounds();
+          UpdateSoundBank();
           ClearDiscardedBuffers();
           if (m_extDrain)
           {
@@ -1182,16 +1216,11 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
   // reset gui sounds
   if (!CompareFormat(oldInternalFormat, m_internalFormat))
   {
-    if (m_settings.guisoundmode == AE_SOUND_ALWAYS ||
-       (m_settings.guisoundmode == AE_SOUND_IDLE && m_streams.empty()))
-    {
-      std::vector<CActiveAESound*>::iterator it;
-      for (it = m_sounds.begin(); it != m_sounds.end(); ++it)
-      {
-        (*it)->SetConverted(false);
-      }
-    }
+    delete m_soundBank;
+    m_soundBank = NULL;
+    m_soundBankDirty = true;
     m_sounds_playing.clear();
+    UpdateSoundBank();
   }
 
   ClearDiscardedBuffers();
@@ -1337,7 +1366,7 @@ void CActiveAE::ClearDiscardedBuffers()
 
 void CActiveAE::SStopSound(CActiveAESound *sound)
 {
-  std::list<SoundState>::iterator it;
+  std::vector<SoundState>::iterator it;
   for (it=m_sounds_playing.begin(); it!=m_sounds_playing.end(); ++it)
   {
     if (it->sound == sound)
@@ -1358,9 +1387,18 @@ void CActiveAE::DiscardSound(CActiveAESound *sound)
     if ((*it) == sound)
     {
       m_sounds.erase(it);
-      return;
+      break;
     }
   }
+
+  if (m_soundBank)
+    m_soundBank->Prune(m_sounds);
+
+  // a running sound bank job may still read the sound
+  if (m_soundBankJob)
+    m_discardedSounds.push_back(sound);
+  else
+    delete sound;
 }
 
 void CActiveAE::ChangeResamplers()
@@ -2029,23 +2067,35 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
   float *sample_buffer;
   int max_samples = dstSample.nb_samples;
 
-  std::list<SoundState>::iterator it;
+  std::vector<SoundState>::iterator it;
   for (it = m_sounds_playing.begin(); it != m_sounds_playing.end(); )
   {
-    if (!it->sound->IsConverted())
-      ResampleSound(it->sound);
-    int available_samples = it->sound->GetSound(false)->nb_samples - it->samples_played;
+    const CActiveAESoundBank::Entry *entry = NULL;
+    if (m_soundBank && m_soundBank->GetPacket())
+      entry = m_soundBank->Find(it->sound);
+    if (!entry)
+    {
+      // converting the sound here would allocate on the engine thread, it starts
+      // once the job building the next bank is done. without one it can't play.
+      if (m_soundBankJob)
+        ++it;
+      else
+        it = m_sounds_playing.erase(it);
+      continue;
+    }
+    CSoundPacket *bank = m_soundBank->GetPacket();
+    int available_samples = entry->samples - it->samples_played;
     int mix_samples = std::min(max_samples, available_samples);
-    int start = it->samples_played *
-                av_get_bytes_per_sample(it->sound->GetSound(false)->config.fmt) *
-                it->sound->GetSound(false)->config.channels /
-                it->sound->GetSound(false)->planes;
+    int start = (entry->offset + it->samples_played) *
+                bank->bytes_per_sample *
+                bank->config.channels /
+                bank->planes;
 
     for(int j=0; j<dstSample.planes; j++)
     {
       volume = it->sound->GetVolume();
       out = (float*)dstSample.data[j];
-      sample_buffer = (float*)(it->sound->GetSound(false)->data[j]+start);
+      sample_buffer = (float*)(bank->data[j]+start);
       int nb_floats = mix_samples * dstSample.config.channels / dstSample.planes;
 #ifdef __SSE__
       CAEUtil::SSEMulAddArray(out, sample_buffer, volume, nb_floats);
@@ -2058,7 +2108,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
     it->samples_played += mix_samples;
 
     // no more frames, so remove it from the list
-    if (it->samples_played >= it->sound->GetSound(false)->nb_samples)
+    if (it->samples_played >= entry->samples)
     {
       it = m_sounds_playing.erase(it);
       continue;
@@ -2201,7 +2251,8 @@ bool CActiveAE::SupportsSilenceTimeout()
 
 bool CActiveAE::SupportsQualityLevel(enum AEQuality level)
 {
-  if (level == AE_QUALITY_LOW || level == AE_QUALITY_MID || level == AE_QUALITY_HIGH)
+  if (level == AE_QUALITY_LOW || level == AE_QUALITY_MID || level == AE_QUALITY_HIGH ||
+      level == AE_QUALITY_REALLYHIGH)
     return true;
 
   return false;
@@ -2549,84 +2600,69 @@ void CActiveAE::StopSound(CActiveAESound *sound)
 }
 
 /**
- * resample sounds to destination format for mixing
+ * convert sounds to destination format for mixing
  * destination format is either format of stream or
- * default sink format when no stream is playing
+ * default sink format when no stream is playing.
+ * conversion runs as a job, the result is posted back
+ * to the engine as a new sound bank
  */
-void CActiveAE::ResampleSounds()
+void CActiveAE::UpdateSoundBank()
 {
   if (m_settings.guisoundmode == AE_SOUND_OFF ||
      (m_settings.guisoundmode == AE_SOUND_IDLE && !m_streams.empty()))
     return;
 
-  std::vector<CActiveAESound*>::iterator it;
-  for (it = m_sounds.begin(); it != m_sounds.end(); ++it)
-  {
-    if (!(*it)->IsConverted())
-    {
-      ResampleSound(*it);
-      // only do one sound, then yield to main loop
-      break;
-    }
-  }
+  if (!m_soundBankDirty || m_soundBankJob)
+    return;
+
+  if (m_mode == MODE_RAW || m_internalFormat.m_dataFormat == AE_FMT_INVALID)
+    return;
+
+  m_soundBankDirty = false;
+  m_soundBankJobDone.Reset();
+  m_soundBankJob = CJobManager::GetInstance().AddJob(new CActiveAESoundBankJob(m_sounds, m_internalFormat, m_settings.resampleQuality), this);
 }
 
-bool CActiveAE::ResampleSound(CActiveAESound *sound)
+void CActiveAE::SetSoundBank(CActiveAESoundBank *bank)
 {
-  SampleConfig orig_config, dst_config;
-  uint8_t **dst_buffer;
-  int dst_samples;
+  m_soundBankJob = 0;
 
-  if (m_mode == MODE_RAW || m_internalFormat.m_dataFormat == AE_FMT_INVALID)
-    return false;
+  // sounds freed while the job was running can go now
+  std::vector<CActiveAESound*>::iterator it;
+  for (it = m_discardedSounds.begin(); it != m_discardedSounds.end(); ++it)
+    delete *it;
+  m_discardedSounds.clear();
 
-  if (!sound->GetSound(true))
-    return false;
+  if (!bank)
+    return;
 
-  orig_config = sound->GetSound(true)->config;
-
-  dst_config.channel_layout = CActiveAEResample::GetAVChannelLayout(m_internalFormat.m_channelLayout);
-  dst_config.channels = m_internalFormat.m_channelLayout.Count();
-  dst_config.sample_rate = m_internalFormat.m_sampleRate;
-  dst_config.fmt = CActiveAEResample::GetAVSampleFormat(m_internalFormat.m_dataFormat);
-  dst_config.bits_per_sample = CAEUtil::DataFormatToUsedBits(m_internalFormat.m_dataFormat);
-
-  CActiveAEResample *resampler = new CActiveAEResample();
-  resampler->Init(dst_config.channel_layout,
-                  dst_config.channels,
-                  dst_config.sample_rate,
-                  dst_config.fmt,
-                  dst_config.bits_per_sample,
-                  orig_config.channel_layout,
-                  orig_config.channels,
-                  orig_config.sample_rate,
-                  orig_config.fmt,
-                  orig_config.bits_per_sample,
-                  false,
-                  true,
-                  NULL,
-                  m_settings.resampleQuality);
-
-  dst_samples = resampler->CalcDstSampleCount(sound->GetSound(true)->nb_samples,
-                                              m_internalFormat.m_sampleRate,
-                                              orig_config.sample_rate);
-
-  dst_buffer = sound->InitSound(false, dst_config, dst_samples);
-  if (!dst_buffer)
-  {
-    delete resampler;
-    return false;
+  if (!CompareFormat(bank->GetFormat(), m_internalFormat))
+  {
+    // format changed while converting
+    delete bank;
+    m_soundBankDirty = true;
+  }
+  else
+  {
+    bank->Prune(m_sounds);
+    delete m_soundBank;
+    m_soundBank = bank;
   }
-  int samples = resampler->Resample(dst_buffer, dst_samples,
-                                    sound->GetSound(true)->data,
-                                    sound->GetSound(true)->nb_samples,
-                                    1.0);
 
-  sound->GetSound(false)->nb_samples = samples;
+  UpdateSoundBank();
+}
 
-  delete resampler;
-  sound->SetConverted(true);
-  return true;
+void CActiveAE::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  // called from a job thread, hand the bank over to the engine
+  CActiveAESoundBank *bank = ((CActiveAESoundBankJob*)job)->DetachBank();
+  if (!success)
+  {
+    delete bank;
+    bank = NULL;
+  }
+  m_dataPort.SendOutMessage(CActiveAEDataProtocol::SOUNDBANK, &bank, sizeof(CActiveAESoundBank*));
+  m_soundBankJobDone.Set();
 }
 
 //-----------------------------------------------------------------------------
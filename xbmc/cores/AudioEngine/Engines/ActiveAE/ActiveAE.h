@@ -28,6 +28,7 @@
 #include "cores/AudioEngine/Interfaces/AESound.h"
 #include "cores/AudioEngine/AEFactory.h"
 #include "guilib/DispResource.h"
+#include "utils/Job.h"
 #include <queue>
 
 // ffmpeg
@@ -44,6 +45,7 @@ namespace ActiveAE
 {
 
 class CActiveAESound;
+class CActiveAESoundBank;
 class CActiveAEStream;
 
 struct AudioSettings
@@ -116,6 +118,7 @@ public:
     FREESTREAM,
     STREAMSAMPLE,
     DRAINSTREAM,
+    SOUNDBANK,
   };
   enum InSignal
   {
@@ -184,9 +187,9 @@ protected:
 };
 
 #if defined(HAS_GLX) || defined(TARGET_DARWIN)
-class CActiveAE : public IAE, public IDispResource, private CThread
+class CActiveAE : public IAE, public IDispResource, public IJobCallback, private CThread
 #else
-class CActiveAE : public IAE, private CThread
+class CActiveAE : public IAE, public IJobCallback, private CThread
 #endif
 {
 protected:
@@ -238,10 +241,12 @@ public:
   virtual void OnResetDevice();
   virtual void OnAppFocusChange(bool focus);
 
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
 protected:
   void PlaySound(CActiveAESound *sound);
-  uint8_t **AllocSoundSample(SampleConfig &config, int &samples, int &bytes_per_sample, int &planes, int &linesize);
-  void FreeSoundSample(uint8_t **data);
+  static uint8_t **AllocSoundSample(SampleConfig &config, int &samples, int &bytes_per_sample, int &planes, int &linesize);
+  static void FreeSoundSample(uint8_t **data);
   float GetDelay(CActiveAEStream *stream) { return m_stats.GetDelay(stream); }
   float GetCacheTime(CActiveAEStream *stream) { return m_stats.GetCacheTime(stream); }
   float GetCacheTotal(CActiveAEStream *stream) { return m_stats.GetCacheTotal(stream); }
@@ -280,8 +285,8 @@ protected:
   bool RunStages();
   bool HasWork();
 
-  void ResampleSounds();
-  bool ResampleSound(CActiveAESound *sound);
+  void UpdateSoundBank();
+  void SetSoundBank(CActiveAESoundBank *bank);
   void MixSounds(CSoundPacket &dstSample);
   void Deamplify(CSoundPacket &dstSample);
 
@@ -336,8 +341,13 @@ protected:
     CActiveAESound *sound;
     int samples_played;
   };
-  std::list<SoundState> m_sounds_playing;
+  std::vector<SoundState> m_sounds_playing;
   std::vector<CActiveAESound*> m_sounds;
+  std::vector<CActiveAESound*> m_discardedSounds;
+  CActiveAESoundBank *m_soundBank;
+  bool m_soundBankDirty;
+  unsigned int m_soundBankJob;
+  CEvent m_soundBankJobDone;
 
   float m_volume; // volume on a 0..1 scale corresponding to a proportion along the dB scale
   float m_volumeScaled; // multiplier to scale samples in order to achieve the volume specified in m_volume
@@ -19,18 +19,14 @@
  */
 
 #include "ActiveAEBuffer.h"
-#include "cores/AudioEngine/AEFactory.h"
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 
 using namespace ActiveAE;
 
-/* typecast AE to CActiveAE */
-#define AE (*((CActiveAE*)CAEFactory::GetEngine()))
-
 CSoundPacket::CSoundPacket(SampleConfig conf, int samples) : config(conf)
 {
-  data = AE.AllocSoundSample(config, samples, bytes_per_sample, planes, linesize);
+  data = CActiveAE::AllocSoundSample(config, samples, bytes_per_sample, planes, linesize);
   max_nb_samples = samples;
   nb_samples = 0;
 }
@@ -38,7 +34,7 @@ CSoundPacket::CSoundPacket(SampleConfig conf, int samples) : config(conf)
 CSoundPacket::~CSoundPacket()
 {
   if (data)
-    AE.FreeSoundSample(data);
+    CActiveAE::FreeSoundSample(data);
 }
 
 CSampleBuffer::CSampleBuffer() : pkt(NULL), pool(NULL)
@@ -280,7 +276,8 @@ bool CActiveAEBufferPoolResample::ResampleBuffers(unsigned int timestamp)
                                           m_procSample->pkt->max_nb_samples - m_procSample->pkt->nb_samples,
                                           in ? in->pkt->data : NULL,
                                           in ? in->pkt->nb_samples : 0,
-                                          m_resampleRatio);
+                                          m_resampleRatio,
+                                          m_drain);
       m_procSample->pkt->nb_samples += out_samples;
       busy = true;
       m_empty = (out_samples == 0);
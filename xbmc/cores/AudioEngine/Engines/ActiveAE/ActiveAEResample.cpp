@@ -33,12 +33,17 @@ CActiveAEResample::CActiveAEResample()
 {
   m_pContext = NULL;
   m_loaded = true;
+  m_pPolyphase = NULL;
+  memset(m_polyPlanes, 0, sizeof(m_polyPlanes));
+  m_polyPlanesSize = 0;
 }
 
 CActiveAEResample::~CActiveAEResample()
 {
   if (m_pContext)
     swr_free(&m_pContext);
+  delete m_pPolyphase;
+  av_freep(&m_polyPlanes[0]);
 }
 
 bool CActiveAEResample::Init(uint64_t dst_chan_layout, int dst_channels, int dst_rate, AVSampleFormat dst_fmt, int dst_bits, uint64_t src_chan_layout, int src_channels, int src_rate, AVSampleFormat src_fmt, int src_bits, bool upmix, bool normalize, CAEChannelInfo *remapLayout, AEQuality quality)
@@ -62,7 +67,12 @@ bool CActiveAEResample::Init(uint64_t dst_chan_layout, int dst_channels, int dst
   if (m_src_chan_layout == 0)
     m_src_chan_layout = av_get_default_channel_layout(m_src_channels);
 
-  m_pContext = swr_alloc_set_opts(NULL, m_dst_chan_layout, m_dst_fmt, m_dst_rate,
+  // really high quality uses our own polyphase resampler for rate conversion
+  // and sync to display. swresample then only converts format and layout at
+  // source rate into float planar, which is what the polyphase stage expects.
+  bool polyphase = (quality == AE_QUALITY_REALLYHIGH && m_dst_fmt == AV_SAMPLE_FMT_FLTP);
+
+  m_pContext = swr_alloc_set_opts(NULL, m_dst_chan_layout, m_dst_fmt, polyphase ? m_src_rate : m_dst_rate,
                                                         m_src_chan_layout, m_src_fmt, m_src_rate,
                                                         0, NULL);
 
@@ -72,7 +82,7 @@ bool CActiveAEResample::Init(uint64_t dst_chan_layout, int dst_channels, int dst
     return false;
   }
 
-  if(quality == AE_QUALITY_HIGH)
+  if(quality == AE_QUALITY_HIGH || quality == AE_QUALITY_REALLYHIGH)
   {
     av_opt_set_double(m_pContext, "cutoff", 1.0, 0);
     av_opt_set_int(m_pContext,"filter_size", 256, 0);
@@ -173,11 +183,24 @@ bool CActiveAEResample::Init(uint64_t dst_chan_layout, int dst_channels, int dst
     CLog::Log(LOGERROR, "CActiveAEResample::Init - init resampler failed");
     return false;
   }
+
+  if (polyphase)
+  {
+    m_pPolyphase = new CAEResamplePolyphase();
+    if (!m_pPolyphase->Init(m_dst_channels, m_src_rate, m_dst_rate, quality))
+    {
+      CLog::Log(LOGERROR, "CActiveAEResample::Init - init polyphase resampler failed");
+      return false;
+    }
+  }
   return true;
 }
 
-int CActiveAEResample::Resample(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio)
+int CActiveAEResample::Resample(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio, bool drain)
 {
+  if (m_pPolyphase)
+    return ResamplePolyphase(dst_buffer, dst_samples, src_buffer, src_samples, ratio, drain);
+
   if (ratio != 1.0)
   {
     if (swr_set_compensation(m_pContext,
@@ -198,14 +221,61 @@ int CActiveAEResample::Resample(uint8_t **dst_buffer, int dst_samples, uint8_t *
   return ret;
 }
 
+int CActiveAEResample::ResamplePolyphase(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio, bool drain)
+{
+  m_pPolyphase->SetRatio(ratio);
+
+  int converted = 0;
+  if (src_buffer && src_samples > 0)
+  {
+    if (src_samples > m_polyPlanesSize)
+    {
+      av_freep(&m_polyPlanes[0]);
+      if (av_samples_alloc(m_polyPlanes, NULL, m_dst_channels, src_samples, AV_SAMPLE_FMT_FLTP, 0) < 0)
+      {
+        m_polyPlanesSize = 0;
+        CLog::Log(LOGERROR, "CActiveAEResample::ResamplePolyphase - alloc failed");
+        return 0;
+      }
+      m_polyPlanesSize = src_samples;
+    }
+
+    converted = swr_convert(m_pContext, m_polyPlanes, m_polyPlanesSize, (const uint8_t**)src_buffer, src_samples);
+    if (converted < 0)
+    {
+      CLog::Log(LOGERROR, "CActiveAEResample::ResamplePolyphase - convert failed");
+      return 0;
+    }
+  }
+
+  int samples = m_pPolyphase->Resample((float**)dst_buffer, dst_samples, (float**)m_polyPlanes, converted);
+
+  // once the rest of the stream is out push the tail of the filter out,
+  // resampling is called without input mid-stream too
+  if (drain && samples == 0 && converted == 0 && dst_samples > 0)
+  {
+    m_pPolyphase->Flush();
+    samples = m_pPolyphase->Resample((float**)dst_buffer, dst_samples, NULL, 0);
+  }
+  return samples;
+}
+
 int64_t CActiveAEResample::GetDelay(int64_t base)
 {
-  return swr_get_delay(m_pContext, base);
+  int64_t delay = swr_get_delay(m_pContext, base);
+  if (m_pPolyphase)
+  {
+    // the lookahead of the filter is only output when draining
+    double buffered = m_pPolyphase->GetDelay() - m_pPolyphase->GetTaps() / 2;
+    if (buffered > 0)
+      delay += (int64_t)(buffered * base / m_src_rate);
+  }
+  return delay;
 }
 
 int CActiveAEResample::GetBufferedSamples()
 {
-  return av_rescale_rnd(swr_get_delay(m_pContext, m_src_rate),
+  return av_rescale_rnd(GetDelay(m_src_rate),
                                     m_dst_rate, m_src_rate, AV_ROUND_UP);
 }
 
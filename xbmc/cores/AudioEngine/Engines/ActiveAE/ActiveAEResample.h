@@ -23,6 +23,7 @@
 #include "cores/AudioEngine/Utils/AEAudioFormat.h"
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
 #include "cores/AudioEngine/Interfaces/AE.h"
+#include "cores/AudioEngine/Utils/AEResamplePolyphase.h"
 
 extern "C" {
 #include "libavutil/avutil.h"
@@ -38,10 +39,10 @@ public:
   CActiveAEResample();
   virtual ~CActiveAEResample();
   bool Init(uint64_t dst_chan_layout, int dst_channels, int dst_rate, AVSampleFormat dst_fmt, int dst_bits, uint64_t src_chan_layout, int src_channels, int src_rate, AVSampleFormat src_fmt, int src_bits, bool upmix, bool normalize, CAEChannelInfo *remapLayout, AEQuality quality);
-  int Resample(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio);
+  int Resample(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio, bool drain = false);
   int64_t GetDelay(int64_t base);
   int GetBufferedSamples();
-  int CalcDstSampleCount(int src_samples, int dst_rate, int src_rate);
+  static int CalcDstSampleCount(int src_samples, int dst_rate, int src_rate);
   int GetSrcBufferSize(int samples);
   int GetDstBufferSize(int samples);
   static uint64_t GetAVChannelLayout(CAEChannelInfo &info);
@@ -52,6 +53,7 @@ public:
   int GetAVChannelIndex(enum AEChannel aechannel, uint64_t layout);
 
 protected:
+  int ResamplePolyphase(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio, bool drain);
   bool m_loaded;
   uint64_t m_src_chan_layout, m_dst_chan_layout;
   int m_src_rate, m_dst_rate;
@@ -60,6 +62,9 @@ protected:
   int m_src_bits, m_dst_bits;
   SwrContext *m_pContext;
   double m_rematrix[AE_CH_MAX][AE_CH_MAX];
+  CAEResamplePolyphase *m_pPolyphase;
+  uint8_t *m_polyPlanes[AE_CH_MAX];
+  int m_polyPlanesSize;
 };
 
 }
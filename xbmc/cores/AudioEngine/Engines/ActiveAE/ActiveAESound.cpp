@@ -81,7 +81,6 @@ uint8_t** CActiveAESound::InitSound(bool orig, SampleConfig config, int nb_sampl
   *info = new CSoundPacket(config, nb_samples);
 
   (*info)->nb_samples = 0;
-  m_isConverted = false;
   return (*info)->data;
 }
 
@@ -46,9 +46,6 @@ public:
   bool StoreSound(bool orig, uint8_t **buffer, int samples, int linesize);
   CSoundPacket *GetSound(bool orig);
 
-  bool IsConverted() { return m_isConverted; }
-  void SetConverted(bool state) { m_isConverted = state; }
-
   bool Prepare();
   void Finish();
   int GetChunkSize();
@@ -67,7 +64,5 @@ protected:
 
   CSoundPacket *m_orig_sound;
   CSoundPacket *m_dst_sound;
-
-  bool m_isConverted;
 };
 }
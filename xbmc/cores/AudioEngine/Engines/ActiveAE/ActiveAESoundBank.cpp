@@ -0,0 +1,172 @@
+/*
+ *      Copyright (C) 2010-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ActiveAESoundBank.h"
+#include "ActiveAESound.h"
+#include "ActiveAEResample.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "utils/log.h"
+#include <algorithm>
+
+using namespace ActiveAE;
+
+CActiveAESoundBank::CActiveAESoundBank(const AEAudioFormat &format) :
+  m_format(format),
+  m_packet(NULL)
+{
+}
+
+CActiveAESoundBank::~CActiveAESoundBank()
+{
+  delete m_packet;
+}
+
+bool CActiveAESoundBank::Build(const std::vector<CActiveAESound*> &sounds, AEQuality quality)
+{
+  SampleConfig dst_config;
+  dst_config.channel_layout = CActiveAEResample::GetAVChannelLayout(m_format.m_channelLayout);
+  dst_config.channels = m_format.m_channelLayout.Count();
+  dst_config.sample_rate = m_format.m_sampleRate;
+  dst_config.fmt = CActiveAEResample::GetAVSampleFormat(m_format.m_dataFormat);
+  dst_config.bits_per_sample = CAEUtil::DataFormatToUsedBits(m_format.m_dataFormat);
+
+  // size the packet for all sounds so it is allocated only once
+  int total = 0;
+  std::vector<CActiveAESound*>::const_iterator it;
+  for (it = sounds.begin(); it != sounds.end(); ++it)
+  {
+    CSoundPacket *orig = (*it)->GetSound(true);
+    if (!orig)
+      continue;
+    total += CActiveAEResample::CalcDstSampleCount(orig->nb_samples,
+                                                   dst_config.sample_rate,
+                                                   orig->config.sample_rate);
+  }
+
+  if (total == 0)
+    return true;
+
+  m_packet = new CSoundPacket(dst_config, total);
+
+  int offset = 0;
+  for (it = sounds.begin(); it != sounds.end(); ++it)
+  {
+    CSoundPacket *orig = (*it)->GetSound(true);
+    if (!orig)
+      continue;
+
+    int dst_samples = CActiveAEResample::CalcDstSampleCount(orig->nb_samples,
+                                                            dst_config.sample_rate,
+                                                            orig->config.sample_rate);
+
+    CActiveAEResample resampler;
+    if (!resampler.Init(dst_config.channel_layout,
+                        dst_config.channels,
+                        dst_config.sample_rate,
+                        dst_config.fmt,
+                        dst_config.bits_per_sample,
+                        orig->config.channel_layout,
+                        orig->config.channels,
+                        orig->config.sample_rate,
+                        orig->config.fmt,
+                        orig->config.bits_per_sample,
+                        false,
+                        true,
+                        NULL,
+                        quality))
+    {
+      CLog::Log(LOGERROR, "CActiveAESoundBank::Build - failed to init resampler");
+      continue;
+    }
+
+    // the resampler holds back the tail of the sound until it is drained
+    int bytes_per_frame = m_packet->bytes_per_sample * dst_config.channels / m_packet->planes;
+    uint8_t *planes[AE_CH_MAX];
+    for (int i = 0; i < m_packet->planes; i++)
+      planes[i] = m_packet->data[i] + offset * bytes_per_frame;
+
+    int samples = resampler.Resample(planes, dst_samples, orig->data, orig->nb_samples, 1.0);
+    while (samples < dst_samples)
+    {
+      for (int i = 0; i < m_packet->planes; i++)
+        planes[i] = m_packet->data[i] + (offset + samples) * bytes_per_frame;
+      int drained = resampler.Resample(planes, dst_samples - samples, NULL, 0, 1.0, true);
+      if (drained <= 0)
+        break;
+      samples += drained;
+    }
+
+    Entry entry;
+    entry.offset = offset;
+    entry.samples = samples;
+    m_entries[*it] = entry;
+
+    offset += dst_samples;
+  }
+  m_packet->nb_samples = offset;
+
+  return true;
+}
+
+void CActiveAESoundBank::Prune(const std::vector<CActiveAESound*> &sounds)
+{
+  std::map<CActiveAESound*, Entry>::iterator it;
+  for (it = m_entries.begin(); it != m_entries.end(); )
+  {
+    if (std::find(sounds.begin(), sounds.end(), it->first) == sounds.end())
+      m_entries.erase(it++);
+    else
+      ++it;
+  }
+}
+
+const CActiveAESoundBank::Entry *CActiveAESoundBank::Find(CActiveAESound *sound) const
+{
+  std::map<CActiveAESound*, Entry>::const_iterator it = m_entries.find(sound);
+  if (it == m_entries.end())
+    return NULL;
+  return &it->second;
+}
+
+//-----------------------------------------------------------------------------
+
+CActiveAESoundBankJob::CActiveAESoundBankJob(const std::vector<CActiveAESound*> &sounds, const AEAudioFormat &format, AEQuality quality) :
+  m_sounds(sounds),
+  m_quality(quality)
+{
+  m_bank = new CActiveAESoundBank(format);
+}
+
+CActiveAESoundBankJob::~CActiveAESoundBankJob()
+{
+  delete m_bank;
+}
+
+bool CActiveAESoundBankJob::DoWork()
+{
+  return m_bank->Build(m_sounds, m_quality);
+}
+
+CActiveAESoundBank *CActiveAESoundBankJob::DetachBank()
+{
+  CActiveAESoundBank *bank = m_bank;
+  m_bank = NULL;
+  return bank;
+}
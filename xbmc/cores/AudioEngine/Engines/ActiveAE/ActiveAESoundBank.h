@@ -0,0 +1,82 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEAudioFormat.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+#include "utils/Job.h"
+#include <map>
+#include <vector>
+
+namespace ActiveAE
+{
+
+class CActiveAESound;
+
+/**
+ * gui sounds converted to the internal format of the engine,
+ * stored back to back in a single packet. A bank is built by a job
+ * and is not modified after it has been handed to the engine, apart
+ * from removing sounds that got freed in the meantime.
+ */
+class CActiveAESoundBank
+{
+public:
+  struct Entry
+  {
+    int offset;
+    int samples;
+  };
+
+  CActiveAESoundBank(const AEAudioFormat &format);
+  ~CActiveAESoundBank();
+
+  bool Build(const std::vector<CActiveAESound*> &sounds, AEQuality quality);
+  void Prune(const std::vector<CActiveAESound*> &sounds);
+
+  const Entry *Find(CActiveAESound *sound) const;
+  CSoundPacket *GetPacket() { return m_packet; }
+  AEAudioFormat &GetFormat() { return m_format; }
+
+protected:
+  AEAudioFormat m_format;
+  CSoundPacket *m_packet;
+  std::map<CActiveAESound*, Entry> m_entries;
+};
+
+class CActiveAESoundBankJob : public CJob
+{
+public:
+  CActiveAESoundBankJob(const std::vector<CActiveAESound*> &sounds, const AEAudioFormat &format, AEQuality quality);
+  virtual ~CActiveAESoundBankJob();
+
+  virtual bool DoWork();
+  virtual const char *GetType() const { return "activeaesoundbank"; }
+
+  /* hands over ownership of the bank */
+  CActiveAESoundBank *DetachBank();
+
+protected:
+  std::vector<CActiveAESound*> m_sounds;
+  AEQuality m_quality;
+  CActiveAESoundBank *m_bank;
+};
+
+}
@@ -21,6 +21,7 @@
 #include "AEBitstreamPacker.h"
 #include "AEPackIEC61937.h"
 #include "AEStreamInfo.h"
+#include <algorithm>
 #include <stdint.h>
 #include <stddef.h>
 #include <string.h>
@@ -40,7 +41,9 @@ CAEBitstreamPacker::CAEBitstreamPacker() :
   m_eac3Size (0),
   m_eac3FramesCount(0),
   m_eac3FramesPerBurst(0),
-  m_dataSize (0)
+  m_dataSize (0),
+  m_packedBuffer(NULL),
+  m_packedBufferSize(0)
 {
 }
 
@@ -49,6 +52,23 @@ CAEBitstreamPacker::~CAEBitstreamPacker()
   delete[] m_trueHD;
   delete[] m_dtsHD;
   delete[] m_eac3;
+  delete[] m_packedBuffer;
+}
+
+uint8_t* CAEBitstreamPacker::GetPackTarget(unsigned int size)
+{
+  /* bursts are appended behind the ones that have not been fetched yet */
+  if (m_dataSize + size > m_packedBufferSize)
+  {
+    unsigned int newSize = std::max(m_packedBufferSize * 2, m_dataSize + size);
+    uint8_t *buffer = new uint8_t[newSize];
+    if (m_dataSize)
+      memcpy(buffer, m_packedBuffer, m_dataSize);
+    delete[] m_packedBuffer;
+    m_packedBuffer     = buffer;
+    m_packedBufferSize = newSize;
+  }
+  return m_packedBuffer + m_dataSize;
 }
 
 void CAEBitstreamPacker::Pack(CAEStreamInfo &info, uint8_t* data, int size)
@@ -69,22 +89,22 @@ void CAEBitstreamPacker::Pack(CAEStreamInfo &info, uint8_t* data, int size)
 
     case CAEStreamInfo::STREAM_TYPE_DTSHD_CORE:
     case CAEStreamInfo::STREAM_TYPE_DTS_512:
-      m_dataSize = CAEPackIEC61937::PackDTS_512(data, size, m_packedBuffer, info.IsLittleEndian());
+      m_dataSize += CAEPackIEC61937::PackDTS_512(data, size, GetPackTarget(OUT_FRAMESTOBYTES(DTS1_FRAME_SIZE)), info.IsLittleEndian());
       break;
 
     case CAEStreamInfo::STREAM_TYPE_DTS_1024:
-      m_dataSize = CAEPackIEC61937::PackDTS_1024(data, size, m_packedBuffer, info.IsLittleEndian());
+      m_dataSize += CAEPackIEC61937::PackDTS_1024(data, size, GetPackTarget(OUT_FRAMESTOBYTES(DTS2_FRAME_SIZE)), info.IsLittleEndian());
       break;
 
     case CAEStreamInfo::STREAM_TYPE_DTS_2048:
-      m_dataSize = CAEPackIEC61937::PackDTS_2048(data, size, m_packedBuffer, info.IsLittleEndian());
+      m_dataSize += CAEPackIEC61937::PackDTS_2048(data, size, GetPackTarget(OUT_FRAMESTOBYTES(DTS3_FRAME_SIZE)), info.IsLittleEndian());
       break;
 
     default:
       /* pack the data into an IEC61937 frame */
       CAEPackIEC61937::PackFunc pack = info.GetPackFunc();
       if (pack)
-        m_dataSize = pack(data, size, m_packedBuffer);
+        m_dataSize += pack(data, size, GetPackTarget(MAX_IEC61937_PACKET));
   }
 }
 
@@ -99,6 +119,11 @@ uint8_t* CAEBitstreamPacker::GetBuffer()
   return m_packedBuffer;
 }
 
+void CAEBitstreamPacker::Discard()
+{
+  m_dataSize = 0;
+}
+
 /* we need to pack 24 TrueHD audio units into the unknown MAT format before packing into IEC61937 */
 void CAEBitstreamPacker::PackTrueHD(CAEStreamInfo &info, uint8_t* data, int size)
 {
@@ -137,7 +162,7 @@ void CAEBitstreamPacker::PackTrueHD(CAEStreamInfo &info, uint8_t* data, int size
   if (++m_trueHDPos == 24)
   {
     m_trueHDPos = 0;
-    m_dataSize  = CAEPackIEC61937::PackTrueHD(m_trueHD, MAT_FRAME_SIZE, m_packedBuffer);
+    m_dataSize += CAEPackIEC61937::PackTrueHD(m_trueHD, MAT_FRAME_SIZE, GetPackTarget(OUT_FRAMESTOBYTES(TRUEHD_FRAME_SIZE)));
   }
 }
 
@@ -158,7 +183,7 @@ void CAEBitstreamPacker::PackDTSHD(CAEStreamInfo &info, uint8_t* data, int size)
   m_dtsHD[sizeof(dtshd_start_code) + 1] = ((uint16_t)size & 0x00FF);
   memcpy(m_dtsHD + sizeof(dtshd_start_code) + 2, data, size);
 
-  m_dataSize = CAEPackIEC61937::PackDTSHD(m_dtsHD, dataSize, m_packedBuffer, info.GetDTSPeriod());
+  m_dataSize += CAEPackIEC61937::PackDTSHD(m_dtsHD, dataSize, GetPackTarget(info.GetDTSPeriod() << 2), info.GetDTSPeriod());
 }
 
 void CAEBitstreamPacker::PackEAC3(CAEStreamInfo &info, uint8_t* data, int size)
@@ -175,7 +200,7 @@ void CAEBitstreamPacker::PackEAC3(CAEStreamInfo &info, uint8_t* data, int size)
   if (m_eac3FramesPerBurst == 1)
   {
     /* simple case, just pass through */
-    m_dataSize = CAEPackIEC61937::PackEAC3(data, size, m_packedBuffer);
+    m_dataSize += CAEPackIEC61937::PackEAC3(data, size, GetPackTarget(OUT_FRAMESTOBYTES(EAC3_FRAME_SIZE)));
   }
   else
   {
@@ -196,7 +221,7 @@ void CAEBitstreamPacker::PackEAC3(CAEStreamInfo &info, uint8_t* data, int size)
 
     if (m_eac3FramesCount >= m_eac3FramesPerBurst || overrun)
     {
-      m_dataSize = CAEPackIEC61937::PackEAC3(m_eac3, m_eac3Size, m_packedBuffer);
+      m_dataSize += CAEPackIEC61937::PackEAC3(m_eac3, m_eac3Size, GetPackTarget(OUT_FRAMESTOBYTES(EAC3_FRAME_SIZE)));
       m_eac3Size = 0;
       m_eac3FramesCount = 0;
     }
@@ -31,11 +31,17 @@ public:
   CAEBitstreamPacker();
   ~CAEBitstreamPacker();
 
+  /* packs the frame and appends any completed burst to the output buffer */
   void         Pack(CAEStreamInfo &info, uint8_t* data, int size);
+  /* returns all bursts packed since the last call and starts a new batch */
   uint8_t*     GetBuffer();
   unsigned int GetSize  ();
+  /* drops completed bursts that have not been fetched yet */
+  void         Discard  ();
 
 private:
+  uint8_t* GetPackTarget(unsigned int size);
+
   void PackTrueHD(CAEStreamInfo &info, uint8_t* data, int size);
   void PackDTSHD (CAEStreamInfo &info, uint8_t* data, int size);
   void PackEAC3  (CAEStreamInfo &info, uint8_t* data, int size);
@@ -53,6 +59,7 @@ private:
   unsigned int  m_eac3FramesPerBurst;
 
   unsigned int  m_dataSize;
-  uint8_t       m_packedBuffer[MAX_IEC61937_PACKET];
+  uint8_t      *m_packedBuffer;
+  unsigned int  m_packedBufferSize;
 };
 
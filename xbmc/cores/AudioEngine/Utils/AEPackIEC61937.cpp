@@ -21,12 +21,25 @@
 #include <cassert>
 #include "system.h"
 #include "AEPackIEC61937.h"
+#include "AEUtil.h"
 
 #define IEC61937_PREAMBLE1  0xF872
 #define IEC61937_PREAMBLE2  0x4E1F
 
-inline void SwapEndian(uint16_t *dst, uint16_t *src, unsigned int size)
+void CAEPackIEC61937::SwapEndian(uint16_t *dst, uint16_t *src, unsigned int size)
 {
+#ifdef __SSE2__
+  /* dst may equal src, every block is loaded before it is stored */
+  for (; size >= 16; size -= 16, dst += 16, src += 16)
+  {
+    __m128i a = _mm_loadu_si128((__m128i*)src);
+    __m128i b = _mm_loadu_si128((__m128i*)(src + 8));
+    a = _mm_or_si128(_mm_slli_epi16(a, 8), _mm_srli_epi16(a, 8));
+    b = _mm_or_si128(_mm_slli_epi16(b, 8), _mm_srli_epi16(b, 8));
+    _mm_storeu_si128((__m128i*)dst, a);
+    _mm_storeu_si128((__m128i*)(dst + 8), b);
+  }
+#endif
   for (unsigned int i = 0; i < size; ++i, ++dst, ++src)
     *dst = ((*src & 0xFF00) >> 8) | ((*src & 0x00FF) << 8);
 }
@@ -48,6 +48,9 @@ public:
   static int PackDTS_2048(uint8_t *data, unsigned int size, uint8_t *dest, bool littleEndian);
   static int PackTrueHD  (uint8_t *data, unsigned int size, uint8_t *dest);
   static int PackDTSHD   (uint8_t *data, unsigned int size, uint8_t *dest, unsigned int period);
+
+  /* swaps size 16 bit words from src to dst, dst may be equal to src */
+  static void SwapEndian(uint16_t *dst, uint16_t *src, unsigned int size);
 private:
 
   static int PackDTS(uint8_t *data, unsigned int size, uint8_t *dest, bool littleEndian,
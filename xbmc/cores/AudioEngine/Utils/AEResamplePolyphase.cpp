@@ -0,0 +1,257 @@
+/*
+ *      Copyright (C) 2010-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AEResamplePolyphase.h"
+#include "AEUtil.h"
+#include <algorithm>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+struct PolyphaseParams
+{
+  int    taps;   /* filter length, multiple of 4 */
+  int    phases; /* table resolution per input sample */
+  double beta;   /* kaiser window shape */
+  double cutoff; /* relative to the nyquist frequency of the lower rate */
+};
+
+static PolyphaseParams GetParams(AEQuality quality)
+{
+  PolyphaseParams params;
+  switch (quality)
+  {
+  case AE_QUALITY_LOW:
+    params.taps = 16;  params.phases = 64;  params.beta = 5.0; params.cutoff = 0.80;
+    break;
+  case AE_QUALITY_MID:
+    params.taps = 32;  params.phases = 128; params.beta = 6.5; params.cutoff = 0.88;
+    break;
+  case AE_QUALITY_HIGH:
+    params.taps = 64;  params.phases = 256; params.beta = 8.0; params.cutoff = 0.92;
+    break;
+  case AE_QUALITY_REALLYHIGH:
+  default:
+    params.taps = 128; params.phases = 512; params.beta = 9.5; params.cutoff = 0.95;
+    break;
+  }
+  return params;
+}
+
+/* zeroth order modified bessel function of the first kind */
+static double BesselI0(double x)
+{
+  double sum = 1.0;
+  double term = 1.0;
+  double half = x / 2.0;
+  for (int k = 1; k < 64; k++)
+  {
+    term *= (half / k) * (half / k);
+    sum += term;
+    if (term < sum * 1e-12)
+      break;
+  }
+  return sum;
+}
+
+CAEResamplePolyphase::CAEResamplePolyphase()
+{
+  m_channels = 0;
+  m_srcRate = 0;
+  m_dstRate = 0;
+  m_taps = 0;
+  m_phases = 0;
+  m_step = 1.0;
+  m_frac = 0.0;
+  m_index = 0;
+  m_flushed = false;
+}
+
+CAEResamplePolyphase::~CAEResamplePolyphase()
+{
+}
+
+bool CAEResamplePolyphase::Init(int channels, int srcRate, int dstRate, AEQuality quality)
+{
+  if (channels <= 0 || srcRate <= 0 || dstRate <= 0)
+    return false;
+
+  PolyphaseParams params = GetParams(quality);
+
+  m_channels = channels;
+  m_srcRate = srcRate;
+  m_dstRate = dstRate;
+  m_taps = params.taps;
+  m_phases = params.phases;
+
+  // the filter is scaled to the lower of both rates so that
+  // downsampling does not alias
+  double fc = params.cutoff * std::min(1.0, (double)dstRate / srcRate);
+  double i0beta = BesselI0(params.beta);
+  int half = m_taps / 2;
+
+  // one extra phase so that phase m_phases - 1 can interpolate towards it
+  std::vector<double> table((m_phases + 1) * m_taps);
+  for (int p = 0; p <= m_phases; p++)
+  {
+    double frac = (double)p / m_phases;
+    double sum = 0.0;
+    for (int k = 0; k < m_taps; k++)
+    {
+      double x = frac + half - 1 - k;
+      double u = x / half;
+      double w = 0.0;
+      if (fabs(u) < 1.0)
+        w = BesselI0(params.beta * sqrt(1.0 - u * u)) / i0beta;
+      double s = (x == 0.0) ? 1.0 : sin(M_PI * fc * x) / (M_PI * fc * x);
+      table[p * m_taps + k] = fc * s * w;
+      sum += table[p * m_taps + k];
+    }
+    // normalise every phase to unity gain at DC
+    for (int k = 0; k < m_taps; k++)
+      table[p * m_taps + k] /= sum;
+  }
+
+  m_coeffs.resize(m_phases * m_taps);
+  m_deltas.resize(m_phases * m_taps);
+  for (int p = 0; p < m_phases; p++)
+  {
+    for (int k = 0; k < m_taps; k++)
+    {
+      m_coeffs[p * m_taps + k] = (float)table[p * m_taps + k];
+      m_deltas[p * m_taps + k] = (float)(table[(p + 1) * m_taps + k] - table[p * m_taps + k]);
+    }
+  }
+
+  m_history.resize(m_channels);
+  SetRatio(1.0);
+  Reset();
+  return true;
+}
+
+void CAEResamplePolyphase::SetRatio(double ratio)
+{
+  if (ratio <= 0.0)
+    ratio = 1.0;
+  m_step = (double)m_srcRate / (m_dstRate * ratio);
+}
+
+void CAEResamplePolyphase::Reset()
+{
+  // pre-roll with silence so the first input sample sits at the filter centre
+  for (int ch = 0; ch < m_channels; ch++)
+    m_history[ch].assign(m_taps / 2 - 1, 0.0f);
+  m_index = m_taps / 2 - 1;
+  m_frac = 0.0;
+  m_flushed = false;
+}
+
+void CAEResamplePolyphase::Flush()
+{
+  if (m_flushed)
+    return;
+
+  for (int ch = 0; ch < m_channels; ch++)
+    m_history[ch].insert(m_history[ch].end(), m_taps / 2, 0.0f);
+  m_flushed = true;
+}
+
+double CAEResamplePolyphase::GetDelay() const
+{
+  if (m_channels == 0)
+    return 0.0;
+  return std::max(0.0, m_history[0].size() - m_index - m_frac);
+}
+
+inline float CAEResamplePolyphase::Convolve(const float *in, const float *coeffs, const float *deltas, float frac) const
+{
+#ifdef __SSE__
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  for (int k = 0; k < m_taps; k += 4)
+  {
+    __m128 x = _mm_loadu_ps(in + k);
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(x, _mm_loadu_ps(coeffs + k)));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(x, _mm_loadu_ps(deltas + k)));
+  }
+  acc0 = _mm_add_ps(acc0, _mm_mul_ps(acc1, _mm_set1_ps(frac)));
+  acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+  acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, 1));
+  return _mm_cvtss_f32(acc0);
+#else
+  float acc0 = 0.0f;
+  float acc1 = 0.0f;
+  for (int k = 0; k < m_taps; k++)
+  {
+    acc0 += in[k] * coeffs[k];
+    acc1 += in[k] * deltas[k];
+  }
+  return acc0 + acc1 * frac;
+#endif
+}
+
+int CAEResamplePolyphase::Resample(float **dst, int dstSamples, float **src, int srcSamples)
+{
+  if (m_channels == 0)
+    return 0;
+
+  if (src && srcSamples > 0)
+  {
+    for (int ch = 0; ch < m_channels; ch++)
+      m_history[ch].insert(m_history[ch].end(), src[ch], src[ch] + srcSamples);
+    m_flushed = false;
+  }
+
+  int half = m_taps / 2;
+  int available = m_history[0].size();
+  int out = 0;
+
+  while (out < dstSamples && m_index + half < available)
+  {
+    double pos = m_frac * m_phases;
+    int phase = (int)pos;
+    float frac = (float)(pos - phase);
+    const float *coeffs = &m_coeffs[phase * m_taps];
+    const float *deltas = &m_deltas[phase * m_taps];
+    int start = m_index - half + 1;
+
+    for (int ch = 0; ch < m_channels; ch++)
+      dst[ch][out] = Convolve(&m_history[ch][start], coeffs, deltas, frac);
+    out++;
+
+    m_frac += m_step;
+    int advance = (int)m_frac;
+    m_index += advance;
+    m_frac -= advance;
+  }
+
+  // drop input that has left the filter window
+  int consumed = std::min(m_index - (half - 1), available);
+  if (consumed > 0)
+  {
+    for (int ch = 0; ch < m_channels; ch++)
+      m_history[ch].erase(m_history[ch].begin(), m_history[ch].begin() + consumed);
+    m_index -= consumed;
+  }
+
+  return out;
+}
@@ -0,0 +1,70 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include "cores/AudioEngine/Interfaces/AE.h"
+
+/**
+ * Polyphase windowed-sinc resampler for planar float samples.
+ *
+ * The kaiser windowed sinc filter is tabulated once per rate pair and
+ * quality level. Fractional positions between two table phases are
+ * linearly interpolated, so the conversion ratio can be changed for
+ * every call (sync playback to display) without recomputing the table.
+ */
+class CAEResamplePolyphase
+{
+public:
+  CAEResamplePolyphase();
+  ~CAEResamplePolyphase();
+
+  bool Init(int channels, int srcRate, int dstRate, AEQuality quality);
+
+  /* additional factor applied to the output rate, >1.0 produces more samples */
+  void SetRatio(double ratio);
+
+  /* consumes all src samples, returns the number of samples written to dst */
+  int Resample(float **dst, int dstSamples, float **src, int srcSamples);
+
+  /* feeds silence to push the filter tail out, call once at end of stream */
+  void Flush();
+  void Reset();
+
+  /* number of input samples not yet turned into output */
+  double GetDelay() const;
+  int GetTaps() const { return m_taps; }
+
+private:
+  float Convolve(const float *in, const float *coeffs, const float *deltas, float frac) const;
+
+  int m_channels;
+  int m_srcRate;
+  int m_dstRate;
+  int m_taps;
+  int m_phases;
+  double m_step;
+  double m_frac;
+  int m_index;
+  bool m_flushed;
+  std::vector<float> m_coeffs;
+  std::vector<float> m_deltas;
+  std::vector< std::vector<float> > m_history;
+};
@@ -0,0 +1,241 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEPackIEC61937.h"
+#include "cores/AudioEngine/Utils/AEBitstreamPacker.h"
+#include "cores/AudioEngine/Utils/AEStreamInfo.h"
+#include "cores/dvdplayer/DVDDemuxers/DVDDemux.h"
+#include "cores/dvdplayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/dvdplayer/DVDDemuxers/DVDFactoryDemuxer.h"
+#include "cores/dvdplayer/DVDInputStreams/DVDFactoryInputStream.h"
+#include "cores/dvdplayer/DVDInputStreams/DVDInputStream.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "settings/AdvancedSettings.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <memory>
+#include <string.h>
+#include <vector>
+
+static std::vector<uint8_t> MakeFrame(unsigned int size)
+{
+  std::vector<uint8_t> frame(size);
+  for (unsigned int i = 0; i < size; i++)
+    frame[i] = (uint8_t)(i * 7 + 3);
+  return frame;
+}
+
+TEST(TestAEPackIEC61937, SwapEndian)
+{
+  // cover the vector loop and the scalar tail
+  for (unsigned int words = 0; words < 70; words++)
+  {
+    std::vector<uint8_t> src = MakeFrame(words * 2);
+    std::vector<uint8_t> dst(words * 2 + 2, 0xAA);
+    CAEPackIEC61937::SwapEndian((uint16_t*)&dst[0], (uint16_t*)&src[0], words);
+    for (unsigned int i = 0; i < words; i++)
+    {
+      EXPECT_EQ(src[i * 2 + 1], dst[i * 2]);
+      EXPECT_EQ(src[i * 2], dst[i * 2 + 1]);
+    }
+    // nothing written beyond the end
+    EXPECT_EQ(0xAA, dst[words * 2]);
+
+    // in place
+    std::vector<uint8_t> inplace = src;
+    if (words)
+      CAEPackIEC61937::SwapEndian((uint16_t*)&inplace[0], (uint16_t*)&inplace[0], words);
+    EXPECT_TRUE(std::equal(inplace.begin(), inplace.end(), dst.begin()));
+  }
+}
+
+TEST(TestAEPackIEC61937, PackAC3)
+{
+  std::vector<uint8_t> frame = MakeFrame(1536);
+  std::vector<uint8_t> burst(MAX_IEC61937_PACKET, 0xAA);
+
+  int size = CAEPackIEC61937::PackAC3(&frame[0], frame.size(), &burst[0]);
+  EXPECT_EQ(OUT_FRAMESTOBYTES(AC3_FRAME_SIZE), size);
+
+  uint16_t *header = (uint16_t*)&burst[0];
+  EXPECT_EQ(0xF872, header[0]);
+  EXPECT_EQ(0x4E1F, header[1]);
+  EXPECT_EQ(1536u << 3, header[3]);
+#ifndef __BIG_ENDIAN__
+  EXPECT_EQ(frame[1], burst[IEC61937_DATA_OFFSET]);
+  EXPECT_EQ(frame[0], burst[IEC61937_DATA_OFFSET + 1]);
+#endif
+  // stuffing up to the burst period
+  for (int i = IEC61937_DATA_OFFSET + 1536; i < size; i++)
+    EXPECT_EQ(0, burst[i]);
+}
+
+TEST(TestAEPackIEC61937, PackDTSHD)
+{
+  std::vector<uint8_t> frame = MakeFrame(5000);
+  std::vector<uint8_t> burst(8192 * 4);
+
+  EXPECT_EQ(2048 << 2, CAEPackIEC61937::PackDTSHD(&frame[0], frame.size(), &burst[0], 2048));
+  EXPECT_EQ(0, CAEPackIEC61937::PackDTSHD(&frame[0], frame.size(), &burst[0], 3000));
+}
+
+#define PASSTHROUGH_PACKETS 2000
+
+/*
+ * Reads the packets of the first AC3, E-AC3, DTS or TrueHD stream of a file.
+ * Returns false if the file has none.
+ */
+static bool ReadBitstream(const std::string& path, std::vector<std::string>& packets, CStdString& codec)
+{
+  std::auto_ptr<CDVDInputStream> input(CDVDFactoryInputStream::CreateInputStream(NULL, path, ""));
+  if (!input.get() || !input->Open(path.c_str(), ""))
+    return false;
+
+  std::auto_ptr<CDVDDemux> demuxer(CDVDFactoryDemuxer::CreateDemuxer(input.get()));
+  if (!demuxer.get())
+    return false;
+
+  int audioStream = -1;
+  for (int i = 0; i < demuxer->GetNrOfStreams(); i++)
+  {
+    CDemuxStream* stream = demuxer->GetStream(i);
+    if (stream->type == STREAM_AUDIO && audioStream < 0 &&
+       (stream->codec == AV_CODEC_ID_AC3 || stream->codec == AV_CODEC_ID_EAC3 ||
+        stream->codec == AV_CODEC_ID_DTS || stream->codec == AV_CODEC_ID_TRUEHD))
+      audioStream = i;
+    else
+      stream->SetDiscard(AVDISCARD_ALL);
+  }
+  if (audioStream < 0)
+    return false;
+  demuxer->GetStreamCodecName(audioStream, codec);
+
+  while (packets.size() < PASSTHROUGH_PACKETS)
+  {
+    DemuxPacket* packet = demuxer->Read();
+    if (!packet)
+      break;
+    if (packet->iStreamId == audioStream && packet->iSize > 0)
+      packets.push_back(std::string((const char*)packet->pData, packet->iSize));
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+  }
+  return !packets.empty();
+}
+
+struct SPassthroughResult
+{
+  int64_t time;
+  int     frames;
+  int     batches;   // the AddData calls the audio engine would get
+  int64_t bytes;
+};
+
+/*
+ * Parses and packs the packets the way CDVDAudioCodecPassthrough does, taking
+ * the bursts after every packet, or after every frame like before the frames
+ * of a packet were batched.
+ */
+static void PackBitstream(const std::vector<std::string>& packets, bool batch, SPassthroughResult& result)
+{
+  CAEStreamInfo info;
+  CAEBitstreamPacker packer;
+  uint8_t* buffer = NULL;
+  unsigned int bufferSize = 0;
+
+  result = SPassthroughResult();
+  int64_t start = CurrentHostCounter();
+  for (size_t i = 0; i < packets.size(); i++)
+  {
+    uint8_t* data = (uint8_t*)packets[i].data();
+    int size = (int)packets[i].size();
+    while (size > 0)
+    {
+      unsigned int frame = bufferSize;
+      int consumed = info.AddData(data, size, &buffer, &frame);
+      bufferSize = std::max(bufferSize, frame);
+      data += consumed;
+      size -= consumed;
+      if (frame)
+      {
+        packer.Pack(info, buffer, frame);
+        result.frames++;
+        if (!batch && packer.GetSize())
+        {
+          result.bytes += packer.GetSize();
+          result.batches++;
+          packer.GetBuffer();
+        }
+      }
+      else if (consumed == 0)
+        break;
+    }
+    if (packer.GetSize())
+    {
+      result.bytes += packer.GetSize();
+      result.batches++;
+      packer.GetBuffer();
+    }
+  }
+  result.time = CurrentHostCounter() - start;
+  delete[] buffer;
+}
+
+/* run with --gtest_also_run_disabled_tests --set-media-samples-dir [DIR] */
+TEST(TestAEPackIEC61937, DISABLED_Benchmark)
+{
+  CStdString directory = CXBMCTestUtils::Instance().getMediaSamplesDirectory();
+  if (directory.empty())
+  {
+    printf("no media samples directory given\n");
+    return;
+  }
+
+  CFileItemList items;
+  ASSERT_TRUE(XFILE::CDirectory::GetDirectory(directory, items, g_advancedSettings.m_videoExtensions + "|" + g_advancedSettings.m_musicExtensions));
+
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (items[i]->m_bIsFolder)
+      continue;
+
+    std::vector<std::string> packets;
+    CStdString codec;
+    if (!ReadBitstream(items[i]->GetPath(), packets, codec))
+      continue;
+
+    SPassthroughResult frames, batches;
+    PackBitstream(packets, false, frames);
+    PackBitstream(packets, true, batches);
+
+    double perFrame = frames.time * 1000.0 / CurrentHostFrequency() / packets.size();
+    double perPacket = batches.time * 1000.0 / CurrentHostFrequency() / packets.size();
+    printf("%-40s %-6s %5d frames, %7.1fkB\n", URIUtils::GetFileName(items[i]->GetPath()).c_str(),
+           codec.c_str(), batches.frames, batches.bytes / 1024.0);
+    printf("  per frame  %6.3fms/packet, %5d bursts handed out\n", perFrame, frames.batches);
+    printf("  per packet %6.3fms/packet, %5d bursts handed out\n", perPacket, batches.batches);
+  }
+}
@@ -0,0 +1,200 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEResamplePolyphase.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Runs a mono sine of the given frequency through the resampler in blocks
+ * and returns the output with the filter settling time removed. */
+static std::vector<float> ResampleTone(double freq, int srcRate, int dstRate,
+                                       AEQuality quality, double ratio = 1.0)
+{
+  CAEResamplePolyphase resampler;
+  EXPECT_TRUE(resampler.Init(1, srcRate, dstRate, quality));
+  resampler.SetRatio(ratio);
+
+  const int block = 1024;
+  const int blocks = 64;
+  std::vector<float> in(block);
+  std::vector<float> out;
+  std::vector<float> tmp(block * 4);
+
+  for (int b = 0; b < blocks; b++)
+  {
+    for (int i = 0; i < block; i++)
+      in[i] = 0.5f * (float)sin(2.0 * M_PI * freq * (b * block + i) / srcRate);
+    float *src = &in[0];
+    float *dst = &tmp[0];
+    int samples = resampler.Resample(&dst, tmp.size(), &src, block);
+    out.insert(out.end(), tmp.begin(), tmp.begin() + samples);
+  }
+
+  int skip = resampler.GetTaps() * 4;
+  return std::vector<float>(out.begin() + skip, out.end() - skip);
+}
+
+/* Least squares fit of a sine at freq, returns the residual power
+ * relative to the fitted tone in dB (THD+N) and the fitted amplitude. */
+static double ToneFit(const std::vector<float> &data, double freq, int rate, double *amplitude)
+{
+  double ss = 0, cc = 0, sc = 0, sy = 0, cy = 0;
+  for (size_t i = 0; i < data.size(); i++)
+  {
+    double s = sin(2.0 * M_PI * freq * i / rate);
+    double c = cos(2.0 * M_PI * freq * i / rate);
+    ss += s * s; cc += c * c; sc += s * c;
+    sy += s * data[i]; cy += c * data[i];
+  }
+  double det = ss * cc - sc * sc;
+  double a = (sy * cc - cy * sc) / det;
+  double b = (cy * ss - sy * sc) / det;
+
+  double noise = 0, signal = 0;
+  for (size_t i = 0; i < data.size(); i++)
+  {
+    double fit = a * sin(2.0 * M_PI * freq * i / rate) + b * cos(2.0 * M_PI * freq * i / rate);
+    noise += (data[i] - fit) * (data[i] - fit);
+    signal += fit * fit;
+  }
+  if (amplitude)
+    *amplitude = sqrt(a * a + b * b);
+  return 10.0 * log10(noise / signal);
+}
+
+static double Rms(const std::vector<float> &data)
+{
+  double sum = 0;
+  for (size_t i = 0; i < data.size(); i++)
+    sum += data[i] * data[i];
+  return sqrt(sum / data.size());
+}
+
+TEST(TestAEResamplePolyphase, THDN)
+{
+  double amplitude;
+  std::vector<float> out = ResampleTone(1000.0, 44100, 48000, AE_QUALITY_REALLYHIGH);
+  EXPECT_LT(ToneFit(out, 1000.0, 48000, &amplitude), -90.0);
+
+  out = ResampleTone(1000.0, 48000, 44100, AE_QUALITY_REALLYHIGH);
+  EXPECT_LT(ToneFit(out, 1000.0, 44100, &amplitude), -90.0);
+}
+
+TEST(TestAEResamplePolyphase, Passband)
+{
+  const double freqs[] = { 20.0, 1000.0, 10000.0, 19000.0 };
+  for (unsigned int i = 0; i < sizeof(freqs) / sizeof(freqs[0]); i++)
+  {
+    double amplitude;
+    std::vector<float> out = ResampleTone(freqs[i], 44100, 48000, AE_QUALITY_REALLYHIGH);
+    ToneFit(out, freqs[i], 48000, &amplitude);
+    EXPECT_NEAR(20.0 * log10(amplitude / 0.5), 0.0, 0.05) << "frequency " << freqs[i];
+  }
+}
+
+TEST(TestAEResamplePolyphase, Stopband)
+{
+  // 23kHz does not exist at 44.1kHz and must not alias back
+  std::vector<float> out = ResampleTone(23000.0, 48000, 44100, AE_QUALITY_REALLYHIGH);
+  EXPECT_LT(20.0 * log10(Rms(out) / (0.5 / sqrt(2.0))), -80.0);
+}
+
+TEST(TestAEResamplePolyphase, RatioChange)
+{
+  CAEResamplePolyphase resampler;
+  ASSERT_TRUE(resampler.Init(2, 48000, 48000, AE_QUALITY_REALLYHIGH));
+
+  std::vector<float> left(4800, 0.25f), right(4800, -0.25f);
+  std::vector<float> outLeft(10000), outRight(10000);
+  float *src[2] = { &left[0], &right[0] };
+  float *dst[2] = { &outLeft[0], &outRight[0] };
+
+  int total = 0;
+  for (int i = 0; i < 100; i++)
+  {
+    // sync playback to display nudges the ratio on every call
+    resampler.SetRatio(i % 2 ? 1.01 : 1.03);
+    total += resampler.Resample(dst, outLeft.size(), src, left.size());
+    EXPECT_NEAR(outLeft[100], 0.25f, 1e-4f);
+    EXPECT_NEAR(outRight[100], -0.25f, 1e-4f);
+  }
+  // whatever is still inside the filter window has not been output yet
+  EXPECT_NEAR(total, 4800 * 100 * 1.02, resampler.GetTaps());
+  EXPECT_LT(resampler.GetDelay(), resampler.GetTaps());
+}
+
+TEST(TestAEResamplePolyphase, Flush)
+{
+  CAEResamplePolyphase resampler;
+  ASSERT_TRUE(resampler.Init(1, 44100, 48000, AE_QUALITY_REALLYHIGH));
+
+  std::vector<float> in(4410, 0.5f), out(8000);
+  float *src = &in[0];
+  float *dst = &out[0];
+  int total = resampler.Resample(&dst, out.size(), &src, in.size());
+  resampler.Flush();
+  resampler.Flush();
+  total += resampler.Resample(&dst, out.size(), NULL, 0);
+  EXPECT_NEAR(total, 4800, 2);
+}
+
+/* run with --gtest_also_run_disabled_tests */
+TEST(TestAEResamplePolyphase, DISABLED_Benchmark)
+{
+  const int channels = 8;
+  const int block = 1024;
+  std::vector< std::vector<float> > in(channels, std::vector<float>(block));
+  std::vector< std::vector<float> > out(channels, std::vector<float>(block * 2));
+  float *src[channels], *dst[channels];
+  for (int ch = 0; ch < channels; ch++)
+  {
+    for (int i = 0; i < block; i++)
+      in[ch][i] = (float)sin(i * 0.01 * (ch + 1));
+    src[ch] = &in[ch][0];
+    dst[ch] = &out[ch][0];
+  }
+
+  const AEQuality qualities[] = { AE_QUALITY_LOW, AE_QUALITY_MID, AE_QUALITY_HIGH, AE_QUALITY_REALLYHIGH };
+  for (unsigned int q = 0; q < sizeof(qualities) / sizeof(qualities[0]); q++)
+  {
+    CAEResamplePolyphase resampler;
+    resampler.Init(channels, 44100, 48000, qualities[q]);
+
+    int64_t start = CurrentHostCounter();
+    int produced = 0;
+    for (int i = 0; i < 2000; i++)
+    {
+      resampler.SetRatio(1.0 + (i % 10) * 0.001);
+      produced += resampler.Resample(dst, block * 2, src, block);
+    }
+    double seconds = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+    printf("quality %3d, %d taps: %.1fx realtime for %d channels\n",
+           qualities[q], resampler.GetTaps(), produced / 48000.0 / seconds, channels);
+  }
+}
@@ -0,0 +1,105 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAESoundBank.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAESound.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResample.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace ActiveAE;
+
+/* a stereo 44.1kHz sine of the given length, loud up to the last sample */
+static CActiveAESound *MakeSound(int samples)
+{
+  CActiveAESound *sound = new CActiveAESound("");
+  CAEChannelInfo layout(AE_CH_LAYOUT_2_0);
+  SampleConfig config;
+  config.channel_layout = CActiveAEResample::GetAVChannelLayout(layout);
+  config.channels = 2;
+  config.sample_rate = 44100;
+  config.fmt = AV_SAMPLE_FMT_FLT;
+  config.bits_per_sample = 32;
+
+  float *data = (float*)sound->InitSound(true, config, samples)[0];
+  for (int i = 0; i < samples; i++)
+    data[2 * i] = data[2 * i + 1] = 0.5f * (float)sin(2.0 * M_PI * 1000.0 * i / 44100);
+  sound->GetSound(true)->nb_samples = samples;
+  return sound;
+}
+
+static void BuildBank(AEQuality quality)
+{
+  AEAudioFormat format;
+  format.m_dataFormat = AE_FMT_FLOATP;
+  format.m_sampleRate = 48000;
+  format.m_channelLayout = CAEChannelInfo(AE_CH_LAYOUT_2_0);
+
+  std::vector<CActiveAESound*> sounds;
+  sounds.push_back(MakeSound(4410));
+  sounds.push_back(MakeSound(22050));
+
+  CActiveAESoundBank bank(format);
+  ASSERT_TRUE(bank.Build(sounds, quality));
+
+  // one packet sized for all sounds, playback only reads from it
+  CSoundPacket *packet = bank.GetPacket();
+  ASSERT_TRUE(packet != NULL);
+  EXPECT_LE(packet->nb_samples, packet->max_nb_samples);
+
+  int offset = 0;
+  for (size_t i = 0; i < sounds.size(); i++)
+  {
+    const CActiveAESoundBank::Entry *entry = bank.Find(sounds[i]);
+    ASSERT_TRUE(entry != NULL);
+    EXPECT_EQ(offset, entry->offset);
+
+    // the tail held back by the filter is drained into the bank as well
+    int expected = CActiveAEResample::CalcDstSampleCount(sounds[i]->GetSound(true)->nb_samples, 48000, 44100);
+    EXPECT_NEAR(expected, entry->samples, 1) << "quality " << quality;
+
+    // and isn't silent, the sound is loud up to its end
+    const float *tail = (const float*)packet->data[0] + entry->offset + entry->samples - 32;
+    float peak = 0.0f;
+    for (int j = 0; j < 32; j++)
+      peak = std::max(peak, (float)fabs(tail[j]));
+    EXPECT_GT(peak, 0.25f) << "quality " << quality;
+
+    offset += expected;
+  }
+  EXPECT_EQ(offset, packet->nb_samples);
+
+  for (size_t i = 0; i < sounds.size(); i++)
+    delete sounds[i];
+}
+
+TEST(TestActiveAESoundBank, Build)
+{
+  BuildBank(AE_QUALITY_MID);
+  BuildBank(AE_QUALITY_REALLYHIGH);
+}
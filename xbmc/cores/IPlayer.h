@@ -122,6 +122,24 @@ struct SPlayerVideoStreamInfo
   }
 };
 
+struct SPlayerBufferInfo
+{
+  double   seconds; // playback time buffered ahead
+  double   target;  // playback time the player tries to buffer
+  int64_t  bytes;   // bytes buffered in the input cache and the player
+  int64_t  budget;  // memory available for buffering
+  unsigned rate;    // bytes per second the buffers are refilled at
+
+  SPlayerBufferInfo()
+  {
+    seconds = 0.0;
+    target = 0.0;
+    bytes = 0;
+    budget = 0;
+    rate = 0;
+  }
+};
+
 class IPlayer
 {
 public:
@@ -207,6 +225,8 @@ public:
   //Cache filled in Percent
   virtual int GetCacheLevel() const {return -1;};
 
+  virtual void GetBufferInfo(SPlayerBufferInfo &info) {};
+
   virtual bool IsInMenu() const {return false;};
   virtual bool HasMenu() { return false; };
 
@@ -136,6 +136,7 @@ CLinuxRendererGL::YUVBUFFER::YUVBUFFER()
   memset(&image , 0, sizeof(image));
   memset(&pbo   , 0, sizeof(pbo));
   flipindex = 0;
+  frame = NULL;
 #ifdef HAVE_LIBVDPAU
   vdpau = NULL;
 #endif
@@ -146,6 +147,7 @@ CLinuxRendererGL::YUVBUFFER::YUVBUFFER()
 
 CLinuxRendererGL::YUVBUFFER::~YUVBUFFER()
 {
+  av_frame_free(&frame);
 #ifdef HAVE_LIBVA
   delete &vaapi;
 #endif
@@ -363,7 +365,12 @@ int CLinuxRendererGL::GetImage(YV12Image *image, int source, bool readonly)
   if( readonly )
     im.flags |= IMAGE_FLAG_READING;
   else
+  {
     im.flags |= IMAGE_FLAG_WRITING;
+    /* image planes get new content, a frame from AddVideoPicture no longer applies */
+    if (m_buffers[source].frame)
+      av_frame_unref(m_buffers[source].frame);
+  }
 
   // copy the image - should be operator of YV12Image
   for (int p=0;p<MAX_PLANES;p++)
@@ -566,9 +573,9 @@ void CLinuxRendererGL::Flush()
 
 void CLinuxRendererGL::ReleaseBuffer(int idx)
 {
-#if defined(HAVE_LIBVDPAU) || defined(HAVE_LIBVA) || defined(TARGET_DARWIN)
   YUVBUFFER &buf = m_buffers[idx];
-#endif
+  if (buf.frame)
+    av_frame_unref(buf.frame);
 #ifdef HAVE_LIBVDPAU
   SAFE_RELEASE(buf.vdpau);
 #endif
@@ -582,6 +589,58 @@ void CLinuxRendererGL::ReleaseBuffer(int idx)
 #endif
 }
 
+bool CLinuxRendererGL::AddVideoPicture(DVDVideoPicture* picture, int index)
+{
+  /* software decoded yuv can be uploaded straight from the decoder frame, saving
+   * the copy into the image. everything else goes through GetImage */
+  if (!m_bValidated
+  ||  !(picture->iFlags & DVP_FLAG_FRAMEREF)
+  ||  picture->format != m_format
+  ||  m_textureUpload != &CLinuxRendererGL::UploadYV12Texture)
+    return false;
+
+  if (m_format != RENDER_FMT_YUV420P
+  &&  m_format != RENDER_FMT_YUV420P10
+  &&  m_format != RENDER_FMT_YUV420P16)
+    return false;
+
+  if (index < 0 || index >= m_NumYV12Buffers)
+    return false;
+
+  YUVBUFFER &buf = m_buffers[index];
+  YV12Image &im  = buf.image;
+
+  if ((im.flags&(~IMAGE_FLAG_READY)) != 0)
+    return false;
+
+  if (picture->iWidth != im.width || picture->iHeight != im.height)
+    return false;
+
+  if (!buf.frame && !(buf.frame = av_frame_alloc()))
+    return false;
+
+  av_frame_unref(buf.frame);
+  if (av_frame_ref(buf.frame, picture->frame) < 0)
+    return false;
+
+  /* the picture may have been pointed elsewhere after decoding, only take
+   * the frame if it still holds the planes we are asked to show */
+  for (int p = 0; p < 3; p++)
+  {
+    if (buf.frame->data[p]     != picture->data[p]
+    ||  buf.frame->linesize[p] != picture->iLineSize[p]
+    ||  picture->iLineSize[p] <= 0)
+    {
+      av_frame_unref(buf.frame);
+      return false;
+    }
+  }
+
+  im.flags |= IMAGE_FLAG_READY;
+  m_bImageReady = true;
+  return true;
+}
+
 void CLinuxRendererGL::Update()
 {
   if (!m_bConfigured) return;
@@ -1816,6 +1875,23 @@ bool CLinuxRendererGL::UploadYV12Texture(int source)
 
   if (!(im->flags&IMAGE_FLAG_READY))
     return false;
+
+  /* a referenced decoder frame is uploaded from client memory instead of the pbo */
+  YV12Image frameImage;
+  GLuint    noPbo = 0;
+  GLuint   *pbo   = NULL;
+  if (buf.frame && buf.frame->data[0])
+  {
+    frameImage = buf.image;
+    for (int p = 0; p < 3; p++)
+    {
+      frameImage.plane[p]  = buf.frame->data[p];
+      frameImage.stride[p] = buf.frame->linesize[p];
+    }
+    im  = &frameImage;
+    pbo = &noPbo;
+  }
+
   bool deinterlacing;
   if (m_currentField == FIELD_FULL)
     deinterlacing = false;
@@ -1832,47 +1908,47 @@ bool CLinuxRendererGL::UploadYV12Texture(int source)
     // Load Even Y Field
     LoadPlane( fields[FIELD_TOP][0] , GL_LUMINANCE, buf.flipindex
              , im->width, im->height >> 1
-             , im->stride[0]*2, im->bpp, im->plane[0] );
+             , im->stride[0]*2, im->bpp, im->plane[0], pbo );
 
     //load Odd Y Field
     LoadPlane( fields[FIELD_BOT][0], GL_LUMINANCE, buf.flipindex
              , im->width, im->height >> 1
-             , im->stride[0]*2, im->bpp, im->plane[0] + im->stride[0]) ;
+             , im->stride[0]*2, im->bpp, im->plane[0] + im->stride[0], pbo );
 
     // Load Even U & V Fields
     LoadPlane( fields[FIELD_TOP][1], GL_LUMINANCE, buf.flipindex
              , im->width >> im->cshift_x, im->height >> (im->cshift_y + 1)
-             , im->stride[1]*2, im->bpp, im->plane[1] );
+             , im->stride[1]*2, im->bpp, im->plane[1], pbo );
 
     LoadPlane( fields[FIELD_TOP][2], GL_ALPHA, buf.flipindex
              , im->width >> im->cshift_x, im->height >> (im->cshift_y + 1)
-             , im->stride[2]*2, im->bpp, im->plane[2] );
+             , im->stride[2]*2, im->bpp, im->plane[2], pbo );
 
     // Load Odd U & V Fields
     LoadPlane( fields[FIELD_BOT][1], GL_LUMINANCE, buf.flipindex
              , im->width >> im->cshift_x, im->height >> (im->cshift_y + 1)
-             , im->stride[1]*2, im->bpp, im->plane[1] + im->stride[1] );
+             , im->stride[1]*2, im->bpp, im->plane[1] + im->stride[1], pbo );
 
     LoadPlane( fields[FIELD_BOT][2], GL_ALPHA, buf.flipindex
              , im->width >> im->cshift_x, im->height >> (im->cshift_y + 1)
-             , im->stride[2]*2, im->bpp, im->plane[2] + im->stride[2] );
+             , im->stride[2]*2, im->bpp, im->plane[2] + im->stride[2], pbo );
   }
   else
   {
     //Load Y plane
     LoadPlane( fields[FIELD_FULL][0], GL_LUMINANCE, buf.flipindex
              , im->width, im->height
-             , im->stride[0], im->bpp, im->plane[0] );
+             , im->stride[0], im->bpp, im->plane[0], pbo );
 
     //load U plane
     LoadPlane( fields[FIELD_FULL][1], GL_LUMINANCE, buf.flipindex
              , im->width >> im->cshift_x, im->height >> im->cshift_y
-             , im->stride[1], im->bpp, im->plane[1] );
+             , im->stride[1], im->bpp, im->plane[1], pbo );
 
     //load V plane
     LoadPlane( fields[FIELD_FULL][2], GL_ALPHA, buf.flipindex
              , im->width >> im->cshift_x, im->height >> im->cshift_y
-             , im->stride[2], im->bpp, im->plane[2] );
+             , im->stride[2], im->bpp, im->plane[2], pbo );
   }
 
   VerifyGLState();
@@ -1889,6 +1965,9 @@ void CLinuxRendererGL::DeleteYV12Texture(int index)
   YUVFIELDS &fields = m_buffers[index].fields;
   GLuint    *pbo    = m_buffers[index].pbo;
 
+  if (m_buffers[index].frame)
+    av_frame_unref(m_buffers[index].frame);
+
   if( fields[FIELD_FULL][0].id == 0 ) return;
 
   /* finish up all textures, and delete them */
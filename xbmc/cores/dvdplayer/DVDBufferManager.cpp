@@ -0,0 +1,155 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDBufferManager.h"
+#include "threads/SingleLock.h"
+
+#include <algorithm>
+#include <limits.h>
+
+// the queues get at least this much, even if the input cache uses up the budget
+#define MIN_QUEUE_BUDGET  (8 * 1024 * 1024)
+#define MIN_QUEUE_SIZE    (1024 * 1024)
+#define MIN_QUEUE_SECONDS 2.0
+// weight of a new measurement in the running averages
+#define SMOOTHING         0.2
+
+SDVDBufferState::SDVDBufferState()
+{
+  cacheSize    = 0;
+  cacheForward = 0;
+  cacheRate    = 0;
+  audio        = false;
+  video        = false;
+  audioBytes   = 0;
+  videoBytes   = 0;
+  audioTime    = 0.0;
+  videoTime    = 0.0;
+  demuxed      = 0;
+  bitrate      = 0.0;
+  clock        = 0.0;
+}
+
+CDVDBufferManager::CDVDBufferManager()
+{
+  Reset(64 * 1024 * 1024, 8.0);
+}
+
+void CDVDBufferManager::Reset(int64_t budget, double seconds)
+{
+  CSingleLock lock(m_section);
+  m_budget      = budget;
+  m_seconds     = std::max(MIN_QUEUE_SECONDS, seconds);
+  m_byteRate    = 0.0;
+  m_refillRate  = 0.0;
+  m_audioShare  = 0.15;
+  m_maxTime     = m_seconds;
+  m_lastDemuxed = 0;
+  m_lastClock   = 0.0;
+  m_maxVideo    = (int)std::min<int64_t>(m_budget * (1.0 - m_audioShare), INT_MAX);
+  m_maxAudio    = (int)std::min<int64_t>(m_budget * m_audioShare, INT_MAX);
+
+  m_info = SPlayerBufferInfo();
+  m_info.target = m_seconds;
+  m_info.budget = m_budget;
+}
+
+void CDVDBufferManager::Update(const SDVDBufferState& state)
+{
+  CSingleLock lock(m_section);
+
+  // bytes per second of playback, measured on the queues once they know their length
+  double queueTime = std::max(state.audio ? state.audioTime : 0.0, state.video ? state.videoTime : 0.0);
+  int    queueBytes = state.audioBytes + state.videoBytes;
+  double byteRate = 0.0;
+  if (queueTime > 0.5 && queueBytes > 0)
+    byteRate = queueBytes / queueTime;
+  else
+    byteRate = state.bitrate;
+  if (byteRate > 0.0)
+    m_byteRate = m_byteRate > 0.0 ? m_byteRate + SMOOTHING * (byteRate - m_byteRate) : byteRate;
+
+  if (state.audioTime > 0.5 && state.videoTime > 0.5 && queueBytes > 0)
+  {
+    double share = (state.audioBytes / state.audioTime) / (state.audioBytes / state.audioTime + state.videoBytes / state.videoTime);
+    m_audioShare += SMOOTHING * (std::min(0.5, std::max(0.02, share)) - m_audioShare);
+  }
+
+  // how fast the buffers are refilled, from the input cache if there is one
+  if (state.cacheSize > 0 && state.cacheRate > 0)
+    m_refillRate = state.cacheRate;
+  else if (m_lastClock > 0.0 && state.clock > m_lastClock && state.demuxed >= m_lastDemuxed)
+  {
+    double rate = (state.demuxed - m_lastDemuxed) / (state.clock - m_lastClock);
+    m_refillRate += SMOOTHING * (rate - m_refillRate);
+  }
+  m_lastDemuxed = state.demuxed;
+  m_lastClock   = state.clock;
+
+  // the memory of the input cache is taken off the budget, what it has read
+  // ahead counts towards the target, so a drained cache leaves all of it to the queues
+  int64_t queueBudget = std::max<int64_t>(m_budget - state.cacheSize, MIN_QUEUE_BUDGET);
+  double  cacheSeconds = m_byteRate > 0.0 ? state.cacheForward / m_byteRate : 0.0;
+  m_maxTime = std::max(MIN_QUEUE_SECONDS, m_seconds - cacheSeconds);
+
+  double audioShare = m_audioShare;
+  if (!state.video)
+    audioShare = 1.0;
+  else if (!state.audio)
+    audioShare = 0.0;
+  m_maxAudio = (int)std::min<int64_t>(std::max<int64_t>(queueBudget * audioShare, MIN_QUEUE_SIZE), INT_MAX);
+  m_maxVideo = (int)std::min<int64_t>(std::max<int64_t>(queueBudget * (1.0 - audioShare), MIN_QUEUE_SIZE), INT_MAX);
+
+  // playback stops as soon as either queue runs dry
+  double queued = -1.0;
+  if (state.audio)
+    queued = state.audioTime > 0.0 || m_byteRate <= 0.0 ? state.audioTime : state.audioBytes / (m_byteRate * audioShare);
+  if (state.video)
+  {
+    double video = state.videoTime > 0.0 || m_byteRate <= 0.0 ? state.videoTime : state.videoBytes / (m_byteRate * (1.0 - audioShare));
+    queued = queued < 0.0 ? video : std::min(queued, video);
+  }
+
+  m_info.seconds = std::max(0.0, queued);
+  if (m_byteRate > 0.0)
+    m_info.seconds += state.cacheForward / m_byteRate;
+  m_info.target = m_seconds;
+  m_info.bytes  = queueBytes + state.cacheForward;
+  m_info.budget = m_budget;
+  m_info.rate   = (unsigned)std::max(0.0, m_refillRate);
+}
+
+int CDVDBufferManager::GetMaxDataSize(bool video) const
+{
+  CSingleLock lock(m_section);
+  return video ? m_maxVideo : m_maxAudio;
+}
+
+double CDVDBufferManager::GetMaxTimeSize() const
+{
+  CSingleLock lock(m_section);
+  return m_maxTime;
+}
+
+void CDVDBufferManager::GetInfo(SPlayerBufferInfo& info) const
+{
+  CSingleLock lock(m_section);
+  info = m_info;
+}
@@ -0,0 +1,82 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/IPlayer.h"
+#include "threads/CriticalSection.h"
+
+/* What the player measured about its buffers since the last update */
+struct SDVDBufferState
+{
+  SDVDBufferState();
+
+  int64_t  cacheSize;    // bytes the input cache holds in memory, 0 without one
+  int64_t  cacheForward; // bytes cached ahead of the demuxer
+  unsigned cacheRate;    // bytes per second the input cache fills at
+  bool     audio;        // streams being played
+  bool     video;
+  int      audioBytes;   // bytes and seconds of packets in the queues,
+  int      videoBytes;   // seconds are 0 if the queue doesn't know them
+  double   audioTime;
+  double   videoTime;
+  int64_t  demuxed;      // total bytes demuxed
+  double   bitrate;      // bytes per second from length and duration, 0 if unknown
+  double   clock;        // seconds, any monotonic clock
+};
+
+/*
+ * Splits one memory budget between the input cache and the packet queues of
+ * the player and sizes the queues to hold a target time of playback.
+ *
+ * The input cache is allocated when the file is opened, so its share is taken
+ * off the budget first. What it holds counts towards the target, the queues
+ * only hold the rest of it. The bytes left for the queues are shared by audio
+ * and video in the ratio of their bitrates, so high bitrate video can use all
+ * of the budget and low bitrate streams are limited by time instead.
+ */
+class CDVDBufferManager
+{
+public:
+  CDVDBufferManager();
+
+  void Reset(int64_t budget, double seconds);
+  void Update(const SDVDBufferState& state);
+
+  int    GetMaxDataSize(bool video) const;
+  double GetMaxTimeSize() const;
+  void   GetInfo(SPlayerBufferInfo& info) const;
+
+private:
+  mutable CCriticalSection m_section;
+  int64_t m_budget;
+  double  m_seconds;
+
+  double  m_byteRate;   // bytes per second of playback
+  double  m_refillRate; // bytes per second read from the source
+  double  m_audioShare;
+  int     m_maxAudio;
+  int     m_maxVideo;
+  double  m_maxTime;
+
+  int64_t m_lastDemuxed;
+  double  m_lastClock;
+
+  SPlayerBufferInfo m_info;
+};
@@ -28,9 +28,12 @@
 #include "cores/AudioEngine/AEFactory.h"
 
 CDVDAudioCodecPassthrough::CDVDAudioCodecPassthrough(void) :
-  m_buffer    (NULL),
-  m_bufferSize(0)
+  m_buffer     (NULL),
+  m_bufferSize (0),
+  m_pendingSize(0)
 {
+  GetFormat(m_batchFormat);
+  GetFormat(m_dataFormat);
 }
 
 CDVDAudioCodecPassthrough::~CDVDAudioCodecPassthrough(void)
@@ -48,7 +51,8 @@ bool CDVDAudioCodecPassthrough::Open(CDVDStreamInfo &hints, CDVDCodecOptions &op
 
   /* only get the dts core from the parser if we don't support dtsHD */
   m_info.SetCoreOnly(!bSupportsDTSHDOut);
-  m_bufferSize = 0;
+  m_bufferSize  = 0;
+  m_pendingSize = 0;
 
   /* 32kHz E-AC-3 passthrough requires 128kHz IEC 60958 stream
    * which HDMI does not support, and IEC 61937 does not mention
@@ -66,17 +70,17 @@ bool CDVDAudioCodecPassthrough::Open(CDVDStreamInfo &hints, CDVDCodecOptions &op
 
 int CDVDAudioCodecPassthrough::GetSampleRate()
 {
-  return m_info.GetOutputRate();
+  return m_dataFormat.outputRate;
 }
 
 int CDVDAudioCodecPassthrough::GetEncodedSampleRate()
 {
-  return m_info.GetSampleRate();
+  return m_dataFormat.sampleRate;
 }
 
 enum AEDataFormat CDVDAudioCodecPassthrough::GetDataFormat()
 {
-  switch(m_info.GetDataType())
+  switch(m_dataFormat.type)
   {
     case CAEStreamInfo::STREAM_TYPE_AC3:
       return AE_FMT_AC3;
@@ -103,17 +107,17 @@ enum AEDataFormat CDVDAudioCodecPassthrough::GetDataFormat()
 
 int CDVDAudioCodecPassthrough::GetChannels()
 {
-  return m_info.GetOutputChannels();
+  return m_dataFormat.outputChannels;
 }
 
 int CDVDAudioCodecPassthrough::GetEncodedChannels()
 {
-  return m_info.GetChannels();
+  return m_dataFormat.channels;
 }
 
 CAEChannelInfo CDVDAudioCodecPassthrough::GetChannelMap()
 {
-  return m_info.GetChannelMap();
+  return m_dataFormat.channelMap;
 }
 
 void CDVDAudioCodecPassthrough::Dispose()
@@ -124,20 +128,50 @@ void CDVDAudioCodecPassthrough::Dispose()
     m_buffer = NULL;
   }
 
-  m_bufferSize = 0;
+  m_bufferSize  = 0;
+  m_pendingSize = 0;
 }
 
 int CDVDAudioCodecPassthrough::Decode(uint8_t* pData, int iSize)
 {
   if (iSize <= 0) return 0;
 
-  unsigned int size = m_bufferSize;
-  unsigned int used = m_info.AddData(pData, iSize, &m_buffer, &size);
-  m_bufferSize = std::max(m_bufferSize, size);
+  /* the frame that started a new format goes first, once the batch before it is fetched */
+  if (m_pendingSize)
+  {
+    if (m_packer.GetSize())
+      return 0;
+    m_packer.Pack(m_info, m_buffer, m_pendingSize);
+    m_pendingSize = 0;
+  }
 
-  /* if we have a frame */
-  if (size)
-    m_packer.Pack(m_info, m_buffer, size);
+  /* pack all frames of the demux packet into one batch of bursts, so they
+   * reach the audio engine with a single AddData call */
+  int used = 0;
+  while (used < iSize)
+  {
+    unsigned int size = m_bufferSize;
+    unsigned int consumed = m_info.AddData(pData + used, iSize - used, &m_buffer, &size);
+    m_bufferSize = std::max(m_bufferSize, size);
+    used += consumed;
+
+    /* if we have a frame */
+    if (size)
+    {
+      if (!m_packer.GetSize())
+        GetFormat(m_batchFormat);
+      else if (!IsSameFormat(m_batchFormat))
+      {
+        /* a batch must not mix formats, end it here and keep the frame for the next one */
+        m_pendingSize = size;
+        break;
+      }
+
+      m_packer.Pack(m_info, m_buffer, size);
+    }
+    else if (consumed == 0)
+      break;
+  }
 
   return used;
 }
@@ -146,14 +180,35 @@ int CDVDAudioCodecPassthrough::GetData(uint8_t** dst)
 {
   int size = m_packer.GetSize();
   *dst     = m_packer.GetBuffer();
+  if (size)
+    m_dataFormat = m_batchFormat;
   return size;
 }
 
 void CDVDAudioCodecPassthrough::Reset()
 {
+  m_packer.Discard();
+  m_pendingSize = 0;
 }
 
 int CDVDAudioCodecPassthrough::GetBufferSize()
 {
   return (int)m_info.GetBufferSize();
 }
+
+void CDVDAudioCodecPassthrough::GetFormat(Format &format)
+{
+  format.type           = m_info.GetDataType();
+  format.outputRate     = m_info.GetOutputRate();
+  format.outputChannels = m_info.GetOutputChannels();
+  format.sampleRate     = m_info.GetSampleRate();
+  format.channels       = m_info.GetChannels();
+  format.channelMap     = m_info.GetChannelMap();
+}
+
+bool CDVDAudioCodecPassthrough::IsSameFormat(const Format &format)
+{
+  return m_info.GetDataType()       == format.type &&
+         m_info.GetOutputRate()     == format.outputRate &&
+         m_info.GetOutputChannels() == format.outputChannels;
+}
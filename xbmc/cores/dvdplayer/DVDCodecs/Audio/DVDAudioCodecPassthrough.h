@@ -49,9 +49,25 @@ public:
   virtual const char* GetName            () { return "passthrough"; }
   virtual int  GetBufferSize();
 private:
+  struct Format
+  {
+    CAEStreamInfo::DataType type;
+    unsigned int   outputRate;
+    unsigned int   outputChannels;
+    unsigned int   sampleRate;
+    unsigned int   channels;
+    CAEChannelInfo channelMap;
+  };
+
+  void GetFormat(Format &format);
+  bool IsSameFormat(const Format &format);
+
   CAEStreamInfo      m_info;
   CAEBitstreamPacker m_packer;
   uint8_t*           m_buffer;
   unsigned int       m_bufferSize;
+  unsigned int       m_pendingSize; /* a frame in m_buffer that starts a new format, packed once the batch before it is fetched */
+  Format             m_batchFormat; /* the format of the frames in the packer */
+  Format             m_dataFormat;  /* the format of the frames last returned by GetData */
 };
 
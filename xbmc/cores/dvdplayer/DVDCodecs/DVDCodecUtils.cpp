@@ -21,10 +21,13 @@
 #include "DVDCodecUtils.h"
 #include "DVDClock.h"
 #include "cores/VideoRenderers/RenderManager.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
 #include "utils/fastmemcpy.h"
 #include "cores/FFmpeg.h"
 
+#include <algorithm>
+
 #ifdef TARGET_WINDOWS
 #pragma comment(lib, "avcodec.lib")
 #pragma comment(lib, "avfilter.lib")
@@ -32,11 +35,357 @@
 #pragma comment(lib, "avutil.lib")
 #pragma comment(lib, "postproc.lib")
 #pragma comment(lib, "swresample.lib")
-#pragma comment(lib, "swscale.lib")
 #endif
 
-extern "C" {
-#include "libswscale/swscale.h"
+#if _M_IX86_FP>1 && !defined(__SSE2__)
+#define __SSE2__
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* avx2 kernels are compiled for that target only and picked at runtime */
+#if defined(__SSE2__) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define HAS_AVX2_KERNELS
+#include <immintrin.h>
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+/* planes larger than this are written with non-temporal stores, they would
+ * only evict the cache and are read next by the gpu or another thread */
+#define STREAM_THRESHOLD (1024 * 1024)
+
+typedef void (*CopyRowFunc)(uint8_t* dst, const uint8_t* src, int bytes);
+typedef void (*InterleaveRowFunc)(uint8_t* dst, const uint8_t* u, const uint8_t* v, int width);
+typedef void (*PackRowFunc)(uint8_t* dst, const uint8_t* y, const uint8_t* u, const uint8_t* v, const uint8_t* un, const uint8_t* vn, int pairs, bool uyvy);
+
+static void CopyRow_C(uint8_t* dst, const uint8_t* src, int bytes)
+{
+  fast_memcpy(dst, src, bytes);
+}
+
+static void InterleaveRow_C(uint8_t* dst, const uint8_t* u, const uint8_t* v, int width)
+{
+  for (int x = 0; x < width; x++)
+  {
+    *dst++ = u[x];
+    *dst++ = v[x];
+  }
+}
+
+/* 3/4 of the nearest chroma row and 1/4 of the next nearest, rounded like two pavgb */
+static inline uint8_t BlendChroma(uint8_t c, uint8_t n)
+{
+  return (uint8_t)((c + ((c + n + 1) >> 1) + 1) >> 1);
+}
+
+/* packs a row with chroma interpolated between row u/v and the neighbouring row un/vn */
+static void PackRow_C(uint8_t* dst, const uint8_t* y, const uint8_t* u, const uint8_t* v, const uint8_t* un, const uint8_t* vn, int pairs, bool uyvy)
+{
+  if (uyvy)
+  {
+    for (int x = 0; x < pairs; x++)
+    {
+      *dst++ = BlendChroma(u[x], un[x]);
+      *dst++ = y[2 * x];
+      *dst++ = BlendChroma(v[x], vn[x]);
+      *dst++ = y[2 * x + 1];
+    }
+  }
+  else
+  {
+    for (int x = 0; x < pairs; x++)
+    {
+      *dst++ = y[2 * x];
+      *dst++ = BlendChroma(u[x], un[x]);
+      *dst++ = y[2 * x + 1];
+      *dst++ = BlendChroma(v[x], vn[x]);
+    }
+  }
+}
+
+#ifdef __SSE2__
+static void CopyRow_SSE2(uint8_t* dst, const uint8_t* src, int bytes)
+{
+  int x = 0;
+  for (; x + 64 <= bytes; x += 64)
+  {
+    __m128i a = _mm_loadu_si128((const __m128i*)(src + x));
+    __m128i b = _mm_loadu_si128((const __m128i*)(src + x + 16));
+    __m128i c = _mm_loadu_si128((const __m128i*)(src + x + 32));
+    __m128i d = _mm_loadu_si128((const __m128i*)(src + x + 48));
+    _mm_storeu_si128((__m128i*)(dst + x)     , a);
+    _mm_storeu_si128((__m128i*)(dst + x + 16), b);
+    _mm_storeu_si128((__m128i*)(dst + x + 32), c);
+    _mm_storeu_si128((__m128i*)(dst + x + 48), d);
+  }
+  if (x < bytes)
+    memcpy(dst + x, src + x, bytes - x);
+}
+
+static void StreamRow_SSE2(uint8_t* dst, const uint8_t* src, int bytes)
+{
+  int x = (16 - ((uintptr_t)dst & 15)) & 15;
+  if (x > bytes)
+    x = bytes;
+  memcpy(dst, src, x);
+
+  for (; x + 64 <= bytes; x += 64)
+  {
+    __m128i a = _mm_loadu_si128((const __m128i*)(src + x));
+    __m128i b = _mm_loadu_si128((const __m128i*)(src + x + 16));
+    __m128i c = _mm_loadu_si128((const __m128i*)(src + x + 32));
+    __m128i d = _mm_loadu_si128((const __m128i*)(src + x + 48));
+    _mm_stream_si128((__m128i*)(dst + x)     , a);
+    _mm_stream_si128((__m128i*)(dst + x + 16), b);
+    _mm_stream_si128((__m128i*)(dst + x + 32), c);
+    _mm_stream_si128((__m128i*)(dst + x + 48), d);
+  }
+  for (; x + 16 <= bytes; x += 16)
+    _mm_stream_si128((__m128i*)(dst + x), _mm_loadu_si128((const __m128i*)(src + x)));
+  if (x < bytes)
+    memcpy(dst + x, src + x, bytes - x);
+  _mm_sfence();
+}
+
+static void InterleaveRow_SSE2(uint8_t* dst, const uint8_t* u, const uint8_t* v, int width)
+{
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    __m128i cu = _mm_loadu_si128((const __m128i*)(u + x));
+    __m128i cv = _mm_loadu_si128((const __m128i*)(v + x));
+    _mm_storeu_si128((__m128i*)(dst + 2 * x)     , _mm_unpacklo_epi8(cu, cv));
+    _mm_storeu_si128((__m128i*)(dst + 2 * x + 16), _mm_unpackhi_epi8(cu, cv));
+  }
+  InterleaveRow_C(dst + 2 * x, u + x, v + x, width - x);
+}
+
+static void PackRow_SSE2(uint8_t* dst, const uint8_t* y, const uint8_t* u, const uint8_t* v, const uint8_t* un, const uint8_t* vn, int pairs, bool uyvy)
+{
+  int x = 0;
+  for (; x + 16 <= pairs; x += 16)
+  {
+    __m128i cu  = _mm_loadu_si128((const __m128i*)(u + x));
+    __m128i cv  = _mm_loadu_si128((const __m128i*)(v + x));
+    cu = _mm_avg_epu8(cu, _mm_avg_epu8(cu, _mm_loadu_si128((const __m128i*)(un + x))));
+    cv = _mm_avg_epu8(cv, _mm_avg_epu8(cv, _mm_loadu_si128((const __m128i*)(vn + x))));
+    __m128i y0  = _mm_loadu_si128((const __m128i*)(y + 2 * x));
+    __m128i y1  = _mm_loadu_si128((const __m128i*)(y + 2 * x + 16));
+    __m128i uv0 = _mm_unpacklo_epi8(cu, cv);
+    __m128i uv1 = _mm_unpackhi_epi8(cu, cv);
+    uint8_t* d = dst + 4 * x;
+    if (uyvy)
+    {
+      _mm_storeu_si128((__m128i*)(d)     , _mm_unpacklo_epi8(uv0, y0));
+      _mm_storeu_si128((__m128i*)(d + 16), _mm_unpackhi_epi8(uv0, y0));
+      _mm_storeu_si128((__m128i*)(d + 32), _mm_unpacklo_epi8(uv1, y1));
+      _mm_storeu_si128((__m128i*)(d + 48), _mm_unpackhi_epi8(uv1, y1));
+    }
+    else
+    {
+      _mm_storeu_si128((__m128i*)(d)     , _mm_unpacklo_epi8(y0, uv0));
+      _mm_storeu_si128((__m128i*)(d + 16), _mm_unpackhi_epi8(y0, uv0));
+      _mm_storeu_si128((__m128i*)(d + 32), _mm_unpacklo_epi8(y1, uv1));
+      _mm_storeu_si128((__m128i*)(d + 48), _mm_unpackhi_epi8(y1, uv1));
+    }
+  }
+  PackRow_C(dst + 4 * x, y + 2 * x, u + x, v + x, un + x, vn + x, pairs - x, uyvy);
+}
+#endif
+
+#ifdef HAS_AVX2_KERNELS
+TARGET_AVX2 static void CopyRow_AVX2(uint8_t* dst, const uint8_t* src, int bytes)
+{
+  int x = 0;
+  for (; x + 128 <= bytes; x += 128)
+  {
+    __m256i a = _mm256_loadu_si256((const __m256i*)(src + x));
+    __m256i b = _mm256_loadu_si256((const __m256i*)(src + x + 32));
+    __m256i c = _mm256_loadu_si256((const __m256i*)(src + x + 64));
+    __m256i d = _mm256_loadu_si256((const __m256i*)(src + x + 96));
+    _mm256_storeu_si256((__m256i*)(dst + x)     , a);
+    _mm256_storeu_si256((__m256i*)(dst + x + 32), b);
+    _mm256_storeu_si256((__m256i*)(dst + x + 64), c);
+    _mm256_storeu_si256((__m256i*)(dst + x + 96), d);
+  }
+  if (x < bytes)
+    memcpy(dst + x, src + x, bytes - x);
+}
+
+TARGET_AVX2 static void StreamRow_AVX2(uint8_t* dst, const uint8_t* src, int bytes)
+{
+  int x = (32 - ((uintptr_t)dst & 31)) & 31;
+  if (x > bytes)
+    x = bytes;
+  memcpy(dst, src, x);
+
+  for (; x + 128 <= bytes; x += 128)
+  {
+    __m256i a = _mm256_loadu_si256((const __m256i*)(src + x));
+    __m256i b = _mm256_loadu_si256((const __m256i*)(src + x + 32));
+    __m256i c = _mm256_loadu_si256((const __m256i*)(src + x + 64));
+    __m256i d = _mm256_loadu_si256((const __m256i*)(src + x + 96));
+    _mm256_stream_si256((__m256i*)(dst + x)     , a);
+    _mm256_stream_si256((__m256i*)(dst + x + 32), b);
+    _mm256_stream_si256((__m256i*)(dst + x + 64), c);
+    _mm256_stream_si256((__m256i*)(dst + x + 96), d);
+  }
+  for (; x + 32 <= bytes; x += 32)
+    _mm256_stream_si256((__m256i*)(dst + x), _mm256_loadu_si256((const __m256i*)(src + x)));
+  if (x < bytes)
+    memcpy(dst + x, src + x, bytes - x);
+  _mm_sfence();
+}
+
+TARGET_AVX2 static void InterleaveRow_AVX2(uint8_t* dst, const uint8_t* u, const uint8_t* v, int width)
+{
+  int x = 0;
+  for (; x + 32 <= width; x += 32)
+  {
+    __m256i cu = _mm256_loadu_si256((const __m256i*)(u + x));
+    __m256i cv = _mm256_loadu_si256((const __m256i*)(v + x));
+    // unpack works within 128 bit lanes, put the lanes back in order
+    __m256i lo = _mm256_unpacklo_epi8(cu, cv);
+    __m256i hi = _mm256_unpackhi_epi8(cu, cv);
+    _mm256_storeu_si256((__m256i*)(dst + 2 * x)     , _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256((__m256i*)(dst + 2 * x + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+  }
+  InterleaveRow_C(dst + 2 * x, u + x, v + x, width - x);
+}
+
+TARGET_AVX2 static void PackRow_AVX2(uint8_t* dst, const uint8_t* y, const uint8_t* u, const uint8_t* v, const uint8_t* un, const uint8_t* vn, int pairs, bool uyvy)
+{
+  int x = 0;
+  for (; x + 32 <= pairs; x += 32)
+  {
+    __m256i cu = _mm256_loadu_si256((const __m256i*)(u + x));
+    __m256i cv = _mm256_loadu_si256((const __m256i*)(v + x));
+    cu = _mm256_avg_epu8(cu, _mm256_avg_epu8(cu, _mm256_loadu_si256((const __m256i*)(un + x))));
+    cv = _mm256_avg_epu8(cv, _mm256_avg_epu8(cv, _mm256_loadu_si256((const __m256i*)(vn + x))));
+    __m256i y0 = _mm256_loadu_si256((const __m256i*)(y + 2 * x));
+    __m256i y1 = _mm256_loadu_si256((const __m256i*)(y + 2 * x + 32));
+    __m256i lo = _mm256_unpacklo_epi8(cu, cv);
+    __m256i hi = _mm256_unpackhi_epi8(cu, cv);
+    __m256i uv0 = _mm256_permute2x128_si256(lo, hi, 0x20);
+    __m256i uv1 = _mm256_permute2x128_si256(lo, hi, 0x31);
+    __m256i p0, p1, p2, p3;
+    if (uyvy)
+    {
+      p0 = _mm256_unpacklo_epi8(uv0, y0);
+      p1 = _mm256_unpackhi_epi8(uv0, y0);
+      p2 = _mm256_unpacklo_epi8(uv1, y1);
+      p3 = _mm256_unpackhi_epi8(uv1, y1);
+    }
+    else
+    {
+      p0 = _mm256_unpacklo_epi8(y0, uv0);
+      p1 = _mm256_unpackhi_epi8(y0, uv0);
+      p2 = _mm256_unpacklo_epi8(y1, uv1);
+      p3 = _mm256_unpackhi_epi8(y1, uv1);
+    }
+    uint8_t* d = dst + 4 * x;
+    _mm256_storeu_si256((__m256i*)(d)     , _mm256_permute2x128_si256(p0, p1, 0x20));
+    _mm256_storeu_si256((__m256i*)(d + 32), _mm256_permute2x128_si256(p0, p1, 0x31));
+    _mm256_storeu_si256((__m256i*)(d + 64), _mm256_permute2x128_si256(p2, p3, 0x20));
+    _mm256_storeu_si256((__m256i*)(d + 96), _mm256_permute2x128_si256(p2, p3, 0x31));
+  }
+  PackRow_C(dst + 4 * x, y + 2 * x, u + x, v + x, un + x, vn + x, pairs - x, uyvy);
+}
+#endif
+
+struct PlaneKernels
+{
+  CopyRowFunc       copy;
+  CopyRowFunc       stream;
+  InterleaveRowFunc interleave;
+  PackRowFunc       pack;
+};
+
+static PlaneKernels SelectKernels(unsigned int features)
+{
+  PlaneKernels k = { CopyRow_C, CopyRow_C, InterleaveRow_C, PackRow_C };
+#ifdef __SSE2__
+  if (features & CPU_FEATURE_SSE2)
+  {
+    k.copy       = CopyRow_SSE2;
+    k.stream     = StreamRow_SSE2;
+    k.interleave = InterleaveRow_SSE2;
+    k.pack       = PackRow_SSE2;
+  }
+#endif
+#ifdef HAS_AVX2_KERNELS
+  if (features & CPU_FEATURE_AVX2)
+  {
+    k.copy       = CopyRow_AVX2;
+    k.stream     = StreamRow_AVX2;
+    k.interleave = InterleaveRow_AVX2;
+    k.pack       = PackRow_AVX2;
+  }
+#endif
+  return k;
+}
+
+static PlaneKernels& Kernels()
+{
+  static PlaneKernels kernels = SelectKernels(g_cpuInfo.GetCPUFeatures());
+  return kernels;
+}
+
+void CDVDCodecUtils::SetCPUFeatures(unsigned int features)
+{
+  Kernels() = SelectKernels(features);
+}
+
+void CDVDCodecUtils::CopyPlane(uint8_t* dst, int dstStride, const uint8_t* src, int srcStride, int width, int height)
+{
+  if (width <= 0 || height <= 0)
+    return;
+
+  const PlaneKernels& k = Kernels();
+  CopyRowFunc copy = width * height >= STREAM_THRESHOLD ? k.stream : k.copy;
+
+  if (width == srcStride && width == dstStride)
+  {
+    copy(dst, src, width * height);
+    return;
+  }
+
+  for (int y = 0; y < height; y++)
+  {
+    copy(dst, src, width);
+    src += srcStride;
+    dst += dstStride;
+  }
+}
+
+void CDVDCodecUtils::InterleavePlanes(uint8_t* dst, int dstStride, const uint8_t* u, int uStride, const uint8_t* v, int vStride, int width, int height)
+{
+  InterleaveRowFunc interleave = Kernels().interleave;
+  for (int y = 0; y < height; y++)
+  {
+    interleave(dst, u, v, width);
+    dst += dstStride;
+    u   += uStride;
+    v   += vStride;
+  }
+}
+
+void CDVDCodecUtils::PackYUV422(uint8_t* dst, int dstStride, const uint8_t* y, int yStride, const uint8_t* u, int uStride, const uint8_t* v, int vStride, int width, int height, bool uyvy)
+{
+  // chroma sits between two luma rows, so each row takes its chroma mostly from the
+  // nearest chroma row and the rest from the one above or below, rather than repeating it
+  PackRowFunc pack = Kernels().pack;
+  int last = (height - 1) >> 1;
+  for (int row = 0; row < height; row++)
+  {
+    int c = row >> 1;
+    int n = row & 1 ? std::min(c + 1, last) : std::max(c - 1, 0);
+    pack(dst, y, u + c * uStride, v + c * vStride, u + n * uStride, v + n * vStride, width >> 1, uyvy);
+    dst += dstStride;
+    y   += yStride;
+  }
 }
 
 // allocate a new picture (PIX_FMT_YUV420P)
@@ -82,94 +431,29 @@ void CDVDCodecUtils::FreePicture(DVDVideoPicture* pPicture)
 
 bool CDVDCodecUtils::CopyPicture(DVDVideoPicture* pDst, DVDVideoPicture* pSrc)
 {
-  uint8_t *s, *d;
   int w = pSrc->iWidth;
   int h = pSrc->iHeight;
 
-  s = pSrc->data[0];
-  d = pDst->data[0];
-
-  for (int y = 0; y < h; y++)
-  {
-    fast_memcpy(d, s, w);
-    s += pSrc->iLineSize[0];
-    d += pDst->iLineSize[0];
-  }
+  CopyPlane(pDst->data[0], pDst->iLineSize[0], pSrc->data[0], pSrc->iLineSize[0], w, h);
 
   w >>= 1;
   h >>= 1;
 
-  s = pSrc->data[1];
-  d = pDst->data[1];
-  for (int y = 0; y < h; y++)
-  {
-    fast_memcpy(d, s, w);
-    s += pSrc->iLineSize[1];
-    d += pDst->iLineSize[1];
-  }
-
-  s = pSrc->data[2];
-  d = pDst->data[2];
-  for (int y = 0; y < h; y++)
-  {
-    fast_memcpy(d, s, w);
-    s += pSrc->iLineSize[2];
-    d += pDst->iLineSize[2];
-  }
+  CopyPlane(pDst->data[1], pDst->iLineSize[1], pSrc->data[1], pSrc->iLineSize[1], w, h);
+  CopyPlane(pDst->data[2], pDst->iLineSize[2], pSrc->data[2], pSrc->iLineSize[2], w, h);
   return true;
 }
 
 bool CDVDCodecUtils::CopyPicture(YV12Image* pImage, DVDVideoPicture *pSrc)
 {
-  uint8_t *s = pSrc->data[0];
-  uint8_t *d = pImage->plane[0];
   int w = pImage->width * pImage->bpp;
   int h = pImage->height;
-  if ((w == pSrc->iLineSize[0]) && ((unsigned int) pSrc->iLineSize[0] == pImage->stride[0]))
-  {
-    fast_memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[0];
-      d += pImage->stride[0];
-    }
-  }
-  s = pSrc->data[1];
-  d = pImage->plane[1];
+  CopyPlane(pImage->plane[0], pImage->stride[0], pSrc->data[0], pSrc->iLineSize[0], w, h);
+
   w =(pImage->width  >> pImage->cshift_x) * pImage->bpp;
   h =(pImage->height >> pImage->cshift_y);
-  if ((w==pSrc->iLineSize[1]) && ((unsigned int) pSrc->iLineSize[1]==pImage->stride[1]))
-  {
-    fast_memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[1];
-      d += pImage->stride[1];
-    }
-  }
-  s = pSrc->data[2];
-  d = pImage->plane[2];
-  if ((w==pSrc->iLineSize[2]) && ((unsigned int) pSrc->iLineSize[2]==pImage->stride[2]))
-  {
-    fast_memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[2];
-      d += pImage->stride[2];
-    }
-  }
+  CopyPlane(pImage->plane[1], pImage->stride[1], pSrc->data[1], pSrc->iLineSize[1], w, h);
+  CopyPlane(pImage->plane[2], pImage->stride[2], pSrc->data[2], pSrc->iLineSize[2], w, h);
   return true;
 }
 
@@ -199,26 +483,13 @@ DVDVideoPicture* CDVDCodecUtils::ConvertToNV12Picture(DVDVideoPicture *pSrc)
       pPicture->format = RENDER_FMT_NV12;
       
       // copy luma
-      uint8_t *s = pSrc->data[0];
-      uint8_t *d = pPicture->data[0];
-      for (int y = 0; y < (int)pSrc->iHeight; y++)
-      {
-        fast_memcpy(d, s, pSrc->iWidth);
-        s += pSrc->iLineSize[0];
-        d += pPicture->iLineSize[0];
-      }
+      CopyPlane(pPicture->data[0], pPicture->iLineSize[0], pSrc->data[0], pSrc->iLineSize[0], pSrc->iWidth, pSrc->iHeight);
 
       //copy chroma
-      for (int y = 0; y < (int)pSrc->iHeight/2; y++) {
-        uint8_t *s_u = pSrc->data[1] + (y * pSrc->iLineSize[1]);
-        uint8_t *s_v = pSrc->data[2] + (y * pSrc->iLineSize[2]);
-        uint8_t *d_uv = pPicture->data[1] + (y * pPicture->iLineSize[1]);
-        for (int x = 0; x < (int)pSrc->iWidth/2; x++) {
-          *d_uv++ = *s_u++;
-          *d_uv++ = *s_v++;
-        }
-      }
-      
+      InterleavePlanes(pPicture->data[1], pPicture->iLineSize[1],
+                       pSrc->data[1], pSrc->iLineSize[1],
+                       pSrc->data[2], pSrc->iLineSize[2],
+                       pSrc->iWidth / 2, pSrc->iHeight / 2);
     }
     else
     {
@@ -253,27 +524,12 @@ DVDVideoPicture* CDVDCodecUtils::ConvertToYUV422PackedPicture(DVDVideoPicture *p
       pPicture->iLineSize[3] = 0;
       pPicture->format = format;
 
-      //if this is going to be used for anything else than testing the renderer
-      //the library should not be loaded on every function call
-      {
-        // Perform the scaling.
-        uint8_t* src[] =       { pSrc->data[0],          pSrc->data[1],      pSrc->data[2],      NULL };
-        int      srcStride[] = { pSrc->iLineSize[0],     pSrc->iLineSize[1], pSrc->iLineSize[2], 0    };
-        uint8_t* dst[] =       { pPicture->data[0],      NULL,               NULL,               NULL };
-        int      dstStride[] = { pPicture->iLineSize[0], 0,                  0,                  0    };
-
-        int dstformat;
-        if (format == RENDER_FMT_UYVY422)
-          dstformat = PIX_FMT_UYVY422;
-        else
-          dstformat = PIX_FMT_YUYV422;
-
-        struct SwsContext *ctx = sws_getContext(pSrc->iWidth, pSrc->iHeight, PIX_FMT_YUV420P,
-                                                           pPicture->iWidth, pPicture->iHeight, (AVPixelFormat)dstformat,
-                                                           SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
-        sws_scale(ctx, src, srcStride, 0, pSrc->iHeight, dst, dstStride);
-        sws_freeContext(ctx);
-      }
+      // chroma lines are repeated, no interpolation
+      PackYUV422(pPicture->data[0], pPicture->iLineSize[0],
+                 pSrc->data[0], pSrc->iLineSize[0],
+                 pSrc->data[1], pSrc->iLineSize[1],
+                 pSrc->data[2], pSrc->iLineSize[2],
+                 pSrc->iWidth, pSrc->iHeight, format == RENDER_FMT_UYVY422);
     }
     else
     {
@@ -287,69 +543,20 @@ DVDVideoPicture* CDVDCodecUtils::ConvertToYUV422PackedPicture(DVDVideoPicture *p
 
 bool CDVDCodecUtils::CopyNV12Picture(YV12Image* pImage, DVDVideoPicture *pSrc)
 {
-  uint8_t *s = pSrc->data[0];
-  uint8_t *d = pImage->plane[0];
-  int w = pSrc->iWidth;
-  int h = pSrc->iHeight;
   // Copy Y
-  if ((w == pSrc->iLineSize[0]) && ((unsigned int) pSrc->iLineSize[0] == pImage->stride[0]))
-  {
-    fast_memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[0];
-      d += pImage->stride[0];
-    }
-  }
-  
-  s = pSrc->data[1];
-  d = pImage->plane[1];
-  w = pSrc->iWidth;
-  h = pSrc->iHeight >> 1;
+  CopyPlane(pImage->plane[0], pImage->stride[0], pSrc->data[0], pSrc->iLineSize[0], pSrc->iWidth, pSrc->iHeight);
+
   // Copy packed UV (width is same as for Y as it's both U and V components)
-  if ((w==pSrc->iLineSize[1]) && ((unsigned int) pSrc->iLineSize[1]==pImage->stride[1]))
-  {
-    fast_memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[1];
-      d += pImage->stride[1];
-    }
-  }
+  CopyPlane(pImage->plane[1], pImage->stride[1], pSrc->data[1], pSrc->iLineSize[1], pSrc->iWidth, pSrc->iHeight >> 1);
 
   return true;
 }
 
 bool CDVDCodecUtils::CopyYUV422PackedPicture(YV12Image* pImage, DVDVideoPicture *pSrc)
 {
-  uint8_t *s = pSrc->data[0];
-  uint8_t *d = pImage->plane[0];
-  int w = pSrc->iWidth;
-  int h = pSrc->iHeight;
-
   // Copy YUYV
-  if ((w * 2 == pSrc->iLineSize[0]) && ((unsigned int) pSrc->iLineSize[0] == pImage->stride[0]))
-  {
-    fast_memcpy(d, s, w*h*2);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w*2);
-      s += pSrc->iLineSize[0];
-      d += pImage->stride[0];
-    }
-  }
-  
+  CopyPlane(pImage->plane[0], pImage->stride[0], pSrc->data[0], pSrc->iLineSize[0], pSrc->iWidth * 2, pSrc->iHeight);
+
   return true;
 }
 
@@ -369,13 +576,7 @@ bool CDVDCodecUtils::CopyDXVA2Picture(YV12Image* pImage, DVDVideoPicture *pSrc)
 
         // Copy Y
         uint8_t* bits = (uint8_t*)(rectangle.pBits);
-        uint8_t* d = pImage->plane[0];
-        for (unsigned y = 0; y < pSrc->iHeight; y++)
-        {
-          memcpy(d, bits, pSrc->iWidth);
-          bits += rectangle.Pitch;
-          d += pImage->stride[0];
-        }
+        CopyPlane(pImage->plane[0], pImage->stride[0], bits, rectangle.Pitch, pSrc->iWidth, pSrc->iHeight);
 
         D3DSURFACE_DESC desc;
         if (FAILED(surface->GetDesc(&desc)))
@@ -383,13 +584,7 @@ bool CDVDCodecUtils::CopyDXVA2Picture(YV12Image* pImage, DVDVideoPicture *pSrc)
         
         // Copy packed UV
         uint8_t *s_uv = ((uint8_t*)(rectangle.pBits)) + desc.Height * rectangle.Pitch;
-        uint8_t *d_uv = pImage->plane[1];
-        for (unsigned y = 0; y < pSrc->iHeight >> 1; y++)
-        {
-          memcpy(d_uv, s_uv, pSrc->iWidth);
-          s_uv += rectangle.Pitch;
-          d_uv += pImage->stride[1];
-        }
+        CopyPlane(pImage->plane[1], pImage->stride[1], s_uv, rectangle.Pitch, pSrc->iWidth, pSrc->iHeight >> 1);
 
         if (FAILED(surface->UnlockRect()))
           return false;
@@ -39,6 +39,15 @@ public:
   static bool CopyYUV422PackedPicture(YV12Image* pImage, DVDVideoPicture *pSrc);
   static bool CopyDXVA2Picture(YV12Image* pImage, DVDVideoPicture *pSrc);
 
+  /* plane kernels used by the functions above, width is in bytes for CopyPlane
+   * and in pixels for the others. PackYUV422 interpolates 4:2:0 chroma between rows */
+  static void CopyPlane(uint8_t* dst, int dstStride, const uint8_t* src, int srcStride, int width, int height);
+  static void InterleavePlanes(uint8_t* dst, int dstStride, const uint8_t* u, int uStride, const uint8_t* v, int vStride, int width, int height);
+  static void PackYUV422(uint8_t* dst, int dstStride, const uint8_t* y, int yStride, const uint8_t* u, int uStride, const uint8_t* v, int vStride, int width, int height, bool uyvy);
+
+  /* pick the plane kernels for the given CPU_FEATURE_ flags instead of the cpu's own */
+  static void SetCPUFeatures(unsigned int features);
+
   static bool IsVP3CompatibleWidth(int width);
 
   static double NormalizeFrameduration(double frameduration);
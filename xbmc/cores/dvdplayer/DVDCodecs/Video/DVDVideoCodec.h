@@ -97,6 +97,8 @@ struct DVDVideoPicture
     };
   };
 
+  AVFrame* frame; // refcounted decoder frame owning data, only valid with DVP_FLAG_FRAMEREF
+
   unsigned int iFlags;
 
   double       iRepeatPicture;
@@ -128,6 +130,15 @@ struct DVDVideoUserData
   int size;
 };
 
+struct DVDVideoDecodeStats
+{
+  double decodeTime;   // average time spent decoding a packet, ms
+  double peakTime;     // slowest recent packet, ms
+  double frameTime;    // duration of a frame, ms
+  int    threads;      // decoder threads, 0 if unknown
+  bool   frameThreads; // frame threading, otherwise slice threading
+};
+
 #define DVP_FLAG_TOP_FIELD_FIRST    0x00000001
 #define DVP_FLAG_REPEAT_TOP_FIELD   0x00000002 //Set to indicate that the top field should be repeated
 #define DVP_FLAG_ALLOCATED          0x00000004 //Set to indicate that this has allocated data
@@ -135,6 +146,7 @@ struct DVDVideoUserData
 
 #define DVP_FLAG_NOSKIP             0x00000010 // indicate this picture should never be dropped
 #define DVP_FLAG_DROPPED            0x00000020 // indicate that this picture has been dropped in decoder stage, will have no data
+#define DVP_FLAG_FRAMEREF           0x00000040 // renderer may keep a reference to frame instead of copying data
 
 // DVP_FLAG 0x00000100 - 0x00000f00 is in use by libmpeg2!
 
@@ -277,6 +289,12 @@ public:
    */
   virtual unsigned GetAllowedReferences() { return 0; }
 
+  /**
+   * Decode timing for the codec info overlay, returns false if the
+   * codec does not measure it
+   */
+  virtual bool GetDecodeStats(DVDVideoDecodeStats &stats) { return false; }
+
   /**
    * Hide or Show Settings depending on the currently running hardware 
    *
@@ -38,6 +38,11 @@
 #include "utils/log.h"
 #include "boost/shared_ptr.hpp"
 #include "threads/Atomics.h"
+#include "threads/SingleLock.h"
+#include "utils/TimeUtils.h"
+
+#include <map>
+#include <math.h>
 
 #ifndef TARGET_POSIX
 #define RINT(x) ((x) >= 0 ? ((int)((x) + 0.5)) : ((int)((x) - 0.5)))
@@ -72,6 +77,32 @@ extern "C" {
 
 using namespace boost;
 
+#define MAX_DECODE_THREADS     16  // what lavc supports for frame threading
+#define LIVE_FRAME_THREADS     2   // every frame thread delays output by one frame
+#define THREAD_BUDGET_INTERVAL 250 // packets between thread budget updates
+#define THREAD_BUDGET_LOAD     0.6 // fraction of the frame time decoding may take
+
+/* Thread counts learned from previous streams, by codec and size class. Changing
+ * the thread count needs a reopen of the codec, so it is applied with the next
+ * stream of the same kind, e.g. the next episode or channel. */
+static std::map<int, int> g_threadBudget;
+static CCriticalSection   g_threadBudgetSection;
+
+static int ThreadBudgetKey(AVCodecID codec, int width, int height)
+{
+  int size = width * height;
+  int sizeClass;
+  if (size <= 720 * 576)
+    sizeClass = 0;
+  else if (size <= 1280 * 720)
+    sizeClass = 1;
+  else if (size <= 1920 * 1088)
+    sizeClass = 2;
+  else
+    sizeClass = 3;
+  return (int)codec * 4 + sizeClass;
+}
+
 enum PixelFormat CDVDVideoCodecFFmpeg::GetFormat( struct AVCodecContext * avctx
                                                 , const PixelFormat * fmt )
 {
@@ -167,6 +198,12 @@ CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg() : CDVDVideoCodec()
   m_iLastKeyframe = 0;
   m_dts = DVD_NOPTS_VALUE;
   m_started = false;
+  m_threadBudgetKey = -1;
+  m_frameTime = 0.0;
+  m_decodeTime = 0.0;
+  m_decodePeak = 0.0;
+  m_decodeCount = 0;
+  m_dropping = false;
 }
 
 CDVDVideoCodecFFmpeg::~CDVDVideoCodecFFmpeg()
@@ -233,25 +270,7 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   m_pCodecContext->workaround_bugs = FF_BUG_AUTODETECT;
   m_pCodecContext->get_format = GetFormat;
   m_pCodecContext->codec_tag = hints.codec_tag;
-  /* Only allow slice threading, since frame threading is more
-   * sensitive to changes in frame sizes, and it causes crashes
-   * during HW accell - so we unset it in this case.
-   *
-   * When we detect a pure SW codec and user did not disable SWmultithreading
-   * via advancedsettings.xml we keep the ffmpeg default thread type.
-   * */
-  if(m_isSWCodec && !g_advancedSettings.m_videoDisableSWMultithreading)
-  {
-    CLog::Log(LOGDEBUG,"CDVDVideoCodecFFmpeg::Open() Keep default threading for swcodec: %d",
-                        m_pCodecContext->thread_type);
-  }
-  else if ((EDECODEMETHOD) CSettings::Get().GetInt("videoplayer.decodingmethod") == VS_DECODEMETHOD_SOFTWARE && CSettings::Get().GetBool("videoplayer.useframemtdec"))
-  {
-    CLog::Log(LOGDEBUG,"CDVDVideoCodecFFmpeg::Open() Keep default threading %d by videoplayer.useframemtdec",
-                        m_pCodecContext->thread_type);
-  }
-  else
-    m_pCodecContext->thread_type = FF_THREAD_SLICE;
+  SetupThreading(pCodec, hints);
 
 #if defined(TARGET_DARWIN_IOS)
   // ffmpeg with enabled neon will crash and burn if this is enabled
@@ -291,12 +310,8 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
       av_opt_set(m_pCodecContext, it->m_name.c_str(), it->m_value.c_str(), 0);
   }
 
-  int num_threads = std::min(8 /*MAX_THREADS*/, g_cpuInfo.getCPUCount());
-  if( num_threads > 1 && !hints.software && m_pHardware == NULL // thumbnail extraction fails when run threaded
-  && ( pCodec->id == AV_CODEC_ID_H264
-    || pCodec->id == AV_CODEC_ID_MPEG4
-    || pCodec->id == AV_CODEC_ID_HEVC))
-    m_pCodecContext->thread_count = num_threads;
+  // frames stay valid until we unref them, so the renderer can take a reference instead of a copy
+  m_pCodecContext->refcounted_frames = 1;
 
   if (avcodec_open2(m_pCodecContext, pCodec, NULL) < 0)
   {
@@ -304,6 +319,12 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     return false;
   }
 
+  CLog::Log(LOGDEBUG,"CDVDVideoCodecFFmpeg::Open() Using %d %s threads", m_pCodecContext->thread_count,
+                      m_pCodecContext->active_thread_type == FF_THREAD_FRAME ? "frame" : "slice");
+
+  if (hints.fpsrate > 0 && hints.fpsscale > 0)
+    m_frameTime = 1000.0 * hints.fpsscale / hints.fpsrate;
+
   m_pFrame = av_frame_alloc();
   if (!m_pFrame) return false;
 
@@ -314,10 +335,119 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   return true;
 }
 
+void CDVDVideoCodecFFmpeg::SetupThreading(AVCodec* pCodec, const CDVDStreamInfo &hints)
+{
+  /* Only allow slice threading, since frame threading is more
+   * sensitive to changes in frame sizes, and it causes crashes
+   * during HW accell.
+   *
+   * Frame threading is used for pure SW codecs unless the user disabled
+   * SWmultithreading via advancedsettings.xml, and when the user asked
+   * for it with software decoding. Live streams prefer slice threading
+   * where the codec has it, frame threading adds a frame of delay per thread.
+   * */
+  bool frameThreads = false;
+  if(m_isSWCodec && !g_advancedSettings.m_videoDisableSWMultithreading)
+    frameThreads = true;
+  else if ((EDECODEMETHOD) CSettings::Get().GetInt("videoplayer.decodingmethod") == VS_DECODEMETHOD_SOFTWARE && CSettings::Get().GetBool("videoplayer.useframemtdec"))
+    frameThreads = true;
+
+  if (!(pCodec->capabilities & CODEC_CAP_FRAME_THREADS))
+    frameThreads = false;
+  else if (frameThreads && hints.realtime && (pCodec->capabilities & CODEC_CAP_SLICE_THREADS))
+    frameThreads = false;
+
+  m_pCodecContext->thread_type = frameThreads ? FF_THREAD_FRAME : FF_THREAD_SLICE;
+
+  // thumbnail extraction fails when run threaded
+  if (hints.software
+  || ( pCodec->id != AV_CODEC_ID_H264
+    && pCodec->id != AV_CODEC_ID_MPEG4
+    && pCodec->id != AV_CODEC_ID_HEVC))
+    return;
+
+  int maxThreads = std::min(MAX_DECODE_THREADS, g_cpuInfo.getCPUCount());
+  int threads;
+
+  m_threadBudgetKey = ThreadBudgetKey(pCodec->id, hints.width, hints.height);
+  CSingleLock lock(g_threadBudgetSection);
+  std::map<int, int>::const_iterator it = g_threadBudget.find(m_threadBudgetKey);
+  if (it != g_threadBudget.end())
+    threads = it->second;
+  else if (hints.width * hints.height > 1920 * 1088)
+    threads = maxThreads;
+  else
+    threads = 8;
+  lock.Leave();
+
+  if (frameThreads && hints.realtime)
+    threads = std::min(threads, LIVE_FRAME_THREADS);
+
+  threads = std::max(1, std::min(threads, maxThreads));
+  if (threads > 1)
+    m_pCodecContext->thread_count = threads;
+}
+
+void CDVDVideoCodecFFmpeg::UpdateDecodeStats(double time)
+{
+  if (m_decodeCount == 0)
+  {
+    m_decodeTime = time;
+    m_decodePeak = time;
+  }
+  else
+  {
+    m_decodeTime = m_decodeTime * 0.95 + time * 0.05;
+    m_decodePeak = std::max(time, m_decodePeak * 0.99);
+  }
+
+  if (++m_decodeCount % THREAD_BUDGET_INTERVAL == 0)
+    UpdateThreadBudget();
+}
+
+void CDVDVideoCodecFFmpeg::UpdateThreadBudget()
+{
+  // hardware decoding and dropped frames say nothing about the threads needed
+  if (m_threadBudgetKey < 0 || m_pHardware || m_dropping || m_frameTime <= 0.0)
+    return;
+
+  int threads = std::max(1, m_pCodecContext->thread_count);
+  int maxThreads = std::min(MAX_DECODE_THREADS, g_cpuInfo.getCPUCount());
+  int wanted = (int)ceil(threads * m_decodeTime / (m_frameTime * THREAD_BUDGET_LOAD));
+  wanted = std::max(1, std::min(wanted, maxThreads));
+
+  // only give threads back when far below budget, so the count does not flip between streams
+  if (wanted < threads && wanted > threads / 2)
+    wanted = threads;
+
+  CSingleLock lock(g_threadBudgetSection);
+  std::map<int, int>::iterator it = g_threadBudget.find(m_threadBudgetKey);
+  if (it != g_threadBudget.end() && it->second == wanted)
+    return;
+  if (it == g_threadBudget.end() && wanted == threads)
+    return;
+
+  CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg::UpdateThreadBudget - decoding takes %.1fms of %.1fms with %d threads, using %d for the next stream",
+            m_decodeTime, m_frameTime, threads, wanted);
+  g_threadBudget[m_threadBudgetKey] = wanted;
+}
+
+bool CDVDVideoCodecFFmpeg::GetDecodeStats(DVDVideoDecodeStats &stats)
+{
+  if (!m_pCodecContext || m_decodeCount == 0)
+    return false;
+
+  stats.decodeTime = m_decodeTime;
+  stats.peakTime = m_decodePeak;
+  stats.frameTime = m_frameTime;
+  stats.threads = m_pCodecContext->thread_count;
+  stats.frameThreads = m_pCodecContext->active_thread_type == FF_THREAD_FRAME;
+  return true;
+}
+
 void CDVDVideoCodecFFmpeg::Dispose()
 {
-  if (m_pFrame) av_free(m_pFrame);
-  m_pFrame = NULL;
+  av_frame_free(&m_pFrame);
 
   av_frame_free(&m_pFilterFrame);
 
@@ -340,6 +470,7 @@ void CDVDVideoCodecFFmpeg::Dispose()
 
 void CDVDVideoCodecFFmpeg::SetDropState(bool bDrop)
 {
+  m_dropping = bDrop;
   if( m_pCodecContext )
   {
     // i don't know exactly how high this should be set
@@ -469,7 +600,11 @@ int CDVDVideoCodecFFmpeg::Decode(uint8_t* pData, int iSize, double dts, double p
   /* We lie, but this flag is only used by pngdec.c.
    * Setting it correctly would allow CorePNG decoding. */
   avpkt.flags = AV_PKT_FLAG_KEY;
+  av_frame_unref(m_pFrame);
+  int64_t start = CurrentHostCounter();
   len = avcodec_decode_video2(m_pCodecContext, m_pFrame, &iGotPicture, &avpkt);
+  if (pData)
+    UpdateDecodeStats((double)(CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency());
 
   if(m_iLastKeyframe < m_pCodecContext->has_b_frames + 2)
     m_iLastKeyframe = m_pCodecContext->has_b_frames + 2;
@@ -664,6 +799,12 @@ bool CDVDVideoCodecFFmpeg::GetPicture(DVDVideoPicture* pDvdVideoPicture)
   pDvdVideoPicture->iFlags |= pDvdVideoPicture->data[0] ? 0 : DVP_FLAG_DROPPED;
   pDvdVideoPicture->extended_format = 0;
 
+  if (pDvdVideoPicture->data[0] && m_pFrame->buf[0])
+  {
+    pDvdVideoPicture->frame   = m_pFrame;
+    pDvdVideoPicture->iFlags |= DVP_FLAG_FRAMEREF;
+  }
+
   PixelFormat pix_fmt;
   pix_fmt = (PixelFormat)m_pFrame->format;
 
@@ -67,6 +67,7 @@ public:
   virtual const char* GetName() { return m_name.c_str(); }; // m_name is never changed after open
   virtual unsigned GetConvergeCount();
   virtual unsigned GetAllowedReferences();
+  virtual bool GetDecodeStats(DVDVideoDecodeStats &stats);
 
   bool               IsHardwareAllowed()                     { return !m_bSoftware; }
   IHardwareDecoder * GetHardware()                           { return m_pHardware; };
@@ -80,6 +81,10 @@ public:
 protected:
   static enum PixelFormat GetFormat(struct AVCodecContext * avctx, const PixelFormat * fmt);
 
+  void SetupThreading(AVCodec* pCodec, const CDVDStreamInfo &hints);
+  void UpdateDecodeStats(double time);
+  void UpdateThreadBudget();
+
   int  FilterOpen(const CStdString& filters, bool scale);
   void FilterClose();
   int  FilterProcess(AVFrame* frame);
@@ -122,4 +127,11 @@ protected:
   double m_dts;
   bool   m_started;
   std::vector<PixelFormat> m_formats;
+
+  int          m_threadBudgetKey;
+  double       m_frameTime;   // ms, 0 if unknown
+  double       m_decodeTime;  // ms, moving average
+  double       m_decodePeak;
+  unsigned int m_decodeCount;
+  bool         m_dropping;
 };
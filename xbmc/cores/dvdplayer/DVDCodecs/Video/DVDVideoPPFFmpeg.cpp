@@ -139,7 +139,7 @@ bool CDVDVideoPPFFmpeg::Process(DVDVideoPicture* pPicture)
                 pict_type); //m_pSource->iFrameType);
 
   //Copy frame information over to target, but make sure it is set as allocated should decoder have forgotten
-  m_pTarget->iFlags = m_pSource->iFlags | DVP_FLAG_ALLOCATED;
+  m_pTarget->iFlags = (m_pSource->iFlags | DVP_FLAG_ALLOCATED) & ~DVP_FLAG_FRAMEREF;
   if (m_deinterlace)
     m_pTarget->iFlags &= ~DVP_FLAG_INTERLACED;
   m_pTarget->iFrameType = m_pSource->iFrameType;
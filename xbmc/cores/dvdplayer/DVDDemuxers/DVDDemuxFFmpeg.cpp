@@ -153,6 +153,9 @@ CDVDDemuxFFmpeg::CDVDDemuxFFmpeg() : CDVDDemux()
   m_program = UINT_MAX;
   m_pkt.result = -1;
   memset(&m_pkt.pkt, 0, sizeof(AVPacket));
+  m_indexStream = -1;
+  m_indexLength = 0;
+  m_indexContiguous = false;
 }
 
 CDVDDemuxFFmpeg::~CDVDDemuxFFmpeg()
@@ -427,14 +430,71 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
 
   CreateStreams();
 
+  OpenIndex();
+
   return true;
 }
 
+void CDVDDemuxFFmpeg::OpenIndex()
+{
+  m_index.Clear();
+  m_index.SetWrapPeriod(0.0);
+  m_indexStream = -1;
+  m_indexContiguous = false;
+
+  // inputs seeking on their own, or not seekable at all
+  if (dynamic_cast<CDVDInputStream::ISeekTime*>(m_pInput)
+  ||  m_pInput->IsStreamType(DVDSTREAM_TYPE_FFMPEG)
+  ||  !m_pInput->Seek(0, SEEK_POSSIBLE)
+  ||  m_pInput->GetLength() <= 0)
+    return;
+
+  // containers where lavf has to search the file on every seek
+  const char *name = m_pFormatContext->iformat->name;
+  if (strcmp(name, "mpegts") != 0
+  &&  strcmp(name, "mpeg") != 0
+  &&  strcmp(name, "avi") != 0
+  &&  strcmp(name, "h264") != 0
+  &&  strcmp(name, "hevc") != 0
+  &&  strcmp(name, "mpegvideo") != 0
+  &&  strcmp(name, "vc1") != 0)
+    return;
+
+  for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
+  {
+    AVStream *stream = m_pFormatContext->streams[i];
+    if (stream->codec && stream->codec->codec_type == AVMEDIA_TYPE_VIDEO)
+    {
+      // avi with an idx1 chunk can be seeked in already
+      if (m_bAVI && stream->nb_index_entries > 0)
+        return;
+      m_indexStream = i;
+      if (stream->pts_wrap_bits > 0 && stream->pts_wrap_bits < 63)
+        m_index.SetWrapPeriod((double)(1LL << stream->pts_wrap_bits) * stream->time_base.num
+                              / stream->time_base.den * DVD_TIME_BASE);
+      break;
+    }
+  }
+  if (m_indexStream < 0)
+    return;
+
+  m_indexFile   = m_pInput->GetFileName();
+  m_indexLength = m_pInput->GetLength();
+  m_indexPath   = CDVDDemuxIndex::GetIndexPath(m_indexFile, m_indexLength);
+  if (m_index.Load(m_indexPath, m_indexFile, m_indexLength))
+    CLog::Log(LOGDEBUG, "%s - loaded %d keyframes from %s", __FUNCTION__, (int)m_index.Size(), m_indexPath.c_str());
+}
+
 void CDVDDemuxFFmpeg::Dispose()
 {
   m_pkt.result = -1;
   av_free_packet(&m_pkt.pkt);
 
+  if (m_indexStream >= 0 && m_index.IsDirty() && m_index.Save(m_indexPath, m_indexFile, m_indexLength))
+    CDVDDemuxIndex::Trim();
+  m_index.Clear();
+  m_indexStream = -1;
+
   if (m_pFormatContext)
   {
     if (m_ioContext && m_pFormatContext->pb && m_pFormatContext->pb != m_ioContext)
@@ -474,6 +534,7 @@ void CDVDDemuxFFmpeg::Flush()
     av_read_frame_flush(m_pFormatContext);
 
   m_iCurrentPts = DVD_NOPTS_VALUE;
+  m_indexContiguous = false;
 
   m_pkt.result = -1;
   av_free_packet(&m_pkt.pkt);
@@ -722,6 +783,17 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
         if (pPacket->dts != DVD_NOPTS_VALUE && (pPacket->dts > m_iCurrentPts || m_iCurrentPts == DVD_NOPTS_VALUE))
           m_iCurrentPts = pPacket->dts;
 
+        // remember where keyframes are for later seeks
+        if (m_pkt.pkt.stream_index == m_indexStream && (m_pkt.pkt.flags & AV_PKT_FLAG_KEY) && m_pkt.pkt.pos >= 0)
+        {
+          double ts = pPacket->pts != DVD_NOPTS_VALUE ? pPacket->pts : pPacket->dts;
+          if (ts != DVD_NOPTS_VALUE)
+          {
+            m_index.Add(ts, m_pkt.pkt.pos, m_indexContiguous);
+            m_indexContiguous = true;
+          }
+        }
+
 
         // check if stream has passed full duration, needed for live streams
         bool bAllowDurationExt = (stream->codec && (stream->codec->codec_type == AVMEDIA_TYPE_VIDEO || stream->codec->codec_type == AVMEDIA_TYPE_AUDIO));
@@ -834,13 +906,31 @@ bool CDVDDemuxFFmpeg::SeekTime(int time, bool backwords, double *startpts)
   if (m_pFormatContext->start_time != (int64_t)AV_NOPTS_VALUE)
     seek_pts += m_pFormatContext->start_time;
 
-  int ret;
+  int ret = -1;
   {
     CSingleLock lock(m_critSection);
-    ret = av_seek_frame(m_pFormatContext, -1, seek_pts, backwords ? AVSEEK_FLAG_BACKWARD : 0);
 
-    if(ret >= 0)
-      UpdateCurrentPTS();
+    // a byte seek to a known keyframe saves lavf searching the file
+    CDVDDemuxIndex::Entry entry;
+    bool indexed = false;
+    if (m_indexStream >= 0 && m_index.Lookup(DVD_MSEC_TO_TIME(time), backwords, entry))
+    {
+      ret = av_seek_frame(m_pFormatContext, -1, entry.pos, AVSEEK_FLAG_BYTE);
+      if (ret >= 0)
+      {
+        m_iCurrentPts = entry.pts;
+        indexed = true;
+      }
+    }
+
+    if (!indexed)
+    {
+      ret = av_seek_frame(m_pFormatContext, -1, seek_pts, backwords ? AVSEEK_FLAG_BACKWARD : 0);
+
+      if(ret >= 0)
+        UpdateCurrentPTS();
+    }
+    m_indexContiguous = false;
   }
 
   if(m_iCurrentPts == DVD_NOPTS_VALUE)
@@ -867,6 +957,12 @@ bool CDVDDemuxFFmpeg::SeekByte(int64_t pos)
   if(ret >= 0)
     UpdateCurrentPTS();
 
+  // byte seeks usually leave the time unknown until the next packet
+  CDVDDemuxIndex::Entry entry;
+  if (ret >= 0 && m_iCurrentPts == DVD_NOPTS_VALUE && m_indexStream >= 0 && m_index.LookupPos(pos, entry))
+    m_iCurrentPts = entry.pts;
+  m_indexContiguous = false;
+
   m_pkt.result = -1;
   av_free_packet(&m_pkt.pkt);
 
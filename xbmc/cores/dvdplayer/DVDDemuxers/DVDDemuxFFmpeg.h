@@ -21,6 +21,7 @@
  */
 
 #include "DVDDemux.h"
+#include "DVDDemuxIndex.h"
 #include "threads/CriticalSection.h"
 #include "threads/SystemClock.h"
 #include <map>
@@ -131,6 +132,7 @@ protected:
   double ConvertTimestamp(int64_t pts, int den, int num);
   void UpdateCurrentPTS();
   bool IsProgramChange();
+  void OpenIndex();
 
   CCriticalSection m_critSection;
   std::map<int, CDemuxStream*> m_streams;
@@ -145,6 +147,14 @@ protected:
   unsigned m_program;
   XbmcThreads::EndTime  m_timeout;
 
+  // keyframe index for containers lavf can't seek in quickly
+  CDVDDemuxIndex m_index;
+  std::string    m_indexPath;
+  std::string    m_indexFile;       // file the index belongs to, and its size
+  int64_t        m_indexLength;
+  int            m_indexStream;     // stream whose keyframes are indexed, -1 if disabled
+  bool           m_indexContiguous; // no seek since the last indexed keyframe
+
   // Due to limitations of ffmpeg, we only can detect a program change
   // with a packet. This struct saves the packet for the next read and
   // signals STREAMCHANGE to player
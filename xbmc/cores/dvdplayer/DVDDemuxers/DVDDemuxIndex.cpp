@@ -0,0 +1,321 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDDemuxIndex.h"
+#include "DVDClock.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+#define INDEX_DIRECTORY "special://profile/seekindex/"
+#define INDEX_MAGIC     "XSIX"
+#define INDEX_VERSION   2
+// magic, version, count, file size, modification time and length of the file path
+#define INDEX_HEADER    32
+// space all indexes may use, a two hour recording takes about 20KB
+#define INDEX_MAX_SIZE  (16 * 1024 * 1024)
+
+// keyframes closer than this are the same keyframe seen twice
+#define INDEX_TOLERANCE (DVD_TIME_BASE / 1000)
+
+static bool CompareLowerPts(const CDVDDemuxIndex::Entry& entry, double pts)
+{
+  return entry.pts < pts;
+}
+
+static bool CompareUpperPts(double pts, const CDVDDemuxIndex::Entry& entry)
+{
+  return pts < entry.pts;
+}
+
+/* entries are stored as zigzag encoded varint deltas to the previous one */
+static void WriteVarint(std::vector<uint8_t>& buffer, uint64_t value)
+{
+  while (value >= 0x80)
+  {
+    buffer.push_back((uint8_t)(value | 0x80));
+    value >>= 7;
+  }
+  buffer.push_back((uint8_t)value);
+}
+
+static bool ReadVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value)
+{
+  value = 0;
+  for (int shift = 0; shift < 64 && data < end; shift += 7)
+  {
+    uint8_t byte = *data++;
+    value |= (uint64_t)(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+
+static uint64_t ZigZag(int64_t value)
+{
+  return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t UnZigZag(uint64_t value)
+{
+  return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+CDVDDemuxIndex::CDVDDemuxIndex()
+{
+  m_wrapPeriod = 0.0;
+  Clear();
+}
+
+void CDVDDemuxIndex::Clear()
+{
+  m_entries.clear();
+  m_lastPts = DVD_NOPTS_VALUE;
+  m_dirty = false;
+}
+
+void CDVDDemuxIndex::Add(double pts, int64_t pos, bool contiguous)
+{
+  if (pts == DVD_NOPTS_VALUE || pos < 0)
+    return;
+
+  if (m_wrapPeriod > 0.0)
+    pts = Unwrap(pts, pos, contiguous);
+
+  std::vector<Entry>::iterator it = std::lower_bound(m_entries.begin(), m_entries.end(),
+                                                     pts - INDEX_TOLERANCE, CompareLowerPts);
+
+  // linked to the previous entry if that is the keyframe we read before
+  bool linked = contiguous && m_lastPts != DVD_NOPTS_VALUE && it != m_entries.begin()
+             && fabs((it - 1)->pts - m_lastPts) < INDEX_TOLERANCE;
+
+  if (it != m_entries.end() && fabs(it->pts - pts) < INDEX_TOLERANCE)
+  {
+    if (linked && !it->contiguous)
+    {
+      it->contiguous = true;
+      m_dirty = true;
+    }
+  }
+  else
+  {
+    Entry entry = { pts, pos, linked };
+    m_entries.insert(it, entry);
+    m_dirty = true;
+  }
+  m_lastPts = pts;
+}
+
+double CDVDDemuxIndex::Unwrap(double pts, int64_t pos, bool contiguous) const
+{
+  // the keyframe read before this one, or after a seek the one before it
+  // in the file, tells how often the timestamps have wrapped by now
+  double reference = pts;
+  Entry entry;
+  if (contiguous && m_lastPts != DVD_NOPTS_VALUE)
+    reference = m_lastPts;
+  else if (LookupPos(pos, entry))
+    reference = entry.pts;
+
+  return pts + floor((reference - pts) / m_wrapPeriod + 0.5) * m_wrapPeriod;
+}
+
+bool CDVDDemuxIndex::Lookup(double pts, bool backwards, Entry& entry) const
+{
+  std::vector<Entry>::const_iterator it = std::upper_bound(m_entries.begin(), m_entries.end(),
+                                                           pts, CompareUpperPts);
+  // outside of what has been indexed, or a gap we seeked over
+  if (it == m_entries.begin() || it == m_entries.end() || !it->contiguous)
+    return false;
+
+  const Entry& before = *(it - 1);
+  if (backwards || pts - before.pts < INDEX_TOLERANCE)
+    entry = before;
+  else
+    entry = *it;
+  return true;
+}
+
+bool CDVDDemuxIndex::LookupPos(int64_t pos, Entry& entry) const
+{
+  // don't rely on positions increasing with pts, damaged files break that
+  const Entry* found = NULL;
+  for (std::vector<Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    if (it->pos <= pos && (!found || it->pos > found->pos))
+      found = &*it;
+  }
+  if (!found)
+    return false;
+  entry = *found;
+  return true;
+}
+
+bool CDVDDemuxIndex::Load(const std::string& path, const std::string& file, int64_t length)
+{
+  Clear();
+
+  XFILE::CFile in;
+  if (!in.Open(path))
+    return false;
+
+  int64_t size = in.GetLength();
+  if (size < INDEX_HEADER || size > 64 * 1024 * 1024)
+    return false;
+
+  std::vector<uint8_t> buffer((size_t)size);
+  if (in.Read(&buffer[0], size) != size)
+    return false;
+  in.Close();
+
+  const uint8_t* data = &buffer[0];
+  const uint8_t* end = data + buffer.size();
+  uint32_t version, count, pathLength;
+  int64_t fileLength, fileTime;
+  memcpy(&version, data + 4, 4);
+  memcpy(&count, data + 8, 4);
+  memcpy(&fileLength, data + 12, 8);
+  memcpy(&fileTime, data + 20, 8);
+  memcpy(&pathLength, data + 28, 4);
+  if (memcmp(data, INDEX_MAGIC, 4) != 0 || version != INDEX_VERSION || count > buffer.size()
+   || pathLength > buffer.size() - INDEX_HEADER)
+  {
+    CLog::Log(LOGWARNING, "CDVDDemuxIndex::Load - ignoring invalid index %s", path.c_str());
+    return false;
+  }
+  data += INDEX_HEADER;
+
+  // the name of the index is a hash, it may belong to another file or an older version of this one
+  if (fileLength != length || fileTime != GetModTime(file)
+   || std::string((const char*)data, pathLength) != file)
+  {
+    CLog::Log(LOGDEBUG, "CDVDDemuxIndex::Load - index %s is for another file", path.c_str());
+    return false;
+  }
+  data += pathLength;
+
+  m_entries.reserve(count);
+  int64_t pts = 0;
+  int64_t pos = 0;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    uint64_t ptsDelta, posDelta;
+    if (!ReadVarint(data, end, ptsDelta) || !ReadVarint(data, end, posDelta))
+    {
+      CLog::Log(LOGWARNING, "CDVDDemuxIndex::Load - truncated index %s", path.c_str());
+      Clear();
+      return false;
+    }
+    pts += UnZigZag(ptsDelta >> 1);
+    pos += UnZigZag(posDelta);
+    Entry entry = { (double)pts, pos, (ptsDelta & 1) != 0 };
+    m_entries.push_back(entry);
+  }
+  return true;
+}
+
+bool CDVDDemuxIndex::Save(const std::string& path, const std::string& file, int64_t length)
+{
+  std::vector<uint8_t> buffer(INDEX_HEADER);
+  uint32_t version = INDEX_VERSION;
+  uint32_t count = m_entries.size();
+  int64_t fileTime = GetModTime(file);
+  uint32_t pathLength = file.size();
+  memcpy(&buffer[0], INDEX_MAGIC, 4);
+  memcpy(&buffer[4], &version, 4);
+  memcpy(&buffer[8], &count, 4);
+  memcpy(&buffer[12], &length, 8);
+  memcpy(&buffer[20], &fileTime, 8);
+  memcpy(&buffer[28], &pathLength, 4);
+  buffer.insert(buffer.end(), file.begin(), file.end());
+
+  int64_t pts = 0;
+  int64_t pos = 0;
+  for (std::vector<Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    int64_t entryPts = (int64_t)it->pts;
+    WriteVarint(buffer, ZigZag(entryPts - pts) << 1 | (it->contiguous ? 1 : 0));
+    WriteVarint(buffer, ZigZag(it->pos - pos));
+    pts = entryPts;
+    pos = it->pos;
+  }
+
+  XFILE::CDirectory::Create(URIUtils::GetDirectory(path));
+  XFILE::CFile out;
+  if (!out.OpenForWrite(path, true) || out.Write(&buffer[0], buffer.size()) != (int)buffer.size())
+  {
+    CLog::Log(LOGERROR, "CDVDDemuxIndex::Save - failed to write %s", path.c_str());
+    return false;
+  }
+  out.Close();
+  m_dirty = false;
+  return true;
+}
+
+int64_t CDVDDemuxIndex::GetModTime(const std::string& file)
+{
+  struct __stat64 st;
+  if (XFILE::CFile::Stat(file, &st) != 0)
+    return 0;
+  return st.st_mtime;
+}
+
+std::string CDVDDemuxIndex::GetIndexPath(const std::string& file, int64_t length)
+{
+  // a file replaced by another one of the same size still gets a new index
+  Crc32 crc;
+  crc.Compute(StringUtils::Format("%s|%" PRId64 "|%" PRId64, file.c_str(), length, GetModTime(file)));
+  return StringUtils::Format(INDEX_DIRECTORY "%08x.idx", (uint32_t)crc);
+}
+
+void CDVDDemuxIndex::Trim(const std::string& directory, int64_t maxSize)
+{
+  CFileItemList items;
+  if (!XFILE::CDirectory::GetDirectory(directory, items, ".idx", XFILE::DIR_FLAG_NO_FILE_DIRS))
+    return;
+
+  int64_t size = 0;
+  for (int i = 0; i < items.Size(); i++)
+    size += items[i]->m_dwSize;
+  if (size <= maxSize)
+    return;
+
+  // an index is rewritten whenever playback adds to it, so the oldest are the least recently used
+  items.Sort(SortByDate, SortOrderAscending);
+  for (int i = 0; i < items.Size() && size > maxSize; i++)
+  {
+    if (XFILE::CFile::Delete(items[i]->GetPath()))
+      size -= items[i]->m_dwSize;
+  }
+}
+
+void CDVDDemuxIndex::Trim()
+{
+  Trim(INDEX_DIRECTORY, INDEX_MAX_SIZE);
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*
+ * Keyframe index collected while a file is played.
+ *
+ * Containers without a usable index (mpeg-ts recordings, avi without idx1,
+ * elementary streams) make lavf search the file on every seek. The demuxer
+ * records the position of every keyframe it passes and stores them per file,
+ * so later seeks into parts that have been played go straight to the right
+ * byte offset.
+ *
+ * An entry is only trusted as seek target when it is known that no keyframe
+ * lies between it and the next entry, i.e. both were seen while reading
+ * through the file without a seek in between.
+ *
+ * Stored indexes carry the path, size and modification time of their file,
+ * so an index is never used for another file that happens to map to the same
+ * name. The oldest ones are deleted once they use more than a fixed amount of
+ * space.
+ */
+class CDVDDemuxIndex
+{
+public:
+  struct Entry
+  {
+    double  pts;        // presentation time, DVD_TIME_BASE units
+    int64_t pos;        // byte position of the packet
+    bool    contiguous; // no keyframe between the previous entry and this one
+  };
+
+  CDVDDemuxIndex();
+
+  void Clear();
+
+  /*
+   * Timestamps of the container wrap around after period (DVD_TIME_BASE
+   * units), like the 33 bit pts of mpeg-ts after 26.5 hours. 0 if they
+   * don't wrap.
+   */
+  void SetWrapPeriod(double period) { m_wrapPeriod = period; }
+
+  /*
+   * Record a keyframe. contiguous is true if the previous call was for the
+   * keyframe read just before this one, false after a seek or flush.
+   * Wrapped timestamps are unwrapped, so the index keeps the time from the
+   * start of the file.
+   */
+  void Add(double pts, int64_t pos, bool contiguous);
+
+  /*
+   * Get the keyframe to start playback from for pts. Fails if pts lies in
+   * a part of the file that has not been read through.
+   */
+  bool Lookup(double pts, bool backwards, Entry& entry) const;
+
+  /* Get the last keyframe at or before byte position pos */
+  bool LookupPos(int64_t pos, Entry& entry) const;
+
+  size_t Size() const { return m_entries.size(); }
+  bool IsDirty() const { return m_dirty; }
+
+  /*
+   * Load and save the index of file at path. Load fails if the index was
+   * saved for a different file, or the file changed since.
+   */
+  bool Load(const std::string& path, const std::string& file, int64_t length);
+  bool Save(const std::string& path, const std::string& file, int64_t length);
+
+  /* Location of the index of a file, identified by path, size and modification time */
+  static std::string GetIndexPath(const std::string& file, int64_t length);
+
+  /* Delete the least recently written indexes in directory until the rest fit in maxSize bytes */
+  static void Trim(const std::string& directory, int64_t maxSize);
+  static void Trim();
+
+private:
+  double Unwrap(double pts, int64_t pos, bool contiguous) const;
+  static int64_t GetModTime(const std::string& file);
+
+  std::vector<Entry> m_entries; // sorted by pts
+  double m_lastPts;             // unwrapped
+  double m_wrapPeriod;
+  bool m_dirty;
+};
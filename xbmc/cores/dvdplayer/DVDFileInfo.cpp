@@ -30,6 +30,7 @@
 #include "utils/URIUtils.h"
 
 #include "DVDClock.h"
+#include "DVDProbeCache.h"
 #include "DVDStreamInfo.h"
 #include "DVDInputStreams/DVDInputStream.h"
 #ifdef HAVE_LIBBLURAY
@@ -48,12 +49,17 @@
 
 #include "libavcodec/avcodec.h"
 #include "libswscale/swscale.h"
+#ifdef TARGET_WINDOWS
+#pragma comment(lib, "swscale.lib")
+#endif
 #include "filesystem/File.h"
 #include "cores/FFmpeg.h"
 #include "TextureCache.h"
 #include "Util.h"
 #include "utils/LangCodeExpander.h"
+#include "utils/StringUtils.h"
 
+#include <algorithm>
 
 bool CDVDFileInfo::GetFileDuration(const CStdString &path, int& duration)
 {
@@ -196,16 +202,20 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
     CDVDStreamInfo hint(*pDemuxer->GetStream(nVideoStream), true);
     hint.software = true;
 
-    if (hint.codec == AV_CODEC_ID_MPEG2VIDEO || hint.codec == AV_CODEC_ID_MPEG1VIDEO)
-    {
-      // libmpeg2 is not thread safe so use ffmepg for mpeg2/mpeg1 thumb extraction
-      CDVDCodecOptions dvdOptions;
-      pVideoCodec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, dvdOptions);
-    }
-    else
-    {
-      pVideoCodec = CDVDFactoryCodec::CreateVideoCodec( hint );
-    }
+    // only the keyframe we seek to is needed, and only at thumbnail size. decoders
+    // fail to open with more lowres than they support, so stay within their limit.
+    int lowres = 0;
+    while (lowres < 3 && (hint.width >> (lowres + 1)) >= (int)g_advancedSettings.GetThumbSize())
+      lowres++;
+    AVCodec *pCodec = avcodec_find_decoder(hint.codec);
+    lowres = pCodec ? std::min(lowres, (int)pCodec->max_lowres) : 0;
+
+    // libmpeg2 is not thread safe so ffmpeg is used for mpeg2/mpeg1 thumb extraction as well
+    CDVDCodecOptions dvdOptions;
+    dvdOptions.m_keys.push_back(CDVDCodecOption("skip_frame", "nokey"));
+    if (lowres > 0)
+      dvdOptions.m_keys.push_back(CDVDCodecOption("lowres", StringUtils::Format("%d", lowres)));
+    pVideoCodec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, dvdOptions);
 
     if (pVideoCodec)
     {
@@ -332,6 +342,10 @@ bool CDVDFileInfo::GetFileStreamDetails(CFileItem *pItem)
   if (URIUtils::IsStack(playablePath))
     playablePath = XFILE::CStackDirectory::GetFirstStackedFile(playablePath);
 
+  CStreamDetails &details = pItem->GetVideoInfoTag()->m_streamDetails;
+  if (CDVDProbeCache::Get().Lookup(strFileNameAndPath, details))
+    return details.HasItems();
+
   CDVDInputStream *pInputStream = CDVDFactoryInputStream::CreateInputStream(NULL, playablePath, "");
   if (!pInputStream)
     return false;
@@ -345,13 +359,21 @@ bool CDVDFileInfo::GetFileStreamDetails(CFileItem *pItem)
   CDVDDemux *pDemuxer = CDVDFactoryDemuxer::CreateDemuxer(pInputStream);
   if (pDemuxer)
   {
-    bool retVal = DemuxerToStreamDetails(pInputStream, pDemuxer, pItem->GetVideoInfoTag()->m_streamDetails, strFileNameAndPath);
+    bool retVal = DemuxerToStreamDetails(pInputStream, pDemuxer, details, strFileNameAndPath);
     delete pDemuxer;
     delete pInputStream;
+    CDVDProbeCache::Get().Store(strFileNameAndPath, details);
     return retVal;
   }
   else
   {
+    // remember local files lavf can't make sense of, opening them fails the same way next
+    // time. remote files may have failed on a read error, they are probed again.
+    if (!URIUtils::IsRemote(playablePath))
+    {
+      details.Reset();
+      CDVDProbeCache::Get().Store(strFileNameAndPath, details);
+    }
     delete pInputStream;
     return false;
   }
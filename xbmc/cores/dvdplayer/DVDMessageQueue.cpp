@@ -249,6 +249,8 @@ void CDVDMessageQueue::WaitUntilEmpty()
 
 int CDVDMessageQueue::GetLevel() const
 {
+  CSingleLock lock(m_section);
+
   if(m_iDataSize > m_iMaxDataSize)
     return 100;
   if(m_iDataSize == 0)
@@ -268,9 +270,25 @@ int CDVDMessageQueue::GetTimeSize() const
     return (int)((m_TimeFront - m_TimeBack) / DVD_TIME_BASE);
 }
 
+double CDVDMessageQueue::GetTimeSpan() const
+{
+  if(IsDataBased())
+    return 0.0;
+  else
+    return (m_TimeFront - m_TimeBack) / DVD_TIME_BASE;
+}
+
 bool CDVDMessageQueue::IsDataBased() const
 {
   return (m_TimeBack == DVD_NOPTS_VALUE  ||
           m_TimeFront == DVD_NOPTS_VALUE ||
           m_TimeFront <= m_TimeBack);
 }
+
+void CDVDMessageQueue::SetLimits(int iMaxDataSize, double sec)
+{
+  // the player changes the limits while the queue is in use
+  CSingleLock lock(m_section);
+  SetMaxDataSize(iMaxDataSize);
+  SetMaxTimeSize(sec);
+}
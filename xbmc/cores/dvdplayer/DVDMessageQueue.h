@@ -107,6 +107,7 @@ public:
 
   int GetDataSize() const               { return m_iDataSize; }
   int GetTimeSize() const;
+  double GetTimeSpan() const;
   unsigned GetPacketCount(CDVDMsg::Message type);
   bool ReceivedAbortRequest()           { return m_bAbortRequest; }
   void WaitUntilEmpty();
@@ -117,6 +118,7 @@ public:
 
   void SetMaxDataSize(int iMaxDataSize) { m_iMaxDataSize = iMaxDataSize; }
   void SetMaxTimeSize(double sec)       { m_TimeSize  = 1.0 / std::max(1.0, sec); }
+  void SetLimits(int iMaxDataSize, double sec);
   int GetMaxDataSize() const            { return m_iMaxDataSize; }
   double GetMaxTimeSize() const         { return m_TimeSize; }
   bool IsInited() const                 { return m_bInitialized; }
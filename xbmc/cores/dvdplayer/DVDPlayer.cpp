@@ -75,6 +75,7 @@
 #include "filesystem/PVRFile.h"
 #include "video/dialogs/GUIDialogFullScreenInfo.h"
 #include "utils/StreamUtils.h"
+#include "utils/JobManager.h"
 #include "utils/Variant.h"
 #include "storage/MediaManager.h"
 #include "dialogs/GUIDialogBusy.h"
@@ -506,11 +507,13 @@ CDVDPlayer::CDVDPlayer(IPlayerCallback& callback)
   m_dvd.Clear();
   m_State.Clear();
   m_EdlAutoSkipMarkers.Clear();
+  m_EdlJob = 0;
   m_UpdateApplication = 0;
 
   m_bAbortRequest = false;
   m_errorCount = 0;
   m_offset_pts = 0.0;
+  m_demuxedBytes = 0;
   m_playSpeed = DVD_PLAYSPEED_NORMAL;
   m_caching = CACHESTATE_DONE;
   m_HasVideo = false;
@@ -603,7 +606,10 @@ bool CDVDPlayer::CloseFile(bool reopen)
   // we are done after the StopThread call
   StopThread();
 
-  m_Edl.Clear();
+  CancelEdl();
+  { CSingleLock lock(m_EdlSection);
+    m_Edl.Clear();
+  }
   m_EdlAutoSkipMarkers.Clear();
 
   m_HasVideo = false;
@@ -883,6 +889,7 @@ bool CDVDPlayer::ReadPacket(DemuxPacket*& packet, CDemuxStream*& stream)
     }
 
     UpdateCorrection(packet, m_offset_pts);
+    m_demuxedBytes += packet->iSize;
 
     if(packet->iStreamId < 0)
       return true;
@@ -997,6 +1004,9 @@ bool CDVDPlayer::IsBetterStream(CCurrentStream& current, CDemuxStream* stream)
 
 void CDVDPlayer::Process()
 {
+  m_BufferManager.Reset(g_advancedSettings.m_bufferMemory, g_advancedSettings.m_bufferSeconds);
+  m_demuxedBytes = 0;
+
   if (!OpenInputStream())
   {
     m_bAbortRequest = true;
@@ -1029,23 +1039,28 @@ void CDVDPlayer::Process()
   OpenDefaultStreams();
 
   // look for any EDL files
-  m_Edl.Clear();
-  m_EdlAutoSkipMarkers.Clear();
-  if (m_CurrentVideo.id >= 0 && m_CurrentVideo.hint.fpsrate > 0 && m_CurrentVideo.hint.fpsscale > 0)
-  {
-    float fFramesPerSecond = (float)m_CurrentVideo.hint.fpsrate / (float)m_CurrentVideo.hint.fpsscale;
-    m_Edl.ReadEditDecisionLists(m_filename, fFramesPerSecond, m_CurrentVideo.hint.height);
+  { CSingleLock lock(m_EdlSection);
+    m_Edl.Clear();
   }
+  m_EdlAutoSkipMarkers.Clear();
+  ReadEdl();
 
   /*
    * Check to see if the demuxer should start at something other than time 0. This will be the case
    * if there was a start time specified as part of the "Start from where last stopped" (aka
    * auto-resume) feature or if there is an EDL cut or commercial break that starts at time 0.
+   *
+   * The start time was stored with the cuts removed so resuming has to wait for the EDL. Otherwise
+   * playback starts straight away and CheckAutoSceneSkip() skips a cut or commercial break at the
+   * start once the EDL has been read.
    */
   CEdl::Cut cut;
   int starttime = 0;
   if(m_PlayerOptions.starttime > 0 || m_PlayerOptions.startpercent > 0)
   {
+    if (!UpdateEdl(5000))
+      CLog::Log(LOGWARNING, "%s - EDL not read in time, resuming without it", __FUNCTION__);
+
     if (m_PlayerOptions.startpercent > 0 && m_pDemuxer)
     {
       int64_t playerStartTime = (int64_t) ( ( (float) m_pDemuxer->GetStreamLength() ) * ( m_PlayerOptions.startpercent/(float)100 ) );
@@ -1057,7 +1072,8 @@ void CDVDPlayer::Process()
     }
     CLog::Log(LOGDEBUG, "%s - Start position set to last stopped position: %d", __FUNCTION__, starttime);
   }
-  else if(m_Edl.InCut(0, &cut)
+  else if(UpdateEdl(0)
+      && m_Edl.InCut(0, &cut)
       && (cut.action == CEdl::CUT || cut.action == CEdl::COMM_BREAK))
   {
     starttime = cut.end;
@@ -1115,6 +1131,9 @@ void CDVDPlayer::Process()
     // handle messages send to this thread, like seek or demuxer reset requests
     HandleMessages();
 
+    // take over the EDL once it has been read
+    UpdateEdl(0);
+
     if(m_bAbortRequest)
       break;
 
@@ -1966,6 +1985,59 @@ void CDVDPlayer::CheckAutoSceneSkip()
 }
 
 
+void CDVDPlayer::ReadEdl()
+{
+  CancelEdl();
+
+  if (m_CurrentVideo.id < 0 || m_CurrentVideo.hint.fpsrate <= 0 || m_CurrentVideo.hint.fpsscale <= 0)
+    return;
+
+  float fFramesPerSecond = (float)m_CurrentVideo.hint.fpsrate / (float)m_CurrentVideo.hint.fpsscale;
+
+  CSingleLock lock(m_EdlSection);
+  m_EdlJob = CJobManager::GetInstance().AddJob(new CEdlJob(m_filename, fFramesPerSecond, m_CurrentVideo.hint.height),
+                                               this, CJob::PRIORITY_NORMAL);
+}
+
+void CDVDPlayer::CancelEdl()
+{
+  CSingleLock lock(m_EdlSection);
+  if (m_EdlJob)
+    CJobManager::GetInstance().CancelJob(m_EdlJob);
+  m_EdlJob = 0;
+  m_EdlReady.Reset();
+}
+
+bool CDVDPlayer::UpdateEdl(unsigned int timeout)
+{
+  if (!m_EdlReady.WaitMSec(timeout))
+    return false;
+
+  /*
+   * Only this thread changes m_Edl, so it reads it without the lock. Other threads take the lock
+   * and only use the const lookups, which don't change the EDL.
+   */
+  { CSingleLock lock(m_EdlSection);
+    m_Edl = m_EdlPending;
+    m_EdlPending.Clear();
+  }
+  m_Edl.WriteMPlayerEdl();
+  CLog::Log(LOGDEBUG, "%s - EDL read: %s", __FUNCTION__, m_Edl.GetInfo().c_str());
+  return true;
+}
+
+void CDVDPlayer::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CSingleLock lock(m_EdlSection);
+  if (jobID != m_EdlJob) // cancelled
+    return;
+
+  // an empty EDL if none was found, so nobody waits for it in vain
+  m_EdlJob = 0;
+  m_EdlPending = ((CEdlJob*)job)->GetEdl();
+  m_EdlReady.Set();
+}
+
 void CDVDPlayer::SynchronizeDemuxer(unsigned int timeout)
 {
   if(IsCurrentThread())
@@ -2576,8 +2648,13 @@ void CDVDPlayer::Seek(bool bPlus, bool bLargeStep, bool bChapterOverride)
     seek = (int64_t)(GetTotalTimeInMsec()*(GetPercentage()+percent)/100);
   }
 
+  bool hasCut;
+  { CSingleLock lock(m_EdlSection);
+    hasCut = m_Edl.HasCut();
+  }
+
   bool restore = true;
-  if (m_Edl.HasCut())
+  if (hasCut)
   {
     /*
      * Alter the standard seek position based on whether any commercial breaks have been
@@ -2642,8 +2719,10 @@ void CDVDPlayer::Seek(bool bPlus, bool bLargeStep, bool bChapterOverride)
 
 bool CDVDPlayer::SeekScene(bool bPlus)
 {
-  if (!m_Edl.HasSceneMarker())
-    return false;
+  { CSingleLock lock(m_EdlSection);
+    if (!m_Edl.HasSceneMarker())
+      return false;
+  }
 
   /*
    * There is a 5 second grace period applied when seeking for scenes backwards. If there is no
@@ -2654,7 +2733,11 @@ bool CDVDPlayer::SeekScene(bool bPlus)
     clock -= 5 * 1000;
 
   int64_t iScenemarker;
-  if (m_Edl.GetNextSceneMarker(bPlus, clock, &iScenemarker))
+  bool bFound;
+  { CSingleLock lock(m_EdlSection);
+    bFound = m_Edl.GetNextSceneMarker(bPlus, clock, &iScenemarker);
+  }
+  if (bFound)
   {
     /*
      * Seeking is flushed and inaccurate, just like Seek()
@@ -2696,7 +2779,9 @@ void CDVDPlayer::GetGeneralInfo(CStdString& strGeneralInfo)
       dDiff = (apts - vpts) / DVD_TIME_BASE;
 
     CStdString strEDL;
-    strEDL += StringUtils::Format(", edl:%s", m_Edl.GetInfo().c_str());
+    { CSingleLock lock(m_EdlSection);
+      strEDL += StringUtils::Format(", edl:%s", m_Edl.GetInfo().c_str());
+    }
 
     CStdString strBuf;
     CSingleLock lock(m_StateSection);
@@ -2709,6 +2794,13 @@ void CDVDPlayer::GetGeneralInfo(CStdString& strGeneralInfo)
         strBuf += StringUtils::Format(" %d sec", DVD_TIME_TO_SEC(m_State.cache_delay));
     }
 
+    SPlayerBufferInfo buffer;
+    m_BufferManager.GetInfo(buffer);
+    strBuf += StringUtils::Format(" buf:%.1f/%.0fs %s/s"
+                                  , buffer.seconds
+                                  , buffer.target
+                                  , StringUtils::SizeToString(buffer.rate).c_str());
+
     strGeneralInfo = StringUtils::Format("C( ad:% 6.3f, a/v:% 6.3f%s, dcpu:%2i%% acpu:%2i%% vcpu:%2i%%%s )"
                                          , dDelay
                                          , dDiff
@@ -3002,6 +3094,10 @@ bool CDVDPlayer::OpenVideoStream(int iStream, int source, bool reset)
     hint.fpsscale = stream->iFpsScale;
   }
 
+  if(m_pInputStream && m_pInputStream->IsStreamType(DVDSTREAM_TYPE_PVRMANAGER) &&
+     !g_PVRManager.IsPlayingRecording())
+    hint.realtime = true;
+
   CDVDInputStream::IMenus* pMenus = dynamic_cast<CDVDInputStream::IMenus*>(m_pInputStream);
   if(pMenus && pMenus->IsInMenu())
     hint.stills = true;
@@ -3915,7 +4011,48 @@ double CDVDPlayer::GetQueueTime()
 {
   int a = m_dvdPlayerAudio.GetLevel();
   int v = m_dvdPlayerVideo.GetLevel();
-  return max(a, v) * 8000.0 / 100;
+  return max(a, v) * m_BufferManager.GetMaxTimeSize() * 1000.0 / 100;
+}
+
+void CDVDPlayer::GetBufferInfo(SPlayerBufferInfo &info)
+{
+  m_BufferManager.GetInfo(info);
+}
+
+void CDVDPlayer::UpdateBuffers()
+{
+  SDVDBufferState buffers;
+
+  XFILE::SCacheStatus status;
+  if(m_pInputStream && m_pInputStream->GetCacheStatus(&status))
+  {
+    buffers.cacheSize    = g_advancedSettings.m_cacheMemBufferSize;
+    buffers.cacheForward = status.forward;
+    buffers.cacheRate    = status.currate;
+  }
+
+  buffers.audio      = m_CurrentAudio.id >= 0;
+  buffers.video      = m_CurrentVideo.id >= 0;
+  buffers.audioBytes = m_dvdPlayerAudio.GetQueueDataSize();
+  buffers.videoBytes = m_dvdPlayerVideo.GetQueueDataSize();
+  buffers.audioTime  = m_dvdPlayerAudio.GetQueueTimeSpan();
+  buffers.videoTime  = m_dvdPlayerVideo.GetQueueTimeSpan();
+  buffers.demuxed    = m_demuxedBytes;
+  buffers.clock      = CDVDClock::GetAbsoluteClock() / DVD_TIME_BASE;
+
+  if(m_pInputStream && m_pDemuxer)
+  {
+    int64_t length = m_pInputStream->GetLength();
+    int     time   = m_pDemuxer->GetStreamLength();
+    if(length > 0 && time > 0)
+      buffers.bitrate = length * 1000.0 / time;
+  }
+
+  m_BufferManager.Update(buffers);
+
+  double seconds = m_BufferManager.GetMaxTimeSize();
+  m_dvdPlayerAudio.SetQueueLimits(m_BufferManager.GetMaxDataSize(false), seconds);
+  m_dvdPlayerVideo.SetQueueLimits(m_BufferManager.GetMaxDataSize(true), seconds);
 }
 
 void CDVDPlayer::GetVideoStreamInfo(SPlayerVideoStreamInfo &info)
@@ -4154,10 +4291,12 @@ void CDVDPlayer::UpdatePlayState(double timeout)
   else
   {
     state.cache_delay  = 0.0;
-    state.cache_level  = min(1.0, GetQueueTime() / 8000.0);
+    state.cache_level  = min(1.0, GetQueueTime() / (m_BufferManager.GetMaxTimeSize() * 1000.0));
     state.cache_offset = GetQueueTime() / state.time_total;
   }
 
+  UpdateBuffers();
+
   XFILE::SCacheStatus status;
   if(m_pInputStream && m_pInputStream->GetCacheStatus(&status))
   {
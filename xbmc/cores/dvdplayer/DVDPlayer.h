@@ -37,10 +37,12 @@
 #include "utils/BitstreamStats.h"
 
 #include "Edl.h"
+#include "DVDBufferManager.h"
 #include "FileItem.h"
 #include "threads/SingleLock.h"
 #include "utils/StreamDetails.h"
 #include "threads/SystemClock.h"
+#include "utils/Job.h"
 
 
 class CDVDInputStream;
@@ -167,7 +169,7 @@ public:
 #define DVDPLAYER_SUBTITLE 3
 #define DVDPLAYER_TELETEXT 4
 
-class CDVDPlayer : public IPlayer, public CThread, public IDVDPlayer
+class CDVDPlayer : public IPlayer, public CThread, public IDVDPlayer, private IJobCallback
 {
 public:
   CDVDPlayer(IPlayerCallback& callback);
@@ -254,6 +256,7 @@ public:
 
   virtual bool IsCaching() const { return m_caching == CACHESTATE_FULL || m_caching == CACHESTATE_PVR; }
   virtual int GetCacheLevel() const ;
+  virtual void GetBufferInfo(SPlayerBufferInfo &info);
 
   virtual int OnDVDNavResult(void* pData, int iMessage);
 protected:
@@ -305,6 +308,7 @@ protected:
   int64_t GetTotalTimeInMsec();
 
   double GetQueueTime();
+  void UpdateBuffers();
   bool GetCachingTimes(double& play_left, double& cache_left, double& file_offset);
 
 
@@ -317,6 +321,10 @@ protected:
   void SynchronizePlayers(unsigned int sources);
   void SynchronizeDemuxer(unsigned int timeout);
   void CheckAutoSceneSkip();
+  void ReadEdl();
+  void CancelEdl();
+  bool UpdateEdl(unsigned int timeout);
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
   void CheckContinuity(CCurrentStream& current, DemuxPacket* pPacket);
   bool CheckSceneSkip(CCurrentStream& current);
   bool CheckPlayerInit(CCurrentStream& current, unsigned int source);
@@ -468,10 +476,17 @@ protected:
   } m_State, m_StateInput;
   CCriticalSection m_StateSection;
 
+  CDVDBufferManager m_BufferManager;
+  int64_t m_demuxedBytes;
+
   CEvent m_ready;
   CCriticalSection m_critStreamSection; // need to have this lock when switching streams (audio / video)
 
-  CEdl m_Edl;
+  CEdl m_Edl;                   // changed by the player thread only, other threads read it with m_EdlSection held
+  CEdl m_EdlPending;            // read by the EDL job, taken over by UpdateEdl()
+  unsigned int m_EdlJob;        // id of the job reading the EDL, 0 if there is none
+  CEvent m_EdlReady;
+  CCriticalSection m_EdlSection;
 
   struct SEdlAutoSkipMarkers {
 
@@ -121,6 +121,9 @@ public:
   void WaitForBuffers();
   bool AcceptsData() const                              { return !m_messageQueue.IsFull(); }
   bool HasData() const                                  { return m_messageQueue.GetDataSize() > 0; }
+  int  GetQueueDataSize() const                         { return m_messageQueue.GetDataSize(); }
+  double GetQueueTimeSpan() const                       { return m_messageQueue.GetTimeSpan(); }
+  void SetQueueLimits(int maxDataSize, double maxTimeSize) { m_messageQueue.SetLimits(maxDataSize, maxTimeSize); }
   int  GetLevel() const                                 { return m_messageQueue.GetLevel(); }
   bool IsInited() const                                 { return m_messageQueue.IsInited(); }
   void SendMessage(CDVDMsg* pMsg, int priority = 0)     { m_messageQueue.Put(pMsg, priority); }
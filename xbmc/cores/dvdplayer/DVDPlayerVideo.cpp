@@ -149,6 +149,7 @@ CDVDPlayerVideo::CDVDPlayerVideo( CDVDClock* pClock
 
   m_iCurrentPts = DVD_NOPTS_VALUE;
   m_iDroppedFrames = 0;
+  m_bDecodeStats = false;
   m_fFrameRate = 25;
   m_bCalcFrameRate = false;
   m_fStableFrameRate = 0.0;
@@ -294,6 +295,7 @@ void CDVDPlayerVideo::CloseStream(bool bWaitForBuffers)
 void CDVDPlayerVideo::OnStartup()
 {
   m_iDroppedFrames = 0;
+  m_bDecodeStats = false;
 
   m_crop.x1 = m_crop.x2 = 0.0f;
   m_crop.y1 = m_crop.y2 = 0.0f;
@@ -548,6 +550,7 @@ void CDVDPlayerVideo::Process()
       mFilters = m_pVideoCodec->SetFilters(mFilters);
 
       int iDecoderState = m_pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
+      m_bDecodeStats = m_pVideoCodec->GetDecodeStats(m_decodeStats);
 
       // buffer packets so we can recover should decoder flush for some reason
       if(m_pVideoCodec->GetConvergeCount() > 0)
@@ -925,6 +928,7 @@ void CDVDPlayerVideo::ProcessOverlays(DVDVideoPicture* pSource, double pts)
       CDVDCodecUtils::CopyPicture(m_pTempOverlayPicture, pSource);
       memcpy(pSource->data     , m_pTempOverlayPicture->data     , sizeof(pSource->data));
       memcpy(pSource->iLineSize, m_pTempOverlayPicture->iLineSize, sizeof(pSource->iLineSize));
+      pSource->iFlags &= ~DVP_FLAG_FRAMEREF;
     }
   }
 
@@ -1430,6 +1434,13 @@ std::string CDVDPlayerVideo::GetPlayerInfo()
   s << ", drop:" << m_iDroppedFrames;
   s << ", skip:" << g_renderManager.GetSkippedFrames();
 
+  if (m_bDecodeStats)
+  {
+    s << ", dt:" << fixed << setprecision(1) << m_decodeStats.decodeTime << "/" << m_decodeStats.peakTime << "ms";
+    if (m_decodeStats.threads > 1)
+      s << ", thr:" << m_decodeStats.threads << (m_decodeStats.frameThreads ? "f" : "s");
+  }
+
   int pc = m_pullupCorrection.GetPatternLength();
   if (pc > 0)
     s << ", pc:" << pc;
@@ -56,6 +56,9 @@ public:
   void WaitForBuffers()                             { m_messageQueue.WaitUntilEmpty(); }
   bool AcceptsData() const                          { return !m_messageQueue.IsFull(); }
   bool HasData() const                              { return m_messageQueue.GetDataSize() > 0; }
+  int  GetQueueDataSize() const                     { return m_messageQueue.GetDataSize(); }
+  double GetQueueTimeSpan() const                   { return m_messageQueue.GetTimeSpan(); }
+  void SetQueueLimits(int maxDataSize, double maxTimeSize) { m_messageQueue.SetLimits(maxDataSize, maxTimeSize); }
   int  GetLevel();
   bool IsInited() const                             { return m_messageQueue.IsInited(); }
   void SendMessage(CDVDMsg* pMsg, int priority = 0) { m_messageQueue.Put(pMsg, priority); }
@@ -169,6 +172,8 @@ protected:
   bool m_stalled;
   bool m_started;
   std::string m_codecname;
+  DVDVideoDecodeStats m_decodeStats;
+  bool m_bDecodeStats;
 
   BitstreamStats m_videoStats;
 
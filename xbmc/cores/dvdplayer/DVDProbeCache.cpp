@@ -0,0 +1,221 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDProbeCache.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/Archive.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <vector>
+
+#define PROBECACHE_FILE    "special://profile/probecache.dat"
+#define PROBECACHE_VERSION 1
+#define PROBECACHE_ENTRIES 20000
+
+using namespace XFILE;
+
+CDVDProbeCache::CDVDProbeCache(const std::string& cacheFile)
+  : m_cacheFile(cacheFile)
+{
+  m_counter = 0;
+  m_loaded = false;
+  m_dirty = false;
+}
+
+CDVDProbeCache& CDVDProbeCache::Get()
+{
+  static CDVDProbeCache s_cache(PROBECACHE_FILE);
+  return s_cache;
+}
+
+bool CDVDProbeCache::GetIdentity(const std::string& file, int64_t& size, int64_t& mtime)
+{
+  struct __stat64 st;
+  if (CFile::Stat(file, &st) != 0)
+    return false;
+  size = st.st_size;
+  mtime = st.st_mtime;
+  return true;
+}
+
+bool CDVDProbeCache::Lookup(const std::string& file, CStreamDetails& details)
+{
+  int64_t size, mtime;
+  if (!GetIdentity(file, size, mtime))
+    return false;
+
+  CSingleLock lock(m_section);
+  EnsureLoaded();
+
+  EntryMap::iterator it = m_entries.find(file);
+  if (it == m_entries.end())
+    return false;
+
+  if (it->second.size != size || it->second.mtime != mtime)
+  {
+    m_entries.erase(it);
+    m_dirty = true;
+    return false;
+  }
+
+  it->second.used = ++m_counter;
+  details = it->second.details;
+  return true;
+}
+
+void CDVDProbeCache::Store(const std::string& file, const CStreamDetails& details)
+{
+  int64_t size, mtime;
+  if (!GetIdentity(file, size, mtime))
+    return;
+
+  CSingleLock lock(m_section);
+  EnsureLoaded();
+
+  Entry& entry = m_entries[file];
+  entry.size = size;
+  entry.mtime = mtime;
+  entry.used = ++m_counter;
+  entry.details = details;
+  m_dirty = true;
+
+  if (m_entries.size() > PROBECACHE_ENTRIES)
+    Trim();
+}
+
+void CDVDProbeCache::Trim()
+{
+  // drop the least recently used tenth, or more if many were never used since loading
+  std::vector<unsigned int> used;
+  used.reserve(m_entries.size());
+  for (EntryMap::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    used.push_back(it->second.used);
+
+  std::vector<unsigned int>::iterator nth = used.begin() + used.size() / 10;
+  std::nth_element(used.begin(), nth, used.end());
+  unsigned int threshold = *nth;
+
+  for (EntryMap::iterator it = m_entries.begin(); it != m_entries.end();)
+  {
+    if (it->second.used <= threshold)
+      m_entries.erase(it++);
+    else
+      ++it;
+  }
+}
+
+void CDVDProbeCache::Clear()
+{
+  CSingleLock lock(m_section);
+  m_entries.clear();
+  m_loaded = true;
+  m_dirty = true;
+}
+
+size_t CDVDProbeCache::Size()
+{
+  CSingleLock lock(m_section);
+  EnsureLoaded();
+  return m_entries.size();
+}
+
+void CDVDProbeCache::Unload()
+{
+  CSingleLock lock(m_section);
+  Save();
+  m_entries.clear();
+  m_loaded = false;
+  m_dirty = false;
+}
+
+void CDVDProbeCache::EnsureLoaded()
+{
+  if (!m_loaded)
+    Load();
+}
+
+bool CDVDProbeCache::Load()
+{
+  CSingleLock lock(m_section);
+  m_entries.clear();
+  m_loaded = true;
+  m_dirty = false;
+
+  CFile file;
+  if (!file.Open(m_cacheFile))
+    return false;
+
+  CArchive ar(&file, CArchive::load);
+  int version = 0;
+  int count = 0;
+  ar >> version;
+  ar >> count;
+  if (version != PROBECACHE_VERSION || count < 0 || count > PROBECACHE_ENTRIES)
+  {
+    CLog::Log(LOGWARNING, "CDVDProbeCache::Load - ignoring invalid cache %s", m_cacheFile.c_str());
+    return false;
+  }
+
+  for (int i = 0; i < count; i++)
+  {
+    std::string path;
+    Entry entry;
+    ar >> path;
+    ar >> entry.size;
+    ar >> entry.mtime;
+    ar >> entry.details;
+    entry.used = 0;
+    m_entries[path] = entry;
+  }
+  ar.Close();
+  file.Close();
+  return true;
+}
+
+bool CDVDProbeCache::Save()
+{
+  CSingleLock lock(m_section);
+  if (!m_dirty)
+    return true;
+
+  CFile file;
+  if (!file.OpenForWrite(m_cacheFile, true))
+  {
+    CLog::Log(LOGERROR, "CDVDProbeCache::Save - failed to write %s", m_cacheFile.c_str());
+    return false;
+  }
+
+  CArchive ar(&file, CArchive::store);
+  ar << (int)PROBECACHE_VERSION;
+  ar << (int)m_entries.size();
+  for (EntryMap::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    ar << it->first;
+    ar << it->second.size;
+    ar << it->second.mtime;
+    ar << it->second.details;
+  }
+  ar.Close();
+  file.Close();
+  m_dirty = false;
+  return true;
+}
@@ -0,0 +1,81 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/CriticalSection.h"
+#include "utils/StreamDetails.h"
+
+#include <map>
+#include <string>
+
+/*
+ * Results of probing media files for their streams.
+ *
+ * Entries are keyed by path and only returned while size and modification
+ * time of the file are unchanged, so listing a directory again does not open
+ * a demuxer for every file. Files that could not be probed are remembered as
+ * well, they would otherwise be retried on every listing.
+ */
+class CDVDProbeCache
+{
+public:
+  CDVDProbeCache(const std::string& cacheFile);
+
+  static CDVDProbeCache& Get();
+
+  /*
+   * Returns true if file has been probed before and did not change since.
+   * details is empty if probing the file failed.
+   */
+  bool Lookup(const std::string& file, CStreamDetails& details);
+
+  /* Store the result of probing file, empty details for a failed probe */
+  void Store(const std::string& file, const CStreamDetails& details);
+
+  void Clear();
+  size_t Size();
+
+  bool Load();
+  bool Save();
+
+  /* Save and forget the entries, they are read again on next use, e.g. from another profile */
+  void Unload();
+
+private:
+  struct Entry
+  {
+    int64_t        size;
+    int64_t        mtime;
+    unsigned int   used;
+    CStreamDetails details;
+  };
+  typedef std::map<std::string, Entry> EntryMap;
+
+  static bool GetIdentity(const std::string& file, int64_t& size, int64_t& mtime);
+  void Trim();
+  void EnsureLoaded();
+
+  CCriticalSection m_section;
+  EntryMap     m_entries;
+  std::string  m_cacheFile;
+  unsigned int m_counter;
+  bool         m_loaded;
+  bool         m_dirty;
+};
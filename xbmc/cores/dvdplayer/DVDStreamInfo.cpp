@@ -41,6 +41,7 @@ void CDVDStreamInfo::Clear()
   codec = AV_CODEC_ID_NONE;
   type = STREAM_NONE;
   software = false;
+  realtime = false;
   codec_tag  = 0;
 
   if( extradata && extrasize ) free(extradata);
@@ -166,6 +167,7 @@ void CDVDStreamInfo::Assign(const CDVDStreamInfo& right, bool withextradata)
   pid = right.pid;
   vfr = right.vfr;
   software = right.software;
+  realtime = right.realtime;
   stereo_mode = right.stereo_mode;
 
   // AUDIO
@@ -51,6 +51,7 @@ public:
   AVCodecID codec;
   StreamType type;
   bool software;  //force software decoding
+  bool realtime;  //live stream, decoder latency matters more than throughput
 
 
   // VIDEO
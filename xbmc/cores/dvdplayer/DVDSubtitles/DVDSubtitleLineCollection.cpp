@@ -21,14 +21,18 @@
 #include "DVDSubtitleLineCollection.h"
 #include "DVDClock.h"
 
+#include <algorithm>
 
-CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
+static bool CompareStart(const CDVDOverlay* a, const CDVDOverlay* b)
 {
-  m_pHead = NULL;
-  m_pCurrent = NULL;
-  m_pTail = NULL;
+  return a->iPTSStartTime < b->iPTSStartTime;
+}
 
-  m_iSize = 0;
+CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
+{
+  m_current = 0;
+  m_seek    = false;
+  m_sorted  = true;
 }
 
 CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
@@ -38,85 +42,93 @@ CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
 
 void CDVDSubtitleLineCollection::Add(CDVDOverlay* pOverlay)
 {
-  ListElement* pElement = new ListElement;
-  pElement->pOverlay = pOverlay;
-  pElement->pNext = NULL;
+  if (!m_lines.empty() && pOverlay->iPTSStartTime < m_lines.back()->iPTSStartTime)
+    m_sorted = false;
+  m_lines.push_back(pOverlay);
+}
 
-  if (!m_pHead)
+void CDVDSubtitleLineCollection::Sort()
+{
+  if (!m_sorted)
   {
-    m_pHead = m_pTail = pElement;
-    m_pCurrent = m_pHead;
+    std::stable_sort(m_lines.begin(), m_lines.end(), CompareStart);
+    m_sorted = true;
   }
-  else
+  BuildIndex();
+}
+
+void CDVDSubtitleLineCollection::BuildIndex()
+{
+  m_stopMax.resize(m_lines.size());
+  double stop = 0.0;
+  for (size_t i = 0; i < m_lines.size(); i++)
   {
-    m_pTail->pNext = pElement;
-    m_pTail = pElement;
+    if (i == 0 || m_lines[i]->iPTSStopTime > stop)
+      stop = m_lines[i]->iPTSStopTime;
+    m_stopMax[i] = stop;
   }
+}
+
+size_t CDVDSubtitleLineCollection::Find(double iPts)
+{
+  if (m_stopMax.size() != m_lines.size())
+    BuildIndex();
 
-  m_iSize++;
+  // the first line that has not stopped before iPts is also the first
+  // position where the running maximum reaches iPts
+  return std::lower_bound(m_stopMax.begin(), m_stopMax.end(), iPts) - m_stopMax.begin();
 }
 
-void CDVDSubtitleLineCollection::Sort()
+CDVDOverlay* CDVDSubtitleLineCollection::Get(double iPts)
 {
-  if (!m_pHead || !m_pHead->pNext)
-    return;
-  
-  for (ListElement* p1 = m_pHead; p1->pNext->pNext != NULL; p1 = p1->pNext)
+  if (m_seek)
   {
-    for (ListElement* p2 = p1->pNext; p2->pNext != NULL; p2 = p2->pNext)
-    {
-      if (p1->pOverlay->iPTSStartTime > p2->pOverlay->iPTSStartTime)
-      {
-        CDVDOverlay* temp = p1->pOverlay;
-        p1->pOverlay = p2->pOverlay;
-        p2->pOverlay = temp;
-      }
-    }
+    m_current = Find(iPts);
+    m_seek = false;
   }
+
+  while (m_current < m_lines.size() && m_lines[m_current]->iPTSStopTime < iPts)
+    m_current++;
+
+  if (m_current < m_lines.size())
+  {
+    // advance to the next overlay
+    return m_lines[m_current++];
+  }
+  return NULL;
 }
 
-CDVDOverlay* CDVDSubtitleLineCollection::Get(double iPts)
+int CDVDSubtitleLineCollection::GetActive(double iPts, std::vector<CDVDOverlay*>& overlays)
 {
-  CDVDOverlay* pOverlay = NULL;
-
-  if (m_pCurrent)
+  overlays.clear();
+  if (!m_sorted)
+    Sort();
+  else if (m_stopMax.size() != m_lines.size())
+    BuildIndex();
+
+  size_t i = std::upper_bound(m_stopMax.begin(), m_stopMax.end(), iPts) - m_stopMax.begin();
+  for (; i < m_lines.size() && m_lines[i]->iPTSStartTime <= iPts; i++)
   {
-    while (m_pCurrent && m_pCurrent->pOverlay->iPTSStopTime < iPts)
-    {
-      m_pCurrent = m_pCurrent->pNext;
-    }
-
-    if (m_pCurrent)
-    {
-      pOverlay = m_pCurrent->pOverlay;
-
-      // advance to the next overlay
-      m_pCurrent = m_pCurrent->pNext;
-    }
+    if (m_lines[i]->iPTSStopTime > iPts)
+      overlays.push_back(m_lines[i]);
   }
-  return pOverlay;
+  return (int)overlays.size();
 }
 
 void CDVDSubtitleLineCollection::Reset()
 {
-  m_pCurrent = m_pHead;
+  m_current = 0;
+  m_seek    = true;
 }
 
 void CDVDSubtitleLineCollection::Clear()
 {
-  ListElement* pElement = NULL;
-
-  while (m_pHead)
-  {
-    pElement = m_pHead;
-    m_pHead = pElement->pNext;
-
-    pElement->pOverlay->Release();
-    delete pElement;
-  }
-
-  m_pTail    = NULL;
-  m_pHead    = NULL;
-  m_pCurrent = NULL;
-  m_iSize    = 0;
+  for (size_t i = 0; i < m_lines.size(); i++)
+    m_lines[i]->Release();
+
+  m_lines.clear();
+  m_stopMax.clear();
+  m_current = 0;
+  m_seek    = false;
+  m_sorted  = true;
 }
@@ -22,39 +22,41 @@
 
 #include "../DVDCodecs/Overlay/DVDOverlay.h"
 
-typedef struct stListElement
-{
-  CDVDOverlay* pOverlay;
-  struct stListElement* pNext;
-
-} ListElement;
+#include <vector>
 
+/*
+ * Subtitle lines of a file, sorted by start time after Sort().
+ *
+ * Get() hands out the lines in order like a fifo. After Reset() the next Get()
+ * finds its starting line by binary search over the running maximum of stop
+ * times, so seeking does not walk the lines from the start of the file.
+ */
 class CDVDSubtitleLineCollection
 {
 public:
   CDVDSubtitleLineCollection();
   virtual ~CDVDSubtitleLineCollection();
 
-  //void Lock()   { EnterCriticalSection(&m_critSection); }
-  //void Unlock() { LeaveCriticalSection(&m_critSection); }
-
   void Add(CDVDOverlay* pSubtitle);
   void Sort();
 
   CDVDOverlay* Get(double iPts = 0LL); // get the first overlay in this fifo
 
+  /* lines showing at iPts, overlapping ones included, returns their number */
+  int GetActive(double iPts, std::vector<CDVDOverlay*>& overlays);
+
   void Reset();
 
-  void Remove();
   void Clear();
-  int GetSize() { return m_iSize; }
+  int GetSize() { return (int)m_lines.size(); }
 
 private:
-  ListElement* m_pHead;
-  ListElement* m_pCurrent;
-  ListElement* m_pTail;
-
-  int m_iSize;
-  //CRITICAL_SECTION m_critSection;
+  void   BuildIndex();
+  size_t Find(double iPts);
+
+  std::vector<CDVDOverlay*> m_lines;
+  std::vector<double>       m_stopMax; // highest stop time of lines up to and including i
+  size_t                    m_current;
+  bool                      m_seek;
+  bool                      m_sorted;
 };
-
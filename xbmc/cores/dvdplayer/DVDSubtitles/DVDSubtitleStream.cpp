@@ -26,11 +26,15 @@
 #include "utils/CharsetDetection.h"
 #include "filesystem/File.h"
 
+#include <algorithm>
+#include <string.h>
+
 using namespace std;
 using XFILE::auto_buffer;
 
 CDVDSubtitleStream::CDVDSubtitleStream()
 {
+  m_position = 0;
 }
 
 CDVDSubtitleStream::~CDVDSubtitleStream()
@@ -65,27 +69,22 @@ bool CDVDSubtitleStream::Open(const string& strFile)
 
     std::string tmpStr(buf.get(), totalread);
     buf.clear();
+    m_position = 0;
 
     std::string enc(CCharsetDetection::GetBomEncoding(tmpStr));
     if (enc == "UTF-8" || (enc.empty() && CUtf8Utils::isValidUtf8(tmpStr)))
-      m_stringstream << tmpStr;
+      m_buffer.swap(tmpStr);
     else if (!enc.empty())
     {
-      std::string converted;
-      g_charsetConverter.ToUtf8(enc, tmpStr, converted);
-      if (converted.empty())
+      g_charsetConverter.ToUtf8(enc, tmpStr, m_buffer);
+      if (m_buffer.empty())
         return false;
-
-      m_stringstream << converted;
     }
     else
     {
-      std::string converted;
-      g_charsetConverter.subtitleCharsetToUtf8(tmpStr, converted);
-      if (converted.empty())
+      g_charsetConverter.subtitleCharsetToUtf8(tmpStr, m_buffer);
+      if (m_buffer.empty())
         return false;
-
-      m_stringstream << converted;
     }
 
     return true;
@@ -97,37 +96,50 @@ bool CDVDSubtitleStream::Open(const string& strFile)
 
 int CDVDSubtitleStream::Read(char* buf, int buf_size)
 {
-  return (int)m_stringstream.readsome(buf, buf_size);
+  size_t read = std::min((size_t)std::max(buf_size, 0), m_buffer.size() - m_position);
+  memcpy(buf, m_buffer.data() + m_position, read);
+  m_position += read;
+  return (int)read;
 }
 
 long CDVDSubtitleStream::Seek(long offset, int whence)
 {
+  long position;
   switch (whence)
   {
     case SEEK_CUR:
-    {
-      m_stringstream.seekg(offset, ios::cur);
+      position = (long)m_position + offset;
       break;
-    }
     case SEEK_END:
-    {
-      m_stringstream.seekg(offset, ios::end);
+      position = (long)m_buffer.size() + offset;
       break;
-    }
     case SEEK_SET:
-    {
-      m_stringstream.seekg(offset, ios::beg);
+    default:
+      position = offset;
       break;
-    }
   }
-  return (int)m_stringstream.tellg();
+  if (position < 0 || position > (long)m_buffer.size())
+    return -1;
+
+  m_position = position;
+  return position;
 }
 
 char* CDVDSubtitleStream::ReadLine(char* buf, int iLen)
 {
-  if (m_stringstream.getline(buf, iLen))
-    return buf;
-  else
+  if (m_position >= m_buffer.size() || iLen <= 0)
     return NULL;
-}
 
+  const char* start = m_buffer.data() + m_position;
+  size_t left = m_buffer.size() - m_position;
+  const char* end = (const char*)memchr(start, '\n', left);
+  size_t length = end ? end - start : left;
+
+  // overlong lines are cut, the rest of the line is skipped
+  size_t copy = std::min(length, (size_t)iLen - 1);
+  memcpy(buf, start, copy);
+  buf[copy] = '\0';
+
+  m_position += end ? length + 1 : length;
+  return buf;
+}
@@ -23,7 +23,6 @@
 #include "system.h"
 
 #include <string>
-#include <sstream>
 
 class CDVDInputStream;
 
@@ -42,6 +41,11 @@ public:
   char* ReadLine(char* pBuffer, int iLen);
   //wchar* ReadLineW(wchar* pBuffer, int iLen) { return NULL; };
 
-  std::stringstream m_stringstream;
+  /* whole file as utf-8 */
+  const std::string& GetBuffer() const { return m_buffer; }
+
+private:
+  std::string m_buffer;
+  size_t      m_position;
 };
 
@@ -30,8 +30,99 @@
 #include "threads/Atomics.h"
 #include "guilib/GraphicContext.h"
 
+#include <math.h>
+#include <string.h>
+
+// frames rendered ahead of the last requested one
+#define PRERENDER_FRAMES 8
+// memory used for cached images
+#define CACHE_SIZE       (32 * 1024 * 1024)
+
 using namespace std;
 
+class CDVDSubtitlesLibass::CPrerenderJob : public CJob
+{
+public:
+  CPrerenderJob(CDVDSubtitlesLibass* libass, int width, int height, double pts, double pixelRatio)
+  {
+    m_libass     = libass->Acquire();
+    m_width      = width;
+    m_height     = height;
+    m_pts        = pts;
+    m_pixelRatio = pixelRatio;
+  }
+
+  virtual ~CPrerenderJob()
+  {
+    m_libass->Release();
+  }
+
+  virtual const char *GetType() const { return "libassprerender"; }
+
+  virtual bool DoWork()
+  {
+    for (int i = 1; i <= PRERENDER_FRAMES; i++)
+    {
+      if (ShouldCancel(i, PRERENDER_FRAMES))
+        return false;
+
+      CKey   key;
+      double pts;
+      {
+        CSingleLock lock(m_libass->m_cacheSection);
+        if (m_libass->m_cacheBytes > CACHE_SIZE)
+          break;
+        pts = m_pts + i * m_libass->m_frameDuration;
+        if (!m_libass->GetKey(m_width, m_height, pts, key)
+        ||  m_libass->m_cache.find(key) != m_libass->m_cache.end())
+          continue;
+        pts = m_libass->GetFramePts(key, pts);
+      }
+
+      CImages* images = m_libass->Render(key, pts, m_pixelRatio);
+      if (!images)
+        return false;
+      m_libass->Store(key, images);
+    }
+    return true;
+  }
+
+private:
+  CDVDSubtitlesLibass* m_libass;
+  int    m_width;
+  int    m_height;
+  double m_pts;
+  double m_pixelRatio;
+};
+
+bool CDVDSubtitlesLibass::CKey::operator<(const CKey& right) const
+{
+  if (width != right.width)
+    return width < right.width;
+  if (height != right.height)
+    return height < right.height;
+  if (frame != right.frame)
+    return frame < right.frame;
+  return events < right.events;
+}
+
+/* Events that look different on every frame they are shown on */
+static bool IsAnimated(const ASS_Event* event)
+{
+  if (event->Effect && event->Effect[0])
+    return true;
+  if (!event->Text)
+    return false;
+
+  static const char* tags[] = { "\\t(", "\\move", "\\fad", "\\k", "\\K" };
+  for (unsigned int i = 0; i < sizeof(tags) / sizeof(tags[0]); i++)
+  {
+    if (strstr(event->Text, tags[i]))
+      return true;
+  }
+  return false;
+}
+
 static void libass_log(int level, const char *fmt, va_list args, void *data)
 {
   if(level >= 5)
@@ -47,6 +138,14 @@ CDVDSubtitlesLibass::CDVDSubtitlesLibass()
   m_library = NULL;
   m_renderer = NULL;
   m_references = 1;
+  m_last = NULL;
+  m_cacheBytes = 0;
+  m_frameDuration = DVD_MSEC_TO_TIME(40);
+  m_frameCandidate = 0.0;
+  m_frameVotes = 0;
+  m_lastPts = DVD_NOPTS_VALUE;
+  m_pixelRatio = 0.0;
+  m_prerender = true;
 
   if(!m_dll.Load())
   {
@@ -96,6 +195,9 @@ CDVDSubtitlesLibass::CDVDSubtitlesLibass()
 
 CDVDSubtitlesLibass::~CDVDSubtitlesLibass()
 {
+  m_prerenderQueue.CancelJobs();
+  ClearCache();
+
   if(m_dll.IsLoaded())
   {
     if(m_track)
@@ -133,6 +235,7 @@ bool CDVDSubtitlesLibass::DecodeDemuxPkt(char* data, int size, double start, dou
   }
 
   m_dll.ass_process_chunk(m_track, data, size, DVD_TIME_TO_MSEC(start), DVD_TIME_TO_MSEC(duration));
+  UpdateEvents();
   return true;
 }
 
@@ -151,10 +254,120 @@ bool CDVDSubtitlesLibass::CreateTrack(char* buf, size_t size)
   if(m_track == NULL)
     return false;
 
+  UpdateEvents();
   return true;
 }
 
 ASS_Image* CDVDSubtitlesLibass::RenderImage(int imageWidth, int imageHeight, double pts, int *changes)
+{
+  double   pixelRatio = g_graphicsContext.GetResInfo().fPixelRatio;
+  CImages* images = NULL;
+  CKey     key;
+  double   framePts = pts;
+  bool     visible;
+  {
+    CSingleLock lock(m_cacheSection);
+    if (pixelRatio != m_pixelRatio)
+    {
+      ClearCache();
+      m_pixelRatio = pixelRatio;
+    }
+    UpdateFrameDuration(pts);
+
+    visible = GetKey(imageWidth, imageHeight, pts, key);
+    if (visible)
+    {
+      CImageMap::iterator it = m_cache.find(key);
+      if (it != m_cache.end())
+      {
+        images = it->second;
+        images->used = pts;
+      }
+      else
+        framePts = GetFramePts(key, pts);
+    }
+  }
+
+  // not rendered ahead, render it now
+  if (visible && !images)
+  {
+    images = Render(key, framePts, pixelRatio);
+    if (!images)
+      return NULL;
+    images = Store(key, images);
+  }
+
+  {
+    CSingleLock lock(m_cacheSection);
+    if (changes)
+      *changes = images != m_last ? 2 : 0;
+    m_last = images;
+    Prune(pts);
+  }
+
+  if (m_prerender)
+    Prerender(imageWidth, imageHeight, pts, pixelRatio);
+
+  if (!images || images->images.empty())
+    return NULL;
+  return &images->images[0];
+}
+
+void CDVDSubtitlesLibass::SetPrerender(bool prerender)
+{
+  m_prerender = prerender;
+  if (!prerender)
+    m_prerenderQueue.CancelJobs();
+}
+
+void CDVDSubtitlesLibass::UpdateEvents()
+{
+  CSingleLock lock(m_cacheSection);
+  if (!m_track)
+    return;
+
+  // events are only ever appended to the track
+  for (int i = (int)m_events.size(); i < m_track->n_events; i++)
+  {
+    const ASS_Event* event = &m_track->events[i];
+    CEvent e;
+    e.start    = event->Start;
+    e.stop     = event->Start + event->Duration;
+    e.animated = IsAnimated(event);
+    m_events.push_back(e);
+  }
+}
+
+bool CDVDSubtitlesLibass::GetKey(int width, int height, double pts, CKey& key)
+{
+  int64_t now = (int64_t)DVD_TIME_TO_MSEC(pts);
+  bool animated = false;
+
+  key.width  = width;
+  key.height = height;
+  key.events.clear();
+  for (size_t i = 0; i < m_events.size(); i++)
+  {
+    if (m_events[i].start <= now && now < m_events[i].stop)
+    {
+      key.events.push_back(i);
+      animated |= m_events[i].animated;
+    }
+  }
+
+  // without animation the images only change with the events shown
+  key.frame = animated ? (int64_t)floor(pts / m_frameDuration + 0.5) : -1;
+  return !key.events.empty();
+}
+
+double CDVDSubtitlesLibass::GetFramePts(const CKey& key, double pts) const
+{
+  if (key.frame < 0)
+    return pts;
+  return key.frame * m_frameDuration;
+}
+
+CDVDSubtitlesLibass::CImages* CDVDSubtitlesLibass::Render(const CKey& key, double pts, double pixelRatio)
 {
   CSingleLock lock(m_section);
   if(!m_renderer || !m_track)
@@ -163,10 +376,131 @@ ASS_Image* CDVDSubtitlesLibass::RenderImage(int imageWidth, int imageHeight, dou
     return NULL;
   }
 
-  double storage_aspact = (double)imageWidth / imageHeight;
-  m_dll.ass_set_frame_size(m_renderer, imageWidth, imageHeight);
-  m_dll.ass_set_aspect_ratio(m_renderer, storage_aspact / g_graphicsContext.GetResInfo().fPixelRatio, storage_aspact);
-  return m_dll.ass_render_frame(m_renderer, m_track, DVD_TIME_TO_MSEC(pts), changes);
+  double storage_aspact = (double)key.width / key.height;
+  m_dll.ass_set_frame_size(m_renderer, key.width, key.height);
+  m_dll.ass_set_aspect_ratio(m_renderer, storage_aspact / pixelRatio, storage_aspact);
+  ASS_Image* img = m_dll.ass_render_frame(m_renderer, m_track, DVD_TIME_TO_MSEC(pts), NULL);
+
+  // the images are only valid until the next render, copy them
+  size_t count = 0, bytes = 0;
+  for (ASS_Image* i = img; i; i = i->next)
+  {
+    count++;
+    bytes += i->w * i->h;
+  }
+
+  CImages* images = new CImages();
+  images->used = pts;
+  images->images.resize(count);
+  images->bitmaps.resize(bytes);
+
+  size_t offset = 0;
+  for (size_t n = 0; n < count; n++, img = img->next)
+  {
+    ASS_Image& copy = images->images[n];
+    copy = *img;
+    copy.next = n + 1 < count ? &images->images[n + 1] : NULL;
+    copy.bitmap = NULL;
+    if (img->w * img->h == 0)
+      continue;
+
+    copy.bitmap = &images->bitmaps[offset];
+    copy.stride = img->w;
+    for (int y = 0; y < img->h; y++)
+      memcpy(copy.bitmap + y * img->w, img->bitmap + y * img->stride, img->w);
+    offset += img->w * img->h;
+  }
+  return images;
+}
+
+CDVDSubtitlesLibass::CImages* CDVDSubtitlesLibass::Store(const CKey& key, CImages* images)
+{
+  CSingleLock lock(m_cacheSection);
+  CImageMap::iterator it = m_cache.find(key);
+  if (it != m_cache.end())
+  {
+    // rendered by both the job and the caller
+    delete images;
+    return it->second;
+  }
+
+  m_cache[key] = images;
+  m_cacheBytes += images->images.size() * sizeof(ASS_Image) + images->bitmaps.size();
+  return images;
+}
+
+void CDVDSubtitlesLibass::Prune(double pts)
+{
+  // drop what was shown already, then what is furthest away
+  for (CImageMap::iterator it = m_cache.begin(); it != m_cache.end();)
+  {
+    CImages* images = it->second;
+    if (images != m_last && images->used < pts - m_frameDuration)
+    {
+      m_cacheBytes -= images->images.size() * sizeof(ASS_Image) + images->bitmaps.size();
+      delete images;
+      m_cache.erase(it++);
+    }
+    else
+      ++it;
+  }
+
+  while (m_cacheBytes > CACHE_SIZE)
+  {
+    CImageMap::iterator furthest = m_cache.end();
+    for (CImageMap::iterator it = m_cache.begin(); it != m_cache.end(); ++it)
+    {
+      if (it->second != m_last
+      && (furthest == m_cache.end() || fabs(it->second->used - pts) > fabs(furthest->second->used - pts)))
+        furthest = it;
+    }
+    if (furthest == m_cache.end())
+      break;
+    m_cacheBytes -= furthest->second->images.size() * sizeof(ASS_Image) + furthest->second->bitmaps.size();
+    delete furthest->second;
+    m_cache.erase(furthest);
+  }
+}
+
+void CDVDSubtitlesLibass::ClearCache()
+{
+  CSingleLock lock(m_cacheSection);
+  for (CImageMap::iterator it = m_cache.begin(); it != m_cache.end(); ++it)
+    delete it->second;
+  m_cache.clear();
+  m_cacheBytes = 0;
+  m_last = NULL;
+}
+
+void CDVDSubtitlesLibass::Prerender(int width, int height, double pts, double pixelRatio)
+{
+  // a job still running will pick up the frames from its own start
+  if (m_prerenderQueue.IsProcessing())
+    return;
+  m_prerenderQueue.AddJob(new CPrerenderJob(this, width, height, pts, pixelRatio));
+}
+
+void CDVDSubtitlesLibass::UpdateFrameDuration(double pts)
+{
+  /* frames are requested once per video frame, learn the frame duration
+   * from the distance between requests once it has been stable for a while */
+  double duration = pts - m_lastPts;
+  m_lastPts = pts;
+  if (duration <= DVD_MSEC_TO_TIME(5) || duration > DVD_MSEC_TO_TIME(100))
+    return;
+
+  if (fabs(duration - m_frameCandidate) > m_frameCandidate * 0.1)
+  {
+    m_frameCandidate = duration;
+    m_frameVotes = 0;
+    return;
+  }
+
+  if (++m_frameVotes < 8 || fabs(m_frameCandidate - m_frameDuration) <= m_frameDuration * 0.1)
+    return;
+
+  m_frameDuration = m_frameCandidate;
+  ClearCache();
 }
 
 ASS_Event* CDVDSubtitlesLibass::GetEvents()
@@ -23,15 +23,31 @@
 #include "DllLibass.h"
 #include "DVDResource.h"
 #include "threads/CriticalSection.h"
+#include "utils/JobManager.h"
+
+#include <map>
+#include <vector>
 
 /** Wrapper for Libass **/
 
+/*
+ * Rendered images are copied into a cache keyed by the events shown, the
+ * frame they were rendered for and the output size. A job renders the frames
+ * following the last requested one ahead of time, so the render path usually
+ * only looks up the cache. Frames only showing events without animation are
+ * shared between all frames those events are shown on.
+ */
+
 class CDVDSubtitlesLibass : public IDVDResourceCounted<CDVDSubtitlesLibass>
 {
 public:
   CDVDSubtitlesLibass();
   virtual ~CDVDSubtitlesLibass();
 
+  /*
+   * The returned images stay valid until the next call. changes is 0 if the
+   * images are the same as returned by the previous call.
+   */
   ASS_Image* RenderImage(int imageWidth, int imageHeight, double pts, int* changes = NULL);
   ASS_Event* GetEvents();
 
@@ -41,12 +57,66 @@ public:
   bool DecodeDemuxPkt(char* data, int size, double start, double duration);
   bool CreateTrack(char* buf, size_t size);
 
+  /* Render frames ahead of the requested ones, enabled by default */
+  void SetPrerender(bool prerender);
+
 private:
+  class CPrerenderJob;
+  friend class CPrerenderJob;
+
+  struct CEvent
+  {
+    int64_t start;
+    int64_t stop;
+    bool    animated;
+  };
+
+  struct CKey
+  {
+    int     width;
+    int     height;
+    int64_t frame;
+    std::vector<int> events;
+    bool operator<(const CKey& right) const;
+  };
+
+  struct CImages
+  {
+    std::vector<ASS_Image> images;
+    std::vector<uint8_t>   bitmaps;
+    double                 used;
+  };
+  typedef std::map<CKey, CImages*> CImageMap;
+
+  void      UpdateEvents();
+  bool      GetKey(int width, int height, double pts, CKey& key);
+  double    GetFramePts(const CKey& key, double pts) const;
+  CImages*  Render(const CKey& key, double pts, double pixelRatio);
+  CImages*  Store(const CKey& key, CImages* images);
+  void      Prune(double pts);
+  void      ClearCache();
+  void      Prerender(int width, int height, double pts, double pixelRatio);
+  void      UpdateFrameDuration(double pts);
+
   DllLibass m_dll;
   long m_references;
   ASS_Library* m_library;
   ASS_Track* m_track;
   ASS_Renderer* m_renderer;
   CCriticalSection m_section;
+
+  // guards the members below, never held while rendering
+  CCriticalSection m_cacheSection;
+  std::vector<CEvent> m_events;
+  CImageMap     m_cache;
+  CImages*      m_last;
+  size_t        m_cacheBytes;
+  double        m_frameDuration;
+  double        m_frameCandidate;
+  int           m_frameVotes;
+  double        m_lastPts;
+  double        m_pixelRatio;
+  bool          m_prerender;
+  CJobQueue     m_prerenderQueue;
 };
 
@@ -31,6 +31,8 @@
 #include "pvr/recordings/PVRRecordings.h"
 #include "pvr/PVRManager.h"
 
+#include <algorithm>
+
 extern "C"
 {
 #include "cmyth/include/cmyth/cmyth.h"
@@ -48,25 +50,54 @@ using namespace XFILE;
 
 CEdl::CEdl()
 {
+  m_bWroteMPlayerEdl = false;
   Clear();
 }
 
+CEdl::CEdl(const CEdl& edl)
+{
+  m_bWroteMPlayerEdl = false;
+  *this = edl;
+}
+
 CEdl::~CEdl()
 {
   Clear();
 }
 
+CEdl& CEdl::operator=(const CEdl& edl)
+{
+  if (this != &edl)
+  {
+    Clear();
+    m_iTotalCutTime = edl.m_iTotalCutTime;
+    m_vecCuts = edl.m_vecCuts;
+    m_vecSceneMarkers = edl.m_vecSceneMarkers;
+    m_vecCutTime = edl.m_vecCutTime;
+  }
+  return *this;
+}
+
+/*
+ * Comparison for upper_bound() on the cut start times.
+ */
+static bool StartsAfter(const int64_t iTime, const CEdl::Cut& cut)
+{
+  return iTime < cut.start;
+}
+
 void CEdl::Clear()
 {
-  if (CFile::Exists(MPLAYER_EDL_FILENAME))
+  if (m_bWroteMPlayerEdl && CFile::Exists(MPLAYER_EDL_FILENAME))
     CFile::Delete(MPLAYER_EDL_FILENAME);
+  m_bWroteMPlayerEdl = false;
 
   m_vecCuts.clear();
   m_vecSceneMarkers.clear();
-  m_iTotalCutTime = 0;
+  BuildIndex();
 }
 
-bool CEdl::ReadEditDecisionLists(const CStdString& strMovie, const float fFrameRate, const int iHeight)
+bool CEdl::ReadEditDecisionLists(const CStdString& strMovie, const float fFrameRate, const int iHeight, bool bWriteMPlayerEdl)
 {
   /*
    * The frame rate hints returned from ffmpeg for the video stream do not appear to take into
@@ -166,10 +197,10 @@ bool CEdl::ReadEditDecisionLists(const CStdString& strMovie, const float fFrameR
   }
 
   if (bFound)
-  {
     MergeShortCommBreaks();
+  BuildIndex();
+  if (bFound && bWriteMPlayerEdl)
     WriteMPlayerEdl();
-  }
   return bFound;
 }
 
@@ -698,15 +729,17 @@ bool CEdl::AddCut(Cut& cut)
     return false;
   }
 
-  for (int i = 0; i < (int)m_vecCuts.size(); i++)
+  /*
+   * As the cuts don't overlap the first one starting after the new cut also ends first, so it's
+   * the only one that needs to be checked.
+   */
+  vector<Cut>::iterator pNextCut = upper_bound(m_vecCuts.begin(), m_vecCuts.end(), cut.start, StartsAfter);
+  if (pNextCut != m_vecCuts.end() && cut.end > pNextCut->end)
   {
-    if (cut.start < m_vecCuts[i].start && cut.end > m_vecCuts[i].end)
-    {
-      CLog::Log(LOGERROR, "%s - Cut surrounds an existing cut! [%s - %s], %d", __FUNCTION__,
-                MillisecondsToTimeString(cut.start).c_str(), MillisecondsToTimeString(cut.end).c_str(),
-                cut.action);
-      return false;
-    }
+    CLog::Log(LOGERROR, "%s - Cut surrounds an existing cut! [%s - %s], %d", __FUNCTION__,
+              MillisecondsToTimeString(cut.start).c_str(), MillisecondsToTimeString(cut.end).c_str(),
+              cut.action);
+    return false;
   }
 
   if (cut.action == COMM_BREAK)
@@ -728,7 +761,7 @@ bool CEdl::AddCut(Cut& cut)
   /*
    * Insert cut in the list in the right position (ALL algorithms assume cuts are in ascending order)
    */
-  if (m_vecCuts.empty() || cut.start > m_vecCuts.back().start)
+  if (pNextCut == m_vecCuts.end())
   {
     CLog::Log(LOGDEBUG, "%s - Pushing new cut to back [%s - %s], %d", __FUNCTION__,
               MillisecondsToTimeString(cut.start).c_str(), MillisecondsToTimeString(cut.end).c_str(),
@@ -737,18 +770,10 @@ bool CEdl::AddCut(Cut& cut)
   }
   else
   {
-    vector<Cut>::iterator pCurrentCut;
-    for (pCurrentCut = m_vecCuts.begin(); pCurrentCut != m_vecCuts.end(); ++pCurrentCut)
-    {
-      if (cut.start < pCurrentCut->start)
-      {
-        CLog::Log(LOGDEBUG, "%s - Inserting new cut [%s - %s], %d", __FUNCTION__,
-                  MillisecondsToTimeString(cut.start).c_str(), MillisecondsToTimeString(cut.end).c_str(),
-                  cut.action);
-        m_vecCuts.insert(pCurrentCut, cut);
-        break;
-      }
-    }
+    CLog::Log(LOGDEBUG, "%s - Inserting new cut [%s - %s], %d", __FUNCTION__,
+              MillisecondsToTimeString(cut.start).c_str(), MillisecondsToTimeString(cut.end).c_str(),
+              cut.action);
+    m_vecCuts.insert(pNextCut, cut);
   }
 
   if (cut.action == CUT)
@@ -766,7 +791,7 @@ bool CEdl::AddSceneMarker(const int64_t iSceneMarker)
 
   CLog::Log(LOGDEBUG, "%s - Inserting new scene marker: %s", __FUNCTION__,
             MillisecondsToTimeString(iSceneMarker).c_str());
-  m_vecSceneMarkers.push_back(iSceneMarker); // Unsorted
+  m_vecSceneMarkers.push_back(iSceneMarker); // Sorted by BuildIndex()
 
   return true;
 }
@@ -783,6 +808,7 @@ bool CEdl::WriteMPlayerEdl()
               MPLAYER_EDL_FILENAME);
     return false;
   }
+  m_bWroteMPlayerEdl = true;
 
   CStdString strBuffer;
   for (int i = 0; i < (int)m_vecCuts.size(); i++)
@@ -812,61 +838,61 @@ CStdString CEdl::GetMPlayerEdl()
   return MPLAYER_EDL_FILENAME;
 }
 
-bool CEdl::HasCut()
+bool CEdl::HasCut() const
 {
   return !m_vecCuts.empty();
 }
 
-int64_t CEdl::GetTotalCutTime()
+int64_t CEdl::GetTotalCutTime() const
 {
   return m_iTotalCutTime; // ms
 }
 
-int64_t CEdl::RemoveCutTime(int64_t iSeek)
+int64_t CEdl::RemoveCutTime(int64_t iSeek) const
 {
   if (!HasCut())
     return iSeek;
 
   /*
-   * TODO: Consider an optimisation of using the (now unused) total cut time if the seek time
-   * requested is later than the end of the last recorded cut. For example, when calculating the
-   * total duration for display.
+   * All cuts before the one the seek time is in or after have been passed over.
    */
-  int64_t iCutTime = 0;
-  for (int i = 0; i < (int)m_vecCuts.size(); i++)
-  {
-    if (m_vecCuts[i].action == CUT)
-    {
-      if (iSeek >= m_vecCuts[i].start && iSeek <= m_vecCuts[i].end) // Inside cut
-        iCutTime += iSeek - m_vecCuts[i].start - 1; // Decrease cut length by 1ms to jump over end boundary.
-      else if (iSeek >= m_vecCuts[i].start) // Cut has already been passed over.
-        iCutTime += m_vecCuts[i].end - m_vecCuts[i].start;
-    }
-  }
-  return iSeek - iCutTime;
+  size_t i = upper_bound(m_vecCuts.begin(), m_vecCuts.end(), iSeek, StartsAfter) - m_vecCuts.begin();
+  if (i > 0 && m_vecCuts[i - 1].action == CUT && iSeek <= m_vecCuts[i - 1].end) // Inside cut
+    return iSeek - m_vecCutTime[i - 1] - (iSeek - m_vecCuts[i - 1].start - 1); // Decrease cut length by 1ms to jump over end boundary.
+
+  return iSeek - m_vecCutTime[i];
 }
 
-int64_t CEdl::RestoreCutTime(int64_t iClock)
+int64_t CEdl::RestoreCutTime(int64_t iClock) const
 {
   if (!HasCut())
     return iClock;
 
-  int64_t iSeek = iClock;
-  for (int i = 0; i < (int)m_vecCuts.size(); i++)
+  /*
+   * A cut is passed over if the clock is at or after its start with the earlier cuts removed. That
+   * time only increases from one cut to the next, so the number of cuts passed over can be found
+   * by a binary search.
+   */
+  size_t iLow = 0;
+  size_t iHigh = m_vecCuts.size();
+  while (iLow < iHigh)
   {
-    if (m_vecCuts[i].action == CUT && iSeek >= m_vecCuts[i].start)
-      iSeek += m_vecCuts[i].end - m_vecCuts[i].start;
+    size_t iMid = (iLow + iHigh) / 2;
+    if (iClock >= m_vecCuts[iMid].start - m_vecCutTime[iMid])
+      iLow = iMid + 1;
+    else
+      iHigh = iMid;
   }
 
-  return iSeek;
+  return iClock + m_vecCutTime[iLow];
 }
 
-bool CEdl::HasSceneMarker()
+bool CEdl::HasSceneMarker() const
 {
   return !m_vecSceneMarkers.empty();
 }
 
-CStdString CEdl::GetInfo()
+CStdString CEdl::GetInfo() const
 {
   CStdString strInfo = "";
   if (HasCut())
@@ -900,25 +926,25 @@ CStdString CEdl::GetInfo()
   return strInfo.empty() ? "-" : strInfo;
 }
 
-bool CEdl::InCut(const int64_t iSeek, Cut *pCut)
+bool CEdl::InCut(const int64_t iSeek, Cut *pCut) const
 {
-  for (int i = 0; i < (int)m_vecCuts.size(); i++)
-  {
-    if (iSeek < m_vecCuts[i].start) // Early exit if not even up to the cut start time.
-      return false;
+  /*
+   * Only the last cut starting at or before the seek time can contain it.
+   */
+  vector<Cut>::const_iterator pCurrentCut = upper_bound(m_vecCuts.begin(), m_vecCuts.end(), iSeek, StartsAfter);
+  if (pCurrentCut == m_vecCuts.begin())
+    return false;
 
-    if (iSeek >= m_vecCuts[i].start && iSeek <= m_vecCuts[i].end) // Inside cut.
-    {
-      if (pCut)
-        *pCut = m_vecCuts[i];
-      return true;
-    }
-  }
+  --pCurrentCut;
+  if (iSeek > pCurrentCut->end)
+    return false;
 
-  return false;
+  if (pCut)
+    *pCut = *pCurrentCut;
+  return true;
 }
 
-bool CEdl::GetNextSceneMarker(bool bPlus, const int64_t iClock, int64_t *iSceneMarker)
+bool CEdl::GetNextSceneMarker(bool bPlus, const int64_t iClock, int64_t *iSceneMarker) const
 {
   if (!HasSceneMarker())
     return false;
@@ -930,26 +956,20 @@ bool CEdl::GetNextSceneMarker(bool bPlus, const int64_t iClock, int64_t *iSceneM
 
   if (bPlus) // Find closest scene forwards
   {
-    for (int i = 0; i < (int)m_vecSceneMarkers.size(); i++)
+    vector<int64_t>::const_iterator pMarker = upper_bound(m_vecSceneMarkers.begin(), m_vecSceneMarkers.end(), iSeek);
+    if (pMarker != m_vecSceneMarkers.end() && *pMarker - iSeek < iDiff)
     {
-      if ((m_vecSceneMarkers[i] > iSeek) && ((m_vecSceneMarkers[i] - iSeek) < iDiff))
-      {
-        iDiff = m_vecSceneMarkers[i] - iSeek;
-        *iSceneMarker = m_vecSceneMarkers[i];
-        bFound = true;
-      }
+      *iSceneMarker = *pMarker;
+      bFound = true;
     }
   }
   else // Find closest scene backwards
   {
-    for (int i = 0; i < (int)m_vecSceneMarkers.size(); i++)
+    vector<int64_t>::const_iterator pMarker = lower_bound(m_vecSceneMarkers.begin(), m_vecSceneMarkers.end(), iSeek);
+    if (pMarker != m_vecSceneMarkers.begin() && iSeek - *(pMarker - 1) < iDiff)
     {
-      if ((m_vecSceneMarkers[i] < iSeek) && ((iSeek - m_vecSceneMarkers[i]) < iDiff))
-      {
-        iDiff = iSeek - m_vecSceneMarkers[i];
-        *iSceneMarker = m_vecSceneMarkers[i];
-        bFound = true;
-      }
+      *iSceneMarker = *(pMarker - 1);
+      bFound = true;
     }
   }
 
@@ -1167,3 +1187,31 @@ void CEdl::MergeShortCommBreaks()
   }
   return;
 }
+
+void CEdl::BuildIndex()
+{
+  m_vecCutTime.resize(m_vecCuts.size() + 1);
+  m_vecCutTime[0] = 0;
+  for (size_t i = 0; i < m_vecCuts.size(); i++)
+  {
+    m_vecCutTime[i + 1] = m_vecCutTime[i];
+    if (m_vecCuts[i].action == CUT)
+      m_vecCutTime[i + 1] += m_vecCuts[i].end - m_vecCuts[i].start;
+  }
+  m_iTotalCutTime = m_vecCutTime.back();
+
+  sort(m_vecSceneMarkers.begin(), m_vecSceneMarkers.end());
+}
+
+CEdlJob::CEdlJob(const CStdString& strMovie, const float fFramesPerSecond, const int iHeight)
+  : m_strMovie(strMovie),
+    m_fFramesPerSecond(fFramesPerSecond),
+    m_iHeight(iHeight)
+{
+}
+
+bool CEdlJob::DoWork()
+{
+  // the player writes the MPlayer EDL file once it takes the EDL over, so a cancelled job leaves none behind
+  return m_edl.ReadEditDecisionLists(m_strMovie, m_fFramesPerSecond, m_iHeight, false);
+}
@@ -23,13 +23,17 @@
 #include <vector>
 #include <stdint.h>
 #include "utils/StdString.h"
+#include "utils/Job.h"
 
 class CEdl
 {
 public:
   CEdl();
+  CEdl(const CEdl& edl);
   virtual ~CEdl(void);
 
+  CEdl& operator=(const CEdl& edl);
+
   typedef enum
   {
     CUT = 0,
@@ -45,20 +49,30 @@ public:
     Action action;
   };
 
-  bool ReadEditDecisionLists(const CStdString& strMovie, const float fFramesPerSecond, const int iHeight);
+  /*
+   * Reads the lists and builds the index the lookups below use, which never change the CEdl so
+   * they can be called from any thread while nothing reads the lists. The MPlayer EDL file is only
+   * written if bWriteMPlayerEdl is set, see WriteMPlayerEdl().
+   */
+  bool ReadEditDecisionLists(const CStdString& strMovie, const float fFramesPerSecond, const int iHeight, bool bWriteMPlayerEdl = true);
   void Clear();
 
-  bool HasCut();
-  bool HasSceneMarker();
-  CStdString GetInfo();
-  int64_t GetTotalCutTime();
-  int64_t RemoveCutTime(int64_t iSeek);
-  int64_t RestoreCutTime(int64_t iClock);
+  bool HasCut() const;
+  bool HasSceneMarker() const;
+  CStdString GetInfo() const;
+  int64_t GetTotalCutTime() const;
+  int64_t RemoveCutTime(int64_t iSeek) const;
+  int64_t RestoreCutTime(int64_t iClock) const;
 
-  bool InCut(int64_t iSeek, Cut *pCut = NULL);
+  bool InCut(int64_t iSeek, Cut *pCut = NULL) const;
 
-  bool GetNextSceneMarker(bool bPlus, const int64_t iClock, int64_t *iSceneMarker);
+  bool GetNextSceneMarker(bool bPlus, const int64_t iClock, int64_t *iSceneMarker) const;
 
+  /*
+   * Writes the cuts to the MPlayer EDL file, which is deleted again when this CEdl is cleared.
+   * Copies of a CEdl don't delete the file written by the original.
+   */
+  bool WriteMPlayerEdl();
   static CStdString GetMPlayerEdl();
 
   static CStdString MillisecondsToTimeString(const int64_t iMilliseconds);
@@ -66,9 +80,16 @@ public:
 protected:
 private:
   int64_t m_iTotalCutTime; // ms
-  std::vector<Cut> m_vecCuts;
+  std::vector<Cut> m_vecCuts; // Sorted by start, never overlapping.
   std::vector<int64_t> m_vecSceneMarkers;
 
+  /*
+   * Time removed by the cuts before each entry of m_vecCuts, with one more entry for the total.
+   * Built by BuildIndex() once all cuts have been added.
+   */
+  std::vector<int64_t> m_vecCutTime;
+  bool m_bWroteMPlayerEdl;
+
   bool ReadEdl(const CStdString& strMovie, const float fFramesPerSecond);
   bool ReadComskip(const CStdString& strMovie, const float fFramesPerSecond);
   bool ReadVideoReDo(const CStdString& strMovie);
@@ -80,7 +101,27 @@ private:
   bool AddCut(Cut& NewCut);
   bool AddSceneMarker(const int64_t sceneMarker);
 
-  bool WriteMPlayerEdl();
-
   void MergeShortCommBreaks();
+  void BuildIndex();
+};
+
+/*
+ * Reads the edit decision lists for a movie on a job thread so that slow sources, e.g. MythTV or a
+ * remote share, don't hold up opening the movie.
+ */
+class CEdlJob : public CJob
+{
+public:
+  CEdlJob(const CStdString& strMovie, const float fFramesPerSecond, const int iHeight);
+
+  virtual bool DoWork();
+  virtual const char *GetType() const { return "edl"; }
+
+  const CEdl& GetEdl() const { return m_edl; }
+
+private:
+  CStdString m_strMovie;
+  float m_fFramesPerSecond;
+  int m_iHeight;
+  CEdl m_edl;
 };
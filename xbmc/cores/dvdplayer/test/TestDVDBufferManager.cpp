@@ -0,0 +1,125 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDBufferManager.h"
+
+#include "gtest/gtest.h"
+
+#define MB (1024 * 1024)
+
+/* queues holding the given seconds of a stream with the given bitrates in bytes per second */
+static SDVDBufferState MakeState(double audioRate, double videoRate, double seconds)
+{
+  SDVDBufferState state;
+  state.audio      = audioRate > 0.0;
+  state.video      = videoRate > 0.0;
+  state.audioBytes = (int)(audioRate * seconds);
+  state.videoBytes = (int)(videoRate * seconds);
+  state.audioTime  = state.audio ? seconds : 0.0;
+  state.videoTime  = state.video ? seconds : 0.0;
+  return state;
+}
+
+TEST(TestDVDBufferManager, Defaults)
+{
+  CDVDBufferManager manager;
+  manager.Reset(64 * MB, 8.0);
+  EXPECT_DOUBLE_EQ(8.0, manager.GetMaxTimeSize());
+  EXPECT_NEAR(64 * MB, manager.GetMaxDataSize(true) + manager.GetMaxDataSize(false), 1);
+
+  SPlayerBufferInfo info;
+  manager.GetInfo(info);
+  EXPECT_DOUBLE_EQ(8.0, info.target);
+  EXPECT_EQ(64 * MB, info.budget);
+  EXPECT_DOUBLE_EQ(0.0, info.seconds);
+}
+
+TEST(TestDVDBufferManager, SharesByBitrate)
+{
+  CDVDBufferManager manager;
+  manager.Reset(64 * MB, 8.0);
+
+  // 5MB/s video with 100KB/s audio, the queues can't hold 8 seconds
+  for (int i = 0; i < 50; i++)
+    manager.Update(MakeState(100 * 1024, 5 * MB, 4.0));
+
+  int video = manager.GetMaxDataSize(true);
+  int audio = manager.GetMaxDataSize(false);
+  EXPECT_GT(video, 60 * MB);
+  EXPECT_GE(audio, 1 * MB);
+  EXPECT_LE(video + audio, 64 * MB + 1);
+
+  // only audio playing gets everything
+  manager.Update(MakeState(100 * 1024, 0.0, 4.0));
+  EXPECT_GT(manager.GetMaxDataSize(false), 60 * MB);
+}
+
+TEST(TestDVDBufferManager, InputCacheCountsTowardsTarget)
+{
+  CDVDBufferManager manager;
+  manager.Reset(64 * MB, 20.0);
+
+  // 20MB of cache, 10MB of it read ahead, hold 5 of the 20 seconds at 2MB/s
+  SDVDBufferState state = MakeState(0.0, 2 * MB, 4.0);
+  state.cacheSize    = 20 * MB;
+  state.cacheForward = 10 * MB;
+  state.cacheRate    = 3 * MB;
+  manager.Update(state);
+
+  EXPECT_NEAR(15.0, manager.GetMaxTimeSize(), 0.01);
+  EXPECT_EQ(44 * MB, manager.GetMaxDataSize(true));
+
+  SPlayerBufferInfo info;
+  manager.GetInfo(info);
+  EXPECT_NEAR(4.0 + 5.0, info.seconds, 0.01);
+  EXPECT_EQ(8 * MB + 10 * MB, info.bytes);
+  EXPECT_EQ(3u * MB, info.rate);
+
+  // a drained cache leaves the whole target to the queues
+  state.cacheForward = 0;
+  manager.Update(state);
+  EXPECT_NEAR(20.0, manager.GetMaxTimeSize(), 0.01);
+  EXPECT_EQ(44 * MB, manager.GetMaxDataSize(true));
+
+  // a cache bigger than the budget leaves the queues their minimum
+  state.cacheSize    = 100 * MB;
+  state.cacheForward = 100 * MB;
+  manager.Update(state);
+  EXPECT_DOUBLE_EQ(2.0, manager.GetMaxTimeSize());
+  EXPECT_EQ(8 * MB, manager.GetMaxDataSize(true));
+}
+
+TEST(TestDVDBufferManager, RefillRate)
+{
+  CDVDBufferManager manager;
+  manager.Reset(64 * MB, 8.0);
+
+  SDVDBufferState state = MakeState(0.0, MB, 2.0);
+  for (int i = 0; i < 100; i++)
+  {
+    state.clock   = i * 0.5;
+    state.demuxed = (int64_t)i * MB;
+    manager.Update(state);
+  }
+
+  SPlayerBufferInfo info;
+  manager.GetInfo(info);
+  EXPECT_NEAR(2.0 * MB, info.rate, 0.01 * MB);
+}
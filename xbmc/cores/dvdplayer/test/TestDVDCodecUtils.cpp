@@ -0,0 +1,259 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDCodecs/DVDCodecUtils.h"
+#include "utils/CPUInfo.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static const unsigned int g_levels[] = { 0, CPU_FEATURE_SSE2, CPU_FEATURE_SSE2 | CPU_FEATURE_AVX2 };
+static const char*        g_names[]  = { "c", "sse2", "avx2" };
+#define LEVELS (sizeof(g_levels) / sizeof(g_levels[0]))
+
+static bool Supported(unsigned int level)
+{
+  return (g_cpuInfo.GetCPUFeatures() & level) == level;
+}
+
+static void Fill(std::vector<uint8_t>& buffer, unsigned int seed)
+{
+  for (size_t i = 0; i < buffer.size(); i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    buffer[i] = (uint8_t)(seed >> 16);
+  }
+}
+
+/* 3/4 of c and 1/4 of n, rounded up */
+static uint8_t Blend(uint8_t c, uint8_t n)
+{
+  return (uint8_t)((c + (c + n + 1) / 2 + 1) / 2);
+}
+
+class TestDVDCodecUtils : public testing::Test
+{
+protected:
+  virtual void TearDown()
+  {
+    CDVDCodecUtils::SetCPUFeatures(g_cpuInfo.GetCPUFeatures());
+  }
+};
+
+TEST_F(TestDVDCodecUtils, CopyPlane)
+{
+  const int widths[] = { 1, 15, 64, 131, 720, 1920 };
+  for (unsigned int l = 0; l < LEVELS; l++)
+  {
+    if (!Supported(g_levels[l]))
+      continue;
+    CDVDCodecUtils::SetCPUFeatures(g_levels[l]);
+
+    for (unsigned int i = 0; i < sizeof(widths) / sizeof(widths[0]); i++)
+    {
+      int width = widths[i], height = 9;
+      int srcStride = width + 3, dstStride = width + 37;
+      std::vector<uint8_t> src(srcStride * height + 1);
+      std::vector<uint8_t> dst(dstStride * height + 1, 0xAA);
+      Fill(src, width);
+
+      // unaligned on both sides
+      CDVDCodecUtils::CopyPlane(&dst[1], dstStride, &src[1], srcStride, width, height);
+      for (int y = 0; y < height; y++)
+      {
+        EXPECT_EQ(0, memcmp(&dst[1 + y * dstStride], &src[1 + y * srcStride], width)) << g_names[l] << " width " << width;
+        EXPECT_EQ(0xAA, dst[1 + y * dstStride + width]) << g_names[l] << " width " << width;
+      }
+    }
+
+    // a plane large enough for streaming stores, contiguous
+    std::vector<uint8_t> src(1920 * 1080), dst(1920 * 1080);
+    Fill(src, 1);
+    CDVDCodecUtils::CopyPlane(&dst[0], 1920, &src[0], 1920, 1920, 1080);
+    EXPECT_TRUE(src == dst) << g_names[l];
+  }
+}
+
+TEST_F(TestDVDCodecUtils, InterleavePlanes)
+{
+  const int widths[] = { 1, 17, 32, 65, 960 };
+  for (unsigned int l = 0; l < LEVELS; l++)
+  {
+    if (!Supported(g_levels[l]))
+      continue;
+    CDVDCodecUtils::SetCPUFeatures(g_levels[l]);
+
+    for (unsigned int i = 0; i < sizeof(widths) / sizeof(widths[0]); i++)
+    {
+      int width = widths[i], height = 5, stride = width + 7;
+      std::vector<uint8_t> u(stride * height), v(stride * height);
+      std::vector<uint8_t> dst(2 * stride * height);
+      Fill(u, width);
+      Fill(v, width + 1);
+
+      CDVDCodecUtils::InterleavePlanes(&dst[0], 2 * stride, &u[0], stride, &v[0], stride, width, height);
+      for (int y = 0; y < height; y++)
+      {
+        for (int x = 0; x < width; x++)
+        {
+          ASSERT_EQ(u[y * stride + x], dst[y * 2 * stride + 2 * x])     << g_names[l] << " width " << width;
+          ASSERT_EQ(v[y * stride + x], dst[y * 2 * stride + 2 * x + 1]) << g_names[l] << " width " << width;
+        }
+      }
+    }
+  }
+}
+
+TEST_F(TestDVDCodecUtils, PackYUV422)
+{
+  const int widths[] = { 2, 30, 64, 126, 1920 };
+  for (unsigned int l = 0; l < LEVELS; l++)
+  {
+    if (!Supported(g_levels[l]))
+      continue;
+    CDVDCodecUtils::SetCPUFeatures(g_levels[l]);
+
+    for (unsigned int i = 0; i < sizeof(widths) / sizeof(widths[0]); i++)
+    {
+      for (int uyvy = 0; uyvy < 2; uyvy++)
+      {
+        int width = widths[i], height = 6;
+        int yStride = width + 5, cStride = width / 2 + 3, dstStride = width * 2 + 11;
+        std::vector<uint8_t> y(yStride * height), u(cStride * height / 2), v(cStride * height / 2);
+        std::vector<uint8_t> dst(dstStride * height);
+        Fill(y, width);
+        Fill(u, width + 1);
+        Fill(v, width + 2);
+
+        CDVDCodecUtils::PackYUV422(&dst[0], dstStride, &y[0], yStride, &u[0], cStride, &v[0], cStride, width, height, uyvy != 0);
+        for (int row = 0; row < height; row++)
+        {
+          const uint8_t* d = &dst[row * dstStride];
+          for (int x = 0; x < width / 2; x++)
+          {
+            uint8_t y0 = y[row * yStride + 2 * x];
+            uint8_t y1 = y[row * yStride + 2 * x + 1];
+            int c = row / 2;
+            int n = row % 2 ? std::min(c + 1, height / 2 - 1) : std::max(c - 1, 0);
+            uint8_t cu = Blend(u[c * cStride + x], u[n * cStride + x]);
+            uint8_t cv = Blend(v[c * cStride + x], v[n * cStride + x]);
+            if (uyvy)
+            {
+              ASSERT_TRUE(d[4 * x] == cu && d[4 * x + 1] == y0 && d[4 * x + 2] == cv && d[4 * x + 3] == y1) << g_names[l] << " width " << width;
+            }
+            else
+            {
+              ASSERT_TRUE(d[4 * x] == y0 && d[4 * x + 1] == cu && d[4 * x + 2] == y1 && d[4 * x + 3] == cv) << g_names[l] << " width " << width;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_F(TestDVDCodecUtils, ConvertToNV12Picture)
+{
+  DVDVideoPicture* src = CDVDCodecUtils::AllocatePicture(64, 32);
+  ASSERT_TRUE(src != NULL);
+  src->format = RENDER_FMT_YUV420P;
+  for (int i = 0; i < 64 * 32; i++)
+    src->data[0][i] = (uint8_t)i;
+  for (int i = 0; i < 32 * 16; i++)
+  {
+    src->data[1][i] = (uint8_t)(i * 3);
+    src->data[2][i] = (uint8_t)(i * 5);
+  }
+
+  DVDVideoPicture* nv12 = CDVDCodecUtils::ConvertToNV12Picture(src);
+  ASSERT_TRUE(nv12 != NULL);
+  EXPECT_EQ(RENDER_FMT_NV12, nv12->format);
+  EXPECT_EQ(0, memcmp(nv12->data[0], src->data[0], 64 * 32));
+  EXPECT_EQ(src->data[1][17], nv12->data[1][34]);
+  EXPECT_EQ(src->data[2][17], nv12->data[1][35]);
+  EXPECT_EQ(src->data[1][32 + 5], nv12->data[1][64 + 10]);
+
+  CDVDCodecUtils::FreePicture(nv12);
+  CDVDCodecUtils::FreePicture(src);
+}
+
+static double Throughput(void (*kernel)(std::vector<uint8_t>*, int, int), std::vector<uint8_t>* planes, int width, int height)
+{
+  const int runs = 50;
+  kernel(planes, width, height);
+  int64_t start = CurrentHostCounter();
+  for (int i = 0; i < runs; i++)
+    kernel(planes, width, height);
+  double seconds = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+  // bytes of a 4:2:0 frame
+  return runs * width * height * 1.5 / seconds / (1024 * 1024 * 1024);
+}
+
+static void CopyFrame(std::vector<uint8_t>* p, int width, int height)
+{
+  CDVDCodecUtils::CopyPlane(&p[3][0], width, &p[0][0], width, width, height);
+  CDVDCodecUtils::CopyPlane(&p[4][0], width / 2, &p[1][0], width / 2, width / 2, height / 2);
+  CDVDCodecUtils::CopyPlane(&p[5][0], width / 2, &p[2][0], width / 2, width / 2, height / 2);
+}
+
+static void ConvertNV12(std::vector<uint8_t>* p, int width, int height)
+{
+  CDVDCodecUtils::CopyPlane(&p[3][0], width, &p[0][0], width, width, height);
+  CDVDCodecUtils::InterleavePlanes(&p[4][0], width, &p[1][0], width / 2, &p[2][0], width / 2, width / 2, height / 2);
+}
+
+static void ConvertYUY2(std::vector<uint8_t>* p, int width, int height)
+{
+  CDVDCodecUtils::PackYUV422(&p[3][0], width * 2, &p[0][0], width, &p[1][0], width / 2, &p[2][0], width / 2, width, height, false);
+}
+
+TEST_F(TestDVDCodecUtils, DISABLED_Benchmark)
+{
+  const int sizes[][2] = { { 1920, 1080 }, { 3840, 2160 } };
+  for (unsigned int s = 0; s < 2; s++)
+  {
+    int width = sizes[s][0], height = sizes[s][1];
+    std::vector<uint8_t> planes[6];
+    planes[0].resize(width * height);
+    planes[1].resize(width * height / 4);
+    planes[2].resize(width * height / 4);
+    planes[3].resize(width * height * 2);
+    planes[4].resize(width * height);
+    planes[5].resize(width * height / 4);
+    for (int i = 0; i < 3; i++)
+      Fill(planes[i], i);
+
+    for (unsigned int l = 0; l < LEVELS; l++)
+    {
+      if (!Supported(g_levels[l]))
+        continue;
+      CDVDCodecUtils::SetCPUFeatures(g_levels[l]);
+      printf("%dx%d %-4s copy %6.2f GB/s, nv12 %6.2f GB/s, yuy2 %6.2f GB/s\n", width, height, g_names[l],
+             Throughput(CopyFrame, planes, width, height),
+             Throughput(ConvertNV12, planes, width, height),
+             Throughput(ConvertYUY2, planes, width, height));
+    }
+  }
+}
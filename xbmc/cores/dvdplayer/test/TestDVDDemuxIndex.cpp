@@ -0,0 +1,347 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDDemuxers/DVDDemuxIndex.h"
+#include "DVDClock.h"
+#include "DVDDemuxers/DVDDemuxFFmpeg.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+#include "DVDInputStreams/DVDInputStreamFile.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "settings/AdvancedSettings.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <stdio.h>
+
+/* keyframes every two seconds, 500kB apart */
+static void Play(CDVDDemuxIndex& index, int from, int to, bool afterSeek)
+{
+  for (int sec = from; sec <= to; sec += 2)
+  {
+    index.Add(DVD_MSEC_TO_TIME(sec * 1000), (int64_t)sec * 250000, !(afterSeek && sec == from));
+  }
+}
+
+TEST(TestDVDDemuxIndex, Linear)
+{
+  CDVDDemuxIndex index;
+  Play(index, 0, 100, true);
+  EXPECT_EQ(51U, index.Size());
+
+  CDVDDemuxIndex::Entry entry;
+  ASSERT_TRUE(index.Lookup(DVD_MSEC_TO_TIME(31000), true, entry));
+  EXPECT_EQ(DVD_MSEC_TO_TIME(30000), entry.pts);
+  EXPECT_EQ(30 * 250000, entry.pos);
+
+  ASSERT_TRUE(index.Lookup(DVD_MSEC_TO_TIME(31000), false, entry));
+  EXPECT_EQ(DVD_MSEC_TO_TIME(32000), entry.pts);
+
+  // exactly on a keyframe
+  ASSERT_TRUE(index.Lookup(DVD_MSEC_TO_TIME(40000), false, entry));
+  EXPECT_EQ(DVD_MSEC_TO_TIME(40000), entry.pts);
+
+  // nothing known past the last keyframe
+  EXPECT_FALSE(index.Lookup(DVD_MSEC_TO_TIME(150000), true, entry));
+  EXPECT_FALSE(index.Lookup(DVD_MSEC_TO_TIME(-1000), true, entry));
+}
+
+TEST(TestDVDDemuxIndex, Gaps)
+{
+  CDVDDemuxIndex index;
+  CDVDDemuxIndex::Entry entry;
+
+  Play(index, 0, 20, true);
+  // seek forward and play on
+  Play(index, 60, 80, true);
+
+  EXPECT_FALSE(index.Lookup(DVD_MSEC_TO_TIME(40000), true, entry));
+  EXPECT_FALSE(index.Lookup(DVD_MSEC_TO_TIME(59000), true, entry));
+  EXPECT_TRUE(index.Lookup(DVD_MSEC_TO_TIME(61000), true, entry));
+  EXPECT_TRUE(index.Lookup(DVD_MSEC_TO_TIME(19000), true, entry));
+
+  // seek back and play over the gap, the known keyframes are not added twice
+  size_t size = index.Size();
+  Play(index, 10, 70, true);
+  EXPECT_EQ(size + 19, index.Size());
+  ASSERT_TRUE(index.Lookup(DVD_MSEC_TO_TIME(59000), true, entry));
+  EXPECT_EQ(DVD_MSEC_TO_TIME(58000), entry.pts);
+  ASSERT_TRUE(index.Lookup(DVD_MSEC_TO_TIME(40000), true, entry));
+  EXPECT_EQ(DVD_MSEC_TO_TIME(40000), entry.pts);
+}
+
+TEST(TestDVDDemuxIndex, LookupPos)
+{
+  CDVDDemuxIndex index;
+  Play(index, 0, 10, true);
+
+  CDVDDemuxIndex::Entry entry;
+  ASSERT_TRUE(index.LookupPos(1100000, entry));
+  EXPECT_EQ(DVD_MSEC_TO_TIME(4000), entry.pts);
+  EXPECT_FALSE(index.LookupPos(-1, entry));
+}
+
+TEST(TestDVDDemuxIndex, Wrap)
+{
+  // the 33 bit pts of mpeg-ts wrap after about 26.5 hours
+  const double period = (double)(1LL << 33) / 90000 * DVD_TIME_BASE;
+  const int wrap = (int)(period / DVD_TIME_BASE);
+  CDVDDemuxIndex index;
+  index.SetWrapPeriod(period);
+  for (int sec = wrap - 20; sec <= wrap + 20; sec += 2)
+  {
+    double pts = DVD_MSEC_TO_TIME((int64_t)sec * 1000);
+    index.Add(pts < period ? pts : pts - period, (int64_t)sec * 250000, sec > wrap - 20);
+  }
+  EXPECT_EQ(21U, index.Size());
+
+  // the keyframes after the wrap are found at the time from the start
+  CDVDDemuxIndex::Entry entry;
+  ASSERT_TRUE(index.Lookup(DVD_MSEC_TO_TIME((int64_t)(wrap + 11) * 1000), true, entry));
+  EXPECT_GT(entry.pts, period);
+  EXPECT_EQ((int64_t)(wrap + 10) * 250000, entry.pos);
+  EXPECT_FALSE(index.Lookup(DVD_MSEC_TO_TIME(11000), true, entry));
+
+  // after a seek, the keyframes before the new position tell the wrap
+  index.Add(DVD_MSEC_TO_TIME(31000), (int64_t)(wrap + 30) * 250000, false);
+  ASSERT_TRUE(index.LookupPos((int64_t)(wrap + 30) * 250000, entry));
+  EXPECT_GT(entry.pts, period);
+}
+
+TEST(TestDVDDemuxIndex, SaveLoad)
+{
+  CDVDDemuxIndex index;
+  Play(index, 0, 20, true);
+  Play(index, 60, 7200, true);
+  EXPECT_TRUE(index.IsDirty());
+
+  XFILE::CFile *file = XBMC_CREATETEMPFILE(".idx");
+  std::string path = XBMC_TEMPFILEPATH(file);
+  file->Close();
+  XFILE::CFile *media = XBMC_CREATETEMPFILE(".ts");
+  std::string mediaPath = XBMC_TEMPFILEPATH(media);
+  media->Close();
+  ASSERT_TRUE(index.Save(path, mediaPath, 1000000));
+  EXPECT_FALSE(index.IsDirty());
+
+  // delta coded, well below the 16 bytes per entry of a plain table
+  struct __stat64 st;
+  ASSERT_EQ(0, XFILE::CFile::Stat(path, &st));
+  EXPECT_LT(st.st_size, (int64_t)index.Size() * 8);
+
+  // an index of another file, or of another version of the file, is not used
+  CDVDDemuxIndex loaded;
+  EXPECT_FALSE(loaded.Load(path, mediaPath + ".other", 1000000));
+  EXPECT_FALSE(loaded.Load(path, mediaPath, 2000000));
+  EXPECT_EQ(0U, loaded.Size());
+
+  ASSERT_TRUE(loaded.Load(path, mediaPath, 1000000));
+  ASSERT_EQ(index.Size(), loaded.Size());
+  CDVDDemuxIndex::Entry a, b;
+  EXPECT_FALSE(loaded.Lookup(DVD_MSEC_TO_TIME(40000), true, b));
+  for (int sec = 61; sec < 7200; sec += 97)
+  {
+    ASSERT_TRUE(index.Lookup(DVD_MSEC_TO_TIME(sec * 1000), true, a));
+    ASSERT_TRUE(loaded.Lookup(DVD_MSEC_TO_TIME(sec * 1000), true, b));
+    EXPECT_EQ(a.pts, b.pts);
+    EXPECT_EQ(a.pos, b.pos);
+  }
+
+  // corrupt file is rejected
+  XFILE::CFile out;
+  ASSERT_TRUE(out.OpenForWrite(path, true));
+  out.Write("XSIX\1\0\0\0\377\377\0\0\1", 13);
+  out.Close();
+  EXPECT_FALSE(loaded.Load(path, mediaPath, 1000000));
+  EXPECT_EQ(0U, loaded.Size());
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(media));
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+TEST(TestDVDDemuxIndex, Trim)
+{
+  XFILE::CFile *file = XBMC_CREATETEMPFILE(".ts");
+  std::string mediaPath = XBMC_TEMPFILEPATH(file);
+  file->Close();
+  std::string directory = URIUtils::AddFileToFolder(URIUtils::GetDirectory(mediaPath), "seekindex");
+
+  CDVDDemuxIndex index;
+  Play(index, 0, 600, true);
+  std::vector<std::string> paths;
+  int64_t size = 0;
+  for (int i = 0; i < 4; i++)
+  {
+    paths.push_back(URIUtils::AddFileToFolder(directory, StringUtils::Format("%d.idx", i)));
+    ASSERT_TRUE(index.Save(paths.back(), mediaPath, 1000000));
+    struct __stat64 st;
+    ASSERT_EQ(0, XFILE::CFile::Stat(paths.back(), &st));
+    size = st.st_size;
+    // modification times only have a resolution of seconds
+    if (i < 3)
+      Sleep(1100);
+  }
+
+  // the oldest go first
+  CDVDDemuxIndex::Trim(directory, size * 2);
+  EXPECT_FALSE(XFILE::CFile::Exists(paths[0]));
+  EXPECT_FALSE(XFILE::CFile::Exists(paths[1]));
+  EXPECT_TRUE(XFILE::CFile::Exists(paths[2]));
+  EXPECT_TRUE(XFILE::CFile::Exists(paths[3]));
+
+  for (size_t i = 0; i < paths.size(); i++)
+    XFILE::CFile::Delete(paths[i]);
+  XFILE::CDirectory::Remove(directory);
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+#define SEEK_SPAN    120                 // seconds played to build the keyframe index
+#define SEEK_COUNT   20
+#define SEEK_LATENCY 20                  // ms per seek on the input
+#define SEEK_RATE    (10 * 1024 * 1024)  // bytes per second read from the input
+
+/*
+ * A file input that behaves like a file on a network share: every seek
+ * costs a round trip and reads are limited in bandwidth.
+ */
+class CLatencyInputStream : public CDVDInputStreamFile
+{
+public:
+  CLatencyInputStream() : m_throttle(false), m_seeks(0), m_bytes(0) {}
+
+  virtual int Read(uint8_t* buf, int buf_size)
+  {
+    int read = CDVDInputStreamFile::Read(buf, buf_size);
+    if (read > 0 && m_throttle)
+    {
+      m_bytes += read;
+      Sleep((unsigned int)((int64_t)read * 1000 / SEEK_RATE));
+    }
+    return read;
+  }
+
+  virtual int64_t Seek(int64_t offset, int whence)
+  {
+    if (whence != SEEK_POSSIBLE && m_throttle)
+    {
+      m_seeks++;
+      Sleep(SEEK_LATENCY);
+    }
+    return CDVDInputStreamFile::Seek(offset, whence);
+  }
+
+  bool    m_throttle;
+  int     m_seeks;
+  int64_t m_bytes;
+};
+
+struct SSeekResult
+{
+  double  time;   // ms per seek
+  double  seeks;  // input seeks per seek
+  double  bytes;  // input bytes read per seek
+};
+
+/*
+ * Seeks SEEK_COUNT times into the first SEEK_SPAN seconds of a file through
+ * CDVDDemuxFFmpeg::SeekTime, then plays those seconds when asked to so the
+ * demuxer indexes their keyframes. Returns false if the file can't be demuxed.
+ */
+static bool SeekFile(const std::string& path, bool play, SSeekResult& result)
+{
+  CLatencyInputStream input;
+  if (!input.Open(path.c_str(), ""))
+    return false;
+
+  CDVDDemuxFFmpeg demuxer;
+  if (!demuxer.Open(&input))
+    return false;
+
+  int span = std::min(demuxer.GetStreamLength(), SEEK_SPAN * 1000);
+  if (span <= 0)
+    return false;
+
+  input.m_throttle = true;
+  int64_t time = 0;
+  for (int i = 0; i < SEEK_COUNT; i++)
+  {
+    int64_t start = CurrentHostCounter();
+    demuxer.SeekTime((int)((int64_t)span * ((i * 37) % SEEK_COUNT + 1) / (SEEK_COUNT + 1)), true);
+    time += CurrentHostCounter() - start;
+  }
+  input.m_throttle = false;
+  result.time = time * 1000.0 / CurrentHostFrequency() / SEEK_COUNT;
+  result.seeks = (double)input.m_seeks / SEEK_COUNT;
+  result.bytes = (double)input.m_bytes / SEEK_COUNT;
+
+  if (play && demuxer.SeekTime(0, true))
+  {
+    while (DemuxPacket* packet = demuxer.Read())
+    {
+      bool done = packet->dts != DVD_NOPTS_VALUE && packet->dts > DVD_MSEC_TO_TIME(span);
+      CDVDDemuxUtils::FreeDemuxPacket(packet);
+      if (done)
+        break;
+    }
+  }
+  // the index is stored when the demuxer is disposed
+  demuxer.Dispose();
+  return true;
+}
+
+/* run with --gtest_also_run_disabled_tests --set-media-samples-dir [DIR] */
+TEST(TestDVDDemuxIndex, DISABLED_Benchmark)
+{
+  CStdString directory = CXBMCTestUtils::Instance().getMediaSamplesDirectory();
+  if (directory.empty())
+  {
+    printf("no media samples directory given\n");
+    return;
+  }
+
+  CFileItemList items;
+  ASSERT_TRUE(XFILE::CDirectory::GetDirectory(directory, items, g_advancedSettings.m_videoExtensions));
+
+  printf("%d seeks, %dms per seek and %dMB/s on the input\n", SEEK_COUNT, SEEK_LATENCY, SEEK_RATE / (1024 * 1024));
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (items[i]->m_bIsFolder)
+      continue;
+
+    std::string path = items[i]->GetPath();
+    XFILE::CFile::Delete(CDVDDemuxIndex::GetIndexPath(path, items[i]->m_dwSize));
+
+    // lavf on its own, then with the keyframes of the played part indexed
+    SSeekResult lavf, indexed;
+    if (!SeekFile(path, true, lavf) || !SeekFile(path, false, indexed))
+      continue;
+    XFILE::CFile::Delete(CDVDDemuxIndex::GetIndexPath(path, items[i]->m_dwSize));
+
+    printf("%-40s lavf %7.1fms %4.1f seeks %7.0fkB, index %7.1fms %4.1f seeks %7.0fkB\n",
+           URIUtils::GetFileName(path).c_str(),
+           lavf.time, lavf.seeks, lavf.bytes / 1024, indexed.time, indexed.seeks, indexed.bytes / 1024);
+  }
+}
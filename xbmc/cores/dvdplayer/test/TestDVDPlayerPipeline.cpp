@@ -0,0 +1,329 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDBufferManager.h"
+#include "DVDClock.h"
+#include "DVDMessage.h"
+#include "DVDMessageQueue.h"
+#include "DVDStreamInfo.h"
+#include "DVDCodecs/DVDCodecs.h"
+#include "DVDCodecs/DVDFactoryCodec.h"
+#include "DVDCodecs/Audio/DVDAudioCodecFFmpeg.h"
+#include "DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
+#include "DVDDemuxers/DVDDemux.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+#include "DVDDemuxers/DVDFactoryDemuxer.h"
+#include "DVDInputStreams/DVDFactoryInputStream.h"
+#include "DVDInputStreams/DVDInputStream.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "settings/AdvancedSettings.h"
+#include "test/TestUtils.h"
+#include "threads/Thread.h"
+#include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <stdio.h>
+
+#define PIPELINE_PACKETS 5000
+
+/*
+ * The decoding side of CDVDPlayerVideo and CDVDPlayerAudio: takes packets off
+ * a message queue and decodes them as fast as it can. What is decoded is
+ * thrown away, there is no renderer, audio sink or clock to wait for.
+ */
+class CDecodeStage : public CThread
+{
+public:
+  CDecodeStage(const char* name)
+    : CThread(name), m_queue(name), m_time(0), m_frames(0), m_drops(0)
+  {
+    m_queue.Init();
+  }
+
+  virtual ~CDecodeStage()
+  {
+    StopThread();
+    m_queue.Flush();
+  }
+
+  CDVDMessageQueue m_queue;
+  int64_t m_time;
+  int     m_frames;
+  int     m_drops;
+
+protected:
+  virtual void Decode(DemuxPacket* packet) = 0;
+
+  virtual void Process()
+  {
+    while (!m_bStop)
+    {
+      CDVDMsg* msg;
+      MsgQueueReturnCode ret = m_queue.Get(&msg, 1000);
+      if (MSGQ_IS_ERROR(ret))
+        break;
+      if (ret == MSGQ_TIMEOUT)
+        continue;
+
+      bool eof = msg->IsType(CDVDMsg::GENERAL_EOF);
+      if (msg->IsType(CDVDMsg::DEMUXER_PACKET))
+      {
+        int64_t start = CurrentHostCounter();
+        Decode(((CDVDMsgDemuxerPacket*)msg)->GetPacket());
+        m_time += CurrentHostCounter() - start;
+      }
+      msg->Release();
+      if (eof)
+        break;
+    }
+  }
+};
+
+class CVideoStage : public CDecodeStage
+{
+public:
+  CVideoStage(CDVDVideoCodec* codec) : CDecodeStage("BenchmarkVideo"), m_codec(codec) {}
+
+protected:
+  virtual void Decode(DemuxPacket* packet)
+  {
+    int state = m_codec->Decode(packet->pData, packet->iSize, packet->dts, packet->pts);
+    while (state & VC_PICTURE)
+    {
+      DVDVideoPicture picture;
+      if (m_codec->GetPicture(&picture))
+      {
+        if (picture.iFlags & DVP_FLAG_DROPPED)
+          m_drops++;
+        else
+          m_frames++;
+      }
+      state = m_codec->Decode(NULL, 0, DVD_NOPTS_VALUE, DVD_NOPTS_VALUE);
+    }
+    if (state & VC_ERROR)
+      m_drops++;
+  }
+
+  std::auto_ptr<CDVDVideoCodec> m_codec;
+};
+
+class CAudioStage : public CDecodeStage
+{
+public:
+  CAudioStage(CDVDAudioCodec* codec) : CDecodeStage("BenchmarkAudio"), m_codec(codec) {}
+
+protected:
+  virtual void Decode(DemuxPacket* packet)
+  {
+    uint8_t* data = packet->pData;
+    int      size = packet->iSize;
+    while (size > 0)
+    {
+      int len = m_codec->Decode(data, size);
+      if (len < 0 || len > size)
+      {
+        // CDVDPlayerAudio skips the rest of the packet
+        m_codec->Reset();
+        m_drops++;
+        return;
+      }
+      data += len;
+      size -= len;
+
+      uint8_t* output;
+      if (m_codec->GetData(&output) > 0)
+        m_frames++;
+    }
+  }
+
+  std::auto_ptr<CDVDAudioCodec> m_codec;
+};
+
+struct SPipelineResult
+{
+  double  seconds;
+  int     packets;
+  int64_t demuxTime;
+  int64_t fullTime;
+  double  videoLevel;
+  double  audioLevel;
+};
+
+/*
+ * Runs demux -> queues -> decoders on the first video and audio stream of a
+ * file with the queue limits the player would use. Returns false if the file
+ * can't be demuxed or has neither stream.
+ */
+static bool RunPipeline(const std::string& path, std::auto_ptr<CVideoStage>& video, std::auto_ptr<CAudioStage>& audio, SPipelineResult& result)
+{
+  std::auto_ptr<CDVDInputStream> input(CDVDFactoryInputStream::CreateInputStream(NULL, path, ""));
+  if (!input.get() || !input->Open(path.c_str(), ""))
+    return false;
+
+  std::auto_ptr<CDVDDemux> demuxer(CDVDFactoryDemuxer::CreateDemuxer(input.get()));
+  if (!demuxer.get())
+    return false;
+
+  int videoStream = -1, audioStream = -1;
+  for (int i = 0; i < demuxer->GetNrOfStreams(); i++)
+  {
+    CDemuxStream* stream = demuxer->GetStream(i);
+    if (stream->type == STREAM_VIDEO && videoStream < 0)
+      videoStream = i;
+    else if (stream->type == STREAM_AUDIO && audioStream < 0)
+      audioStream = i;
+    else
+      stream->SetDiscard(AVDISCARD_ALL);
+  }
+
+  CDVDCodecOptions options;
+  options.m_formats.push_back(RENDER_FMT_YUV420P);
+  if (videoStream >= 0)
+  {
+    CDVDStreamInfo hint(*demuxer->GetStream(videoStream), true);
+    CDVDVideoCodec* codec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, options);
+    if (codec)
+      video.reset(new CVideoStage(codec));
+  }
+  if (audioStream >= 0)
+  {
+    CDVDStreamInfo hint(*demuxer->GetStream(audioStream), true);
+    CDVDAudioCodec* codec = CDVDFactoryCodec::OpenCodec(new CDVDAudioCodecFFmpeg(), hint, options);
+    if (codec)
+      audio.reset(new CAudioStage(codec));
+  }
+  if (!video.get() && !audio.get())
+    return false;
+
+  CDVDBufferManager buffers;
+  buffers.Reset(g_advancedSettings.m_bufferMemory, g_advancedSettings.m_bufferSeconds);
+  if (video.get())
+  {
+    video->m_queue.SetMaxDataSize(buffers.GetMaxDataSize(true));
+    video->m_queue.SetMaxTimeSize(buffers.GetMaxTimeSize());
+    video->Create();
+  }
+  if (audio.get())
+  {
+    audio->m_queue.SetMaxDataSize(buffers.GetMaxDataSize(false));
+    audio->m_queue.SetMaxTimeSize(buffers.GetMaxTimeSize());
+    audio->Create();
+  }
+
+  result = SPipelineResult();
+  int samples = 0;
+  int64_t start = CurrentHostCounter();
+  while (result.packets < PIPELINE_PACKETS)
+  {
+    // like CDVDPlayer::Process, don't read while a queue is full
+    if ((video.get() && video->m_queue.IsFull()) || (audio.get() && audio->m_queue.IsFull()))
+    {
+      int64_t wait = CurrentHostCounter();
+      Sleep(1);
+      result.fullTime += CurrentHostCounter() - wait;
+      continue;
+    }
+
+    int64_t read = CurrentHostCounter();
+    DemuxPacket* packet = demuxer->Read();
+    result.demuxTime += CurrentHostCounter() - read;
+    if (!packet)
+      break;
+
+    if (video.get() && packet->iStreamId == videoStream)
+      video->m_queue.Put(new CDVDMsgDemuxerPacket(packet));
+    else if (audio.get() && packet->iStreamId == audioStream)
+      audio->m_queue.Put(new CDVDMsgDemuxerPacket(packet));
+    else
+    {
+      CDVDDemuxUtils::FreeDemuxPacket(packet);
+      continue;
+    }
+    result.packets++;
+
+    result.videoLevel += video.get() ? video->m_queue.GetLevel() : 0;
+    result.audioLevel += audio.get() ? audio->m_queue.GetLevel() : 0;
+    samples++;
+  }
+
+  if (video.get())
+    video->m_queue.Put(new CDVDMsg(CDVDMsg::GENERAL_EOF));
+  if (audio.get())
+    audio->m_queue.Put(new CDVDMsg(CDVDMsg::GENERAL_EOF));
+  while ((video.get() && !video->WaitForThreadExit(1000)) || (audio.get() && !audio->WaitForThreadExit(1000)))
+    ;
+
+  result.seconds = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+  if (samples)
+  {
+    result.videoLevel /= samples;
+    result.audioLevel /= samples;
+  }
+  return true;
+}
+
+static double Milliseconds(int64_t time, int count)
+{
+  return count ? time * 1000.0 / CurrentHostFrequency() / count : 0.0;
+}
+
+/* run with --gtest_also_run_disabled_tests --set-media-samples-dir [DIR] */
+TEST(TestDVDPlayerPipeline, DISABLED_Benchmark)
+{
+  CStdString directory = CXBMCTestUtils::Instance().getMediaSamplesDirectory();
+  if (directory.empty())
+  {
+    printf("no media samples directory given\n");
+    return;
+  }
+
+  CFileItemList items;
+  ASSERT_TRUE(XFILE::CDirectory::GetDirectory(directory, items, g_advancedSettings.m_videoExtensions + "|" + g_advancedSettings.m_musicExtensions));
+
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (items[i]->m_bIsFolder)
+      continue;
+
+    std::auto_ptr<CVideoStage> video;
+    std::auto_ptr<CAudioStage> audio;
+    SPipelineResult result;
+    if (!RunPipeline(items[i]->GetPath(), video, audio, result))
+      continue;
+
+    int videoFrames = video.get() ? video->m_frames : 0;
+    int audioFrames = audio.get() ? audio->m_frames : 0;
+    printf("%-40s %7.1f fps, %5d packets in %6.2fs\n", URIUtils::GetFileName(items[i]->GetPath()).c_str(),
+           (videoFrames ? videoFrames : audioFrames) / result.seconds, result.packets, result.seconds);
+    printf("  demux %6.3fms/packet, waited on full queues %4.1f%%\n",
+           Milliseconds(result.demuxTime, result.packets),
+           100.0 * result.fullTime / CurrentHostFrequency() / result.seconds);
+    if (video.get())
+      printf("  video %6.3fms/frame, %5d frames, %4d drops, queue %3.0f%%\n",
+             Milliseconds(video->m_time, videoFrames), videoFrames, video->m_drops, result.videoLevel);
+    if (audio.get())
+      printf("  audio %6.3fms/frame, %5d frames, %4d drops, queue %3.0f%%\n",
+             Milliseconds(audio->m_time, audioFrames), audioFrames, audio->m_drops, result.audioLevel);
+  }
+}
@@ -0,0 +1,231 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDFileInfo.h"
+#include "DVDProbeCache.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "settings/AdvancedSettings.h"
+#include "test/TestUtils.h"
+#include "utils/CPUInfo.h"
+#include "utils/JobManager.h"
+#include "utils/TimeUtils.h"
+#include "video/VideoInfoTag.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <stdio.h>
+
+static void MakeDetails(CStreamDetails& details)
+{
+  CStreamDetailVideo *video = new CStreamDetailVideo();
+  video->m_iWidth = 1920;
+  video->m_iHeight = 1080;
+  video->m_strCodec = "h264";
+  video->m_iDuration = 5400;
+  details.AddStream(video);
+  CStreamDetailAudio *audio = new CStreamDetailAudio();
+  audio->m_iChannels = 6;
+  audio->m_strCodec = "dca";
+  audio->m_strLanguage = "eng";
+  details.AddStream(audio);
+  details.DetermineBestStreams();
+}
+
+static XFILE::CFile *CreateMediaFile()
+{
+  XFILE::CFile *file = XBMC_CREATETEMPFILE(".mkv");
+  if (!file)
+    return NULL;
+  file->Close();
+  file->OpenForWrite(XBMC_TEMPFILEPATH(file), true);
+  file->Write("media", 5);
+  file->Flush();
+  return file;
+}
+
+TEST(TestDVDProbeCache, LookupStore)
+{
+  XFILE::CFile *media = CreateMediaFile();
+  ASSERT_TRUE(media != NULL);
+  std::string path = XBMC_TEMPFILEPATH(media);
+
+  XFILE::CFile *cacheFile = XBMC_CREATETEMPFILE(".dat");
+  CDVDProbeCache cache(XBMC_TEMPFILEPATH(cacheFile));
+  cacheFile->Close();
+
+  CStreamDetails details, cached;
+  EXPECT_FALSE(cache.Lookup(path, cached));
+
+  MakeDetails(details);
+  cache.Store(path, details);
+  ASSERT_TRUE(cache.Lookup(path, cached));
+  EXPECT_TRUE(details == cached);
+
+  // files that could not be probed are cached as well
+  CStreamDetails empty;
+  cache.Store(path, empty);
+  ASSERT_TRUE(cache.Lookup(path, cached));
+  EXPECT_FALSE(cached.HasItems());
+
+  // no caching for files that don't exist
+  cache.Store(path + ".missing", details);
+  EXPECT_FALSE(cache.Lookup(path + ".missing", cached));
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(cacheFile));
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(media));
+}
+
+TEST(TestDVDProbeCache, ChangedFile)
+{
+  XFILE::CFile *media = CreateMediaFile();
+  ASSERT_TRUE(media != NULL);
+  std::string path = XBMC_TEMPFILEPATH(media);
+
+  XFILE::CFile *cacheFile = XBMC_CREATETEMPFILE(".dat");
+  CDVDProbeCache cache(XBMC_TEMPFILEPATH(cacheFile));
+  cacheFile->Close();
+
+  CStreamDetails details, cached;
+  MakeDetails(details);
+  cache.Store(path, details);
+
+  media->Write("more", 4);
+  media->Flush();
+  EXPECT_FALSE(cache.Lookup(path, cached));
+  EXPECT_EQ(0U, cache.Size());
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(cacheFile));
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(media));
+}
+
+TEST(TestDVDProbeCache, SaveLoad)
+{
+  XFILE::CFile *media = CreateMediaFile();
+  ASSERT_TRUE(media != NULL);
+  std::string path = XBMC_TEMPFILEPATH(media);
+
+  XFILE::CFile *cacheFile = XBMC_CREATETEMPFILE(".dat");
+  std::string cachePath = XBMC_TEMPFILEPATH(cacheFile);
+  cacheFile->Close();
+
+  CStreamDetails details, cached;
+  MakeDetails(details);
+  {
+    CDVDProbeCache cache(cachePath);
+    cache.Store(path, details);
+    EXPECT_TRUE(cache.Save());
+  }
+
+  CDVDProbeCache cache(cachePath);
+  EXPECT_EQ(1U, cache.Size());
+  ASSERT_TRUE(cache.Lookup(path, cached));
+  EXPECT_TRUE(details == cached);
+  EXPECT_EQ(1920, cached.GetVideoWidth());
+  EXPECT_EQ(6, cached.GetAudioChannels());
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(cacheFile));
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(media));
+}
+
+TEST(TestDVDProbeCache, Unload)
+{
+  XFILE::CFile *media = CreateMediaFile();
+  ASSERT_TRUE(media != NULL);
+  std::string path = XBMC_TEMPFILEPATH(media);
+
+  XFILE::CFile *cacheFile = XBMC_CREATETEMPFILE(".dat");
+  std::string cachePath = XBMC_TEMPFILEPATH(cacheFile);
+  cacheFile->Close();
+
+  CStreamDetails details, cached;
+  MakeDetails(details);
+  CDVDProbeCache cache(cachePath);
+  cache.Store(path, details);
+  cache.Unload();
+
+  // entries are saved and read back on next use
+  ASSERT_TRUE(cache.Lookup(path, cached));
+  EXPECT_TRUE(details == cached);
+
+  // a different cache file behind the same path starts over
+  cache.Unload();
+  EXPECT_TRUE(XFILE::CFile::Delete(cachePath));
+  EXPECT_EQ(0U, cache.Size());
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(cacheFile));
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(media));
+}
+
+class CProbeJob : public CJob
+{
+public:
+  CProbeJob(const CFileItem& item) : m_item(item) {}
+  virtual bool DoWork() { return CDVDFileInfo::GetFileStreamDetails(&m_item); }
+  CFileItem m_item;
+};
+
+static double ProbeAll(const CFileItemList& items, unsigned int jobs)
+{
+  int64_t start = CurrentHostCounter();
+  if (jobs <= 1)
+  {
+    for (int i = 0; i < items.Size(); i++)
+    {
+      CFileItem item(*items[i]);
+      CDVDFileInfo::GetFileStreamDetails(&item);
+    }
+  }
+  else
+  {
+    CJobQueue queue(false, jobs);
+    for (int i = 0; i < items.Size(); i++)
+      queue.AddJob(new CProbeJob(*items[i]));
+    while (queue.IsProcessing())
+      Sleep(1);
+  }
+  double seconds = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+  return items.Size() / seconds;
+}
+
+/* run with --gtest_also_run_disabled_tests --set-media-samples-dir [DIR] */
+TEST(TestDVDProbeCache, DISABLED_Benchmark)
+{
+  CStdString directory = CXBMCTestUtils::Instance().getMediaSamplesDirectory();
+  if (directory.empty())
+  {
+    printf("no media samples directory given\n");
+    return;
+  }
+
+  CFileItemList items;
+  ASSERT_TRUE(XFILE::CDirectory::GetDirectory(directory, items, g_advancedSettings.m_videoExtensions));
+  printf("probing %d files\n", items.Size());
+
+  CDVDProbeCache::Get().Clear();
+  printf("serial        %8.1f files/s\n", ProbeAll(items, 1));
+  printf("cached        %8.1f files/s\n", ProbeAll(items, 1));
+
+  unsigned int jobs = std::max(2, std::min(g_cpuInfo.getCPUCount(), 4));
+  CDVDProbeCache::Get().Clear();
+  printf("%u jobs        %8.1f files/s\n", jobs, ProbeAll(items, jobs));
+}
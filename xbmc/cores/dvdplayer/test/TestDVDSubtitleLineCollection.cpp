@@ -0,0 +1,227 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDClock.h"
+#include "DVDStreamInfo.h"
+#include "DVDCodecs/Overlay/DVDOverlayText.h"
+#include "DVDSubtitles/DVDSubtitleLineCollection.h"
+#include "DVDSubtitles/DVDSubtitleParserSubrip.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static CDVDOverlay* MakeLine(double start, double stop)
+{
+  CDVDOverlay* overlay = new CDVDOverlayText();
+  overlay->iPTSStartTime = DVD_SEC_TO_TIME(start);
+  overlay->iPTSStopTime  = DVD_SEC_TO_TIME(stop);
+  return overlay;
+}
+
+static bool CompareStart(const CDVDOverlay* a, const CDVDOverlay* b)
+{
+  return a->iPTSStartTime < b->iPTSStartTime;
+}
+
+TEST(TestDVDSubtitleLineCollection, Fifo)
+{
+  CDVDSubtitleLineCollection collection;
+  CDVDOverlay* a = MakeLine(0, 1);
+  CDVDOverlay* b = MakeLine(2, 3);
+  CDVDOverlay* c = MakeLine(4, 5);
+  collection.Add(c);
+  collection.Add(a);
+  collection.Add(b);
+  collection.Sort();
+  EXPECT_EQ(3, collection.GetSize());
+
+  EXPECT_EQ(a, collection.Get(0));
+  EXPECT_EQ(b, collection.Get(0));
+  EXPECT_EQ(c, collection.Get(0));
+  EXPECT_TRUE(collection.Get(0) == NULL);
+
+  collection.Reset();
+  EXPECT_EQ(b, collection.Get(DVD_SEC_TO_TIME(2.5)));
+  EXPECT_EQ(c, collection.Get(DVD_SEC_TO_TIME(2.5)));
+
+  // lines that stopped are skipped going forward
+  collection.Reset();
+  EXPECT_EQ(a, collection.Get(0));
+  EXPECT_EQ(c, collection.Get(DVD_SEC_TO_TIME(4.5)));
+  EXPECT_TRUE(collection.Get(DVD_SEC_TO_TIME(4.5)) == NULL);
+}
+
+TEST(TestDVDSubtitleLineCollection, SeekMatchesWalk)
+{
+  CDVDSubtitleLineCollection collection;
+  std::vector<CDVDOverlay*> lines;
+  srand(1);
+  for (int i = 0; i < 2000; i++)
+  {
+    double start = rand() % 10000 / 10.0;
+    double length = (rand() % 2 ? 60 : 2) * (rand() % 100 + 1) / 100.0;
+    CDVDOverlay* line = MakeLine(start, start + length);
+    lines.push_back(line);
+    collection.Add(line);
+  }
+  collection.Sort();
+  std::stable_sort(lines.begin(), lines.end(), CompareStart);
+
+  for (int i = 0; i < 500; i++)
+  {
+    double pts = DVD_SEC_TO_TIME(rand() % 11000 / 10.0);
+
+    // what the collection did before seeking was indexed: walk from the first line
+    size_t expected = 0;
+    while (expected < lines.size() && lines[expected]->iPTSStopTime < pts)
+      expected++;
+
+    collection.Reset();
+    CDVDOverlay* overlay = collection.Get(pts);
+    if (expected < lines.size())
+      ASSERT_EQ(lines[expected], overlay) << "pts " << pts;
+    else
+      ASSERT_TRUE(overlay == NULL) << "pts " << pts;
+  }
+}
+
+TEST(TestDVDSubtitleLineCollection, GetActive)
+{
+  CDVDSubtitleLineCollection collection;
+  CDVDOverlay* a = MakeLine(0, 10);
+  CDVDOverlay* b = MakeLine(2, 3);
+  CDVDOverlay* c = MakeLine(4, 12);
+  CDVDOverlay* d = MakeLine(11, 13);
+  collection.Add(d);
+  collection.Add(b);
+  collection.Add(a);
+  collection.Add(c);
+
+  std::vector<CDVDOverlay*> active;
+  ASSERT_EQ(2, collection.GetActive(DVD_SEC_TO_TIME(2.5), active));
+  EXPECT_EQ(a, active[0]);
+  EXPECT_EQ(b, active[1]);
+
+  ASSERT_EQ(2, collection.GetActive(DVD_SEC_TO_TIME(5), active));
+  EXPECT_EQ(a, active[0]);
+  EXPECT_EQ(c, active[1]);
+
+  ASSERT_EQ(2, collection.GetActive(DVD_SEC_TO_TIME(11.5), active));
+  EXPECT_EQ(c, active[0]);
+  EXPECT_EQ(d, active[1]);
+
+  EXPECT_EQ(0, collection.GetActive(DVD_SEC_TO_TIME(20), active));
+}
+
+static XFILE::CFile *WriteSubrip(int lines, bool shuffled)
+{
+  XFILE::CFile *file = XBMC_CREATETEMPFILE(".srt");
+  if (!file)
+    return NULL;
+  file->Close();
+  file->OpenForWrite(XBMC_TEMPFILEPATH(file), true);
+
+  std::vector<int> order;
+  for (int i = 0; i < lines; i++)
+    order.push_back(i);
+  if (shuffled)
+    std::reverse(order.begin(), order.end());
+
+  for (int i = 0; i < lines; i++)
+  {
+    int start = order[i] * 2000;
+    int stop = start + 1500;
+    std::string entry = StringUtils::Format("%d\r\n%02d:%02d:%02d,%03d --> %02d:%02d:%02d,%03d\r\nline %d\r\n\r\n", i + 1,
+                                            start / 3600000, start / 60000 % 60, start / 1000 % 60, start % 1000,
+                                            stop / 3600000, stop / 60000 % 60, stop / 1000 % 60, stop % 1000, order[i]);
+    file->Write(entry.c_str(), entry.size());
+  }
+  file->Flush();
+  return file;
+}
+
+TEST(TestDVDSubtitleLineCollection, ParseSubrip)
+{
+  XFILE::CFile *file = WriteSubrip(10, true);
+  ASSERT_TRUE(file != NULL);
+
+  CDVDStreamInfo hints;
+  CDVDSubtitleParserSubrip parser(NULL, XBMC_TEMPFILEPATH(file));
+  ASSERT_TRUE(parser.Open(hints));
+  parser.Reset();
+
+  CDVDOverlay* overlay = parser.Parse(DVD_SEC_TO_TIME(7));
+  ASSERT_TRUE(overlay != NULL);
+  EXPECT_EQ(DVD_SEC_TO_TIME(6), overlay->iPTSStartTime);
+  EXPECT_EQ(DVD_SEC_TO_TIME(7.5), overlay->iPTSStopTime);
+  overlay->Release();
+
+  parser.Dispose();
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+/* run with --gtest_also_run_disabled_tests */
+TEST(TestDVDSubtitleLineCollection, DISABLED_Benchmark)
+{
+  const int lines = 50000;
+  const int seeks = 10000;
+
+  XFILE::CFile *file = WriteSubrip(lines, false);
+  ASSERT_TRUE(file != NULL);
+
+  CDVDStreamInfo hints;
+  CDVDSubtitleParserSubrip parser(NULL, XBMC_TEMPFILEPATH(file));
+  int64_t start = CurrentHostCounter();
+  ASSERT_TRUE(parser.Open(hints));
+  double open = (double)(CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency();
+
+  srand(1);
+  start = CurrentHostCounter();
+  int found = 0;
+  for (int i = 0; i < seeks; i++)
+  {
+    double pts = DVD_MSEC_TO_TIME(rand() % (lines * 2000));
+    parser.Reset();
+    // what CDVDPlayerSubtitle does after a seek, fetch the next few lines
+    for (int j = 0; j < 5; j++)
+    {
+      CDVDOverlay* overlay = parser.Parse(pts);
+      if (!overlay)
+        break;
+      overlay->Release();
+      found++;
+    }
+  }
+  double seek = (double)(CurrentHostCounter() - start) * 1000000.0 / CurrentHostFrequency() / seeks;
+  EXPECT_GT(found, 0);
+
+  printf("%d lines: open %.1fms, seek %.2fus\n", lines, open, seek);
+
+  parser.Dispose();
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
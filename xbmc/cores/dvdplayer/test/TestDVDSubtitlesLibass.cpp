@@ -0,0 +1,125 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDClock.h"
+#include "DVDSubtitles/DVDSubtitlesLibass.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+
+#define FRAME_RATE 23.976
+#define FRAMES     1440
+
+/*
+ * Replay the file in real time the way the renderer does, one request per
+ * video frame, and return the time spent in RenderImage for every frame.
+ */
+static bool Replay(const std::string& path, bool prerender, std::vector<double>& times)
+{
+  XFILE::CFile file;
+  if (!file.Open(path))
+    return false;
+  std::vector<char> buffer((size_t)file.GetLength());
+  if (buffer.empty() || file.Read(&buffer[0], buffer.size()) != buffer.size())
+    return false;
+
+  CDVDSubtitlesLibass* libass = new CDVDSubtitlesLibass();
+  libass->SetPrerender(prerender);
+  if (!libass->CreateTrack(&buffer[0], buffer.size()) || libass->GetNrOfEvents() == 0)
+  {
+    libass->Release();
+    return false;
+  }
+
+  double start = DVD_MSEC_TO_TIME(libass->GetEvents()[0].Start);
+  double frame = DVD_TIME_BASE / FRAME_RATE;
+  int64_t frequency = CurrentHostFrequency();
+  int64_t clock = CurrentHostCounter();
+
+  times.clear();
+  for (int i = 0; i < FRAMES; i++)
+  {
+    int64_t before = CurrentHostCounter();
+    libass->RenderImage(1920, 1080, start + i * frame);
+    int64_t after = CurrentHostCounter();
+    times.push_back((double)(after - before) * 1000.0 / frequency);
+
+    // wait for the next frame to be due
+    int64_t due = clock + (int64_t)((i + 1) * frequency / FRAME_RATE);
+    while (CurrentHostCounter() < due)
+      Sleep(1);
+  }
+
+  libass->Release();
+  return true;
+}
+
+static void Report(const char* name, std::vector<double>& times)
+{
+  double total = 0.0;
+  int late = 0;
+  for (size_t i = 0; i < times.size(); i++)
+  {
+    total += times[i];
+    if (times[i] > 1000.0 / FRAME_RATE)
+      late++;
+  }
+  std::sort(times.begin(), times.end());
+  printf("%-10s avg %6.2fms, 99%% %6.2fms, max %6.2fms, %d frames over budget\n", name,
+         total / times.size(), times[times.size() * 99 / 100], times.back(), late);
+}
+
+/* run with --gtest_also_run_disabled_tests --set-media-samples-dir [DIR] */
+TEST(TestDVDSubtitlesLibass, DISABLED_Benchmark)
+{
+  CStdString directory = CXBMCTestUtils::Instance().getMediaSamplesDirectory();
+  if (directory.empty())
+  {
+    printf("no media samples directory given\n");
+    return;
+  }
+
+  CFileItemList items;
+  XFILE::CDirectory::GetDirectory(directory, items, ".ass|.ssa");
+  if (items.IsEmpty())
+  {
+    printf("no .ass files in %s\n", directory.c_str());
+    return;
+  }
+
+  for (int i = 0; i < items.Size(); i++)
+  {
+    std::string path = items[i]->GetPath();
+    std::vector<double> times;
+    printf("%s, %d frames at %.3f fps\n", path.c_str(), FRAMES, FRAME_RATE);
+    ASSERT_TRUE(Replay(path, false, times));
+    Report("render", times);
+    ASSERT_TRUE(Replay(path, true, times));
+    Report("prerender", times);
+  }
+}
@@ -0,0 +1,254 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDClock.h"
+#include "DVDStreamInfo.h"
+#include "DVDCodecs/DVDCodecs.h"
+#include "DVDCodecs/DVDCodecUtils.h"
+#include "DVDCodecs/DVDFactoryCodec.h"
+#include "DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
+#include "DVDDemuxers/DVDDemux.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+#include "DVDDemuxers/DVDFactoryDemuxer.h"
+#include "DVDInputStreams/DVDFactoryInputStream.h"
+#include "DVDInputStreams/DVDInputStream.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "settings/AdvancedSettings.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <stdio.h>
+#include <string.h>
+
+#define BENCHMARK_PACKETS 1000
+#define BENCHMARK_BUFFERS 4
+
+/* Receives the decoded pictures, the way the render manager would */
+class CPictureSink
+{
+public:
+  CPictureSink() : m_time(0), m_bytes(0), m_pictures(0) {}
+  virtual ~CPictureSink() {}
+  virtual void Output(DVDVideoPicture& picture) = 0;
+
+  int64_t  m_time;
+  uint64_t m_bytes;
+  int      m_pictures;
+};
+
+/* copies every picture into an image of its own, like GetImage + CopyPicture */
+class CCopySink : public CPictureSink
+{
+public:
+  CCopySink() : m_target(NULL) {}
+  virtual ~CCopySink() { if (m_target) CDVDCodecUtils::FreePicture(m_target); }
+  virtual void Output(DVDVideoPicture& picture)
+  {
+    if (picture.format != RENDER_FMT_YUV420P)
+      return;
+    if (m_target && (m_target->iWidth != picture.iWidth || m_target->iHeight != picture.iHeight))
+    {
+      CDVDCodecUtils::FreePicture(m_target);
+      m_target = NULL;
+    }
+    if (!m_target)
+      m_target = CDVDCodecUtils::AllocatePicture(picture.iWidth, picture.iHeight);
+
+    int64_t start = CurrentHostCounter();
+    CDVDCodecUtils::CopyPicture(m_target, &picture);
+    m_time += CurrentHostCounter() - start;
+    m_bytes += picture.iWidth * picture.iHeight * 3 / 2;
+    m_pictures++;
+  }
+  DVDVideoPicture* m_target;
+};
+
+/* keeps references to the last decoder frames, like CLinuxRendererGL::AddVideoPicture */
+class CRefSink : public CPictureSink
+{
+public:
+  CRefSink() : m_next(0)
+  {
+    for (int i = 0; i < BENCHMARK_BUFFERS; i++)
+      m_frames[i] = av_frame_alloc();
+  }
+  virtual ~CRefSink()
+  {
+    for (int i = 0; i < BENCHMARK_BUFFERS; i++)
+      av_frame_free(&m_frames[i]);
+  }
+  virtual void Output(DVDVideoPicture& picture)
+  {
+    if (!(picture.iFlags & DVP_FLAG_FRAMEREF))
+      return;
+
+    int64_t start = CurrentHostCounter();
+    AVFrame* frame = m_frames[m_next];
+    m_next = (m_next + 1) % BENCHMARK_BUFFERS;
+    av_frame_unref(frame);
+    av_frame_ref(frame, picture.frame);
+    m_time += CurrentHostCounter() - start;
+    m_pictures++;
+  }
+  AVFrame* m_frames[BENCHMARK_BUFFERS];
+  int      m_next;
+};
+
+/* Decodes the first BENCHMARK_PACKETS packets of the first video stream,
+ * returns decoded frames per second or 0 if the file can't be decoded. */
+static double DecodeFile(const std::string& path, CDVDCodecOptions& options, DVDVideoDecodeStats& stats, CPictureSink* sink = NULL)
+{
+  std::auto_ptr<CDVDInputStream> input(CDVDFactoryInputStream::CreateInputStream(NULL, path, ""));
+  if (!input.get() || !input->Open(path.c_str(), ""))
+    return 0.0;
+
+  std::auto_ptr<CDVDDemux> demuxer(CDVDFactoryDemuxer::CreateDemuxer(input.get()));
+  if (!demuxer.get())
+    return 0.0;
+
+  int videoStream = -1;
+  for (int i = 0; i < demuxer->GetNrOfStreams(); i++)
+  {
+    if (demuxer->GetStream(i)->type == STREAM_VIDEO && videoStream < 0)
+      videoStream = i;
+    else
+      demuxer->GetStream(i)->SetDiscard(AVDISCARD_ALL);
+  }
+  if (videoStream < 0)
+    return 0.0;
+
+  CDVDStreamInfo hint(*demuxer->GetStream(videoStream), true);
+  std::auto_ptr<CDVDVideoCodec> codec(CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, options));
+  if (!codec.get())
+    return 0.0;
+
+  int frames = 0;
+  int64_t start = CurrentHostCounter();
+  for (int packets = 0; packets < BENCHMARK_PACKETS;)
+  {
+    DemuxPacket* packet = demuxer->Read();
+    if (!packet)
+      break;
+    if (packet->iStreamId != videoStream)
+    {
+      CDVDDemuxUtils::FreeDemuxPacket(packet);
+      continue;
+    }
+    packets++;
+
+    int state = codec->Decode(packet->pData, packet->iSize, packet->dts, packet->pts);
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+    while (state & VC_PICTURE)
+    {
+      DVDVideoPicture picture;
+      if (codec->GetPicture(&picture))
+      {
+        frames++;
+        if (sink)
+          sink->Output(picture);
+      }
+      state = codec->Decode(NULL, 0, DVD_NOPTS_VALUE, DVD_NOPTS_VALUE);
+    }
+    if (state & VC_ERROR)
+      break;
+  }
+  double seconds = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+
+  if (!codec->GetDecodeStats(stats))
+    memset(&stats, 0, sizeof(stats));
+  return frames / seconds;
+}
+
+/* run with --gtest_also_run_disabled_tests --set-media-samples-dir [DIR] */
+TEST(TestDVDVideoCodecFFmpeg, DISABLED_Benchmark)
+{
+  CStdString directory = CXBMCTestUtils::Instance().getMediaSamplesDirectory();
+  if (directory.empty())
+  {
+    printf("no media samples directory given\n");
+    return;
+  }
+
+  CFileItemList items;
+  ASSERT_TRUE(XFILE::CDirectory::GetDirectory(directory, items, g_advancedSettings.m_videoExtensions));
+
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (items[i]->m_bIsFolder)
+      continue;
+
+    CDVDCodecOptions single;
+    single.m_formats.push_back(RENDER_FMT_YUV420P);
+    single.m_keys.push_back(CDVDCodecOption("threads", "1"));
+    CDVDCodecOptions adaptive;
+    adaptive.m_formats.push_back(RENDER_FMT_YUV420P);
+
+    DVDVideoDecodeStats stats;
+    double singleFps = DecodeFile(items[i]->GetPath(), single, stats);
+    double adaptiveFps = DecodeFile(items[i]->GetPath(), adaptive, stats);
+    printf("%-40s 1 thread %7.1f fps, %2d %s threads %7.1f fps (%.1f/%.1fms per packet)\n",
+           URIUtils::GetFileName(items[i]->GetPath()).c_str(), singleFps,
+           stats.threads, stats.frameThreads ? "frame" : "slice", adaptiveFps,
+           stats.decodeTime, stats.peakTime);
+  }
+}
+
+/* run with --gtest_also_run_disabled_tests --set-media-samples-dir [DIR] */
+TEST(TestDVDVideoCodecFFmpeg, DISABLED_BenchmarkHandOff)
+{
+  CStdString directory = CXBMCTestUtils::Instance().getMediaSamplesDirectory();
+  if (directory.empty())
+  {
+    printf("no media samples directory given\n");
+    return;
+  }
+
+  CFileItemList items;
+  ASSERT_TRUE(XFILE::CDirectory::GetDirectory(directory, items, g_advancedSettings.m_videoExtensions));
+
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (items[i]->m_bIsFolder)
+      continue;
+
+    CDVDCodecOptions options;
+    options.m_formats.push_back(RENDER_FMT_YUV420P);
+
+    DVDVideoDecodeStats stats;
+    CCopySink copy;
+    CRefSink ref;
+    DecodeFile(items[i]->GetPath(), options, stats, &copy);
+    DecodeFile(items[i]->GetPath(), options, stats, &ref);
+    if (!copy.m_pictures || !ref.m_pictures)
+      continue;
+
+    double frequency = CurrentHostFrequency() / 1000000.0;
+    printf("%-40s copy %8.1fus %6.1fMB/frame, ref %6.2fus 0MB/frame\n",
+           URIUtils::GetFileName(items[i]->GetPath()).c_str(),
+           copy.m_time / frequency / copy.m_pictures,
+           (double)copy.m_bytes / copy.m_pictures / (1024 * 1024),
+           ref.m_time / frequency / ref.m_pictures);
+  }
+}
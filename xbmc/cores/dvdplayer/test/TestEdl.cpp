@@ -0,0 +1,239 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Edl.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+/*
+ * Writes cuts and scene markers to an EDL file next to a temporary movie file
+ * and reads them back with CEdl.
+ */
+class TestEdl : public testing::Test
+{
+protected:
+  TestEdl()
+  {
+    m_movie = XBMC_CREATETEMPFILE(".ts");
+    m_edlPath = URIUtils::ReplaceExtension(XBMC_TEMPFILEPATH(m_movie), ".edl");
+  }
+
+  ~TestEdl()
+  {
+    m_edl.Clear();
+    XFILE::CFile::Delete(m_edlPath);
+    XBMC_DELETETEMPFILE(m_movie);
+  }
+
+  bool Read()
+  {
+    CStdString buffer;
+    for (size_t i = 0; i < m_cuts.size(); i++)
+      buffer += StringUtils::Format("%d %d %d\n", (int)(m_cuts[i].start / 1000), (int)(m_cuts[i].end / 1000), m_cuts[i].action);
+    for (size_t i = 0; i < m_markers.size(); i++)
+      buffer += StringUtils::Format("%d 2\n", (int)(m_markers[i] / 1000));
+
+    XFILE::CFile file;
+    if (!file.OpenForWrite(m_edlPath, true))
+      return false;
+    file.Write(buffer.c_str(), buffer.size());
+    file.Close();
+
+    return m_edl.ReadEditDecisionLists(XBMC_TEMPFILEPATH(m_movie), 25.0f, 720);
+  }
+
+  /*
+   * Whole seconds, cuts and mutes with random lengths and gaps and a scene
+   * marker in every gap.
+   */
+  void Generate(int count)
+  {
+    srand(count);
+    int64_t time = 0;
+    for (int i = 0; i < count; i++)
+    {
+      CEdl::Cut cut;
+      cut.start  = time + (11 + rand() % 600) * 1000;
+      cut.end    = cut.start + (1 + rand() % 120) * 1000;
+      cut.action = rand() % 4 ? CEdl::CUT : CEdl::MUTE;
+      m_cuts.push_back(cut);
+      time = cut.end;
+
+      m_markers.push_back(cut.end + (1 + rand() % 10) * 1000);
+    }
+  }
+
+  /* what CEdl did before it kept an index of the cut times */
+  int64_t RemoveCutTime(int64_t seek) const
+  {
+    int64_t cutTime = 0;
+    for (size_t i = 0; i < m_cuts.size(); i++)
+    {
+      if (m_cuts[i].action == CEdl::CUT)
+      {
+        if (seek >= m_cuts[i].start && seek <= m_cuts[i].end)
+          cutTime += seek - m_cuts[i].start - 1;
+        else if (seek >= m_cuts[i].start)
+          cutTime += m_cuts[i].end - m_cuts[i].start;
+      }
+    }
+    return seek - cutTime;
+  }
+
+  int64_t RestoreCutTime(int64_t clock) const
+  {
+    for (size_t i = 0; i < m_cuts.size(); i++)
+    {
+      if (m_cuts[i].action == CEdl::CUT && clock >= m_cuts[i].start)
+        clock += m_cuts[i].end - m_cuts[i].start;
+    }
+    return clock;
+  }
+
+  XFILE::CFile* m_movie;
+  CStdString m_edlPath;
+  std::vector<CEdl::Cut> m_cuts;
+  std::vector<int64_t> m_markers;
+  CEdl m_edl;
+};
+
+TEST_F(TestEdl, InCut)
+{
+  Generate(50);
+  ASSERT_TRUE(Read());
+
+  for (size_t i = 0; i < m_cuts.size(); i++)
+  {
+    CEdl::Cut cut;
+    EXPECT_FALSE(m_edl.InCut(m_cuts[i].start - 1));
+    EXPECT_TRUE(m_edl.InCut(m_cuts[i].start, &cut));
+    EXPECT_EQ(m_cuts[i].start, cut.start);
+    EXPECT_EQ(m_cuts[i].action, cut.action);
+    EXPECT_TRUE(m_edl.InCut(m_cuts[i].end, &cut));
+    EXPECT_EQ(m_cuts[i].end, cut.end);
+    EXPECT_FALSE(m_edl.InCut(m_cuts[i].end + 1));
+  }
+}
+
+TEST_F(TestEdl, CutTime)
+{
+  Generate(200);
+  ASSERT_TRUE(Read());
+
+  int64_t total = 0;
+  for (size_t i = 0; i < m_cuts.size(); i++)
+  {
+    if (m_cuts[i].action == CEdl::CUT)
+      total += m_cuts[i].end - m_cuts[i].start;
+  }
+  EXPECT_EQ(total, m_edl.GetTotalCutTime());
+
+  int64_t end = m_cuts.back().end + 60000;
+  for (int64_t time = 0; time < end; time += 997)
+  {
+    ASSERT_EQ(RemoveCutTime(time), m_edl.RemoveCutTime(time)) << "at " << time;
+    ASSERT_EQ(RestoreCutTime(time), m_edl.RestoreCutTime(time)) << "at " << time;
+  }
+  for (size_t i = 0; i < m_cuts.size(); i++)
+  {
+    int64_t edges[] = { m_cuts[i].start - 1, m_cuts[i].start, m_cuts[i].end, m_cuts[i].end + 1 };
+    for (size_t j = 0; j < sizeof(edges) / sizeof(edges[0]); j++)
+    {
+      EXPECT_EQ(RemoveCutTime(edges[j]), m_edl.RemoveCutTime(edges[j]));
+      EXPECT_EQ(RestoreCutTime(edges[j]), m_edl.RestoreCutTime(edges[j]));
+    }
+  }
+}
+
+TEST_F(TestEdl, SceneMarkers)
+{
+  Generate(20);
+  ASSERT_TRUE(Read());
+  ASSERT_TRUE(m_edl.HasSceneMarker());
+
+  // markers come back in order, next to the clock with the cuts removed
+  int64_t marker;
+  int64_t seek = 0;
+  for (size_t i = 0; i < m_markers.size(); i++)
+  {
+    ASSERT_TRUE(m_edl.GetNextSceneMarker(true, m_edl.RemoveCutTime(seek), &marker));
+    EXPECT_EQ(m_markers[i], marker);
+    seek = marker;
+  }
+  EXPECT_FALSE(m_edl.GetNextSceneMarker(true, m_edl.RemoveCutTime(seek), &marker));
+
+  ASSERT_TRUE(m_edl.GetNextSceneMarker(false, m_edl.RemoveCutTime(seek), &marker));
+  EXPECT_EQ(m_markers[m_markers.size() - 2], marker);
+}
+
+TEST_F(TestEdl, MPlayerEdl)
+{
+  Generate(5);
+  ASSERT_TRUE(Read());
+  EXPECT_TRUE(XFILE::CFile::Exists(CEdl::GetMPlayerEdl()));
+
+  // copies leave the file to the CEdl that wrote it
+  {
+    CEdl copy(m_edl);
+    EXPECT_EQ(m_edl.GetTotalCutTime(), copy.GetTotalCutTime());
+  }
+  EXPECT_TRUE(XFILE::CFile::Exists(CEdl::GetMPlayerEdl()));
+  m_edl.Clear();
+  EXPECT_FALSE(XFILE::CFile::Exists(CEdl::GetMPlayerEdl()));
+
+  // the job leaves writing it to the player
+  CEdlJob job(XBMC_TEMPFILEPATH(m_movie), 25.0f, 720);
+  EXPECT_TRUE(job.DoWork());
+  EXPECT_TRUE(job.GetEdl().HasCut());
+  EXPECT_FALSE(XFILE::CFile::Exists(CEdl::GetMPlayerEdl()));
+}
+
+/* run with --gtest_also_run_disabled_tests */
+TEST_F(TestEdl, DISABLED_Benchmark)
+{
+  Generate(5000);
+
+  int64_t start = CurrentHostCounter();
+  ASSERT_TRUE(Read());
+  double read = (double)(CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency();
+
+  int64_t end = m_cuts.back().end;
+  int lookups = 0;
+  start = CurrentHostCounter();
+  for (int64_t time = 0; time < end; time += 997, lookups++)
+  {
+    m_edl.InCut(time);
+    m_edl.RemoveCutTime(time);
+    m_edl.RestoreCutTime(time);
+  }
+  double lookup = (double)(CurrentHostCounter() - start) * 1000000.0 / CurrentHostFrequency() / lookups;
+
+  printf("%d cuts read in %.1fms, %.3fus per InCut/RemoveCutTime/RestoreCutTime\n",
+         (int)m_cuts.size(), read, lookup);
+}
@@ -28,6 +28,7 @@
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
 #include "FileItem.h"
+#include "GUILargeTextureManager.h"
 #include "Key.h"
 #include "utils/MathUtils.h"
 #include "utils/XBMCTinyXML.h"
@@ -160,11 +161,8 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
     item->SetInvalid();
   if (focused)
   {
-    if (!item->GetFocusedLayout())
-    {
-      CGUIListItemLayout *layout = new CGUIListItemLayout(*m_focusedLayout);
-      item->SetFocusedLayout(layout);
-    }
+    if (!m_layoutPool.IsBound(item.get(), true))
+      m_layoutPool.Bind(item, *m_focusedLayout, true);
     if (item->GetFocusedLayout())
     {
       if (item != m_lastItem || !HasFocus())
@@ -181,17 +179,21 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
       }
       item->GetFocusedLayout()->Process(item.get(), m_parentID, currentTime, dirtyregions);
     }
+    if (HasFocus())
+    { // images are loaded outwards from the focused item
+      float width = m_focusedLayout->Size(HORIZONTAL);
+      float height = m_focusedLayout->Size(VERTICAL);
+      g_largeTextureManager.SetFocus(CRect(g_graphicsContext.ScaleFinalXCoord(0, 0), g_graphicsContext.ScaleFinalYCoord(0, 0),
+                                           g_graphicsContext.ScaleFinalXCoord(width, height), g_graphicsContext.ScaleFinalYCoord(width, height)));
+    }
     m_lastItem = item;
   }
   else
   {
     if (item->GetFocusedLayout())
       item->GetFocusedLayout()->SetFocusedItem(0);  // focus is not set
-    if (!item->GetLayout())
-    {
-      CGUIListItemLayout *layout = new CGUIListItemLayout(*m_layout);
-      item->SetLayout(layout);
-    }
+    if (!m_layoutPool.IsBound(item.get(), false))
+      m_layoutPool.Bind(item, *m_layout, false);
     if (item->GetFocusedLayout())
       item->GetFocusedLayout()->Process(item.get(), m_parentID, currentTime, dirtyregions);
     if (item->GetLayout())
@@ -821,15 +823,17 @@ void CGUIBaseContainer::FreeResources(bool immediately)
 
     m_listProvider->Reset(immediately);
   }
+  if (immediately)
+    m_layoutPool.Clear();
   m_scroller.Stop();
 }
 
 void CGUIBaseContainer::UpdateLayout(bool updateAllItems)
 {
   if (updateAllItems)
-  { // free memory of items
-    for (iItems it = m_items.begin(); it != m_items.end(); ++it)
-      (*it)->FreeMemory();
+  { // take back the layouts of items, so they're given the current ones.
+    // Items with layouts from elsewhere get ours as they come into view.
+    m_layoutPool.ReleaseAll();
   }
   // and recalculate the layout
   CalculateLayout();
@@ -1059,6 +1063,7 @@ int CGUIBaseContainer::CorrectOffset(int offset, int cursor) const
 void CGUIBaseContainer::Reset()
 {
   m_wasReset = true;
+  m_layoutPool.ReleaseAll();
   m_items.clear();
   m_lastItem.reset();
   ResetAutoScrolling();
@@ -1106,18 +1111,8 @@ void CGUIBaseContainer::SetRenderOffset(const CPoint &offset)
 
 void CGUIBaseContainer::FreeMemory(int keepStart, int keepEnd)
 {
-  if (keepStart < keepEnd)
-  { // remove before keepStart and after keepEnd
-    for (int i = 0; i < keepStart && i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
-    for (int i = std::max(keepEnd + 1, 0); i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
-  }
-  else
-  { // wrapping
-    for (int i = std::max(keepEnd + 1, 0); i < keepStart && i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
-  }
+  // the layouts of items before keepStart and after keepEnd are reused for the items coming into view
+  m_layoutPool.ReleaseUnused(m_items, keepStart, keepEnd);
 }
 
 bool CGUIBaseContainer::InsideLayout(const CGUIListItemLayout *layout, const CPoint &point) const
@@ -1132,7 +1127,10 @@ bool CGUIBaseContainer::InsideLayout(const CGUIListItemLayout *layout, const CPo
 #ifdef _DEBUG
 void CGUIBaseContainer::DumpTextureUse()
 {
-  CLog::Log(LOGDEBUG, "%s for container %u", __FUNCTION__, GetID());
+  unsigned int allocations, reuses;
+  m_layoutPool.GetStats(allocations, reuses);
+  CLog::Log(LOGDEBUG, "%s for container %u, %u layouts bound, %u free, %u allocated and %u reused since last time", __FUNCTION__, GetID(),
+            m_layoutPool.GetBoundCount(), m_layoutPool.GetFreeCount(), allocations, reuses);
   for (unsigned int i = 0; i < m_items.size(); ++i)
   {
     CGUIListItemPtr item = m_items[i];
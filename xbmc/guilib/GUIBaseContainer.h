@@ -27,6 +27,7 @@
 
 #include "IGUIContainer.h"
 #include "GUIListItemLayout.h"
+#include "GUIListItemLayoutPool.h"
 #include "utils/Stopwatch.h"
 
 /*!
@@ -150,6 +151,7 @@ protected:
 
   CGUIListItemLayout *m_layout;
   CGUIListItemLayout *m_focusedLayout;
+  CGUIListItemLayoutPool m_layoutPool; ///< copies of the layouts bound to the items in view
 
   void ScrollToOffset(int offset);
   void SetContainerMoving(int direction);
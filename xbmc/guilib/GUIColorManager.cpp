@@ -19,6 +19,7 @@
  */
 
 #include "GUIColorManager.h"
+#include "GUITextLayout.h"
 #include "filesystem/SpecialProtocol.h"
 #include "addons/Skin.h"
 #include "utils/log.h"
@@ -46,6 +47,7 @@ void CGUIColorManager::Clear()
 void CGUIColorManager::Load(const CStdString &colorFile)
 {
   Clear();
+  CGUITextLayout::ClearCache(); // layouts hold the colors of [COLOR] tags
 
   // load the global color map if it exists
   CXBMCTinyXML xmlDoc;
@@ -602,11 +602,11 @@ bool CGUIControl::UpdateColors()
   return m_diffuseColor.Update();
 }
 
-void CGUIControl::SetInitialVisibility()
+void CGUIControl::SetInitialVisibility(const CGUIListItem *item /* = NULL */)
 {
   if (m_visibleCondition)
   {
-    m_visibleFromSkinCondition = m_visibleCondition->Get();
+    m_visibleFromSkinCondition = m_visibleCondition->Get(item);
     m_visible = m_visibleFromSkinCondition ? VISIBLE : HIDDEN;
   //  CLog::Log(LOGDEBUG, "Set initial visibility for control %i: %s", m_controlID, m_visible == VISIBLE ? "visible" : "hidden");
   }
@@ -617,13 +617,13 @@ void CGUIControl::SetInitialVisibility()
   {
     CAnimation &anim = m_animations[i];
     if (anim.GetType() == ANIM_TYPE_CONDITIONAL)
-      anim.SetInitialCondition();
+      anim.SetInitialCondition(item);
   }
   // and check for conditional enabling - note this overrides SetEnabled() from the code currently
   // this may need to be reviewed at a later date
   if (m_enableCondition)
-    m_enabled = m_enableCondition->Get();
-  m_allowHiddenFocus.Update();
+    m_enabled = m_enableCondition->Get(item);
+  m_allowHiddenFocus.Update(item);
   UpdateColors();
 
   MarkDirtyRegion();
@@ -298,11 +298,11 @@ bool CGUIControlGroup::CanFocus() const
   return false;
 }
 
-void CGUIControlGroup::SetInitialVisibility()
+void CGUIControlGroup::SetInitialVisibility(const CGUIListItem *item /* = NULL */)
 {
-  CGUIControl::SetInitialVisibility();
+  CGUIControl::SetInitialVisibility(item);
   for (iControls it = m_children.begin(); it != m_children.end(); ++it)
-    (*it)->SetInitialVisibility();
+    (*it)->SetInitialVisibility(item);
 }
 
 void CGUIControlGroup::QueueAnimation(ANIMATION_TYPE animType)
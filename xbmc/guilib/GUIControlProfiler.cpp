@@ -19,6 +19,7 @@
  */
 
 #include "GUIControlProfiler.h"
+#include "GUIInfoManager.h"
 #include "utils/XBMCTinyXML.h"
 #include "utils/TimeUtils.h"
 #include "utils/StringUtils.h"
@@ -237,7 +238,8 @@ CGUIControlProfilerItem *CGUIControlProfilerItem::FindOrAddControl(CGUIControl *
 }
 
 CGUIControlProfiler::CGUIControlProfiler(void)
-: m_ItemHead(NULL, NULL, NULL), m_pLastItem(NULL), m_iMaxFrameCount(200), m_iFrameCount(0)
+: m_ItemHead(NULL, NULL, NULL), m_pLastItem(NULL), m_iMaxFrameCount(200), m_iFrameCount(0),
+  m_infoBools(0), m_infoLabels(0)
 // m_bIsRunning(false), no isRunning because it is static
 {
   m_fPerfScale = 100000.0f / CurrentHostFrequency();
@@ -260,6 +262,11 @@ void CGUIControlProfiler::Start(void)
   m_bIsRunning = true;
   m_pLastItem = NULL;
   m_ItemHead.Reset(this);
+
+  // drop what was evaluated before we started
+  g_infoManager.GetEvaluations(m_infoBools, m_infoLabels);
+  m_infoBools = 0;
+  m_infoLabels = 0;
 }
 
 void CGUIControlProfiler::BeginVisibility(CGUIControl *pControl)
@@ -316,6 +323,11 @@ CGUIControlProfilerItem *CGUIControlProfiler::FindOrAddControl(CGUIControl *pCon
 
 void CGUIControlProfiler::EndFrame(void)
 {
+  unsigned int bools, labels;
+  g_infoManager.GetEvaluations(bools, labels);
+  m_infoBools += bools;
+  m_infoLabels += labels;
+
   m_iFrameCount++;
   if (m_iFrameCount >= m_iMaxFrameCount)
   {
@@ -346,6 +358,13 @@ bool CGUIControlProfiler::SaveResults(void)
   CStdString str = StringUtils::Format("%d", m_iFrameCount);
   root->SetAttribute("framecount", str.c_str());
   root->SetAttribute("timeunit", "ms");
+  if (m_iFrameCount)
+  {
+    str = StringUtils::Format("%.1f", (float)m_infoBools / m_iFrameCount);
+    root->SetAttribute("infoboolsperframe", str.c_str());
+    str = StringUtils::Format("%.1f", (float)m_infoLabels / m_iFrameCount);
+    root->SetAttribute("infolabelsperframe", str.c_str());
+  }
   doc.LinkEndChild(root);
 
   m_ItemHead.SaveToXML(root);
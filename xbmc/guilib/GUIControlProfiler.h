@@ -91,6 +91,8 @@ private:
   CStdString m_strOutputFile;
   int m_iMaxFrameCount;
   int m_iFrameCount;
+  unsigned int m_infoBools;   // info bools evaluated while profiling
+  unsigned int m_infoLabels;  // info labels evaluated while profiling
 };
 
 #define GUIPROFILER_VISIBILITY_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginVisibility(x); }
@@ -0,0 +1,131 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIFontAtlas.h"
+
+using namespace std;
+
+// shelf heights are rounded up to this, so glyphs of similar height share shelves
+#define SHELF_GRANULARITY 4
+
+CGUIFontAtlas::CGUIFontAtlas(unsigned int width, unsigned int maxHeight)
+{
+  m_clock = 0;
+  m_evictions = 0;
+  Reset(width, maxHeight);
+}
+
+void CGUIFontAtlas::Reset(unsigned int width, unsigned int maxHeight)
+{
+  m_shelves.clear();
+  m_width = width;
+  m_maxHeight = maxHeight;
+  m_top = 0;
+}
+
+int CGUIFontAtlas::Allocate(unsigned int width, unsigned int height, unsigned int &x, unsigned int &y)
+{
+  if (width > m_width || height > m_maxHeight)
+    return -1;
+
+  unsigned int shelfHeight = (height + SHELF_GRANULARITY - 1) / SHELF_GRANULARITY * SHELF_GRANULARITY;
+  if (shelfHeight > m_maxHeight)
+    shelfHeight = height;
+
+  // prefer a shelf of the glyph's own height, then a new shelf, then the lowest shelf it fits in
+  int best = -1;
+  for (unsigned int i = 0; i < m_shelves.size(); i++)
+  {
+    const Shelf &shelf = m_shelves[i];
+    if (shelf.height < height || shelf.used + width > m_width)
+      continue;
+    if (shelf.height == shelfHeight)
+    {
+      best = i;
+      break;
+    }
+    if (best < 0 || shelf.height < m_shelves[best].height)
+      best = i;
+  }
+
+  if ((best < 0 || m_shelves[best].height != shelfHeight) && m_top + shelfHeight <= m_maxHeight)
+  {
+    Shelf shelf;
+    shelf.y = m_top;
+    shelf.height = shelfHeight;
+    shelf.used = 0;
+    shelf.glyphs = 0;
+    shelf.area = 0;
+    shelf.lastUse = m_clock;
+    m_shelves.push_back(shelf);
+    m_top += shelfHeight;
+    best = m_shelves.size() - 1;
+  }
+  if (best < 0)
+    return -1;
+
+  Shelf &shelf = m_shelves[best];
+  x = shelf.used;
+  y = shelf.y;
+  shelf.used += width;
+  shelf.glyphs++;
+  shelf.area += width * height;
+  shelf.lastUse = ++m_clock;
+  return best;
+}
+
+int CGUIFontAtlas::Evict(unsigned int height, unsigned int &y, unsigned int &shelfHeight)
+{
+  int oldest = -1;
+  for (unsigned int i = 0; i < m_shelves.size(); i++)
+  {
+    const Shelf &shelf = m_shelves[i];
+    if (shelf.height >= height && shelf.glyphs &&
+        (oldest < 0 || shelf.lastUse < m_shelves[oldest].lastUse))
+      oldest = i;
+  }
+  if (oldest < 0)
+    return -1;
+
+  Shelf &shelf = m_shelves[oldest];
+  shelf.used = 0;
+  shelf.glyphs = 0;
+  shelf.area = 0;
+  y = shelf.y;
+  shelfHeight = shelf.height;
+  m_evictions++;
+  return oldest;
+}
+
+void CGUIFontAtlas::GetStats(SGUIFontAtlasStats &stats) const
+{
+  stats.width = m_width;
+  stats.height = m_top;
+  stats.maxHeight = m_maxHeight;
+  stats.shelves = m_shelves.size();
+  stats.glyphs = 0;
+  stats.usedArea = 0;
+  for (vector<Shelf>::const_iterator i = m_shelves.begin(); i != m_shelves.end(); ++i)
+  {
+    stats.glyphs += i->glyphs;
+    stats.usedArea += i->area;
+  }
+  stats.evictions = m_evictions;
+}
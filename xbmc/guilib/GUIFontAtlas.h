@@ -0,0 +1,114 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <vector>
+
+/*!
+ \ingroup textures
+ \brief Occupancy of a glyph atlas
+ */
+struct SGUIFontAtlasStats
+{
+  SGUIFontAtlasStats() : width(0), height(0), maxHeight(0), shelves(0), glyphs(0), usedArea(0), evictions(0) {};
+
+  unsigned int width;     ///< width of the atlas
+  unsigned int height;    ///< rows used by shelves
+  unsigned int maxHeight; ///< rows the atlas may grow to
+  unsigned int shelves;
+  unsigned int glyphs;
+  uint64_t     usedArea;  ///< pixels covered by glyphs
+  unsigned int evictions; ///< shelves evicted to make room
+};
+
+/*!
+ \ingroup textures
+ \brief Shelf packer for the glyphs of a font texture
+
+ Glyphs are placed left to right on shelves (horizontal bands of the texture) of a
+ height rounded up from theirs, and new shelves are opened below the existing ones
+ until the maximum height is reached. After that, the least recently used shelf is
+ evicted and reused, rather than throwing away all glyphs at once.
+
+ Only does the bookkeeping - copying the glyphs to the texture and forgetting the
+ glyphs of evicted shelves is up to the font.
+ */
+class CGUIFontAtlas
+{
+public:
+  CGUIFontAtlas(unsigned int width = 0, unsigned int maxHeight = 0);
+
+  /*! \brief Empty the atlas
+   \param width width of the atlas
+   \param maxHeight number of rows the atlas may grow to
+   */
+  void Reset(unsigned int width, unsigned int maxHeight);
+
+  /*! \brief Find room for a glyph
+   \param width width of the glyph, including any spacing needed between glyphs
+   \param height height of the glyph, including any spacing needed between glyphs
+   \param x [out] left edge of the room found
+   \param y [out] top edge of the room found
+   \return the shelf holding the glyph, or -1 if the atlas is full.
+   \sa Evict
+   */
+  int Allocate(unsigned int width, unsigned int height, unsigned int &x, unsigned int &y);
+
+  /*! \brief Mark a shelf as used, so it's evicted last
+   */
+  inline void Touch(int shelf)
+  {
+    m_shelves[shelf].lastUse = ++m_clock;
+  }
+
+  /*! \brief Empty the least recently used shelf that a glyph fits in
+   \param height height of the glyph that needs room
+   \param y [out] top edge of the evicted shelf
+   \param shelfHeight [out] height of the evicted shelf
+   \return the evicted shelf, or -1 if no shelf is high enough.
+   */
+  int Evict(unsigned int height, unsigned int &y, unsigned int &shelfHeight);
+
+  /*! \brief Number of rows covered by shelves, which the texture needs to hold
+   */
+  unsigned int GetHeight() const { return m_top; };
+
+  void GetStats(SGUIFontAtlasStats &stats) const;
+
+private:
+  struct Shelf
+  {
+    unsigned int y;
+    unsigned int height;
+    unsigned int used;     ///< width taken up by glyphs
+    unsigned int glyphs;
+    uint64_t     area;
+    unsigned int lastUse;
+  };
+
+  std::vector<Shelf> m_shelves;
+  unsigned int m_width;
+  unsigned int m_maxHeight;
+  unsigned int m_top;
+  unsigned int m_clock;
+  unsigned int m_evictions;
+};
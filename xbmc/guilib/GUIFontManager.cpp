@@ -24,6 +24,7 @@
 #include "addons/Skin.h"
 #include "GUIFontTTF.h"
 #include "GUIFont.h"
+#include "GUITextLayout.h"
 #include "utils/XMLUtils.h"
 #include "GUIControlFactory.h"
 #include "filesystem/Directory.h"
@@ -208,6 +209,9 @@ void GUIFontManager::ReloadTTFFonts(void)
   if (!m_vecFonts.size())
     return;   // we haven't even loaded fonts in yet
 
+  // cached layouts were measured with the old font files
+  CGUITextLayout::ClearCache();
+
   for (unsigned int i = 0; i < m_vecFonts.size(); i++)
   {
     CGUIFont* font = m_vecFonts[i];
@@ -246,6 +250,7 @@ void GUIFontManager::Unload(const CStdString& strFontName)
   {
     if ((*iFont)->GetFontName().Equals(strFontName))
     {
+      CGUITextLayout::ClearCache();
       delete (*iFont);
       m_vecFonts.erase(iFont);
       return;
@@ -341,6 +346,9 @@ void GUIFontManager::Clear()
 
 void GUIFontManager::LoadFonts(const CStdString& strFontSet)
 {
+  // new fonts may reuse the addresses of the old ones
+  CGUITextLayout::ClearCache();
+
   CXBMCTinyXML xmlDoc;
   if (!OpenFontFile(xmlDoc))
     return;
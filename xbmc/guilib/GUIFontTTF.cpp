@@ -24,6 +24,8 @@
 #include "Texture.h"
 #include "GraphicContext.h"
 #include "filesystem/SpecialProtocol.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
 #include "utils/MathUtils.h"
 #include "utils/log.h"
 #include "windowing/WindowingFactory.h"
@@ -48,6 +50,7 @@ using namespace std;
 
 #define CHARS_PER_TEXTURE_LINE 20 // number of characters to cache per texture line
 #define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
+#define RASTERIZE_CHARS 256     // characters rasterized in the background
 
 int CGUIFontTTFBase::justification_word_weight = 6;   // weight of word spacing over letter spacing when justifying.
                                                   // A larger number means more of the "dead space" is placed between
@@ -78,10 +81,15 @@ public:
       return NULL;
     }
 
+    return LoadFace(m_library, filename, size, aspect);
+  };
+
+  static FT_Face LoadFace(FT_Library library, const CStdString &filename, float size, float aspect)
+  {
     FT_Face face;
 
     // ok, now load the font face
-    if (FT_New_Face( m_library, CSpecialProtocol::TranslatePath(filename).c_str(), 0, &face ))
+    if (FT_New_Face( library, CSpecialProtocol::TranslatePath(filename).c_str(), 0, &face ))
       return NULL;
 
     unsigned int ydpi = 72; // 72 points to the inch is the freetype default
@@ -131,6 +139,62 @@ private:
 XBMC_GLOBAL_REF(CFreeTypeLibrary, g_freeTypeLibrary); // our freetype library
 #define g_freeTypeLibrary XBMC_GLOBAL_USE(CFreeTypeLibrary)
 
+CGUIFontRasterizeJob::CGUIFontRasterizeJob(const CStdString &filename, float height, float aspect, const ResultPtr &result)
+ : m_result(result), m_filename(filename), m_height(height), m_aspect(aspect)
+{
+}
+
+bool CGUIFontRasterizeJob::DoWork()
+{
+  // FreeType libraries can't be shared between threads
+  FT_Library library;
+  if (FT_Init_FreeType(&library))
+    return false;
+  FT_Face face = CFreeTypeLibrary::LoadFace(library, m_filename, m_height, m_aspect);
+  if (!face)
+  {
+    FT_Done_FreeType(library);
+    return false;
+  }
+
+  std::vector<Glyph> glyphs(RASTERIZE_CHARS);
+  for (wchar_t letter = L' '; letter < RASTERIZE_CHARS; letter++)
+  {
+    if (letter == 0x7f)
+      letter = 0xa0; // skip the control characters
+
+    FT_Glyph glyph = NULL;
+    if (FT_Load_Glyph(face, FT_Get_Char_Index(face, letter), FT_LOAD_TARGET_LIGHT) ||
+        FT_Get_Glyph(face->glyph, &glyph))
+      continue;
+    if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, NULL, 1))
+    {
+      FT_Done_Glyph(glyph);
+      continue;
+    }
+
+    FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
+    Glyph &rasterized = glyphs[letter];
+    rasterized.left = bitGlyph->left;
+    rasterized.top = bitGlyph->top;
+    rasterized.width = bitGlyph->bitmap.width;
+    rasterized.rows = bitGlyph->bitmap.rows;
+    rasterized.advance = (float)MathUtils::round_int( (float)face->glyph->advance.x / 64 );
+    rasterized.pixels.resize(rasterized.width * rasterized.rows);
+    for (unsigned int y = 0; y < rasterized.rows; y++)
+      memcpy(&rasterized.pixels[y * rasterized.width], bitGlyph->bitmap.buffer + y * bitGlyph->bitmap.pitch, rasterized.width);
+    rasterized.valid = true;
+    FT_Done_Glyph(glyph);
+  }
+
+  FT_Done_Face(face);
+  FT_Done_FreeType(library);
+
+  CSingleLock lock(m_result->section);
+  m_result->glyphs.swap(glyphs);
+  return true;
+}
+
 CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
 {
   m_texture = NULL;
@@ -150,13 +214,13 @@ CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
   m_originX = m_originY = 0.0f;
   m_cellBaseLine = m_cellHeight = 0;
   m_numChars = 0;
-  m_posX = m_posY = 0;
   m_textureHeight = m_textureWidth = 0;
   m_textureScaleX = m_textureScaleY = 0.0;
   m_ellipsesWidth = m_height = 0.0f;
   m_color = 0;
   m_vertex_count = 0;
   m_nTexture = 0;
+  m_rasterizeJob = 0;
 }
 
 CGUIFontTTFBase::~CGUIFontTTFBase(void)
@@ -190,14 +254,19 @@ void CGUIFontTTFBase::ClearCharacterCache()
   memset(m_charquick, 0, sizeof(m_charquick));
   m_numChars = 0;
   m_maxChars = CHAR_CHUNK;
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)GetTextureLineHeight();
+  // our texture will be created on first character write.
+  m_atlas.Reset(m_textureWidth, g_Windowing.GetMaxTextureSize());
   m_textureHeight = 0;
 }
 
 void CGUIFontTTFBase::Clear()
 {
+  // a running job keeps its own reference to the result, and has no callback into us
+  if (m_rasterizeJob)
+    CJobManager::GetInstance().CancelJob(m_rasterizeJob);
+  m_rasterizeJob = 0;
+  m_rasterized.reset();
+
   delete(m_texture);
   m_texture = NULL;
   delete[] m_char;
@@ -205,8 +274,7 @@ void CGUIFontTTFBase::Clear()
   m_char = NULL;
   m_maxChars = 0;
   m_numChars = 0;
-  m_posX = 0;
-  m_posY = 0;
+  m_atlas.Reset(0, 0);
   m_nestedBeginCount = 0;
 
   if (m_face)
@@ -298,14 +366,20 @@ bool CGUIFontTTFBase::Load(const CStdString& strFilename, float height, float as
     m_textureWidth = g_Windowing.GetMaxTextureSize();
   m_textureScaleX = 1.0f / m_textureWidth;
 
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)GetTextureLineHeight();
+  // our texture will be created on first character write.
+  m_atlas.Reset(m_textureWidth, g_Windowing.GetMaxTextureSize());
 
   // cache the ellipses width
   Character *ellipse = GetCharacter(L'.');
   if (ellipse) m_ellipsesWidth = ellipse->advance;
 
+  // rasterize the rest of the common characters while the skin loads
+  if (!m_stroker && !m_rasterizeJob)
+  {
+    m_rasterized.reset(new CGUIFontRasterizeJob::Result);
+    m_rasterizeJob = CJobManager::GetInstance().AddJob(new CGUIFontRasterizeJob(strFilename, height, aspect, m_rasterized), NULL);
+  }
+
   return true;
 }
 
@@ -459,11 +533,6 @@ float CGUIFontTTFBase::GetLineHeight(float lineSpacing) const
 
 const unsigned int CGUIFontTTFBase::spacing_between_characters_in_texture = 1;
 
-unsigned int CGUIFontTTFBase::GetTextureLineHeight() const
-{
-  return m_cellHeight + spacing_between_characters_in_texture;
-}
-
 CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
 {
   wchar_t letter = (wchar_t)(chr & 0xffff);
@@ -478,7 +547,11 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   {
     character_t ch = (style << 8) | letter;
     if (m_charquick[ch])
+    {
+      if (m_charquick[ch]->shelf >= 0)
+        m_atlas.Touch(m_charquick[ch]->shelf);
       return m_charquick[ch];
+    }
   }
 
   // letters are stored based on style and letter
@@ -494,9 +567,45 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
     else if (ch < m_char[mid].letterAndStyle)
       high = mid - 1;
     else
+    {
+      if (m_char[mid].shelf >= 0)
+        m_atlas.Touch(m_char[mid].shelf);
       return &m_char[mid];
+    }
+  }
+
+  // render the character to our texture
+  // must End() as we can't render text to our texture during a Begin(), End() block
+  Character character;
+  unsigned int nestedBeginCount = m_nestedBeginCount;
+  m_nestedBeginCount = 1;
+  if (nestedBeginCount) End();
+  if (!CacheCharacter(letter, style, &character))
+  { // unable to cache character - try clearing them all out and starting over
+    CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, m_numChars);
+    ClearCharacterCache();
+    if (!CacheCharacter(letter, style, &character))
+    {
+      CLog::Log(LOGERROR, "%s: Unable to cache character (out of memory?)", __FUNCTION__);
+      if (nestedBeginCount) Begin();
+      m_nestedBeginCount = nestedBeginCount;
+      return NULL;
+    }
+  }
+  if (nestedBeginCount) Begin();
+  m_nestedBeginCount = nestedBeginCount;
+
+  // caching may have evicted characters, so find where the new one goes again
+  low = 0;
+  high = m_numChars;
+  while (low < high)
+  {
+    int mid = (low + high) >> 1;
+    if (ch > m_char[mid].letterAndStyle)
+      low = mid + 1;
+    else
+      high = mid;
   }
-  // if we get to here, then low is where we should insert the new character
 
   // increase the size of the buffer if we need it
   if (m_numChars >= m_maxChars)
@@ -516,26 +625,8 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   { // just move the data along as necessary
     memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
   }
-  // render the character to our texture
-  // must End() as we can't render text to our texture during a Begin(), End() block
-  unsigned int nestedBeginCount = m_nestedBeginCount;
-  m_nestedBeginCount = 1;
-  if (nestedBeginCount) End();
-  if (!CacheCharacter(letter, style, m_char + low))
-  { // unable to cache character - try clearing them all out and starting over
-    CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, m_numChars);
-    ClearCharacterCache();
-    low = 0;
-    if (!CacheCharacter(letter, style, m_char + low))
-    {
-      CLog::Log(LOGERROR, "%s: Unable to cache character (out of memory?)", __FUNCTION__);
-      if (nestedBeginCount) Begin();
-      m_nestedBeginCount = nestedBeginCount;
-      return NULL;
-    }
-  }
-  if (nestedBeginCount) Begin();
-  m_nestedBeginCount = nestedBeginCount;
+  m_char[low] = character;
+  m_numChars++;
 
   // fixup quick access
   memset(m_charquick, 0, sizeof(m_charquick));
@@ -553,6 +644,29 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
 
 bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
 {
+  // the common characters may have been rasterized in the background already
+  if (!style && letter < RASTERIZE_CHARS && !m_stroker && m_rasterized)
+  {
+    CSingleLock lock(m_rasterized->section);
+    std::vector<CGUIFontRasterizeJob::Glyph> &glyphs = m_rasterized->glyphs;
+    if (letter < (wchar_t)glyphs.size() && glyphs[letter].valid)
+    {
+      CGUIFontRasterizeJob::Glyph &rasterized = glyphs[letter];
+      FT_BitmapGlyphRec bitGlyph;
+      memset(&bitGlyph, 0, sizeof(bitGlyph));
+      bitGlyph.left = rasterized.left;
+      bitGlyph.top = rasterized.top;
+      bitGlyph.bitmap.width = rasterized.width;
+      bitGlyph.bitmap.rows = rasterized.rows;
+      bitGlyph.bitmap.pitch = rasterized.width;
+      bitGlyph.bitmap.buffer = rasterized.pixels.empty() ? NULL : &rasterized.pixels[0];
+      bool placed = PlaceCharacter(letter, style, &bitGlyph, rasterized.advance, ch);
+      rasterized.valid = false;
+      vector<unsigned char>().swap(rasterized.pixels);
+      return placed;
+    }
+  }
+
   int glyph_index = FT_Get_Char_Index( m_face, letter );
 
   FT_Glyph glyph = NULL;
@@ -581,50 +695,55 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
     CLog::Log(LOGDEBUG, "%s Failed to render glyph %x to a bitmap", __FUNCTION__, letter);
     return false;
   }
-  FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
+  bool placed = PlaceCharacter(letter, style, (FT_BitmapGlyph)glyph, (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 ), ch);
+
+  // free the glyph
+  FT_Done_Glyph(glyph);
+
+  return placed;
+}
+
+bool CGUIFontTTFBase::PlaceCharacter(wchar_t letter, uint32_t style, FT_BitmapGlyph bitGlyph, float advance, Character *ch)
+{
   FT_Bitmap bitmap = bitGlyph->bitmap;
   bool isEmptyGlyph = (bitmap.width == 0 || bitmap.rows == 0);
 
+  unsigned int x = 0, y = 0;
+  int shelf = -1;
   if (!isEmptyGlyph)
   {
-    if (bitGlyph->left < 0)
-      m_posX += -bitGlyph->left;
-
     // check we have enough room for the character
-    if (m_posX + bitGlyph->left + bitmap.width > (int)m_textureWidth)
-    { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
-      m_posX = 0;
-      m_posY += GetTextureLineHeight();
-      if (bitGlyph->left < 0)
-        m_posX += -bitGlyph->left;
-
-      if(m_posY + GetTextureLineHeight() >= m_textureHeight)
-      {
-        // create the new larger texture
-        unsigned int newHeight = m_posY + GetTextureLineHeight();
-        // check for max height
-        if (newHeight > g_Windowing.GetMaxTextureSize())
-        {
-          CLog::Log(LOGDEBUG, "%s: New cache texture is too large (%u > %u pixels long)", __FUNCTION__, newHeight, g_Windowing.GetMaxTextureSize());
-          FT_Done_Glyph(glyph);
-          return false;
-        }
+    unsigned int width = bitmap.width + spacing_between_characters_in_texture;
+    unsigned int height = bitmap.rows + spacing_between_characters_in_texture;
+    shelf = m_atlas.Allocate(width, height, x, y);
+    if (shelf < 0)
+    { // no space - make room by dropping the characters that haven't been used for the longest time
+      unsigned int shelfY, shelfHeight;
+      int evicted = m_atlas.Evict(height, shelfY, shelfHeight);
+      if (evicted < 0)
+        return false;
+      EvictShelf(evicted, shelfY, shelfHeight);
+      shelf = m_atlas.Allocate(width, height, x, y);
+      if (shelf < 0)
+        return false;
+    }
 
-        CBaseTexture* newTexture = NULL;
-        newTexture = ReallocTexture(newHeight);
-        if(newTexture == NULL)
-        {
-          FT_Done_Glyph(glyph);
-          CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
-          return false;
-        }
-        m_texture = newTexture;
+    if (m_atlas.GetHeight() > m_textureHeight)
+    {
+      // create the new larger texture
+      unsigned int newHeight = m_atlas.GetHeight();
+      CBaseTexture* newTexture = NULL;
+      newTexture = ReallocTexture(newHeight);
+      if(newTexture == NULL)
+      {
+        CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
+        return false;
       }
+      m_texture = newTexture;
     }
 
     if(m_texture == NULL)
     {
-      FT_Done_Glyph(glyph);
       CLog::Log(LOGDEBUG, "%s: no texture to cache character to", __FUNCTION__);
       return false;
     }
@@ -633,32 +752,57 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   ch->letterAndStyle = (style << 16) | letter;
   ch->offsetX = (short)bitGlyph->left;
   ch->offsetY = (short)m_cellBaseLine - bitGlyph->top;
-  ch->left = isEmptyGlyph ? 0 : ((float)m_posX + ch->offsetX);
-  ch->top = isEmptyGlyph ? 0 : ((float)m_posY + ch->offsetY);
+  ch->left = (float)x;
+  ch->top = (float)y;
   ch->right = ch->left + bitmap.width;
   ch->bottom = ch->top + bitmap.rows;
-  ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  ch->advance = advance;
+  ch->shelf = shelf;
 
   // we need only render if we actually have some pixels
   if (!isEmptyGlyph)
   {
     // ensure our rect will stay inside the texture (it *should* but we need to be certain)
-    unsigned int x1 = max(m_posX + ch->offsetX, 0);
-    unsigned int y1 = max(m_posY + ch->offsetY, 0);
-    unsigned int x2 = min(x1 + bitmap.width, m_textureWidth);
-    unsigned int y2 = min(y1 + bitmap.rows, m_textureHeight);
-    CopyCharToTexture(bitGlyph, x1, y1, x2, y2);
-  
-    m_posX += spacing_between_characters_in_texture + (unsigned short)max(ch->right - ch->left + ch->offsetX, ch->advance);
+    unsigned int x2 = min(x + bitmap.width, m_textureWidth);
+    unsigned int y2 = min(y + bitmap.rows, m_textureHeight);
+    CopyCharToTexture(bitGlyph, x, y, x2, y2);
   }
-  m_numChars++;
-
-  // free the glyph
-  FT_Done_Glyph(glyph);
 
   return true;
 }
 
+void CGUIFontTTFBase::EvictShelf(int shelf, unsigned int y, unsigned int height)
+{
+  // forget the characters on the shelf
+  int count = 0;
+  for (int i = 0; i < m_numChars; i++)
+  {
+    if (m_char[i].shelf != shelf)
+      m_char[count++] = m_char[i];
+  }
+  m_numChars = count;
+
+  // and blank it out, so nothing bleeds into the characters that take its place
+  if (m_texture && y < m_textureHeight)
+  {
+    height = min(height, m_textureHeight - y);
+    vector<unsigned char> blank(m_textureWidth * height);
+    FT_BitmapGlyphRec bitGlyph;
+    memset(&bitGlyph, 0, sizeof(bitGlyph));
+    bitGlyph.bitmap.width = m_textureWidth;
+    bitGlyph.bitmap.rows = height;
+    bitGlyph.bitmap.pitch = m_textureWidth;
+    bitGlyph.bitmap.buffer = &blank[0];
+    CopyCharToTexture(&bitGlyph, 0, y, m_textureWidth, y + height);
+  }
+
+  SGUIFontAtlasStats stats;
+  m_atlas.GetStats(stats);
+  CLog::Log(LOGDEBUG, "%s: evicted a character row of %s at %.1f, %u of %u rows used, %u%% covered, %u evictions", __FUNCTION__,
+            m_strFileName.c_str(), m_height, stats.height, stats.maxHeight,
+            (unsigned int)(stats.usedArea * 100 / max<uint64_t>((uint64_t)stats.width * stats.height, 1)), stats.evictions);
+}
+
 void CGUIFontTTFBase::RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX)
 {
   // actual image width isn't same as the character width as that is
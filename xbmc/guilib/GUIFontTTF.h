@@ -27,6 +27,12 @@
  *
  */
 
+#include "GUIFontAtlas.h"
+#include "threads/CriticalSection.h"
+#include "utils/Job.h"
+#include "utils/StdString.h"
+#include "boost/shared_ptr.hpp"
+
 // forward definition
 class CBaseTexture;
 
@@ -64,6 +70,46 @@ struct SVertex
 };
 
 
+/*!
+ \ingroup textures
+ \brief Rasterizes the ASCII and latin-1 characters of a font in the background
+
+ Uses a FreeType library and face of its own, so it can run while the font is in use.
+ Only the normal style is rasterized.
+ */
+class CGUIFontRasterizeJob : public CJob
+{
+public:
+  struct Glyph
+  {
+    Glyph() : valid(false), left(0), top(0), width(0), rows(0), advance(0) {};
+
+    bool valid;
+    int left, top;
+    unsigned int width, rows;
+    float advance;
+    std::vector<unsigned char> pixels; ///< rows of width bytes
+  };
+
+  /* what the job hands over, shared with the font so either can go first */
+  struct Result
+  {
+    CCriticalSection section;
+    std::vector<Glyph> glyphs;          ///< indexed by character, empty until the job is done
+  };
+  typedef boost::shared_ptr<Result> ResultPtr;
+
+  CGUIFontRasterizeJob(const CStdString &filename, float height, float aspect, const ResultPtr &result);
+  virtual bool DoWork();
+  virtual const char *GetType() const { return "fontrasterize"; };
+
+private:
+  ResultPtr m_result;
+  CStdString m_filename;
+  float m_height;
+  float m_aspect;
+};
+
 class CGUIFontTTFBase
 {
   friend class CGUIFont;
@@ -82,6 +128,10 @@ public:
 
   const CStdString& GetFileName() const { return m_strFileName; };
 
+  /*! \brief Get the occupancy of the texture holding the rendered characters
+   */
+  void GetAtlasStats(SGUIFontAtlasStats &stats) const { m_atlas.GetStats(stats); };
+
 protected:
   struct Character
   {
@@ -89,6 +139,7 @@ protected:
     float left, top, right, bottom;
     float advance;
     character_t letterAndStyle;
+    int shelf;                        ///< atlas shelf, or -1 for an empty glyph
   };
   void AddReference();
   void RemoveReference();
@@ -109,6 +160,8 @@ protected:
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
+  bool PlaceCharacter(wchar_t letter, uint32_t style, FT_BitmapGlyph bitGlyph, float advance, Character *ch);
+  void EvictShelf(int shelf, unsigned int y, unsigned int height);
   void RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX);
   void ClearCharacterCache();
 
@@ -124,13 +177,8 @@ protected:
 
   unsigned int m_textureWidth;       // width of our texture
   unsigned int m_textureHeight;      // heigth of our texture
-  int m_posX;                        // current position in the texture
-  int m_posY;
+  CGUIFontAtlas m_atlas;             // where the characters are in our texture
 
-  /*! \brief the height of each line in the texture.
-   Accounts for spacing between lines to avoid characters overlapping.
-   */
-  unsigned int GetTextureLineHeight() const;
   static const unsigned int spacing_between_characters_in_texture;
 
   color_t m_color;
@@ -168,6 +216,10 @@ protected:
 
   CStdString m_strFileName;
 
+  // characters rasterized in the background, used when first needed
+  CGUIFontRasterizeJob::ResultPtr m_rasterized;
+  unsigned int m_rasterizeJob;
+
 private:
   CGUIFontTTFBase(const CGUIFontTTFBase&);
   CGUIFontTTFBase& operator=(const CGUIFontTTFBase&);
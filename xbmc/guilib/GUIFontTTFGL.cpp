@@ -25,6 +25,7 @@
 #include "Texture.h"
 #include "TextureManager.h"
 #include "GraphicContext.h"
+#include "GUIRenderBatch.h"
 #include "gui3d.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
@@ -54,6 +55,9 @@ void CGUIFontTTFGL::Begin()
 {
   if (m_nestedBeginCount == 0 && m_texture != NULL)
   {
+    // text is drawn over the textures recorded before it
+    CGUIRenderBatch::Get().Flush();
+
     if (!m_bTextureLoaded)
     {
       // Have OpenGL generate a texture object handle for us
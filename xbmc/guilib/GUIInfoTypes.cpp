@@ -121,7 +121,7 @@ void CGUIInfoColor::Parse(const CStdString &label, int context)
     m_color = g_colorManager.GetColor(label);
 }
 
-CGUIInfoLabel::CGUIInfoLabel()
+CGUIInfoLabel::CGUIInfoLabel() : m_sources(INFO::INFO_SOURCE_NONE), m_cacheValid(false)
 {
 }
 
@@ -134,10 +134,28 @@ void CGUIInfoLabel::SetLabel(const CStdString &label, const CStdString &fallback
 {
   m_fallback = fallback;
   Parse(label, context);
+
+  m_sources = INFO::INFO_SOURCE_NONE;
+  for (vector<CInfoPortion>::const_iterator i = m_info.begin(); i != m_info.end(); ++i)
+  {
+    if (i->m_info)
+      m_sources |= g_infoManager.GetInfoSources(i->m_info);
+  }
+  m_cacheValid = false;
 }
 
 CStdString CGUIInfoLabel::GetLabel(int contextWindow, bool preferImage, CStdString *fallback /*= NULL*/) const
 {
+  // a label that doesn't change every frame is kept until one of its sources changes
+  bool cache = !fallback && !(m_sources & INFO::INFO_SOURCE_FRAME);
+  unsigned int stamp = 0;
+  if (cache)
+  {
+    stamp = g_infoManager.GetSourceStamp(m_sources);
+    if (m_cacheValid && m_cacheStamp == stamp && m_cacheContext == contextWindow && m_cachePreferImage == preferImage)
+      return m_cacheLabel;
+  }
+
   CStdString label;
   for (unsigned int i = 0; i < m_info.size(); i++)
   {
@@ -158,7 +176,16 @@ CStdString CGUIInfoLabel::GetLabel(int contextWindow, bool preferImage, CStdStri
     }
   }
   if (label.empty())  // empty label, use the fallback
-    return m_fallback;
+    label = m_fallback;
+
+  if (cache)
+  {
+    m_cacheLabel = label;
+    m_cacheStamp = stamp;
+    m_cacheContext = contextWindow;
+    m_cachePreferImage = preferImage;
+    m_cacheValid = true;
+  }
   return label;
 }
 
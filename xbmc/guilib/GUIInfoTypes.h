@@ -132,6 +132,13 @@ private:
 
   CStdString m_fallback;
   std::vector<CInfoPortion> m_info;
+
+  unsigned int m_sources;                ///< INFO::InfoSource flags of all the infos in the label
+  mutable CStdString m_cacheLabel;       ///< label from the last GetLabel(), unless it depends on INFO_SOURCE_FRAME
+  mutable unsigned int m_cacheStamp;     ///< stamp of the sources when the label was cached
+  mutable int m_cacheContext;
+  mutable bool m_cachePreferImage;
+  mutable bool m_cacheValid;
 };
 
 #endif
@@ -393,6 +393,14 @@ CGUIListItemLayout *CGUIListItem::GetFocusedLayout()
   return m_focusedLayout;
 }
 
+CGUIListItemLayout *CGUIListItem::DetachLayout(bool focused)
+{
+  CGUIListItemLayout *&layout = focused ? m_focusedLayout : m_layout;
+  CGUIListItemLayout *detached = layout;
+  layout = NULL;
+  return detached;
+}
+
 void CGUIListItem::SetInvalid()
 {
   if (m_layout) m_layout->SetInvalid();
@@ -145,6 +145,12 @@ public:
   void SetFocusedLayout(CGUIListItemLayout *layout);
   CGUIListItemLayout *GetFocusedLayout();
 
+  /*! \brief Take a layout from the item without freeing it, e.g. to reuse it for another item
+   \param focused whether to take the focused layout
+   \return the layout, which the caller now owns
+   */
+  CGUIListItemLayout *DetachLayout(bool focused);
+
   void FreeIcons();
   void FreeMemory(bool immediately = false);
   void SetInvalid();
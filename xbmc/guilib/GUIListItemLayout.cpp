@@ -63,6 +63,15 @@ void CGUIListItemLayout::ResetAnimation(ANIMATION_TYPE animType)
   return m_group.ResetAnimation(animType);
 }
 
+void CGUIListItemLayout::Reset(const CGUIListItem *item)
+{
+  m_group.ResetAnimations();
+  m_group.SetInitialVisibility(item);
+  m_group.SetFocusedItem(0);
+  // invalidates the labels as well, so they scroll from the start
+  SetInvalid();
+}
+
 float CGUIListItemLayout::Size(ORIENTATION orientation) const
 {
   return (orientation == HORIZONTAL) ? m_width : m_height;
@@ -43,6 +43,11 @@ public:
   bool IsAnimating(ANIMATION_TYPE animType);
   void ResetAnimation(ANIMATION_TYPE animType);
   void SetInvalid() { m_invalidated = true; };
+  /*! \brief Set up the controls to show another item, as if they were never shown before.
+   Running animations are stopped, visibility and conditional animations are taken from the
+   item straight away and labels start to scroll from the beginning.
+   */
+  void Reset(const CGUIListItem *item);
   void FreeResources(bool immediately = false);
 
 //#ifdef PRE_SKIN_VERSION_9_10_COMPATIBILITY
@@ -0,0 +1,190 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIListItemLayoutPool.h"
+#include "GUIListItem.h"
+#include "GUIListItemLayout.h"
+
+#include <algorithm>
+
+CGUIListItemLayoutPool::CGUIListItemLayoutPool()
+{
+  m_maxFree = 0;
+  m_allocations = 0;
+  m_reuses = 0;
+}
+
+CGUIListItemLayoutPool::CGUIListItemLayoutPool(const CGUIListItemLayoutPool &from)
+{
+  m_maxFree = 0;
+  m_allocations = 0;
+  m_reuses = 0;
+}
+
+CGUIListItemLayoutPool &CGUIListItemLayoutPool::operator=(const CGUIListItemLayoutPool &from)
+{
+  if (this != &from)
+    Clear();
+  return *this;
+}
+
+CGUIListItemLayoutPool::~CGUIListItemLayoutPool()
+{
+  Clear();
+}
+
+bool CGUIListItemLayoutPool::IsBound(CGUIListItem *item, bool focused) const
+{
+  for (std::vector<Binding>::const_iterator i = m_bound.begin(); i != m_bound.end(); ++i)
+  {
+    if (i->item.get() == item && i->focused == focused)
+      return (focused ? item->GetFocusedLayout() : item->GetLayout()) == i->layout;
+  }
+  return false;
+}
+
+void CGUIListItemLayoutPool::Bind(const CGUIListItemPtr &item, const CGUIListItemLayout &layout, bool focused)
+{
+  // take back what we bound to the item before, if it still has it
+  for (std::vector<Binding>::iterator i = m_bound.begin(); i != m_bound.end(); ++i)
+  {
+    if (i->item == item && i->focused == focused)
+    {
+      Binding binding = *i;
+      m_bound.erase(i);
+      Release(binding);
+      break;
+    }
+  }
+
+  Binding binding;
+  binding.item = item;
+  binding.source = &layout;
+  binding.focused = focused;
+
+  std::vector<CGUIListItemLayout*> &free = m_free[&layout];
+  if (free.empty())
+  {
+    binding.layout = new CGUIListItemLayout(layout);
+    m_allocations++;
+  }
+  else
+  { // the last item may have left controls hidden, animating or scrolled
+    binding.layout = free.back();
+    free.pop_back();
+    binding.layout->Reset(item.get());
+    m_reuses++;
+  }
+
+  if (focused)
+    item->SetFocusedLayout(binding.layout);
+  else
+    item->SetLayout(binding.layout);
+  m_bound.push_back(binding);
+}
+
+void CGUIListItemLayoutPool::ReleaseUnused(const std::vector<CGUIListItemPtr> &items, int keepStart, int keepEnd)
+{
+  if (keepStart == keepEnd)
+    return; // a wrapping range that keeps everything
+
+  int size = (int)items.size();
+  m_keep.clear();
+  if (keepStart < keepEnd)
+  {
+    for (int i = std::max(keepStart, 0); i <= keepEnd && i < size; ++i)
+      m_keep.push_back(items[i].get());
+  }
+  else
+  { // wrapping
+    for (int i = std::max(keepStart, 0); i < size; ++i)
+      m_keep.push_back(items[i].get());
+    for (int i = 0; i <= keepEnd && i < size; ++i)
+      m_keep.push_back(items[i].get());
+  }
+  std::sort(m_keep.begin(), m_keep.end());
+  m_maxFree = m_keep.size();
+
+  for (size_t i = 0; i < m_bound.size(); )
+  {
+    if (std::binary_search(m_keep.begin(), m_keep.end(), m_bound[i].item.get()))
+      ++i;
+    else
+    {
+      Binding binding = m_bound[i];
+      m_bound[i] = m_bound.back();
+      m_bound.pop_back();
+      Release(binding);
+    }
+  }
+}
+
+void CGUIListItemLayoutPool::ReleaseAll()
+{
+  m_maxFree = std::max(m_maxFree, (unsigned int)m_bound.size());
+  std::vector<Binding> bound;
+  bound.swap(m_bound);
+  for (std::vector<Binding>::const_iterator i = bound.begin(); i != bound.end(); ++i)
+    Release(*i);
+}
+
+void CGUIListItemLayoutPool::Clear()
+{
+  ReleaseAll();
+  for (FreeMap::iterator i = m_free.begin(); i != m_free.end(); ++i)
+  {
+    for (std::vector<CGUIListItemLayout*>::iterator j = i->second.begin(); j != i->second.end(); ++j)
+      delete *j;
+  }
+  m_free.clear();
+  m_maxFree = 0;
+}
+
+void CGUIListItemLayoutPool::GetStats(unsigned int &allocations, unsigned int &reuses)
+{
+  allocations = m_allocations;
+  reuses = m_reuses;
+  m_allocations = 0;
+  m_reuses = 0;
+}
+
+unsigned int CGUIListItemLayoutPool::GetFreeCount() const
+{
+  unsigned int count = 0;
+  for (FreeMap::const_iterator i = m_free.begin(); i != m_free.end(); ++i)
+    count += i->second.size();
+  return count;
+}
+
+void CGUIListItemLayoutPool::Release(const Binding &binding)
+{
+  CGUIListItem *item = binding.item.get();
+  if ((binding.focused ? item->GetFocusedLayout() : item->GetLayout()) != binding.layout)
+    return; // the item has freed our layout itself
+
+  CGUIListItemLayout *layout = item->DetachLayout(binding.focused);
+  layout->FreeResources();
+
+  std::vector<CGUIListItemLayout*> &free = m_free[binding.source];
+  if (free.size() < m_maxFree)
+    free.push_back(layout);
+  else
+    delete layout;
+}
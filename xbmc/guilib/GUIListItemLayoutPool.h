@@ -0,0 +1,104 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "boost/shared_ptr.hpp"
+
+#include <map>
+#include <vector>
+
+class CGUIListItem;
+class CGUIListItemLayout;
+typedef boost::shared_ptr<CGUIListItem> CGUIListItemPtr;
+
+/*!
+ \ingroup controls
+ \brief Hands out the item layouts of a container, reusing the ones of items scrolled out of view
+
+ A container binds a copy of its layout to each item it shows. Once an item is outside the
+ range the container keeps, its layout is taken back and bound to the next item that needs
+ one, rather than deleted, so scrolling a long list allocates no layouts once the pool holds
+ enough for the visible items and their cache. A layout that is bound again is reset in
+ place, so nothing the last item did to its controls shows. Only the bound items are looked
+ at, so the work doesn't grow with the size of the list.
+ */
+class CGUIListItemLayoutPool
+{
+public:
+  CGUIListItemLayoutPool();
+  /*! \brief Copies start out empty, as the layouts belong to the container that bound them */
+  CGUIListItemLayoutPool(const CGUIListItemLayoutPool &from);
+  CGUIListItemLayoutPool &operator=(const CGUIListItemLayoutPool &from);
+  ~CGUIListItemLayoutPool();
+
+  /*! \brief Check whether an item has a layout bound by this pool
+   \param item the item to check
+   \param focused whether to check the focused layout
+   \return true if the item has the layout this pool bound to it
+   */
+  bool IsBound(CGUIListItem *item, bool focused) const;
+
+  /*! \brief Bind a copy of a layout to an item, replacing any layout the item had
+   \param item the item to give the layout
+   \param layout the layout to copy, which must outlive the copies (see Clear())
+   \param focused whether to set the focused layout of the item
+   */
+  void Bind(const CGUIListItemPtr &item, const CGUIListItemLayout &layout, bool focused);
+
+  /*! \brief Take back the layouts of the items outside a range
+   \param items the items of the container
+   \param keepStart the first item to keep
+   \param keepEnd the last item to keep. If before keepStart the range wraps around the end.
+   */
+  void ReleaseUnused(const std::vector<CGUIListItemPtr> &items, int keepStart, int keepEnd);
+
+  /*! \brief Take back the layouts of all items, keeping them for reuse */
+  void ReleaseAll();
+
+  /*! \brief Take back the layouts of all items and free them, e.g. when the layouts they copy go away */
+  void Clear();
+
+  /*! \brief Get the number of layouts allocated and reused since the last call */
+  void GetStats(unsigned int &allocations, unsigned int &reuses);
+
+  unsigned int GetBoundCount() const { return m_bound.size(); };
+  unsigned int GetFreeCount() const;
+
+private:
+  struct Binding
+  {
+    CGUIListItemPtr item;
+    CGUIListItemLayout *layout;
+    const CGUIListItemLayout *source;   ///< the layout this one is a copy of
+    bool focused;
+  };
+
+  void Release(const Binding &binding);
+
+  typedef std::map<const CGUIListItemLayout*, std::vector<CGUIListItemLayout*> > FreeMap;
+
+  std::vector<Binding> m_bound;
+  FreeMap m_free;                       ///< unbound layouts, by the layout they are a copy of
+  std::vector<CGUIListItem*> m_keep;    ///< the items kept by ReleaseUnused(), sorted
+  unsigned int m_maxFree;               ///< the most layouts of each kind to keep for reuse
+  unsigned int m_allocations;
+  unsigned int m_reuses;
+};
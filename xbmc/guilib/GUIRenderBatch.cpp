@@ -0,0 +1,136 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIRenderBatch.h"
+
+#include <algorithm>
+
+using namespace std;
+
+// how many batches a quad may move back past to join a batch with its state
+#define MAX_LOOKBACK 16
+
+void CGUIRenderBackendNull::Submit(const SGUIRenderState &state, const SGUIVertex *vertices, unsigned int count)
+{
+  DrawCall call;
+  call.state = state;
+  call.vertices.assign(vertices, vertices + count);
+  m_drawCalls.push_back(call);
+}
+
+CGUIRenderBatch::CGUIRenderBatch()
+{
+  m_backend = NULL;
+  m_used = 0;
+  m_quads = 0;
+  m_drawCalls = 0;
+}
+
+CGUIRenderBatch &CGUIRenderBatch::Get()
+{
+  static CGUIRenderBatch sRenderBatch;
+  return sRenderBatch;
+}
+
+void CGUIRenderBatch::SetBackend(IGUIRenderBackend *backend)
+{
+  Flush();
+  m_backend = backend;
+}
+
+void CGUIRenderBatch::AddQuad(const SGUIRenderState &state, const SGUIVertex *vertices)
+{
+  float x1 = vertices[0].x, y1 = vertices[0].y, x2 = x1, y2 = y1;
+  bool flat = true;
+  for (int i = 0; i < 4; i++)
+  {
+    x1 = min(x1, vertices[i].x);
+    y1 = min(y1, vertices[i].y);
+    x2 = max(x2, vertices[i].x);
+    y2 = max(y2, vertices[i].y);
+    flat &= vertices[i].z == 0;
+  }
+
+  // find the batch to add to: the last one if it has our state, or an earlier one
+  // with our state if we can be drawn before everything recorded after it
+  int batch = -1;
+  if (m_used && m_batches[m_used - 1].state == state)
+    batch = m_used - 1;
+  else if (flat)
+  {
+    int first = max((int)m_used - MAX_LOOKBACK, 0);
+    for (int i = (int)m_used - 1; i >= first; i--)
+    {
+      const Batch &later = m_batches[i];
+      if (later.state == state)
+      {
+        batch = i;
+        break;
+      }
+      if (!later.flat || (later.x1 < x2 && x1 < later.x2 && later.y1 < y2 && y1 < later.y2))
+        break;
+    }
+  }
+
+  if (batch < 0)
+  {
+    if (m_used == m_batches.size())
+      m_batches.push_back(Batch());
+    batch = m_used++;
+    Batch &added = m_batches[batch];
+    added.state = state;
+    added.vertices.clear();
+    added.x1 = x1; added.y1 = y1; added.x2 = x2; added.y2 = y2;
+    added.flat = flat;
+  }
+  else
+  {
+    Batch &joined = m_batches[batch];
+    joined.x1 = min(joined.x1, x1);
+    joined.y1 = min(joined.y1, y1);
+    joined.x2 = max(joined.x2, x2);
+    joined.y2 = max(joined.y2, y2);
+    joined.flat &= flat;
+  }
+
+  m_batches[batch].vertices.insert(m_batches[batch].vertices.end(), vertices, vertices + 4);
+  m_quads++;
+}
+
+void CGUIRenderBatch::Flush()
+{
+  if (!m_used)
+    return;
+
+  for (unsigned int i = 0; i < m_used; i++)
+  {
+    if (m_backend)
+      m_backend->Submit(m_batches[i].state, &m_batches[i].vertices[0], m_batches[i].vertices.size());
+    m_drawCalls++;
+  }
+  m_used = 0;
+}
+
+void CGUIRenderBatch::GetStats(unsigned int &quads, unsigned int &drawCalls)
+{
+  quads = m_quads;
+  drawCalls = m_drawCalls;
+  m_quads = m_drawCalls = 0;
+}
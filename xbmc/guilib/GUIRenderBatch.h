@@ -0,0 +1,143 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+
+/*!
+ \ingroup textures
+ \brief A corner of a GUI quad, in final screen coordinates
+ */
+struct SGUIVertex
+{
+  float x, y, z;
+  unsigned char r, g, b, a;
+  float u1, v1;     ///< texture coordinates
+  float u2, v2;     ///< diffuse texture coordinates
+};
+
+/*!
+ \ingroup textures
+ \brief State a quad is drawn with
+ */
+struct SGUIRenderState
+{
+  SGUIRenderState() : texture(0), diffuse(0), limitedColor(false) {};
+
+  bool operator==(const SGUIRenderState &right) const
+  {
+    return texture == right.texture && diffuse == right.diffuse && limitedColor == right.limitedColor;
+  };
+
+  unsigned int texture;   ///< texture object of the render system
+  unsigned int diffuse;   ///< texture object of the diffuse texture, 0 for none
+  bool limitedColor;      ///< whether colors are mapped to the limited range
+};
+
+/*!
+ \ingroup textures
+ \brief Draws batches of quads with a render system
+ */
+class IGUIRenderBackend
+{
+public:
+  virtual ~IGUIRenderBackend() {};
+
+  /*! \brief Draw quads
+   \param state the state to draw with
+   \param vertices the corners of the quads, four per quad
+   \param count number of vertices
+   */
+  virtual void Submit(const SGUIRenderState &state, const SGUIVertex *vertices, unsigned int count) = 0;
+};
+
+/*!
+ \ingroup textures
+ \brief Backend that draws nothing, but remembers the draw calls it was given
+ */
+class CGUIRenderBackendNull : public IGUIRenderBackend
+{
+public:
+  struct DrawCall
+  {
+    SGUIRenderState state;
+    std::vector<SGUIVertex> vertices;
+  };
+
+  virtual void Submit(const SGUIRenderState &state, const SGUIVertex *vertices, unsigned int count);
+
+  std::vector<DrawCall> m_drawCalls;
+};
+
+/*!
+ \ingroup textures
+ \brief Records the quads of the GUI and draws them in as few draw calls as possible
+
+ Quads are recorded rather than drawn right away. Quads with the same state as the
+ previously recorded quad are added to its batch. A quad with a different state may
+ be added to an earlier batch with its state, as long as it doesn't overlap anything
+ recorded since, so the result is the same as drawing everything in order.
+
+ Batches are drawn by Flush(), which needs calling whenever something is drawn without
+ going through the batch or the render state changes, e.g. by the graphics context
+ when the viewport, scissors or camera change.
+ */
+class CGUIRenderBatch
+{
+public:
+  CGUIRenderBatch();
+
+  static CGUIRenderBatch &Get();
+
+  /*! \brief Set the backend that draws the batches, flushing anything recorded with the old one
+   */
+  void SetBackend(IGUIRenderBackend *backend);
+  IGUIRenderBackend *GetBackend() const { return m_backend; };
+
+  /*! \brief Record a quad
+   \param state the state to draw the quad with
+   \param vertices the four corners of the quad
+   */
+  void AddQuad(const SGUIRenderState &state, const SGUIVertex *vertices);
+
+  /*! \brief Draw everything recorded so far
+   */
+  void Flush();
+
+  /*! \brief Get the number of quads recorded and draw calls made since the last call
+   */
+  void GetStats(unsigned int &quads, unsigned int &drawCalls);
+
+private:
+  struct Batch
+  {
+    SGUIRenderState state;
+    std::vector<SGUIVertex> vertices;
+    float x1, y1, x2, y2;   ///< bounds of the quads
+    bool flat;              ///< all quads have z = 0
+  };
+
+  IGUIRenderBackend *m_backend;
+  std::vector<Batch> m_batches;   ///< kept between flushes, so the vertex buffers are reused
+  unsigned int m_used;            ///< number of batches recorded
+  unsigned int m_quads;
+  unsigned int m_drawCalls;
+};
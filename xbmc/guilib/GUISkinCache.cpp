@@ -0,0 +1,435 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUISkinCache.h"
+#include "GUIInfoManager.h"
+#include "addons/Skin.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include <string.h>
+
+using namespace std;
+using namespace XFILE;
+
+#define CACHE_PATH    "special://temp/skincache/"
+#define CACHE_MAGIC   "XBMC skin cache"
+#define CACHE_VERSION 1
+
+// sanity limits, so a damaged file can't make us allocate without bounds
+#define MAX_SIZE      (64 << 20)
+#define MAX_DEPTH     256
+
+enum NodeType
+{
+  NODE_ELEMENT = 0,
+  NODE_TEXT,
+  NODE_CDATA
+};
+
+typedef map<string, unsigned int> StringTable;
+
+static bool IsStored(const TiXmlNode *node)
+{
+  return node->Type() == TiXmlNode::TINYXML_ELEMENT || node->Type() == TiXmlNode::TINYXML_TEXT;
+}
+
+static unsigned int AddString(StringTable &strings, const string &str)
+{
+  return strings.insert(make_pair(str, (unsigned int)strings.size())).first->second;
+}
+
+static void CollectStrings(const TiXmlNode *node, StringTable &strings)
+{
+  AddString(strings, node->ValueStr());
+  if (const TiXmlElement *element = node->ToElement())
+  {
+    for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+    {
+      AddString(strings, attribute->Name());
+      AddString(strings, attribute->ValueStr());
+    }
+  }
+  for (const TiXmlNode *child = node->FirstChild(); child; child = child->NextSibling())
+  {
+    if (IsStored(child))
+      CollectStrings(child, strings);
+  }
+}
+
+static void WriteNode(CArchive &ar, const TiXmlNode *node, const StringTable &strings)
+{
+  const TiXmlText *text = node->ToText();
+  ar << (char)(text ? (text->CDATA() ? NODE_CDATA : NODE_TEXT) : NODE_ELEMENT);
+  ar << strings.find(node->ValueStr())->second;
+  if (text)
+    return;
+
+  const TiXmlElement *element = node->ToElement();
+  unsigned int count = 0;
+  for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+    count++;
+  ar << count;
+  for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+  {
+    ar << strings.find(attribute->Name())->second;
+    ar << strings.find(attribute->ValueStr())->second;
+  }
+
+  count = 0;
+  for (const TiXmlNode *child = node->FirstChild(); child; child = child->NextSibling())
+  {
+    if (IsStored(child))
+      count++;
+  }
+  ar << count;
+  for (const TiXmlNode *child = node->FirstChild(); child; child = child->NextSibling())
+  {
+    if (IsStored(child))
+      WriteNode(ar, child, strings);
+  }
+}
+
+/*!
+ \brief Reads what CArchive wrote from a cache file held in memory
+
+ Every field is checked against what is left of the file, so a truncated or damaged
+ file fails the read instead of leaving fields unset or allocating from bogus lengths.
+ */
+class CCacheReader
+{
+public:
+  CCacheReader(const vector<char> &data) : m_data(data), m_pos(0), m_error(false) {}
+
+  template<typename T> bool Read(T &value)
+  {
+    if (m_error || Remaining() < sizeof(T))
+      return Fail();
+    memcpy(&value, &m_data[m_pos], sizeof(T));
+    m_pos += sizeof(T);
+    return true;
+  }
+
+  bool Read(string &str)
+  {
+    size_t length;
+    if (!Read(length) || length > Remaining())
+      return Fail();
+    str.assign(m_data.begin() + m_pos, m_data.begin() + m_pos + length);
+    m_pos += length;
+    return true;
+  }
+
+  /*! \brief Read the number of entries that follow, each taking at least entrySize bytes */
+  bool ReadCount(unsigned int &count, size_t entrySize)
+  {
+    if (!Read(count) || count > Remaining() / entrySize)
+      return Fail();
+    return true;
+  }
+
+  size_t Remaining() const { return m_data.size() - m_pos; }
+
+private:
+  bool Fail()
+  {
+    m_error = true;
+    return false;
+  }
+
+  const vector<char> &m_data;
+  size_t m_pos;
+  bool m_error;
+};
+
+static TiXmlNode *ReadNode(CCacheReader &ar, const vector<string> &strings, int depth)
+{
+  char type;
+  unsigned int value;
+  if (!ar.Read(type) || !ar.Read(value) || value >= strings.size() || depth > MAX_DEPTH)
+    return NULL;
+
+  if (type == NODE_TEXT || type == NODE_CDATA)
+  {
+    TiXmlText *text = new TiXmlText(strings[value]);
+    text->SetCDATA(type == NODE_CDATA);
+    return text;
+  }
+  if (type != NODE_ELEMENT)
+    return NULL;
+
+  TiXmlElement *element = new TiXmlElement(strings[value]);
+  unsigned int count;
+  if (!ar.ReadCount(count, 2 * sizeof(unsigned int)))
+  {
+    delete element;
+    return NULL;
+  }
+  for (unsigned int i = 0; i < count; i++)
+  {
+    unsigned int name, attribute;
+    if (!ar.Read(name) || !ar.Read(attribute) ||
+        name >= strings.size() || attribute >= strings.size())
+    {
+      delete element;
+      return NULL;
+    }
+    element->SetAttribute(strings[name], strings[attribute]);
+  }
+
+  if (!ar.ReadCount(count, sizeof(char) + sizeof(unsigned int)))
+  {
+    delete element;
+    return NULL;
+  }
+  for (unsigned int i = 0; i < count; i++)
+  {
+    TiXmlNode *child = ReadNode(ar, strings, depth + 1);
+    if (!child)
+    {
+      delete element;
+      return NULL;
+    }
+    element->LinkEndChild(child);
+  }
+  return element;
+}
+
+static bool ReadCache(const vector<char> &data, SGUISkinCacheInfo &info, TiXmlNode *&root)
+{
+  CCacheReader ar(data);
+
+  string magic;
+  int version;
+  if (!ar.Read(magic) || magic != CACHE_MAGIC || !ar.Read(version) || version != CACHE_VERSION)
+    return false;
+
+  unsigned int count;
+  if (!ar.Read(info.key) || !ar.ReadCount(count, sizeof(size_t) + 2 * sizeof(int64_t)))
+    return false;
+  info.files.resize(count);
+  for (unsigned int i = 0; i < count; i++)
+  {
+    if (!ar.Read(info.files[i].path) || !ar.Read(info.files[i].time) || !ar.Read(info.files[i].size))
+      return false;
+  }
+
+  if (!ar.ReadCount(count, sizeof(size_t) + sizeof(bool)))
+    return false;
+  info.conditions.resize(count);
+  for (unsigned int i = 0; i < count; i++)
+  {
+    if (!ar.Read(info.conditions[i].first) || !ar.Read(info.conditions[i].second))
+      return false;
+  }
+
+  if (!ar.ReadCount(count, sizeof(size_t)))
+    return false;
+  vector<string> strings(count);
+  for (unsigned int i = 0; i < count; i++)
+  {
+    if (!ar.Read(strings[i]))
+      return false;
+  }
+
+  root = ReadNode(ar, strings, 0);
+  return root && ar.Remaining() == 0;
+}
+
+CGUISkinCache &CGUISkinCache::Get()
+{
+  static CGUISkinCache sSkinCache;
+  return sSkinCache;
+}
+
+TiXmlElement *CGUISkinCache::Load(const CStdString &xmlFile, map<INFO::InfoPtr, bool> &xmlIncludeConditions)
+{
+  if (!g_advancedSettings.m_guiSkinCache || !g_SkinInfo)
+    return NULL;
+
+  CStdString cacheFile = GetCacheFile(xmlFile);
+  if (!CFile::Exists(cacheFile))
+    return NULL;
+
+  SGUISkinCacheInfo info;
+  TiXmlElement *root = Read(cacheFile, info);
+  if (!root)
+  {
+    CLog::Log(LOGWARNING, "CGUISkinCache::Load - %s is damaged, discarding it", cacheFile.c_str());
+    CFile::Delete(cacheFile);
+    return NULL;
+  }
+
+  bool valid = info.key == GetKey() && !info.files.empty();
+  for (vector<SGUISkinCacheInfo::File>::const_iterator i = info.files.begin(); valid && i != info.files.end(); ++i)
+  {
+    SGUISkinCacheInfo::File file = GetFile(i->path);
+    valid = file.time == i->time && file.size == i->size;
+  }
+
+  map<INFO::InfoPtr, bool> conditions;
+  for (vector<pair<string, bool> >::const_iterator i = info.conditions.begin(); valid && i != info.conditions.end(); ++i)
+  {
+    INFO::InfoPtr condition = g_infoManager.Register(i->first);
+    valid = condition && condition->Get() == i->second;
+    conditions[condition] = i->second;
+  }
+
+  if (!valid)
+  {
+    CLog::Log(LOGDEBUG, "CGUISkinCache::Load - %s is out of date", xmlFile.c_str());
+    delete root;
+    return NULL;
+  }
+
+  // the include files may hold skin variables used by the window
+  for (vector<SGUISkinCacheInfo::File>::const_iterator i = info.files.begin() + 1; i != info.files.end(); ++i)
+    g_SkinInfo->LoadIncludeFile(i->path);
+
+  xmlIncludeConditions.swap(conditions);
+  return root;
+}
+
+void CGUISkinCache::Store(const CStdString &xmlFile, const CStdString &loadedFile, const TiXmlElement &root,
+                          const map<INFO::InfoPtr, bool> &xmlIncludeConditions)
+{
+  if (!g_advancedSettings.m_guiSkinCache || !g_SkinInfo)
+    return;
+
+  SGUISkinCacheInfo info;
+  info.key = GetKey();
+  info.files.push_back(GetFile(loadedFile));
+  vector<CStdString> includes;
+  g_SkinInfo->GetIncludeFiles(includes);
+  for (vector<CStdString>::const_iterator i = includes.begin(); i != includes.end(); ++i)
+    info.files.push_back(GetFile(*i));
+  for (map<INFO::InfoPtr, bool>::const_iterator i = xmlIncludeConditions.begin(); i != xmlIncludeConditions.end(); ++i)
+    info.conditions.push_back(make_pair(i->first->GetExpression(), i->second));
+
+  if (!CDirectory::Exists(CACHE_PATH))
+    CDirectory::Create(CACHE_PATH);
+
+  // write to a temporary file first so a window is never read from a partly written file
+  CStdString cacheFile = GetCacheFile(xmlFile);
+  CStdString tempFile = cacheFile + ".tmp";
+  if (CFile::Exists(cacheFile))
+    CFile::Delete(cacheFile);
+  if (!Write(tempFile, info, root) || !CFile::Rename(tempFile, cacheFile))
+  {
+    CLog::Log(LOGERROR, "CGUISkinCache::Store - unable to write %s", cacheFile.c_str());
+    CFile::Delete(tempFile);
+  }
+}
+
+bool CGUISkinCache::Write(const CStdString &cacheFile, const SGUISkinCacheInfo &info, const TiXmlElement &root)
+{
+  CFile file;
+  if (!file.OpenForWrite(cacheFile, true))
+    return false;
+
+  StringTable strings;
+  CollectStrings(&root, strings);
+  vector<string> table(strings.size());
+  for (StringTable::const_iterator i = strings.begin(); i != strings.end(); ++i)
+    table[i->second] = i->first;
+
+  CArchive ar(&file, CArchive::store);
+  ar << string(CACHE_MAGIC);
+  ar << (int)CACHE_VERSION;
+  ar << info.key;
+  ar << (unsigned int)info.files.size();
+  for (vector<SGUISkinCacheInfo::File>::const_iterator i = info.files.begin(); i != info.files.end(); ++i)
+  {
+    ar << i->path;
+    ar << i->time;
+    ar << i->size;
+  }
+  ar << (unsigned int)info.conditions.size();
+  for (vector<pair<string, bool> >::const_iterator i = info.conditions.begin(); i != info.conditions.end(); ++i)
+  {
+    ar << i->first;
+    ar << i->second;
+  }
+  ar << (unsigned int)table.size();
+  for (vector<string>::const_iterator i = table.begin(); i != table.end(); ++i)
+    ar << *i;
+  WriteNode(ar, &root, strings);
+  ar.Close();
+  file.Close();
+  return true;
+}
+
+TiXmlElement *CGUISkinCache::Read(const CStdString &cacheFile, SGUISkinCacheInfo &info)
+{
+  CFile file;
+  if (!file.Open(cacheFile))
+    return NULL;
+
+  int64_t size = file.GetLength();
+  if (size <= 0 || size > MAX_SIZE)
+    return NULL;
+  vector<char> data((size_t)size);
+  if (file.Read(&data[0], data.size()) != (unsigned int)data.size())
+    return NULL;
+  file.Close();
+
+  TiXmlNode *root = NULL;
+  if (!ReadCache(data, info, root) || !root->ToElement())
+  {
+    delete root;
+    info = SGUISkinCacheInfo();
+    return NULL;
+  }
+  return (TiXmlElement *)root;
+}
+
+SGUISkinCacheInfo::File CGUISkinCache::GetFile(const string &path)
+{
+  SGUISkinCacheInfo::File file;
+  file.path = path;
+  file.time = -1;
+  file.size = -1;
+
+  struct __stat64 stat;
+  if (CFile::Stat(path, &stat) == 0)
+  {
+    file.time = stat.st_mtime;
+    file.size = stat.st_size;
+  }
+  return file;
+}
+
+CStdString CGUISkinCache::GetKey()
+{
+  return StringUtils::Format("%s-%s-%.2f", g_SkinInfo->ID().c_str(), g_SkinInfo->Version().c_str(), g_SkinInfo->GetVersion());
+}
+
+CStdString CGUISkinCache::GetCacheFile(const CStdString &xmlFile)
+{
+  Crc32 crc;
+  crc.ComputeFromLowerCase(xmlFile);
+  return StringUtils::Format("%s%08x.bin", CACHE_PATH, (unsigned int)crc);
+}
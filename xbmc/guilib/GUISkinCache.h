@@ -0,0 +1,115 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/StdString.h"
+#include "interfaces/info/InfoBool.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+class TiXmlElement;
+
+/*!
+ \ingroup windows
+ \brief What a cached window was resolved from
+
+ A cached window is only used if the key and the modification times of the files
+ match and the include conditions still have the values they had when it was stored.
+ */
+struct SGUISkinCacheInfo
+{
+  struct File
+  {
+    std::string path;
+    int64_t     time; ///< modification time, -1 if the file didn't exist
+    int64_t     size;
+  };
+
+  std::string key;                                         ///< skin id, skin version and GUI version
+  std::vector<File> files;                                 ///< window and include files
+  std::vector<std::pair<std::string, bool> > conditions;   ///< include conditions and their values
+};
+
+/*!
+ \ingroup windows
+ \brief Precompiled skin windows
+
+ Keeps the XML of a window with its includes, defaults and constants resolved in
+ a compact binary file, so that loading the window again only reads that file
+ instead of parsing the skin XML and resolving the includes for every node.
+
+ \sa CGUIWindow::LoadXML, CGUIIncludes
+ */
+class CGUISkinCache
+{
+public:
+  static CGUISkinCache &Get();
+
+  /*!
+   \brief Load the resolved XML of a window
+   \param xmlFile path of the window XML
+   \param xmlIncludeConditions [out] the conditions used to resolve the includes and their values
+   \return the resolved <window> element, to be deleted by the caller, or NULL if the window isn't
+           cached or the cache is out of date.
+   */
+  TiXmlElement *Load(const CStdString &xmlFile, std::map<INFO::InfoPtr, bool> &xmlIncludeConditions);
+
+  /*!
+   \brief Store the resolved XML of a window
+   \param xmlFile path of the window XML, as passed to Load()
+   \param loadedFile the file the XML was actually read from
+   \param root the <window> element with its includes resolved
+   \param xmlIncludeConditions the conditions used to resolve the includes and their values
+   */
+  void Store(const CStdString &xmlFile, const CStdString &loadedFile, const TiXmlElement &root,
+             const std::map<INFO::InfoPtr, bool> &xmlIncludeConditions);
+
+  /*!
+   \brief Write a resolved window to a cache file
+   \param cacheFile the file to write
+   \param info what the window was resolved from
+   \param root the element to write, with all its children
+   \return true if the file was written
+   */
+  static bool Write(const CStdString &cacheFile, const SGUISkinCacheInfo &info, const TiXmlElement &root);
+
+  /*!
+   \brief Read a resolved window from a cache file
+   \param cacheFile the file to read
+   \param info [out] what the window was resolved from
+   \return the element, to be deleted by the caller, or NULL if the file couldn't be read
+   */
+  static TiXmlElement *Read(const CStdString &cacheFile, SGUISkinCacheInfo &info);
+
+  /*!
+   \brief Stat a file for SGUISkinCacheInfo
+   */
+  static SGUISkinCacheInfo::File GetFile(const std::string &path);
+
+private:
+  CGUISkinCache() {};
+
+  static CStdString GetKey();
+  static CStdString GetCacheFile(const CStdString &xmlFile);
+};
@@ -22,13 +22,107 @@
 #include "GUIFont.h"
 #include "GUIControl.h"
 #include "GUIColorManager.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/CharsetConverter.h"
 #include "utils/StringUtils.h"
 
+#include <list>
+#include <map>
+
 using namespace std;
 
 #define WORK_AROUND_NEEDED_FOR_LINE_BREAKS
 
+#define LAYOUT_CACHE_SIZE      2048 // layouts kept in the cache
+#define LAYOUT_CACHE_MAX_TEXT  4096 // longer texts aren't worth keeping around
+
+namespace
+{
+  /* everything a layout depends on */
+  struct LayoutKey
+  {
+    const CGUIFont *font;
+    uint32_t    style;
+    color_t     color;
+    bool        wrap;
+    bool        forceLTR;
+    bool        utf16;
+    float       maxWidth;
+    float       maxHeight;
+    float       scaleX;
+    float       scaleY;
+    std::string utf8Text;
+    CStdStringW text;
+
+    bool operator<(const LayoutKey &right) const
+    {
+      if (font != right.font) return font < right.font;
+      if (style != right.style) return style < right.style;
+      if (color != right.color) return color < right.color;
+      if (wrap != right.wrap) return wrap < right.wrap;
+      if (forceLTR != right.forceLTR) return forceLTR < right.forceLTR;
+      if (utf16 != right.utf16) return utf16 < right.utf16;
+      if (maxWidth != right.maxWidth) return maxWidth < right.maxWidth;
+      if (maxHeight != right.maxHeight) return maxHeight < right.maxHeight;
+      if (scaleX != right.scaleX) return scaleX < right.scaleX;
+      if (scaleY != right.scaleY) return scaleY < right.scaleY;
+      if (utf16)
+        return text.compare(right.text) < 0;
+      return utf8Text.compare(right.utf8Text) < 0;
+    }
+  };
+
+  struct Layout
+  {
+    vector<CGUIString> lines;
+    vecColors colors;
+    float width;
+    float height;
+    list<const LayoutKey *>::iterator age;
+  };
+
+  /* least recently used layouts, shared by all text layouts */
+  class CLayoutCache
+  {
+  public:
+    CLayoutCache() : m_hits(0), m_misses(0) {};
+
+    CCriticalSection m_section;
+    map<LayoutKey, Layout> m_layouts;
+    list<const LayoutKey *> m_ages;  ///< most recently used first
+    unsigned int m_hits;
+    unsigned int m_misses;
+  };
+
+  CLayoutCache &GetLayoutCache()
+  {
+    static CLayoutCache layoutCache;
+    return layoutCache;
+  }
+
+  LayoutKey MakeKey(const CGUIFont *font, color_t color, bool wrap, float maxWidth, float maxHeight, bool forceLTR,
+                    const std::string &utf8Text, const CStdStringW &text, bool utf16)
+  {
+    LayoutKey key;
+    key.font = font;
+    key.style = font ? font->GetStyle() : 0;
+    key.color = color;
+    key.wrap = wrap && maxWidth > 0;
+    key.forceLTR = forceLTR;
+    key.utf16 = utf16;
+    key.maxWidth = key.wrap ? maxWidth : 0;
+    key.maxHeight = maxHeight;
+    key.scaleX = g_graphicsContext.GetGUIScaleX();
+    key.scaleY = g_graphicsContext.GetGUIScaleY();
+    if (utf16)
+      key.text = text;
+    else
+      key.utf8Text = utf8Text;
+    return key;
+  }
+}
+
 CGUIString::CGUIString(iString start, iString end, bool carriageReturn)
 {
   m_text.assign(start, end);
@@ -223,9 +317,13 @@ bool CGUITextLayout::Update(const CStdString &text, float maxWidth, bool forceUp
 
   m_lastUtf8Text = text;
   m_lastUpdateW = false;
+  if (GetCachedLayout(m_lastUtf8Text, m_lastText, false, maxWidth, forceLTRReadingOrder))
+    return true;
+
   CStdStringW utf16;
   utf8ToW(text, utf16);
   UpdateCommon(utf16, maxWidth, forceLTRReadingOrder);
+  CacheLayout(m_lastUtf8Text, m_lastText, false, maxWidth, forceLTRReadingOrder);
   return true;
 }
 
@@ -236,10 +334,75 @@ bool CGUITextLayout::UpdateW(const CStdStringW &text, float maxWidth /*= 0*/, bo
 
   m_lastText = text;
   m_lastUpdateW = true;
+  if (GetCachedLayout(m_lastUtf8Text, m_lastText, true, maxWidth, forceLTRReadingOrder))
+    return true;
+
   UpdateCommon(text, maxWidth, forceLTRReadingOrder);
+  CacheLayout(m_lastUtf8Text, m_lastText, true, maxWidth, forceLTRReadingOrder);
   return true;
 }
 
+bool CGUITextLayout::GetCachedLayout(const std::string &utf8Text, const CStdStringW &text, bool utf16, float maxWidth, bool forceLTRReadingOrder)
+{
+  CLayoutCache &cache = GetLayoutCache();
+  CSingleLock lock(cache.m_section);
+  map<LayoutKey, Layout>::iterator i = cache.m_layouts.find(MakeKey(m_font, m_textColor, m_wrap, maxWidth, m_maxHeight, forceLTRReadingOrder, utf8Text, text, utf16));
+  if (i == cache.m_layouts.end())
+  {
+    cache.m_misses++;
+    return false;
+  }
+  cache.m_hits++;
+
+  Layout &layout = i->second;
+  cache.m_ages.splice(cache.m_ages.begin(), cache.m_ages, layout.age);
+  m_lines = layout.lines;
+  m_colors = layout.colors;
+  m_textWidth = layout.width;
+  m_textHeight = layout.height;
+  return true;
+}
+
+void CGUITextLayout::CacheLayout(const std::string &utf8Text, const CStdStringW &text, bool utf16, float maxWidth, bool forceLTRReadingOrder) const
+{
+  if ((utf16 ? text.size() : utf8Text.size()) > LAYOUT_CACHE_MAX_TEXT)
+    return;
+
+  CLayoutCache &cache = GetLayoutCache();
+  CSingleLock lock(cache.m_section);
+  pair<map<LayoutKey, Layout>::iterator, bool> inserted = cache.m_layouts.insert(make_pair(MakeKey(m_font, m_textColor, m_wrap, maxWidth, m_maxHeight, forceLTRReadingOrder, utf8Text, text, utf16), Layout()));
+  Layout &layout = inserted.first->second;
+  if (inserted.second)
+    layout.age = cache.m_ages.insert(cache.m_ages.begin(), &inserted.first->first);
+  layout.lines = m_lines;
+  layout.colors = m_colors;
+  layout.width = m_textWidth;
+  layout.height = m_textHeight;
+
+  while (cache.m_layouts.size() > LAYOUT_CACHE_SIZE)
+  {
+    cache.m_layouts.erase(cache.m_layouts.find(*cache.m_ages.back()));
+    cache.m_ages.pop_back();
+  }
+}
+
+void CGUITextLayout::ClearCache()
+{
+  CLayoutCache &cache = GetLayoutCache();
+  CSingleLock lock(cache.m_section);
+  cache.m_layouts.clear();
+  cache.m_ages.clear();
+}
+
+void CGUITextLayout::GetCacheStatistics(unsigned int &hits, unsigned int &misses)
+{
+  CLayoutCache &cache = GetLayoutCache();
+  CSingleLock lock(cache.m_section);
+  hits = cache.m_hits;
+  misses = cache.m_misses;
+  cache.m_hits = cache.m_misses = 0;
+}
+
 void CGUITextLayout::UpdateCommon(const CStdStringW &text, float maxWidth, bool forceLTRReadingOrder)
 {
   // parse the text for style information
@@ -110,6 +110,17 @@ public:
   static void DrawText(CGUIFont *font, float x, float y, color_t color, color_t shadowColor, const CStdString &text, uint32_t align);
   static void Filter(CStdString &text);
 
+  /*! \brief Forget all cached layouts.
+   Needs calling whenever fonts or colors are reloaded, as the cache only knows the font by its address.
+   */
+  static void ClearCache();
+
+  /*! \brief Get the number of layouts found in and missing from the layout cache since the last call.
+   \param hits [out] number of updates served from the cache
+   \param misses [out] number of updates that had to parse, wrap and measure the text
+   */
+  static void GetCacheStatistics(unsigned int &hits, unsigned int &misses);
+
 protected:
   void LineBreakText(const vecText &text, std::vector<CGUIString> &lines);
   void WrapText(const vecText &text, float maxWidth);
@@ -152,5 +163,14 @@ private:
   static void ParseText(const CStdStringW &text, uint32_t defaultStyle, color_t defaultColor, vecColors &colors, vecText &parsedText);
 
   static void utf8ToW(const CStdString &utf8, CStdStringW &utf16);
+
+  /*! \brief Copy the layout of a text from the layout cache, if it's there.
+   Layouts are shared by all controls using the same font, wrapping and width, so a list
+   reusing its item layouts while scrolling doesn't need to lay out the same labels again.
+   \param text the text, either as utf8 or as utf16
+   \return true if the layout was found in the cache
+   */
+  bool GetCachedLayout(const std::string &utf8Text, const CStdStringW &text, bool utf16, float maxWidth, bool forceLTRReadingOrder);
+  void CacheLayout(const std::string &utf8Text, const CStdStringW &text, bool utf16, float maxWidth, bool forceLTRReadingOrder) const;
 };
 
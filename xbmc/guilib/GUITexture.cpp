@@ -81,6 +81,7 @@ CGUITextureBase::CGUITextureBase(float posX, float posY, float width, float heig
 
   m_allocateDynamically = false;
   m_isAllocated = NO;
+  m_largeSize = 0;
   m_invalid = true;
   m_use_cache = true;
 }
@@ -119,6 +120,7 @@ CGUITextureBase::CGUITextureBase(const CGUITextureBase &right) :
   m_currentLoop = 0;
 
   m_isAllocated = NO;
+  m_largeSize = 0;
   m_invalid = true;
 }
 
@@ -318,7 +320,16 @@ bool CGUITextureBase::AllocResources()
     if (m_isAllocated != NORMAL)
     { // use our large image background loader
       CTextureArray texture;
-      if (g_largeTextureManager.GetImage(m_info.filename, texture, !IsAllocated(), m_use_cache))
+      if (!IsAllocated())
+      { // decode at the size we're drawn at, unless we're cropped and could need more
+        if (m_aspect.ratio == CAspectRatio::AR_SCALE)
+          m_largeSize = 0;
+        else
+          m_largeSize = CGUILargeTextureManager::GetLoadSize(m_width * g_graphicsContext.GetGUIScaleX(), m_height * g_graphicsContext.GetGUIScaleY());
+      }
+      CRect rect(g_graphicsContext.ScaleFinalXCoord(m_posX, m_posY), g_graphicsContext.ScaleFinalYCoord(m_posX, m_posY),
+                 g_graphicsContext.ScaleFinalXCoord(m_posX + m_width, m_posY + m_height), g_graphicsContext.ScaleFinalYCoord(m_posX + m_width, m_posY + m_height));
+      if (g_largeTextureManager.GetImage(m_info.filename, texture, !IsAllocated(), m_use_cache, m_largeSize, g_largeTextureManager.GetPriority(rect)))
       {
         m_isAllocated = LARGE;
 
@@ -460,7 +471,7 @@ bool CGUITextureBase::CalculateSize()
 void CGUITextureBase::FreeResources(bool immediately /* = false */)
 {
   if (m_isAllocated == LARGE || m_isAllocated == LARGE_FAILED)
-    g_largeTextureManager.ReleaseImage(m_info.filename, immediately || (m_isAllocated == LARGE_FAILED));
+    g_largeTextureManager.ReleaseImage(m_info.filename, immediately || (m_isAllocated == LARGE_FAILED), m_largeSize);
   else if (m_isAllocated == NORMAL && m_texture.size())
     g_TextureManager.ReleaseTexture(m_info.filename, immediately);
 
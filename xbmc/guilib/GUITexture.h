@@ -165,6 +165,7 @@ protected:
   bool m_allocateDynamically;
   enum ALLOCATE_TYPE { NO = 0, NORMAL, LARGE, NORMAL_FAILED, LARGE_FAILED };
   ALLOCATE_TYPE m_isAllocated;
+  unsigned int m_largeSize;   // size the large texture manager decodes our image at
 
   CTextureInfo m_info;
   CAspectRatio m_aspect;
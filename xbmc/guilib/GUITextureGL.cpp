@@ -28,6 +28,8 @@
 #include "guilib/Geometry.h"
 #include "windowing/WindowingFactory.h"
 
+#include <stddef.h>
+
 #if defined(HAS_GL)
 
 CGUITextureGL::CGUITextureGL(float posX, float posY, float width, float height, const CTextureInfo &texture)
@@ -36,25 +38,15 @@ CGUITextureGL::CGUITextureGL(float posX, float posY, float width, float height,
   memset(m_col, 0, sizeof(m_col));
 }
 
-void CGUITextureGL::Begin(color_t color)
-{
-  int range, unit = 0;
-  if(g_Windowing.UseLimitedColor())
-    range = 235 - 16;
-  else
-    range = 255 -  0;
-
-  m_col[0] = GET_R(color) * range / 255;
-  m_col[1] = GET_G(color) * range / 255;
-  m_col[2] = GET_B(color) * range / 255;
-  m_col[3] = GET_A(color);
-
-  CBaseTexture* texture = m_texture.m_textures[m_currentFrame];
-  texture->LoadToGPU();
-  if (m_diffuse.size())
-    m_diffuse.m_textures[0]->LoadToGPU();
+static CGUIRenderBackendGL renderBackendGL;
 
-  texture->BindToUnit(unit++);
+void CGUIRenderBackendGL::Submit(const SGUIRenderState &state, const SGUIVertex *vertices, unsigned int count)
+{
+  int unit = 0;
+  glActiveTexture(GL_TEXTURE0_ARB);
+  glBindTexture(GL_TEXTURE_2D, state.texture);
+  glEnable(GL_TEXTURE_2D);
+  unit++;
 
   glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
   glEnable(GL_BLEND);          // Turn Blending On
@@ -75,9 +67,11 @@ void CGUITextureGL::Begin(color_t color)
   glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA, GL_SRC_ALPHA);
   VerifyGLState();
 
-  if (m_diffuse.size())
+  if (state.diffuse)
   {
-    m_diffuse.m_textures[0]->BindToUnit(unit++);
+    glActiveTexture(GL_TEXTURE0_ARB + unit++);
+    glBindTexture(GL_TEXTURE_2D, state.diffuse);
+    glEnable(GL_TEXTURE_2D);
     glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
     glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
     glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE);
@@ -93,9 +87,11 @@ void CGUITextureGL::Begin(color_t color)
     VerifyGLState();
   }
 
-  if(g_Windowing.UseLimitedColor())
+  if (state.limitedColor)
   {
-    texture->BindToUnit(unit++); // dummy bind
+    glActiveTexture(GL_TEXTURE0_ARB + unit++);
+    glBindTexture(GL_TEXTURE_2D, state.texture); // dummy bind
+    glEnable(GL_TEXTURE_2D);
     const GLfloat rgba[4] = {16.0f / 255.0f, 16.0f / 255.0f, 16.0f / 255.0f, 0.0f};
     glTexEnvi (GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE , GL_COMBINE);
     glTexEnvfv(GL_TEXTURE_ENV, GL_TEXTURE_ENV_COLOR, rgba);
@@ -110,14 +106,29 @@ void CGUITextureGL::Begin(color_t color)
     VerifyGLState();
   }
 
-  //glDisable(GL_TEXTURE_2D); // uncomment these 2 lines to switch to wireframe rendering
-  //glBegin(GL_LINE_LOOP);
-  glBegin(GL_QUADS);
-}
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+  glColorPointer (4, GL_UNSIGNED_BYTE, sizeof(SGUIVertex), (char*)vertices + offsetof(SGUIVertex, r));
+  glVertexPointer(3, GL_FLOAT        , sizeof(SGUIVertex), (char*)vertices + offsetof(SGUIVertex, x));
+  glClientActiveTexture(GL_TEXTURE0_ARB);
+  glTexCoordPointer(2, GL_FLOAT, sizeof(SGUIVertex), (char*)vertices + offsetof(SGUIVertex, u1));
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  if (state.diffuse)
+  {
+    glClientActiveTexture(GL_TEXTURE1_ARB);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(SGUIVertex), (char*)vertices + offsetof(SGUIVertex, u2));
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  }
+  glEnableClientState(GL_COLOR_ARRAY);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glDrawArrays(GL_QUADS, 0, count);
+  if (state.diffuse)
+  {
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glClientActiveTexture(GL_TEXTURE0_ARB);
+  }
+  glPopClientAttrib();
 
-void CGUITextureGL::End()
-{
-  glEnd();
   glActiveTexture(GL_TEXTURE2_ARB);
   glBindTexture(GL_TEXTURE_2D, 0);
   glDisable(GL_TEXTURE_2D);
@@ -129,55 +140,115 @@ void CGUITextureGL::End()
   glDisable(GL_TEXTURE_2D);
 }
 
+void CGUITextureGL::Begin(color_t color)
+{
+  int range;
+  if(g_Windowing.UseLimitedColor())
+    range = 235 - 16;
+  else
+    range = 255 -  0;
+
+  m_col[0] = GET_R(color) * range / 255;
+  m_col[1] = GET_G(color) * range / 255;
+  m_col[2] = GET_B(color) * range / 255;
+  m_col[3] = GET_A(color);
+
+  CBaseTexture* texture = m_texture.m_textures[m_currentFrame];
+  texture->LoadToGPU();
+  if (m_diffuse.size())
+    m_diffuse.m_textures[0]->LoadToGPU();
+
+  // the quads are recorded and drawn by the batch, with as many others of the same state as it can
+  m_state.texture = static_cast<CGLTexture*>(texture)->GetTextureObject();
+  m_state.diffuse = m_diffuse.size() ? static_cast<CGLTexture*>(m_diffuse.m_textures[0])->GetTextureObject() : 0;
+  m_state.limitedColor = g_Windowing.UseLimitedColor();
+
+  if (!CGUIRenderBatch::Get().GetBackend())
+    CGUIRenderBatch::Get().SetBackend(&renderBackendGL);
+}
+
+void CGUITextureGL::End()
+{
+}
+
 void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
 {
+  SGUIVertex vertices[4];
+  for (int i = 0; i < 4; i++)
+  {
+    vertices[i].x = x[i];
+    vertices[i].y = y[i];
+    vertices[i].z = z[i];
+    vertices[i].r = m_col[0];
+    vertices[i].g = m_col[1];
+    vertices[i].b = m_col[2];
+    vertices[i].a = m_col[3];
+  }
+
   // Top-left vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
-  glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y1);
-  if (m_diffuse.size())
-    glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y1);
-  glVertex3f(x[0], y[0], z[0]);
+  vertices[0].u1 = texture.x1;
+  vertices[0].v1 = texture.y1;
+  vertices[0].u2 = diffuse.x1;
+  vertices[0].v2 = diffuse.y1;
 
   // Top-right vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
   if (orientation & 4)
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y2);
+  {
+    vertices[1].u1 = texture.x1;
+    vertices[1].v1 = texture.y2;
+  }
   else
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y1);
-  if (m_diffuse.size())
   {
-    if (m_info.orientation & 4)
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y2);
-    else
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y1);
+    vertices[1].u1 = texture.x2;
+    vertices[1].v1 = texture.y1;
+  }
+  if (m_info.orientation & 4)
+  {
+    vertices[1].u2 = diffuse.x1;
+    vertices[1].v2 = diffuse.y2;
+  }
+  else
+  {
+    vertices[1].u2 = diffuse.x2;
+    vertices[1].v2 = diffuse.y1;
   }
-  glVertex3f(x[1], y[1], z[1]);
 
   // Bottom-right vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
-  glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y2);
-  if (m_diffuse.size())
-    glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y2);
-  glVertex3f(x[2], y[2], z[2]);
+  vertices[2].u1 = texture.x2;
+  vertices[2].v1 = texture.y2;
+  vertices[2].u2 = diffuse.x2;
+  vertices[2].v2 = diffuse.y2;
 
   // Bottom-left vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
   if (orientation & 4)
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y1);
+  {
+    vertices[3].u1 = texture.x2;
+    vertices[3].v1 = texture.y1;
+  }
   else
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y2);
-  if (m_diffuse.size())
   {
-    if (m_info.orientation & 4)
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y1);
-    else
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y2);
+    vertices[3].u1 = texture.x1;
+    vertices[3].v1 = texture.y2;
   }
-  glVertex3f(x[3], y[3], z[3]);
+  if (m_info.orientation & 4)
+  {
+    vertices[3].u2 = diffuse.x2;
+    vertices[3].v2 = diffuse.y1;
+  }
+  else
+  {
+    vertices[3].u2 = diffuse.x1;
+    vertices[3].v2 = diffuse.y2;
+  }
+
+  CGUIRenderBatch::Get().AddQuad(m_state, vertices);
 }
 
 void CGUITextureGL::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
+  // drawn right away, so anything recorded has to go first
+  CGUIRenderBatch::Get().Flush();
+
   if (texture)
   {
     texture->LoadToGPU();
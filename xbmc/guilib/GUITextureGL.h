@@ -29,9 +29,20 @@
  */
 
 #include "GUITexture.h"
+#include "GUIRenderBatch.h"
 
 #include "system_gl.h"
 
+/*!
+ \ingroup textures
+ \brief Draws batches of GUI quads with vertex arrays
+ */
+class CGUIRenderBackendGL : public IGUIRenderBackend
+{
+public:
+  virtual void Submit(const SGUIRenderState &state, const SGUIVertex *vertices, unsigned int count);
+};
+
 class CGUITextureGL : public CGUITextureBase
 {
 public:
@@ -43,6 +54,7 @@ protected:
   void End();
 private:
   GLubyte m_col[4];
+  SGUIRenderState m_state;
 };
 
 #endif
@@ -29,6 +29,8 @@
 #ifdef PRE_SKIN_VERSION_9_10_COMPATIBILITY
 #include "GUIEditControl.h"
 #endif
+#include "GUISkinCache.h"
+#include "TextureManager.h"
 
 #include "addons/Skin.h"
 #include "GUIInfoManager.h"
@@ -42,6 +44,7 @@
 #include "ApplicationMessenger.h"
 #include "utils/Variant.h"
 #include "utils/StringUtils.h"
+#include "utils/XBMCTinyXML.h"
 
 #ifdef HAS_PERFORMANCE_SAMPLE
 #include "utils/PerformanceSample.h"
@@ -137,13 +140,28 @@ bool CGUIWindow::Load(const CStdString& strFileName, bool bContainsPath)
 
 bool CGUIWindow::LoadXML(const CStdString &strPath, const CStdString &strLowerPath)
 {
+  // use the resolved xml from an earlier load if the skin cache has it
+  TiXmlElement *pRootElement = CGUISkinCache::Get().Load(strPath, m_xmlIncludeConditions);
+  if (pRootElement)
+  {
+    CLog::Log(LOGDEBUG, "Using skin cache for %s", strPath.c_str());
+    return LoadResolved(pRootElement);
+  }
+
   // load window xml if we don't have it stored yet
+  CStdString strLoadedPath = strPath;
   if (!m_windowXMLRootElement)
   {
     CXBMCTinyXML xmlDoc;
     std::string strPathLower = strPath;
     StringUtils::ToLower(strPathLower);
-    if (!xmlDoc.LoadFile(strPath) && !xmlDoc.LoadFile(strPathLower) && !xmlDoc.LoadFile(strLowerPath))
+    if (xmlDoc.LoadFile(strPath))
+      strLoadedPath = strPath;
+    else if (xmlDoc.LoadFile(strPathLower))
+      strLoadedPath = strPathLower;
+    else if (xmlDoc.LoadFile(strLowerPath))
+      strLoadedPath = strLowerPath;
+    else
     {
       CLog::Log(LOGERROR, "unable to load:%s, Line %d\n%s", strPath.c_str(), xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
       SetID(WINDOW_INVALID);
@@ -154,30 +172,49 @@ bool CGUIWindow::LoadXML(const CStdString &strPath, const CStdString &strLowerPa
   else
     CLog::Log(LOGDEBUG, "Using already stored xml root node for %s", strPath.c_str());
 
-  return Load(m_windowXMLRootElement);
+  pRootElement = ResolveIncludes(m_windowXMLRootElement);
+  if (!pRootElement)
+    return false;
+
+  CGUISkinCache::Get().Store(strPath, strLoadedPath, *pRootElement, m_xmlIncludeConditions);
+  return LoadResolved(pRootElement);
 }
 
 bool CGUIWindow::Load(TiXmlElement* pRootElement)
 {
+  pRootElement = ResolveIncludes(pRootElement);
   if (!pRootElement)
     return false;
+
+  return LoadResolved(pRootElement);
+}
+
+TiXmlElement *CGUIWindow::ResolveIncludes(TiXmlElement *pRootElement)
+{
+  if (!pRootElement)
+    return NULL;
   
   if (strcmpi(pRootElement->Value(), "window"))
   {
     CLog::Log(LOGERROR, "file : XML file doesnt contain <window>");
-    return false;
+    return NULL;
   }
 
   // we must create copy of root element as we will manipulate it when resolving includes
   // and we don't want original root element to change
   pRootElement = (TiXmlElement*)pRootElement->Clone();
 
+  // Resolve any includes that may be present and save conditions used to do it
+  g_SkinInfo->ResolveIncludes(pRootElement, &m_xmlIncludeConditions);
+  return pRootElement;
+}
+
+bool CGUIWindow::LoadResolved(TiXmlElement *pRootElement)
+{
   // set the scaling resolution so that any control creation or initialisation can
   // be done with respect to the correct aspect ratio
   g_graphicsContext.SetScalingResolution(m_coordsRes, m_needsScaling);
 
-  // Resolve any includes that may be present and save conditions used to do it
-  g_SkinInfo->ResolveIncludes(pRootElement, &m_xmlIncludeConditions);
   // now load in the skin file
   SetDefaults();
 
@@ -808,11 +845,11 @@ bool CGUIWindow::Initialize()
   return m_windowLoaded;
 }
 
-void CGUIWindow::SetInitialVisibility()
+void CGUIWindow::SetInitialVisibility(const CGUIListItem *item /* = NULL */)
 {
   // reset our info manager caches
   g_infoManager.ResetCache();
-  CGUIControlGroup::SetInitialVisibility();
+  CGUIControlGroup::SetInitialVisibility(item);
 }
 
 bool CGUIWindow::IsActive() const
@@ -996,6 +1033,50 @@ bool CGUIWindow::SendMessage(int message, int id, int param1 /* = 0*/, int param
   return OnMessage(msg);
 }
 
+/*! \brief Collect the textures named by the elements below an element */
+static void GetTextures(const TiXmlElement *element, std::vector<CStdString> &textures)
+{
+  for (const TiXmlElement *child = element->FirstChildElement(); child; child = child->NextSiblingElement())
+  {
+    const TiXmlNode *text = child->FirstChild();
+    if (child->ValueStr().find("texture") != std::string::npos && text && text->Type() == TiXmlNode::TINYXML_TEXT)
+    { // infolabels and variables are only known once the window is up
+      if (text->ValueStr()[0] != '$')
+        textures.push_back(text->ValueStr());
+    }
+    else
+      GetTextures(child, textures);
+  }
+}
+
+void CGUIWindow::PredecodeTextures()
+{
+  CStdString xmlFile = GetProperty("xmlfile").asString();
+  if (xmlFile.empty())
+    return;
+
+  bool hasPath = xmlFile.find("\\") != std::string::npos || xmlFile.find("/") != std::string::npos;
+  CStdString path = hasPath ? xmlFile : g_SkinInfo->GetSkinPath(xmlFile);
+
+  std::map<INFO::InfoPtr, bool> conditions;
+  TiXmlElement *root = CGUISkinCache::Get().Load(path, conditions);
+  if (!root)
+  {
+    CXBMCTinyXML doc;
+    if (!doc.LoadFile(path) || strcmpi(doc.RootElement()->Value(), "window"))
+      return;
+    root = (TiXmlElement*)doc.RootElement()->Clone();
+    g_SkinInfo->ResolveIncludes(root, &conditions);
+    CGUISkinCache::Get().Store(path, path, *root, conditions);
+  }
+
+  std::vector<CStdString> textures;
+  GetTextures(root, textures);
+  delete root;
+
+  g_TextureManager.Predecode(textures);
+}
+
 void CGUIWindow::DumpTextureUse()
 {
 #ifdef _DEBUG
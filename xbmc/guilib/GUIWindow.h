@@ -151,7 +151,7 @@ public:
   void SetLoadType(LOAD_TYPE loadType) { m_loadType = loadType; };
   LOAD_TYPE GetLoadType() { return m_loadType; } const
   int GetRenderOrder() { return m_renderOrder; };
-  virtual void SetInitialVisibility();
+  virtual void SetInitialVisibility(const CGUIListItem *item = NULL);
   virtual bool IsVisible() const { return true; }; // windows are always considered visible as they implement their own
                                                    // versions of UpdateVisibility, and are deemed visible if they're in
                                                    // the window manager's active list.
@@ -190,6 +190,13 @@ public:
 
   void DumpTextureUse();
 
+  /*! \brief Start decoding the bundled textures of the window ahead of its first load
+   Resolves the includes of the window XML and stores them in the skin cache, so they are
+   not resolved again when the window is loaded.
+   \sa CGUITextureManager::Predecode
+   */
+  void PredecodeTextures();
+
   bool HasSaveLastControl() const { return !m_defaultAlways; };
 
   virtual void OnDeinitWindow(int nextWindowID);
@@ -197,6 +204,8 @@ protected:
   virtual EVENT_RESULT OnMouseEvent(const CPoint &point, const CMouseEvent &event);
   virtual bool LoadXML(const CStdString& strPath, const CStdString &strLowerPath);  ///< Loads from the given file
   bool Load(TiXmlElement *pRootElement);                 ///< Loads from the given XML root element
+  TiXmlElement *ResolveIncludes(TiXmlElement *pRootElement); ///< Returns a copy of the given <window> element with its includes resolved
+  bool LoadResolved(TiXmlElement *pRootElement);         ///< Loads from, and deletes, an XML root element with its includes resolved
   /*! \brief Check if XML file needs (re)loading
    XML file has to be (re)loaded when window is not loaded or include conditions values were changed
    */
@@ -31,6 +31,7 @@
 #include "settings/Settings.h"
 #include "addons/Skin.h"
 #include "GUITexture.h"
+#include "GUIRenderBatch.h"
 #include "windowing/WindowingFactory.h"
 #include "utils/Variant.h"
 #include "Key.h"
@@ -593,6 +594,7 @@ bool CGUIWindowManager::Render()
       CGUITexture::DrawQuad(*i, 0x4c00ff00);
   }
 
+  CGUIRenderBatch::Get().Flush();
   return hasRendered;
 }
 
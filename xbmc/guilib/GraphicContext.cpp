@@ -32,6 +32,7 @@
 #include "TextureManager.h"
 #include "input/MouseStat.h"
 #include "GUIWindowManager.h"
+#include "GUIRenderBatch.h"
 #include "utils/JobManager.h"
 #include "video/VideoReferenceClock.h"
 #include "cores/IPlayer.h"
@@ -230,6 +231,8 @@ bool CGraphicContext::SetViewPort(float fx, float fy, float fwidth, float fheigh
 
   CRect newviewport((float)newLeft, (float)newTop, (float)newRight, (float)newBottom);
 
+  // quads recorded so far are drawn with the old viewport
+  CGUIRenderBatch::Get().Flush();
   m_viewStack.push(newviewport);
 
   newviewport = StereoCorrection(newviewport);
@@ -244,6 +247,7 @@ void CGraphicContext::RestoreViewPort()
 {
   if (m_viewStack.size() <= 1) return;
 
+  CGUIRenderBatch::Get().Flush();
   m_viewStack.pop();
   CRect viewport = StereoCorrection(m_viewStack.top());
   g_Windowing.SetViewPort(viewport);
@@ -281,6 +285,7 @@ CRect CGraphicContext::StereoCorrection(const CRect &rect) const
 
 void CGraphicContext::SetScissors(const CRect &rect)
 {
+  CGUIRenderBatch::Get().Flush();
   m_scissors = rect;
   m_scissors.Intersect(CRect(0,0,(float)m_iScreenWidth, (float)m_iScreenHeight));
   g_Windowing.SetScissors(StereoCorrection(m_scissors));
@@ -288,6 +293,7 @@ void CGraphicContext::SetScissors(const CRect &rect)
 
 void CGraphicContext::ResetScissors()
 {
+  CGUIRenderBatch::Get().Flush();
   m_scissors.SetRect(0, 0, (float)m_iScreenWidth, (float)m_iScreenHeight);
   g_Windowing.SetScissors(StereoCorrection(m_scissors));
 }
@@ -667,6 +673,7 @@ void CGraphicContext::ResetScreenParameters(RESOLUTION res)
 
 void CGraphicContext::Clear(color_t color)
 {
+  CGUIRenderBatch::Get().Flush();
   g_Windowing.ClearBuffers(color);
 }
 
@@ -677,6 +684,7 @@ void CGraphicContext::CaptureStateBlock()
 
 void CGraphicContext::ApplyStateBlock()
 {
+  CGUIRenderBatch::Get().Flush();
   g_Windowing.ApplyStateBlock();
 }
 
@@ -817,6 +825,7 @@ void CGraphicContext::SetRenderingResolution(const RESOLUTION_INFO &res, bool ne
 
 void CGraphicContext::SetStereoView(RENDER_STEREO_VIEW view)
 {
+  CGUIRenderBatch::Get().Flush();
   m_stereoView = view;
 
   while(!m_viewStack.empty())
@@ -908,6 +917,7 @@ CRect CGraphicContext::generateAABB(const CRect &rect) const
 //       to cut down on one setting)
 void CGraphicContext::UpdateCameraPosition(const CPoint &camera)
 {
+  CGUIRenderBatch::Get().Flush();
   g_Windowing.SetCameraPosition(camera, m_iScreenWidth, m_iScreenHeight);
 }
 
@@ -937,6 +947,8 @@ float CGraphicContext::GetFPS() const
 void CGraphicContext::BeginPaint(bool lock)
 {
   if (lock) Lock();
+  // whatever is painted next goes over the GUI recorded so far
+  CGUIRenderBatch::Get().Flush();
 }
 
 void CGraphicContext::EndPaint(bool lock)
@@ -1003,6 +1015,7 @@ void CGraphicContext::SetMediaDir(const CStdString &strMediaDir)
 
 void CGraphicContext::Flip(const CDirtyRegionList& dirty)
 {
+  CGUIRenderBatch::Get().Flush();
   g_Windowing.PresentRender(dirty);
 
   if(m_stereoMode != m_nextStereoMode)
@@ -1015,11 +1028,13 @@ void CGraphicContext::Flip(const CDirtyRegionList& dirty)
 
 void CGraphicContext::ApplyHardwareTransform()
 {
+  CGUIRenderBatch::Get().Flush();
   g_Windowing.ApplyHardwareTransform(m_finalTransform.matrix);
 }
 
 void CGraphicContext::RestoreHardwareTransform()
 {
+  CGUIRenderBatch::Get().Flush();
   g_Windowing.RestoreHardwareTransform();
 }
 
@@ -103,6 +103,14 @@ int CTextureBundle::LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextu
   }
 }
 
+void CTextureBundle::Predecode(const std::vector<CStdString> &textures)
+{
+  if (m_useXBT)
+  {
+    m_tbXBT.Predecode(textures);
+  }
+}
+
 void CTextureBundle::Cleanup()
 {
   m_tbXBT.Cleanup();
@@ -41,6 +41,8 @@ public:
 
   int LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextures, int &width, int &height, int& nLoops, int** ppDelays);
 
+  void Predecode(const std::vector<CStdString> &textures);
+
 private:
   CTextureBundleXPR m_tbXPR;
   CTextureBundleXBT m_tbXBT;
@@ -33,11 +33,209 @@
 #include "XBTF.h"
 #include <lzo/lzo1x.h>
 #include "utils/StringUtils.h"
+#include "utils/JobManager.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include <algorithm>
 
 #ifdef TARGET_WINDOWS
 #pragma comment(lib,"liblzo2.lib")
 #endif
 
+// at most this many jobs decode the frames of a batch
+#define MAX_DECODE_JOBS 4
+
+/*! \brief Create a texture from the packed data of a frame */
+static CBaseTexture *DecodeFrame(const CStdString& name, const CXBTFFrame& frame, const unsigned char *data)
+{
+  const unsigned char *pixels = data;
+  squish::u8 *unpacked = NULL;
+
+  // check if it's packed with lzo
+  if (frame.IsPacked())
+  { // unpack
+    unpacked = new squish::u8[(size_t)frame.GetUnpackedSize()];
+    if (unpacked == NULL)
+    {
+      CLog::Log(LOGERROR, "Out of memory unpacking texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetUnpackedSize());
+      return NULL;
+    }
+    lzo_uint s = (lzo_uint)frame.GetUnpackedSize();
+    if (lzo1x_decompress_safe(data, (lzo_uint)frame.GetPackedSize(), unpacked, &s, NULL) != LZO_E_OK ||
+        s != frame.GetUnpackedSize())
+    {
+      CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
+      delete[] unpacked;
+      return NULL;
+    }
+    pixels = unpacked;
+  }
+
+  // create an xbmc texture - frames that aren't packed are copied straight from the bundle
+  CBaseTexture *texture = new CTexture();
+  texture->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), pixels);
+
+  delete[] unpacked;
+
+  return texture;
+}
+
+/*!
+ \brief Frames of a mapped bundle, decoded by jobs and by the threads waiting for them
+ Every thread decodes the next frame that nobody has started on, so a thread waiting for a
+ frame never waits on a job that a busy job pool hasn't started yet.
+ */
+class CXBTFDecodeBatch
+{
+public:
+  CXBTFDecodeBatch() : m_next(0), m_decoding(0) {}
+  ~CXBTFDecodeBatch();
+
+  /*! \brief Add a frame, before any are decoded */
+  void Add(const CStdString &name, const CXBTFFrame &frame, const unsigned char *data);
+  int Find(const CStdString &name) const;
+  size_t Size() const { return m_frames.size(); }
+
+  /*! \brief Decode the next frame that nobody has started on
+   \return false if there is no such frame
+   */
+  bool DecodeNext();
+
+  /*! \brief Take the texture of a frame, decoding frames until it's done
+   \return the texture, NULL if it failed to decode or was taken before
+   */
+  CBaseTexture *Take(size_t index);
+
+  /*! \brief Stop decoding, wait for the frames being decoded and free all textures not taken */
+  void Cancel();
+
+private:
+  struct Frame
+  {
+    CStdString name;
+    CXBTFFrame frame;
+    const unsigned char *data;
+    CBaseTexture *texture;
+    bool decoded;
+  };
+
+  std::vector<Frame> m_frames;
+  size_t m_next;     ///< the first frame that nobody has started on
+  size_t m_decoding; ///< the number of frames being decoded
+  CCriticalSection m_section;
+  CEvent m_decoded;
+};
+
+CXBTFDecodeBatch::~CXBTFDecodeBatch()
+{
+  for (std::vector<Frame>::iterator i = m_frames.begin(); i != m_frames.end(); ++i)
+    delete i->texture;
+}
+
+void CXBTFDecodeBatch::Add(const CStdString &name, const CXBTFFrame &frame, const unsigned char *data)
+{
+  Frame decode;
+  decode.name = name;
+  decode.frame = frame;
+  decode.data = data;
+  decode.texture = NULL;
+  decode.decoded = false;
+  m_frames.push_back(decode);
+}
+
+int CXBTFDecodeBatch::Find(const CStdString &name) const
+{
+  for (size_t i = 0; i < m_frames.size(); i++)
+  {
+    if (m_frames[i].name == name)
+      return (int)i;
+  }
+  return -1;
+}
+
+bool CXBTFDecodeBatch::DecodeNext()
+{
+  size_t index;
+  {
+    CSingleLock lock(m_section);
+    if (m_next >= m_frames.size())
+      return false;
+    index = m_next++;
+    m_decoding++;
+  }
+
+  Frame &frame = m_frames[index];
+  CBaseTexture *texture = DecodeFrame(frame.name, frame.frame, frame.data);
+
+  {
+    CSingleLock lock(m_section);
+    frame.texture = texture;
+    frame.decoded = true;
+    m_decoding--;
+  }
+  m_decoded.Set();
+  return true;
+}
+
+CBaseTexture *CXBTFDecodeBatch::Take(size_t index)
+{
+  CSingleLock lock(m_section);
+  while (!m_frames[index].decoded)
+  {
+    lock.Leave();
+    if (!DecodeNext())
+      m_decoded.Wait();
+    lock.Enter();
+  }
+
+  CBaseTexture *texture = m_frames[index].texture;
+  m_frames[index].texture = NULL;
+  return texture;
+}
+
+void CXBTFDecodeBatch::Cancel()
+{
+  CSingleLock lock(m_section);
+  m_next = m_frames.size();
+  while (m_decoding)
+  {
+    lock.Leave();
+    m_decoded.Wait();
+    lock.Enter();
+  }
+
+  for (std::vector<Frame>::iterator i = m_frames.begin(); i != m_frames.end(); ++i)
+  {
+    delete i->texture;
+    i->texture = NULL;
+  }
+}
+
+/*! \brief Decodes the frames of a batch until none are left */
+class CXBTFDecodeJob : public CJob
+{
+public:
+  CXBTFDecodeJob(const boost::shared_ptr<CXBTFDecodeBatch> &batch) : m_batch(batch) {}
+
+  virtual const char *GetType() const { return "xbtfdecode"; }
+  virtual bool DoWork()
+  {
+    while (m_batch->DecodeNext()) {}
+    return true;
+  }
+
+private:
+  boost::shared_ptr<CXBTFDecodeBatch> m_batch;
+};
+
+/*! \brief Start jobs to decode a batch along with the calling thread */
+static void StartDecodeJobs(const boost::shared_ptr<CXBTFDecodeBatch> &batch, size_t jobs)
+{
+  jobs = std::min(jobs, (size_t)MAX_DECODE_JOBS);
+  for (size_t i = 0; i < jobs; i++)
+    CJobManager::GetInstance().AddJob(new CXBTFDecodeJob(batch), NULL, CJob::PRIORITY_NORMAL);
+}
+
 CTextureBundleXBT::CTextureBundleXBT(void)
 {
   m_themeBundle = false;
@@ -146,7 +344,17 @@ bool CTextureBundleXBT::LoadTexture(const CStdString& Filename, CBaseTexture** p
     return false;
 
   CXBTFFrame& frame = file->GetFrames().at(0);
-  if (!ConvertFrameToTexture(Filename, frame, ppTexture))
+
+  // pick up the texture if it was predecoded
+  *ppTexture = NULL;
+  if (m_predecode)
+  {
+    int index = m_predecode->Find(name);
+    if (index >= 0)
+      *ppTexture = m_predecode->Take(index);
+  }
+
+  if (!*ppTexture && !ConvertFrameToTexture(Filename, frame, ppTexture))
   {
     return false;
   }
@@ -173,12 +381,36 @@ int CTextureBundleXBT::LoadAnim(const CStdString& Filename, CBaseTexture*** ppTe
   *ppTextures = new CBaseTexture*[nTextures];
   *ppDelays = new int[nTextures];
 
+  // decode the frames on the job pool as well if they can be read from any thread
+  boost::shared_ptr<CXBTFDecodeBatch> batch(new CXBTFDecodeBatch);
+  for (size_t i = 0; i < nTextures && batch; i++)
+  {
+    CXBTFFrame& frame = file->GetFrames().at(i);
+    const unsigned char *data = m_XBTFReader.GetData(frame);
+    if (data)
+      batch->Add(Filename, frame, data);
+    else
+      batch.reset();
+  }
+  if (batch)
+    StartDecodeJobs(batch, nTextures - 1);
+
   for (size_t i = 0; i < nTextures; i++)
   {
     CXBTFFrame& frame = file->GetFrames().at(i);
 
-    if (!ConvertFrameToTexture(Filename, frame, &((*ppTextures)[i])))
+    bool loaded;
+    if (batch)
+      loaded = ((*ppTextures)[i] = batch->Take(i)) != NULL;
+    else
+      loaded = ConvertFrameToTexture(Filename, frame, &((*ppTextures)[i]));
+
+    if (!loaded)
     {
+      if (batch)
+        batch->Cancel();
+      for (size_t j = 0; j < i; j++)
+        delete (*ppTextures)[j];
       return false;
     }
 
@@ -194,56 +426,79 @@ int CTextureBundleXBT::LoadAnim(const CStdString& Filename, CBaseTexture*** ppTe
 
 bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture)
 {
-  // found texture - allocate the necessary buffers
-  squish::u8 *buffer = new squish::u8[(size_t)frame.GetPackedSize()];
-  if (buffer == NULL)
+  // use the frame in the mapped bundle if we can, otherwise read it
+  const unsigned char *data = m_XBTFReader.GetData(frame);
+  squish::u8 *buffer = NULL;
+  if (!data)
   {
-    CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
-    return false;
-  }
-
-  // load the compressed texture
-  if (!m_XBTFReader.Load(frame, buffer))
-  {
-    CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
-    delete[] buffer;
-    return false;
-  }
-
-  // check if it's packed with lzo
-  if (frame.IsPacked())
-  { // unpack
-    squish::u8 *unpacked = new squish::u8[(size_t)frame.GetUnpackedSize()];
-    if (unpacked == NULL)
+    buffer = new squish::u8[(size_t)frame.GetPackedSize()];
+    if (buffer == NULL)
     {
-      CLog::Log(LOGERROR, "Out of memory unpacking texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetUnpackedSize());
-      delete[] buffer;
+      CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
       return false;
     }
-    lzo_uint s = (lzo_uint)frame.GetUnpackedSize();
-    if (lzo1x_decompress_safe(buffer, (lzo_uint)frame.GetPackedSize(), unpacked, &s, NULL) != LZO_E_OK ||
-        s != frame.GetUnpackedSize())
+
+    // load the compressed texture
+    if (!m_XBTFReader.Load(frame, buffer))
     {
-      CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
+      CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
       delete[] buffer;
-      delete[] unpacked;
       return false;
     }
-    delete[] buffer;
-    buffer = unpacked;
+    data = buffer;
   }
 
-  // create an xbmc texture
-  *ppTexture = new CTexture();
-  (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), buffer);
+  *ppTexture = DecodeFrame(name, frame, data);
 
   delete[] buffer;
 
-  return true;
+  return *ppTexture != NULL;
+}
+
+void CTextureBundleXBT::Predecode(const std::vector<CStdString> &textures)
+{
+  if (!m_XBTFReader.IsOpen() && !OpenBundle())
+    return;
+
+  CancelPredecode();
+
+  boost::shared_ptr<CXBTFDecodeBatch> batch(new CXBTFDecodeBatch);
+  for (std::vector<CStdString>::const_iterator i = textures.begin(); i != textures.end(); ++i)
+  {
+    CStdString name = Normalize(*i);
+    CXBTFFile* file = m_XBTFReader.Find(name);
+    if (!file || file->GetFrames().size() != 1 || batch->Find(name) >= 0)
+      continue;
+
+    // without a mapped bundle frames can only be read on this thread
+    const unsigned char *data = m_XBTFReader.GetData(file->GetFrames()[0]);
+    if (!data)
+      return;
+    batch->Add(name, file->GetFrames()[0], data);
+  }
+
+  if (!batch->Size())
+    return;
+
+  CLog::Log(LOGDEBUG, "%s - Decoding %u textures", __FUNCTION__, (unsigned int)batch->Size());
+  m_predecode = batch;
+  StartDecodeJobs(batch, batch->Size());
+}
+
+void CTextureBundleXBT::CancelPredecode()
+{
+  // the jobs must be done with the mapped bundle before it's closed
+  if (m_predecode)
+  {
+    m_predecode->Cancel();
+    m_predecode.reset();
+  }
 }
 
 void CTextureBundleXBT::Cleanup()
 {
+  CancelPredecode();
+
   if (m_XBTFReader.IsOpen())
   {
     m_XBTFReader.Close();
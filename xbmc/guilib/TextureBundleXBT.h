@@ -22,9 +22,11 @@
 
 #include "utils/StdString.h"
 #include <map>
+#include <boost/shared_ptr.hpp>
 #include "XBTFReader.h"
 
 class CBaseTexture;
+class CXBTFDecodeBatch;
 
 class CTextureBundleXBT
 {
@@ -44,14 +46,24 @@ public:
   int LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextures,
                 int &width, int &height, int& nLoops, int** ppDelays);
 
+  /*! \brief Decode textures on the job pool ahead of their first use
+   A later LoadTexture() of one of the textures picks up the decoded texture, waiting for it
+   if need be. Textures that aren't in the bundle, and animated ones, are skipped.
+   Replaces the textures of an earlier call that haven't been picked up yet.
+   \param textures the names of the textures to decode
+   */
+  void Predecode(const std::vector<CStdString> &textures);
+
 private:
   bool OpenBundle();
   bool ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture);
+  void CancelPredecode();
 
   time_t m_TimeStamp;
 
   bool m_themeBundle;
   CXBTFReader m_XBTFReader;
+  boost::shared_ptr<CXBTFDecodeBatch> m_predecode;
 };
 
 
@@ -439,6 +439,23 @@ const CTextureArray& CGUITextureManager::Load(const CStdString& strTextureName,
 }
 
 
+void CGUITextureManager::Predecode(const std::vector<CStdString> &textures)
+{
+  std::vector<CStdString> bundled[2];
+  for (std::vector<CStdString>::const_iterator i = textures.begin(); i != textures.end(); ++i)
+  {
+    int bundle = -1, size = 0;
+    if (HasTexture(*i, NULL, &bundle, &size) && !size && bundle >= 0 && !StringUtils::EndsWithNoCase(*i, ".gif"))
+      bundled[bundle].push_back(*i);
+  }
+
+  for (int i = 0; i < 2; i++)
+  {
+    if (!bundled[i].empty())
+      m_TexBundle[i].Predecode(bundled[i]);
+  }
+}
+
 void CGUITextureManager::ReleaseTexture(const CStdString& strTextureName, bool immediately /*= false */)
 {
   CSingleLock lock(g_graphicsContext);
@@ -110,6 +110,11 @@ public:
   bool HasTexture(const CStdString &textureName, CStdString *path = NULL, int *bundle = NULL, int *size = NULL);
   static bool CanLoad(const CStdString &texturePath); ///< Returns true if the texture manager can load this texture
   const CTextureArray& Load(const CStdString& strTextureName, bool checkBundleOnly = false);
+  /*! \brief Decode bundled textures in the background, so that loading them later is quick
+   \param textures the textures to decode - those not in a bundle or already loaded are skipped
+   \sa CTextureBundleXBT::Predecode
+   */
+  void Predecode(const std::vector<CStdString> &textures);
   void ReleaseTexture(const CStdString& strTextureName, bool immediately = false);
   void Cleanup();
   void Dump() const;
@@ -602,9 +602,9 @@ void CAnimation::UpdateCondition(const CGUIListItem *item)
   m_lastCondition = condition;
 }
 
-void CAnimation::SetInitialCondition()
+void CAnimation::SetInitialCondition(const CGUIListItem *item /* = NULL */)
 {
-  m_lastCondition = m_condition ? m_condition->Get() : false;
+  m_lastCondition = m_condition ? m_condition->Get(item) : false;
   if (m_lastCondition)
     ApplyAnimation();
   else
@@ -173,7 +173,7 @@ public:
 
   bool CheckCondition();
   void UpdateCondition(const CGUIListItem *item = NULL);
-  void SetInitialCondition();
+  void SetInitialCondition(const CGUIListItem *item = NULL);
 
 private:
   void Calculate(const CPoint &point);
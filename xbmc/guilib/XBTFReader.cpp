@@ -24,6 +24,9 @@
 #include "utils/CharsetConverter.h"
 #ifdef TARGET_WINDOWS
 #include "FileSystem/SpecialProtocol.h"
+#include <io.h>
+#else
+#include <sys/mman.h>
 #endif
 
 #include <string.h>
@@ -46,6 +49,11 @@
 CXBTFReader::CXBTFReader()
 {
   m_file = NULL;
+  m_data = NULL;
+  m_dataSize = 0;
+#ifdef TARGET_WINDOWS
+  m_mapping = NULL;
+#endif
 }
 
 bool CXBTFReader::IsOpen() const
@@ -135,11 +143,58 @@ bool CXBTFReader::Open(const CStdString& fileName)
     return false;
   }
 
+  // frames are read from the mapped file if we can map it, and from m_file if we can't
+  Map();
+
   return true;
 }
 
+void CXBTFReader::Map()
+{
+  struct stat fileStat;
+  if (fstat(fileno(m_file), &fileStat) == -1 || fileStat.st_size <= 0)
+    return;
+
+#ifdef TARGET_WINDOWS
+  m_mapping = CreateFileMapping((HANDLE)_get_osfhandle(_fileno(m_file)), NULL, PAGE_READONLY, 0, 0, NULL);
+  if (m_mapping == NULL)
+    return;
+  m_data = (const unsigned char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+  if (m_data == NULL)
+  {
+    CloseHandle(m_mapping);
+    m_mapping = NULL;
+    return;
+  }
+#else
+  void *data = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_SHARED, fileno(m_file), 0);
+  if (data == MAP_FAILED)
+    return;
+  m_data = (const unsigned char*)data;
+#endif
+  m_dataSize = fileStat.st_size;
+}
+
+void CXBTFReader::Unmap()
+{
+  if (!m_data)
+    return;
+
+#ifdef TARGET_WINDOWS
+  UnmapViewOfFile(m_data);
+  CloseHandle(m_mapping);
+  m_mapping = NULL;
+#else
+  munmap((void*)m_data, (size_t)m_dataSize);
+#endif
+  m_data = NULL;
+  m_dataSize = 0;
+}
+
 void CXBTFReader::Close()
 {
+  Unmap();
+
   if (m_file)
   {
     fclose(m_file);
@@ -182,12 +237,30 @@ CXBTFFile* CXBTFReader::Find(const CStdString& name)
   return &(iter->second);
 }
 
+const unsigned char* CXBTFReader::GetData(const CXBTFFrame& frame) const
+{
+  if (!m_data || frame.GetOffset() > m_dataSize || frame.GetPackedSize() > m_dataSize - frame.GetOffset())
+  {
+    return NULL;
+  }
+
+  return m_data + frame.GetOffset();
+}
+
 bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer)
 {
   if (!m_file)
   {
     return false;
   }
+
+  const unsigned char* data = GetData(frame);
+  if (data)
+  {
+    memcpy(buffer, data, (size_t)frame.GetPackedSize());
+    return true;
+  }
+
 #if defined(TARGET_DARWIN) || defined(TARGET_FREEBSD) || defined(TARGET_ANDROID)
     if (fseeko(m_file, (off_t)frame.GetOffset(), SEEK_SET) == -1)
 #else
@@ -37,12 +37,28 @@ public:
   bool Exists(const CStdString& name);
   CXBTFFile* Find(const CStdString& name);
   bool Load(const CXBTFFrame& frame, unsigned char* buffer);
+
+  /*! \brief Get the data of a frame in the mapped file
+   The data stays valid until the reader is closed, and may be read from any thread.
+   \param frame the frame to get the data of.
+   \return the packed data of the frame, or NULL if the file isn't mapped or the frame lies outside of it.
+   \sa Load
+   */
+  const unsigned char* GetData(const CXBTFFrame& frame) const;
   std::vector<CXBTFFile>&  GetFiles();
 
 private:
+  void Map();
+  void Unmap();
+
   CXBTF      m_xbtf;
   CStdString m_fileName;
   FILE*      m_file;
+  const unsigned char* m_data; ///< the file mapped into memory, NULL if mapping failed
+  uint64_t   m_dataSize;
+#ifdef TARGET_WINDOWS
+  HANDLE     m_mapping;
+#endif
   std::map<CStdString, CXBTFFile> m_filesMap;
 };
 
@@ -0,0 +1,176 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/GUIFontAtlas.h"
+#include "guilib/GUIFontTTF.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Rect
+{
+  unsigned int x, y, width, height;
+  int shelf;
+};
+
+static bool Overlaps(const Rect &a, const Rect &b)
+{
+  return a.x < b.x + b.width && b.x < a.x + a.width &&
+         a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+TEST(TestGUIFontAtlas, Packing)
+{
+  CGUIFontAtlas atlas(256, 256);
+  std::vector<Rect> rects;
+  srand(1);
+  for (;;)
+  {
+    Rect rect;
+    rect.width = 4 + rand() % 20;
+    rect.height = 8 + rand() % 24;
+    rect.shelf = atlas.Allocate(rect.width, rect.height, rect.x, rect.y);
+    if (rect.shelf < 0)
+      break;
+    rects.push_back(rect);
+  }
+  ASSERT_GT(rects.size(), 100u);
+
+  for (size_t i = 0; i < rects.size(); i++)
+  {
+    EXPECT_LE(rects[i].x + rects[i].width, 256u);
+    EXPECT_LE(rects[i].y + rects[i].height, atlas.GetHeight());
+    for (size_t j = i + 1; j < rects.size(); j++)
+      EXPECT_FALSE(Overlaps(rects[i], rects[j])) << i << " and " << j;
+  }
+
+  SGUIFontAtlasStats stats;
+  atlas.GetStats(stats);
+  EXPECT_EQ(rects.size(), stats.glyphs);
+  EXPECT_LE(atlas.GetHeight(), 256u);
+  EXPECT_LE(stats.usedArea, (uint64_t)256 * atlas.GetHeight());
+  // shelves are rounded to a few pixels, so most of the atlas is covered
+  EXPECT_GT(stats.usedArea * 10, (uint64_t)256 * atlas.GetHeight() * 6);
+  EXPECT_EQ(0u, stats.evictions);
+}
+
+TEST(TestGUIFontAtlas, Eviction)
+{
+  // four shelves of four glyphs
+  CGUIFontAtlas atlas(64, 64);
+  unsigned int x, y;
+  for (int i = 0; i < 16; i++)
+    ASSERT_EQ(i / 4, atlas.Allocate(16, 16, x, y));
+  EXPECT_EQ(-1, atlas.Allocate(16, 16, x, y));
+
+  // the shelves not used for longest go first
+  atlas.Touch(0);
+  atlas.Touch(2);
+  unsigned int shelfY, shelfHeight;
+  EXPECT_EQ(1, atlas.Evict(16, shelfY, shelfHeight));
+  EXPECT_EQ(16u, shelfY);
+  EXPECT_EQ(16u, shelfHeight);
+  EXPECT_EQ(1, atlas.Allocate(16, 16, x, y));
+  EXPECT_EQ(0u, x);
+  EXPECT_EQ(16u, y);
+  EXPECT_EQ(3, atlas.Evict(16, shelfY, shelfHeight));
+
+  // nothing is high enough
+  EXPECT_EQ(-1, atlas.Evict(32, shelfY, shelfHeight));
+
+  SGUIFontAtlasStats stats;
+  atlas.GetStats(stats);
+  EXPECT_EQ(9u, stats.glyphs);
+  EXPECT_EQ(2u, stats.evictions);
+}
+
+TEST(TestGUIFontAtlas, Rasterize)
+{
+  // the glyphs outlive the job, as the font may read them after it is gone
+  CGUIFontRasterizeJob::ResultPtr result(new CGUIFontRasterizeJob::Result);
+  {
+    CGUIFontRasterizeJob job(XBMC_REF_FILE_PATH("media/Fonts/teletext.ttf"), 20.0f, 1.0f, result);
+    EXPECT_TRUE(result->glyphs.empty());
+    ASSERT_TRUE(job.DoWork());
+  }
+  const std::vector<CGUIFontRasterizeJob::Glyph> &glyphs = result->glyphs;
+  ASSERT_EQ(256u, glyphs.size());
+
+  const CGUIFontRasterizeJob::Glyph &space = glyphs[' '];
+  EXPECT_TRUE(space.valid);
+  EXPECT_GT(space.advance, 0.0f);
+
+  const CGUIFontRasterizeJob::Glyph &letter = glyphs['A'];
+  ASSERT_TRUE(letter.valid);
+  EXPECT_GT(letter.width, 0u);
+  EXPECT_GT(letter.rows, 0u);
+  EXPECT_EQ(letter.width * letter.rows, letter.pixels.size());
+
+  // control characters are left out
+  EXPECT_FALSE(glyphs[0x10].valid);
+  EXPECT_FALSE(glyphs[0x80].valid);
+}
+
+/* run with --gtest_also_run_disabled_tests */
+TEST(TestGUIFontAtlas, DISABLED_Benchmark)
+{
+  // mixed script text with a large character set, in an atlas too small to hold all of it
+  CGUIFontAtlas atlas(1024, 512);
+  std::vector<int> shelves(20000, -1);
+  unsigned int x, y, shelfY, shelfHeight;
+  int allocations = 0, evictions = 0;
+  srand(2);
+  int64_t start = CurrentHostCounter();
+  for (int i = 0; i < 1000000; i++)
+  {
+    // a few characters are used all the time
+    int character = rand() % 4 ? rand() % 100 : rand() % shelves.size();
+    if (shelves[character] >= 0)
+    {
+      atlas.Touch(shelves[character]);
+      continue;
+    }
+    unsigned int height = 20 + character % 9;
+    int shelf = atlas.Allocate(20, height, x, y);
+    if (shelf < 0)
+    {
+      int evicted = atlas.Evict(height, shelfY, shelfHeight);
+      for (size_t j = 0; j < shelves.size(); j++)
+      {
+        if (shelves[j] == evicted)
+          shelves[j] = -1;
+      }
+      evictions++;
+      shelf = atlas.Allocate(20, height, x, y);
+    }
+    shelves[character] = shelf;
+    allocations++;
+  }
+  double time = (double)(CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency();
+
+  SGUIFontAtlasStats stats;
+  atlas.GetStats(stats);
+  printf("%d allocations, %d evictions in %.1fms, %u shelves, %u%% covered\n", allocations, evictions, time,
+         stats.shelves, (unsigned int)(stats.usedArea * 100 / ((uint64_t)stats.width * stats.height)));
+}
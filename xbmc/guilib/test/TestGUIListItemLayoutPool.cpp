@@ -0,0 +1,237 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/GUIListItemLayoutPool.h"
+#include "guilib/GUIImage.h"
+#include "guilib/GUIListItem.h"
+#include "guilib/GUIListGroup.h"
+#include "guilib/GUIListItemLayout.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+
+/* a layout with a background, an icon and an overlay, like most skins have, and a folder overlay */
+class CTestLayout : public CGUIListItemLayout
+{
+public:
+  CTestLayout()
+  {
+    m_width = 400;
+    m_height = 40;
+    for (int i = 0; i < 3; i++)
+      m_group.AddControl(new CGUIImage(0, 0, i * 40.0f, 0, 40, 40, CTextureInfo("")));
+
+    CGUIImage *folder = new CGUIImage(0, FOLDER_CONTROL, 120.0f, 0, 40, 40, CTextureInfo(""));
+    folder->SetVisibleCondition("ListItem.IsFolder");
+    m_group.AddControl(folder);
+  }
+
+  /* the controls of a copy of the layout */
+  static CGUIListGroup &GetGroup(CGUIListItemLayout *layout)
+  {
+    return layout->*(&CTestLayout::m_group);
+  }
+
+  static const int FOLDER_CONTROL = 10;
+};
+
+class TestGUIListItemLayoutPool : public testing::Test
+{
+protected:
+  TestGUIListItemLayoutPool()
+  {
+    for (int i = 0; i < 1000; i++)
+      m_items.push_back(CGUIListItemPtr(new CGUIListItem));
+  }
+
+  /* what the container does for each frame when the items first to first + count - 1 are in view */
+  void Show(int first, int count)
+  {
+    m_pool.ReleaseUnused(m_items, first, first + count - 1);
+    for (int i = first; i < first + count; i++)
+    {
+      if (!m_pool.IsBound(m_items[i].get(), false))
+        m_pool.Bind(m_items[i], m_layout, false);
+    }
+  }
+
+  std::vector<CGUIListItemPtr> m_items;
+  CTestLayout m_layout;
+  CGUIListItemLayoutPool m_pool;
+};
+
+TEST_F(TestGUIListItemLayoutPool, Scroll)
+{
+  unsigned int allocations, reuses;
+  Show(0, 20);
+  m_pool.GetStats(allocations, reuses);
+  EXPECT_EQ(20u, allocations);
+  EXPECT_EQ(0u, reuses);
+
+  // scrolling through the list only reuses the layouts
+  for (int first = 1; first <= 980; first++)
+    Show(first, 20);
+  m_pool.GetStats(allocations, reuses);
+  EXPECT_EQ(0u, allocations);
+  EXPECT_EQ(980u, reuses);
+  EXPECT_EQ(20u, m_pool.GetBoundCount());
+  EXPECT_LE(m_pool.GetFreeCount(), 20u);
+
+  // only the items in view have layouts
+  for (int i = 0; i < 980; i++)
+    EXPECT_TRUE(m_items[i]->GetLayout() == NULL) << i;
+  for (int i = 980; i < 1000; i++)
+    EXPECT_TRUE(m_items[i]->GetLayout() != NULL) << i;
+}
+
+TEST_F(TestGUIListItemLayoutPool, Wrap)
+{
+  // a wrapping list keeps the items at both ends
+  for (int i = 0; i < 5; i++)
+  {
+    m_pool.Bind(m_items[i], m_layout, false);
+    m_pool.Bind(m_items[995 + i], m_layout, false);
+  }
+  m_pool.ReleaseUnused(m_items, 995, 4);
+  EXPECT_EQ(10u, m_pool.GetBoundCount());
+  EXPECT_TRUE(m_items[0]->GetLayout() != NULL);
+  EXPECT_TRUE(m_items[999]->GetLayout() != NULL);
+
+  m_pool.ReleaseUnused(m_items, 998, 1);
+  EXPECT_EQ(4u, m_pool.GetBoundCount());
+  EXPECT_TRUE(m_items[2]->GetLayout() == NULL);
+  EXPECT_TRUE(m_items[997]->GetLayout() == NULL);
+}
+
+TEST_F(TestGUIListItemLayoutPool, Foreign)
+{
+  // an item with a layout from elsewhere gets one of ours
+  CGUIListItemLayout *foreign = new CGUIListItemLayout(m_layout);
+  m_items[0]->SetLayout(foreign);
+  EXPECT_FALSE(m_pool.IsBound(m_items[0].get(), false));
+  Show(0, 1);
+  EXPECT_TRUE(m_pool.IsBound(m_items[0].get(), false));
+  EXPECT_TRUE(m_items[0]->GetLayout() != foreign);
+
+  // an item freeing our layout itself gets a new one
+  m_items[0]->FreeMemory();
+  EXPECT_FALSE(m_pool.IsBound(m_items[0].get(), false));
+  Show(0, 1);
+  EXPECT_TRUE(m_pool.IsBound(m_items[0].get(), false));
+  EXPECT_EQ(1u, m_pool.GetBoundCount());
+
+  // and the focused layout is bound separately
+  EXPECT_FALSE(m_pool.IsBound(m_items[0].get(), true));
+  m_pool.Bind(m_items[0], m_layout, true);
+  EXPECT_TRUE(m_pool.IsBound(m_items[0].get(), true));
+  EXPECT_TRUE(m_items[0]->GetFocusedLayout() != m_items[0]->GetLayout());
+}
+
+TEST_F(TestGUIListItemLayoutPool, ReleaseAll)
+{
+  Show(0, 10);
+  m_pool.ReleaseAll();
+  EXPECT_EQ(0u, m_pool.GetBoundCount());
+  EXPECT_EQ(10u, m_pool.GetFreeCount());
+  for (int i = 0; i < 10; i++)
+    EXPECT_TRUE(m_items[i]->GetLayout() == NULL);
+
+  // a new list gets the same layouts
+  unsigned int allocations, reuses;
+  m_pool.GetStats(allocations, reuses);
+  Show(500, 10);
+  m_pool.GetStats(allocations, reuses);
+  EXPECT_EQ(0u, allocations);
+  EXPECT_EQ(10u, reuses);
+
+  m_pool.Clear();
+  EXPECT_EQ(0u, m_pool.GetBoundCount());
+  EXPECT_EQ(0u, m_pool.GetFreeCount());
+  EXPECT_TRUE(m_items[500]->GetLayout() == NULL);
+}
+
+/* run with --gtest_also_run_disabled_tests */
+TEST_F(TestGUIListItemLayoutPool, DISABLED_Benchmark)
+{
+  // page through a list of 50000 items with 20 in view and 10 cached on either side,
+  // as the container did before the pool and does now
+  const int items = 50000, view = 20, cache = 10;
+  m_items.clear();
+  for (int i = 0; i < items; i++)
+    m_items.push_back(CGUIListItemPtr(new CGUIListItem));
+
+  for (int pooled = 0; pooled < 2; pooled++)
+  {
+    unsigned int allocations = 0, reuses = 0;
+    int64_t start = CurrentHostCounter();
+    int frames = 0;
+    for (int first = 0; first + view + 2 * cache <= items; first += view, frames++)
+    {
+      if (pooled)
+        Show(first, view + 2 * cache);
+      else
+      {
+        for (int i = 0; i < first; i++)
+          m_items[i]->FreeMemory();
+        for (int i = first + view + 2 * cache; i < items; i++)
+          m_items[i]->FreeMemory();
+        for (int i = first; i < first + view + 2 * cache; i++)
+        {
+          if (!m_items[i]->GetLayout())
+          {
+            m_items[i]->SetLayout(new CGUIListItemLayout(m_layout));
+            allocations++;
+          }
+        }
+      }
+    }
+    if (pooled)
+      m_pool.GetStats(allocations, reuses);
+    double time = (double)(CurrentHostCounter() - start) * 1000000.0 / CurrentHostFrequency() / frames;
+    printf("%-8s %.2f layouts allocated, %.2f reused and %.2fus per frame\n", pooled ? "pooled" : "unpooled",
+           (double)allocations / frames, (double)reuses / frames, time);
+  }
+}
+
+TEST_F(TestGUIListItemLayoutPool, Reset)
+{
+  m_items[1]->m_bIsFolder = true;
+  Show(0, 1);
+  CGUIListItemLayout *layout = m_items[0]->GetLayout();
+  CGUIListGroup &group = CTestLayout::GetGroup(layout);
+  const CGUIControl *folder = group.GetControl(CTestLayout::FOLDER_CONTROL);
+  EXPECT_TRUE(folder->IsVisibleFromSkin());
+
+  // the item hides the folder overlay
+  group.UpdateInfo(m_items[0].get());
+  EXPECT_FALSE(folder->IsVisibleFromSkin());
+  EXPECT_FALSE(folder->IsVisible());
+
+  // the next item gets the same controls, shown as they are for that item
+  Show(1, 1);
+  ASSERT_EQ(layout, m_items[1]->GetLayout());
+  ASSERT_EQ(folder, group.GetControl(CTestLayout::FOLDER_CONTROL));
+  EXPECT_TRUE(folder->IsVisibleFromSkin());
+  EXPECT_TRUE(folder->IsVisible());
+  group.UpdateInfo(m_items[1].get());
+  EXPECT_TRUE(folder->IsVisibleFromSkin());
+}
@@ -0,0 +1,166 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/GUIRenderBatch.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static SGUIRenderState State(unsigned int texture, unsigned int diffuse = 0)
+{
+  SGUIRenderState state;
+  state.texture = texture;
+  state.diffuse = diffuse;
+  return state;
+}
+
+static void AddQuad(CGUIRenderBatch &batch, const SGUIRenderState &state, float x1, float y1, float x2, float y2, float z = 0)
+{
+  SGUIVertex vertices[4];
+  memset(vertices, 0, sizeof(vertices));
+  vertices[0].x = x1; vertices[0].y = y1;
+  vertices[1].x = x2; vertices[1].y = y1;
+  vertices[2].x = x2; vertices[2].y = y2;
+  vertices[3].x = x1; vertices[3].y = y2;
+  for (int i = 0; i < 4; i++)
+    vertices[i].z = z;
+  batch.AddQuad(state, vertices);
+}
+
+class TestGUIRenderBatch : public testing::Test
+{
+protected:
+  TestGUIRenderBatch()
+  {
+    m_batch.SetBackend(&m_backend);
+  }
+
+  CGUIRenderBatch m_batch;
+  CGUIRenderBackendNull m_backend;
+};
+
+TEST_F(TestGUIRenderBatch, Merge)
+{
+  AddQuad(m_batch, State(1), 0, 0, 10, 10);
+  AddQuad(m_batch, State(1), 5, 5, 15, 15);
+  AddQuad(m_batch, State(1, 2), 0, 0, 10, 10);
+  EXPECT_TRUE(m_backend.m_drawCalls.empty());
+  m_batch.Flush();
+
+  ASSERT_EQ(2u, m_backend.m_drawCalls.size());
+  EXPECT_TRUE(m_backend.m_drawCalls[0].state == State(1));
+  EXPECT_EQ(8u, m_backend.m_drawCalls[0].vertices.size());
+  EXPECT_TRUE(m_backend.m_drawCalls[1].state == State(1, 2));
+  EXPECT_EQ(4u, m_backend.m_drawCalls[1].vertices.size());
+
+  unsigned int quads, drawCalls;
+  m_batch.GetStats(quads, drawCalls);
+  EXPECT_EQ(3u, quads);
+  EXPECT_EQ(2u, drawCalls);
+
+  // nothing is drawn twice
+  m_batch.Flush();
+  EXPECT_EQ(2u, m_backend.m_drawCalls.size());
+}
+
+TEST_F(TestGUIRenderBatch, Reorder)
+{
+  // a list of items with a background, an icon and an overlay each, none overlapping the others
+  for (int i = 0; i < 10; i++)
+  {
+    float y = i * 20.0f;
+    AddQuad(m_batch, State(1), 0, y, 100, y + 20);
+    AddQuad(m_batch, State(2), 0, y, 20, y + 20);
+    AddQuad(m_batch, State(3), 80, y, 100, y + 20);
+  }
+  m_batch.Flush();
+
+  ASSERT_EQ(3u, m_backend.m_drawCalls.size());
+  for (unsigned int i = 0; i < 3; i++)
+  {
+    EXPECT_EQ(i + 1, m_backend.m_drawCalls[i].state.texture);
+    EXPECT_EQ(40u, m_backend.m_drawCalls[i].vertices.size());
+  }
+  // the quads keep their order within the batch
+  EXPECT_EQ(20.0f, m_backend.m_drawCalls[1].vertices[4].y);
+}
+
+TEST_F(TestGUIRenderBatch, Overlap)
+{
+  // the last quad would go below the second if it joined the first
+  AddQuad(m_batch, State(1), 0, 0, 10, 10);
+  AddQuad(m_batch, State(2), 20, 0, 30, 10);
+  AddQuad(m_batch, State(1), 25, 5, 35, 15);
+  m_batch.Flush();
+
+  ASSERT_EQ(3u, m_backend.m_drawCalls.size());
+  EXPECT_EQ(1u, m_backend.m_drawCalls[0].state.texture);
+  EXPECT_EQ(2u, m_backend.m_drawCalls[1].state.texture);
+  EXPECT_EQ(1u, m_backend.m_drawCalls[2].state.texture);
+  EXPECT_EQ(25.0f, m_backend.m_drawCalls[2].vertices[0].x);
+}
+
+TEST_F(TestGUIRenderBatch, Depth)
+{
+  // quads with depth may overlap anything on screen, so they aren't moved and nothing moves past them
+  AddQuad(m_batch, State(1), 0, 0, 10, 10);
+  AddQuad(m_batch, State(2), 20, 0, 30, 10, 1);
+  AddQuad(m_batch, State(1), 40, 0, 50, 10);
+  AddQuad(m_batch, State(3), 60, 0, 70, 10);
+  AddQuad(m_batch, State(2), 80, 0, 90, 10, 1);
+  m_batch.Flush();
+
+  ASSERT_EQ(5u, m_backend.m_drawCalls.size());
+  EXPECT_EQ(1u, m_backend.m_drawCalls[2].state.texture);
+  EXPECT_EQ(2u, m_backend.m_drawCalls[4].state.texture);
+}
+
+/* run with --gtest_also_run_disabled_tests */
+TEST_F(TestGUIRenderBatch, DISABLED_Benchmark)
+{
+  // a window with a background, a panel and a list of 20 items with a focus texture,
+  // an icon and an overlay, where every icon is a texture of its own
+  const int frames = 1000;
+  unsigned int quads = 0, drawCalls = 0;
+  int64_t start = CurrentHostCounter();
+  for (int frame = 0; frame < frames; frame++)
+  {
+    m_backend.m_drawCalls.clear();
+    AddQuad(m_batch, State(1), 0, 0, 1280, 720);
+    AddQuad(m_batch, State(2), 100, 50, 1180, 670);
+    for (int i = 0; i < 20; i++)
+    {
+      float y = 60.0f + i * 30.0f;
+      AddQuad(m_batch, State(3), 110, y, 1170, y + 30);
+      if (i == frame % 20)
+        AddQuad(m_batch, State(4), 110, y, 1170, y + 30);
+      AddQuad(m_batch, State(10 + i), 110, y, 140, y + 30);
+      AddQuad(m_batch, State(5), 1140, y, 1170, y + 30);
+    }
+    m_batch.Flush();
+  }
+  double time = (double)(CurrentHostCounter() - start) * 1000000.0 / CurrentHostFrequency() / frames;
+  m_batch.GetStats(quads, drawCalls);
+  printf("%.1f quads in %.1f draw calls and %.2fus per frame\n",
+         (double)quads / frames, (double)drawCalls / frames, time);
+}
@@ -0,0 +1,193 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/GUISkinCache.h"
+#include "addons/Skin.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define WINDOW_XML \
+  "<window id=\"3000\">" \
+    "<!-- dropped from the cache -->" \
+    "<defaultcontrol always=\"true\">50</defaultcontrol>" \
+    "<controls>" \
+      "<control type=\"label\" id=\"2\">" \
+        "<left>10</left><width>1260</width>" \
+        "<label>$INFO[ListItem.Label]</label>" \
+        "<visible>!Window.IsVisible(Home) + Control.HasFocus(50)</visible>" \
+      "</control>" \
+      "<control type=\"image\"><texture><![CDATA[a<b>.png]]></texture></control>" \
+    "</controls>" \
+  "</window>"
+
+static std::string Print(const TiXmlNode *node)
+{
+  TiXmlPrinter printer;
+  node->Accept(&printer);
+  return printer.Str();
+}
+
+class TestGUISkinCache : public testing::Test
+{
+protected:
+  TestGUISkinCache()
+  {
+    m_file = XBMC_CREATETEMPFILE(".bin");
+    m_file->Close();
+  }
+
+  ~TestGUISkinCache()
+  {
+    XBMC_DELETETEMPFILE(m_file);
+  }
+
+  XFILE::CFile *m_file;
+};
+
+TEST_F(TestGUISkinCache, RoundTrip)
+{
+  CXBMCTinyXML doc;
+  doc.Parse(WINDOW_XML);
+  ASSERT_TRUE(doc.RootElement() != NULL);
+
+  SGUISkinCacheInfo info;
+  info.key = "skin.test-1.0.0-2.11";
+  info.files.push_back(SGUISkinCacheInfo::File());
+  info.files[0].path = "special://skin/720p/Test.xml";
+  info.files[0].time = 1377000000;
+  info.files[0].size = 1234;
+  info.conditions.push_back(std::make_pair("skin.hassetting(test)", true));
+  info.conditions.push_back(std::make_pair("system.platform.linux", false));
+  ASSERT_TRUE(CGUISkinCache::Write(XBMC_TEMPFILEPATH(m_file), info, *doc.RootElement()));
+
+  SGUISkinCacheInfo read;
+  TiXmlElement *root = CGUISkinCache::Read(XBMC_TEMPFILEPATH(m_file), read);
+  ASSERT_TRUE(root != NULL);
+
+  EXPECT_EQ(info.key, read.key);
+  ASSERT_EQ(1u, read.files.size());
+  EXPECT_EQ(info.files[0].path, read.files[0].path);
+  EXPECT_EQ(info.files[0].time, read.files[0].time);
+  EXPECT_EQ(info.files[0].size, read.files[0].size);
+  EXPECT_TRUE(info.conditions == read.conditions);
+
+  // everything but the comment survives
+  doc.RootElement()->RemoveChild(doc.RootElement()->FirstChild());
+  EXPECT_EQ(Print(doc.RootElement()), Print(root));
+  EXPECT_TRUE(root->FirstChildElement("controls")->LastChild()->FirstChild()->FirstChild()->ToText()->CDATA());
+  delete root;
+}
+
+TEST_F(TestGUISkinCache, Damaged)
+{
+  SGUISkinCacheInfo info;
+  EXPECT_TRUE(CGUISkinCache::Read(XBMC_TEMPFILEPATH(m_file), info) == NULL);
+
+  XFILE::CFile file;
+  ASSERT_TRUE(file.OpenForWrite(XBMC_TEMPFILEPATH(m_file), true));
+  file.Write(WINDOW_XML, sizeof(WINDOW_XML));
+  file.Close();
+  EXPECT_TRUE(CGUISkinCache::Read(XBMC_TEMPFILEPATH(m_file), info) == NULL);
+
+  // cut off in the middle of the tree
+  CXBMCTinyXML doc;
+  doc.Parse(WINDOW_XML);
+  ASSERT_TRUE(CGUISkinCache::Write(XBMC_TEMPFILEPATH(m_file), info, *doc.RootElement()));
+  struct __stat64 stat;
+  ASSERT_EQ(0, XFILE::CFile::Stat(XBMC_TEMPFILEPATH(m_file), &stat));
+  std::vector<char> buffer((size_t)stat.st_size);
+  ASSERT_TRUE(file.Open(XBMC_TEMPFILEPATH(m_file)));
+  file.Read(&buffer[0], buffer.size());
+  file.Close();
+  ASSERT_TRUE(file.OpenForWrite(XBMC_TEMPFILEPATH(m_file), true));
+  file.Write(&buffer[0], buffer.size() - 20);
+  file.Close();
+  EXPECT_TRUE(CGUISkinCache::Read(XBMC_TEMPFILEPATH(m_file), info) == NULL);
+
+  // a length past the end of the file, here the one of the key
+  size_t length = (size_t)-1 / 2;
+  memcpy(&buffer[sizeof(size_t) + strlen("XBMC skin cache") + sizeof(int)], &length, sizeof(length));
+  ASSERT_TRUE(file.OpenForWrite(XBMC_TEMPFILEPATH(m_file), true));
+  file.Write(&buffer[0], buffer.size());
+  file.Close();
+  info.key = "stale";
+  EXPECT_TRUE(CGUISkinCache::Read(XBMC_TEMPFILEPATH(m_file), info) == NULL);
+  EXPECT_TRUE(info.key.empty());
+}
+
+/* run with --gtest_also_run_disabled_tests */
+TEST_F(TestGUISkinCache, DISABLED_Benchmark)
+{
+  ADDON::AddonProps props("skin.confluence", ADDON::ADDON_SKIN, "2.1.0", "");
+  props.path = XBMC_REF_FILE_PATH("/addons/skin.confluence");
+  g_SkinInfo.reset(new ADDON::CSkinInfo(props));
+  g_SkinInfo->Start();
+  g_SkinInfo->LoadIncludes();
+
+  CFileItemList items;
+  ASSERT_TRUE(XFILE::CDirectory::GetDirectory(URIUtils::AddFileToFolder(props.path, "720p"), items, ".xml"));
+
+  const int runs = 10;
+  double totalXml = 0.0, totalCache = 0.0;
+  for (int i = 0; i < items.Size(); i++)
+  {
+    std::map<INFO::InfoPtr, bool> conditions;
+    TiXmlElement *root = NULL;
+    int64_t start = CurrentHostCounter();
+    for (int run = 0; run < runs; run++)
+    {
+      delete root;
+      CXBMCTinyXML doc;
+      if (!doc.LoadFile(items[i]->GetPath()) || strcmp(doc.RootElement()->Value(), "window"))
+        break;
+      root = (TiXmlElement *)doc.RootElement()->Clone();
+      g_SkinInfo->ResolveIncludes(root, &conditions);
+    }
+    if (!root)
+      continue;
+    double xml = (double)(CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency() / runs;
+
+    SGUISkinCacheInfo info;
+    ASSERT_TRUE(CGUISkinCache::Write(XBMC_TEMPFILEPATH(m_file), info, *root));
+    delete root;
+
+    start = CurrentHostCounter();
+    for (int run = 0; run < runs; run++)
+      delete CGUISkinCache::Read(XBMC_TEMPFILEPATH(m_file), info);
+    double cache = (double)(CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency() / runs;
+
+    printf("%-36s xml %7.2fms, cache %7.2fms\n", items[i]->GetLabel().c_str(), xml, cache);
+    totalXml += xml;
+    totalCache += cache;
+  }
+  printf("%-36s xml %7.2fms, cache %7.2fms\n", "total", totalXml, totalCache);
+
+  g_SkinInfo.reset();
+}
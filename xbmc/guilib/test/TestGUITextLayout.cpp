@@ -0,0 +1,177 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/GUITextLayout.h"
+#include "guilib/GUIFont.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+
+#define TEXT "[B]Bold[/B] and [UPPERCASE]upper[/UPPERCASE][CR]second line"
+
+/*
+ * Fonts without a font file: nothing is measured, but the text is still
+ * parsed, broken into lines and bidi flipped.
+ */
+class TestGUITextLayout : public testing::Test
+{
+protected:
+  TestGUITextLayout()
+  : m_font("test", FONT_STYLE_NORMAL, 0, 0, 1.0f, 20.0f, NULL),
+    m_boldFont("test", FONT_STYLE_BOLD, 0, 0, 1.0f, 20.0f, NULL)
+  {
+    CGUITextLayout::ClearCache();
+    GetStatistics();
+  }
+
+  ~TestGUITextLayout()
+  {
+    CGUITextLayout::ClearCache();
+  }
+
+  void GetStatistics()
+  {
+    CGUITextLayout::GetCacheStatistics(m_hits, m_misses);
+  }
+
+  static vecText GetFirstText(const CGUITextLayout &layout)
+  {
+    vecText text;
+    layout.GetFirstText(text);
+    return text;
+  }
+
+  CGUIFont m_font;
+  CGUIFont m_boldFont;
+  unsigned int m_hits;
+  unsigned int m_misses;
+};
+
+TEST_F(TestGUITextLayout, Shared)
+{
+  CGUITextLayout first(&m_font, false);
+  EXPECT_TRUE(first.Update(TEXT));
+  GetStatistics();
+  EXPECT_EQ(0u, m_hits);
+  EXPECT_EQ(1u, m_misses);
+
+  // another control showing the same text gets the same layout
+  CGUITextLayout second(&m_font, false);
+  EXPECT_TRUE(second.Update(TEXT));
+  GetStatistics();
+  EXPECT_EQ(1u, m_hits);
+  EXPECT_EQ(0u, m_misses);
+  EXPECT_EQ(first.GetTextLength(), second.GetTextLength());
+  EXPECT_TRUE(GetFirstText(first) == GetFirstText(second));
+
+  // and so does the same text laid out from scratch
+  CGUITextLayout::ClearCache();
+  CGUITextLayout third(&m_font, false);
+  EXPECT_TRUE(third.Update(TEXT));
+  GetStatistics();
+  EXPECT_EQ(0u, m_hits);
+  EXPECT_EQ(1u, m_misses);
+  EXPECT_EQ(first.GetTextLength(), third.GetTextLength());
+  EXPECT_TRUE(GetFirstText(first) == GetFirstText(third));
+
+  // unchanged text isn't looked up at all
+  EXPECT_FALSE(third.Update(TEXT));
+  GetStatistics();
+  EXPECT_EQ(0u, m_hits + m_misses);
+}
+
+TEST_F(TestGUITextLayout, Key)
+{
+  CGUITextLayout layout(&m_font, false);
+  layout.Update(TEXT);
+
+  // the font style changes the glyphs
+  CGUITextLayout bold(&m_boldFont, false);
+  bold.Update(TEXT);
+  EXPECT_FALSE(GetFirstText(layout) == GetFirstText(bold));
+
+  // the width only matters when wrapping
+  CGUITextLayout wide(&m_font, false);
+  wide.Update(TEXT, 500.0f);
+  CGUITextLayout wrapped(&m_font, true);
+  wrapped.Update(TEXT, 500.0f);
+  CGUITextLayout ltr(&m_font, false);
+  ltr.Update(TEXT, 0, false, true);
+
+  GetStatistics();
+  EXPECT_EQ(1u, m_hits);
+  EXPECT_EQ(4u, m_misses);
+}
+
+TEST_F(TestGUITextLayout, Eviction)
+{
+  CGUITextLayout layout(&m_font, false);
+  layout.Update("first");
+  for (int i = 0; i < 10000; i++)
+    layout.Update(StringUtils::Format("label %d", i));
+  GetStatistics();
+
+  layout.Update("first");
+  GetStatistics();
+  EXPECT_EQ(0u, m_hits);
+  EXPECT_EQ(1u, m_misses);
+}
+
+/* run with --gtest_also_run_disabled_tests */
+TEST_F(TestGUITextLayout, DISABLED_Benchmark)
+{
+  // a list of 10000 items showing 20 at a time, scrolled from top to bottom,
+  // with two labels in each item layout
+  const int items = 10000, rows = 20, passes = 3;
+  std::vector<CStdString> labels, label2s;
+  for (int i = 0; i < items; i++)
+  {
+    labels.push_back(StringUtils::Format("%05d. [B]Artist %d[/B] - Track title number %d", i + 1, i % 97, i));
+    label2s.push_back(StringUtils::Format("[COLOR grey]%d:%02d[/COLOR]", i % 7, i % 60));
+  }
+
+  for (int cached = 0; cached < 2; cached++)
+  {
+    std::vector<CGUITextLayout> layouts(2 * rows, CGUITextLayout(&m_font, false));
+    CGUITextLayout::ClearCache();
+    GetStatistics();
+    int64_t start = CurrentHostCounter();
+    int frames = 0;
+    for (int pass = 0; pass < passes; pass++)
+    {
+      for (int offset = 0; offset + rows <= items; offset++, frames++)
+      {
+        for (int row = 0; row < rows; row++)
+        {
+          if (!cached)
+            CGUITextLayout::ClearCache();
+          layouts[2 * row].Update(labels[offset + row], 600.0f);
+          layouts[2 * row + 1].Update(label2s[offset + row], 100.0f);
+        }
+      }
+    }
+    double time = (double)(CurrentHostCounter() - start) * 1000000.0 / CurrentHostFrequency() / frames;
+    GetStatistics();
+    printf("%-9s %.2fus per frame, %u hits, %u misses\n", cached ? "cached" : "uncached", time, m_hits, m_misses);
+  }
+}
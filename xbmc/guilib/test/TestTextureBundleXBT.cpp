@@ -0,0 +1,303 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/TextureBundleXBT.h"
+#include "guilib/GraphicContext.h"
+#include "guilib/Texture.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <lzo/lzo1x.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SIZE 16
+
+static void WriteU32(std::string &out, uint32_t value)
+{
+  for (int i = 0; i < 4; i++)
+    out += (char)(value >> (8 * i));
+}
+
+static void WriteU64(std::string &out, uint64_t value)
+{
+  WriteU32(out, (uint32_t)value);
+  WriteU32(out, (uint32_t)(value >> 32));
+}
+
+/* the pixels of a SIZE x SIZE frame */
+static std::string Pixels(int seed)
+{
+  std::string pixels(SIZE * SIZE * 4, 0);
+  for (size_t i = 0; i < pixels.size(); i++)
+    pixels[i] = (char)(seed * 31 + i % 64);
+  return pixels;
+}
+
+struct TestFrame
+{
+  std::string name;
+  int seed;
+  bool packed;
+};
+
+/* an XBT bundle of SIZE x SIZE ARGB frames, with consecutive frames of the same name in one file */
+static std::string Bundle(const TestFrame *frames, size_t count)
+{
+  std::vector<std::string> data;
+  std::vector<size_t> files;
+  for (size_t i = 0; i < count; i++)
+  {
+    std::string pixels = Pixels(frames[i].seed);
+    if (frames[i].packed)
+    {
+      std::vector<unsigned char> packed(pixels.size() + pixels.size() / 16 + 64 + 3);
+      std::vector<unsigned char> work(LZO1X_1_MEM_COMPRESS);
+      lzo_uint size = packed.size();
+      lzo1x_1_compress((const unsigned char *)pixels.c_str(), pixels.size(), &packed[0], &size, &work[0]);
+      pixels.assign((const char *)&packed[0], size);
+    }
+    data.push_back(pixels);
+    if (!i || frames[i].name != frames[i - 1].name)
+      files.push_back(i);
+  }
+  files.push_back(count);
+
+  uint64_t offset = 4 + 1 + 4 + (files.size() - 1) * (256 + 4 + 4) + count * 40;
+  std::string out(XBTF_MAGIC);
+  out += XBTF_VERSION;
+  WriteU32(out, files.size() - 1);
+  for (size_t file = 0; file + 1 < files.size(); file++)
+  {
+    std::string path(frames[files[file]].name);
+    path.resize(256, 0);
+    out += path;
+    WriteU32(out, 0);
+    WriteU32(out, files[file + 1] - files[file]);
+    for (size_t i = files[file]; i < files[file + 1]; i++)
+    {
+      WriteU32(out, SIZE);
+      WriteU32(out, SIZE);
+      WriteU32(out, XB_FMT_A8R8G8B8);
+      WriteU64(out, data[i].size());
+      WriteU64(out, SIZE * SIZE * 4);
+      WriteU32(out, 100 * (i - files[file] + 1));
+      WriteU64(out, offset);
+      offset += data[i].size();
+    }
+  }
+  for (size_t i = 0; i < count; i++)
+    out += data[i];
+  return out;
+}
+
+static bool HasPixels(CBaseTexture *texture, int seed)
+{
+  if (!texture || texture->GetWidth() != SIZE || texture->GetHeight() != SIZE)
+    return false;
+  std::string pixels = Pixels(seed);
+  for (unsigned int y = 0; y < SIZE; y++)
+  {
+    if (memcmp(texture->GetPixels() + y * texture->GetPitch(), pixels.c_str() + y * SIZE * 4, SIZE * 4))
+      return false;
+  }
+  return true;
+}
+
+class TestTextureBundleXBT : public testing::Test
+{
+protected:
+  TestTextureBundleXBT()
+  {
+    static const TestFrame frames[] = {
+      { "plain.png", 1, false },
+      { "packed.png", 2, true },
+      { "anim.gif", 3, true },
+      { "anim.gif", 4, false },
+      { "anim.gif", 5, true },
+    };
+    std::string bundle = Bundle(frames, sizeof(frames) / sizeof(frames[0]));
+
+    m_mediaDir = g_graphicsContext.GetMediaDir();
+    m_path = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), "xbttest");
+    XFILE::CDirectory::Create(m_path);
+    XFILE::CDirectory::Create(URIUtils::AddFileToFolder(m_path, "media"));
+    XFILE::CFile file;
+    if (file.OpenForWrite(URIUtils::AddFileToFolder(m_path, "media/Textures.xbt"), true))
+      file.Write(bundle.c_str(), bundle.size());
+    file.Close();
+    g_graphicsContext.SetMediaDir(m_path);
+  }
+
+  ~TestTextureBundleXBT()
+  {
+    m_bundle.Cleanup();
+    g_graphicsContext.SetMediaDir(m_mediaDir);
+    XFILE::CFile::Delete(URIUtils::AddFileToFolder(m_path, "media/Textures.xbt"));
+    XFILE::CDirectory::Remove(URIUtils::AddFileToFolder(m_path, "media"));
+    XFILE::CDirectory::Remove(m_path);
+  }
+
+  CStdString m_mediaDir;
+  CStdString m_path;
+  CTextureBundleXBT m_bundle;
+};
+
+TEST_F(TestTextureBundleXBT, Reader)
+{
+  CXBTFReader reader;
+  ASSERT_TRUE(reader.Open(URIUtils::AddFileToFolder(m_path, "media/Textures.xbt")));
+  ASSERT_EQ(3u, reader.GetFiles().size());
+
+  // reading a frame gives what's in the mapped file
+  CXBTFFile *file = reader.Find("anim.gif");
+  ASSERT_TRUE(file != NULL);
+  ASSERT_EQ(3u, file->GetFrames().size());
+  for (size_t i = 0; i < file->GetFrames().size(); i++)
+  {
+    CXBTFFrame &frame = file->GetFrames()[i];
+    const unsigned char *data = reader.GetData(frame);
+    ASSERT_TRUE(data != NULL);
+    std::vector<unsigned char> buffer((size_t)frame.GetPackedSize());
+    EXPECT_TRUE(reader.Load(frame, &buffer[0]));
+    EXPECT_EQ(0, memcmp(data, &buffer[0], buffer.size()));
+  }
+  EXPECT_TRUE(file->GetFrames()[0].IsPacked());
+  EXPECT_FALSE(file->GetFrames()[1].IsPacked());
+
+  CXBTFFrame frame = file->GetFrames()[0];
+  reader.Close();
+  EXPECT_TRUE(reader.GetData(frame) == NULL);
+}
+
+TEST_F(TestTextureBundleXBT, LoadTexture)
+{
+  ASSERT_TRUE(m_bundle.HasFile("plain.png"));
+  EXPECT_FALSE(m_bundle.HasFile("missing.png"));
+
+  const char *names[] = { "plain.png", "Packed.png" };
+  for (int i = 0; i < 2; i++)
+  {
+    CBaseTexture *texture = NULL;
+    int width = 0, height = 0;
+    ASSERT_TRUE(m_bundle.LoadTexture(names[i], &texture, width, height));
+    EXPECT_EQ(SIZE, width);
+    EXPECT_EQ(SIZE, height);
+    EXPECT_TRUE(HasPixels(texture, i + 1)) << names[i];
+    delete texture;
+  }
+}
+
+TEST_F(TestTextureBundleXBT, LoadAnim)
+{
+  ASSERT_TRUE(m_bundle.HasFile("anim.gif"));
+
+  CBaseTexture **textures = NULL;
+  int *delays = NULL;
+  int width = 0, height = 0, loops = -1;
+  ASSERT_EQ(3, m_bundle.LoadAnim("anim.gif", &textures, width, height, loops, &delays));
+  EXPECT_EQ(SIZE, width);
+  EXPECT_EQ(0, loops);
+  for (int i = 0; i < 3; i++)
+  {
+    EXPECT_TRUE(HasPixels(textures[i], i + 3)) << i;
+    EXPECT_EQ(100 * (i + 1), delays[i]);
+    delete textures[i];
+  }
+  delete[] textures;
+  delete[] delays;
+}
+
+TEST_F(TestTextureBundleXBT, Predecode)
+{
+  ASSERT_TRUE(m_bundle.HasFile("plain.png"));
+
+  std::vector<CStdString> names;
+  names.push_back("packed.png");
+  names.push_back("missing.png");
+  names.push_back("anim.gif");
+  names.push_back("packed.png");
+  m_bundle.Predecode(names);
+
+  // the predecoded texture is handed out once, and decoded again after that
+  for (int i = 0; i < 2; i++)
+  {
+    CBaseTexture *texture = NULL;
+    int width = 0, height = 0;
+    ASSERT_TRUE(m_bundle.LoadTexture("packed.png", &texture, width, height));
+    EXPECT_TRUE(HasPixels(texture, 2));
+    delete texture;
+  }
+
+  // textures that aren't picked up are dropped with the bundle
+  names.clear();
+  names.push_back("plain.png");
+  m_bundle.Predecode(names);
+  m_bundle.Cleanup();
+}
+
+/* run with --gtest_also_run_disabled_tests */
+TEST_F(TestTextureBundleXBT, DISABLED_Benchmark)
+{
+  // load every texture of the skin bundle, in groups the size of a window
+  g_graphicsContext.SetMediaDir(XBMC_REF_FILE_PATH("/addons/skin.confluence"));
+  CXBTFReader reader;
+  ASSERT_TRUE(reader.Open(XBMC_REF_FILE_PATH("/addons/skin.confluence/media/Textures.xbt")));
+  std::vector<CStdString> names;
+  for (size_t i = 0; i < reader.GetFiles().size(); i++)
+  {
+    if (reader.GetFiles()[i].GetFrames().size() == 1)
+      names.push_back(reader.GetFiles()[i].GetPath());
+  }
+  reader.Close();
+  ASSERT_FALSE(names.empty());
+
+  const size_t window = 100;
+  for (int predecode = 0; predecode < 2; predecode++)
+  {
+    m_bundle.Cleanup();
+    uint64_t bytes = 0;
+    int64_t start = CurrentHostCounter();
+    ASSERT_TRUE(m_bundle.HasFile(names[0]));
+    for (size_t first = 0; first < names.size(); first += window)
+    {
+      std::vector<CStdString> textures(names.begin() + first, names.begin() + std::min(first + window, names.size()));
+      if (predecode)
+        m_bundle.Predecode(textures);
+      for (size_t i = 0; i < textures.size(); i++)
+      {
+        CBaseTexture *texture = NULL;
+        int width, height;
+        if (m_bundle.LoadTexture(textures[i], &texture, width, height))
+          bytes += texture->GetPitch() * texture->GetRows();
+        delete texture;
+      }
+    }
+    double time = (double)(CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency();
+    printf("%-10s %d textures, %.1fMB in %.1fms\n", predecode ? "predecoded" : "serial",
+           (int)names.size(), bytes / 1048576.0, time);
+  }
+}
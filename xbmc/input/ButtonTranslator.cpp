@@ -33,6 +33,7 @@
 #include "utils/StringUtils.h"
 #include "utils/log.h"
 #include "utils/XBMCTinyXML.h"
+#include "threads/SingleLock.h"
 #include "XBIRRemote.h"
 
 #if defined(TARGET_WINDOWS)
@@ -484,6 +485,8 @@ CButtonTranslator::~CButtonTranslator()
 // Add the supplied device name to the list of connected devices
 void CButtonTranslator::AddDevice(CStdString& strDevice)
 {
+  CSingleLock lock(m_section);
+
   // Only add the device if it isn't already in the list
   std::list<CStdString>::iterator it;
   for (it = m_deviceList.begin(); it != m_deviceList.end(); it++)
@@ -500,6 +503,8 @@ void CButtonTranslator::AddDevice(CStdString& strDevice)
 
 void CButtonTranslator::RemoveDevice(CStdString& strDevice)
 {
+  CSingleLock lock(m_section);
+
   // Find the device
   std::list<CStdString>::iterator it;
   for (it = m_deviceList.begin(); it != m_deviceList.end(); it++)
@@ -517,6 +522,7 @@ void CButtonTranslator::RemoveDevice(CStdString& strDevice)
 
 bool CButtonTranslator::Load(bool AlwaysLoad)
 {
+  CSingleLock lock(m_section);
   m_translatorMap.clear();
 
   // Directories to search for keymaps. They're applied in this order,
@@ -1455,6 +1461,7 @@ uint32_t CButtonTranslator::TranslateMouseCommand(const char *szButton)
 
 void CButtonTranslator::Clear()
 {
+  CSingleLock lock(m_section);
   m_translatorMap.clear();
 #if defined(HAS_LIRC) || defined(HAS_IRSERVERSUITE)
   ClearLircButtonMapEntries();
@@ -30,6 +30,7 @@
 #ifdef HAS_EVENT_SERVER
 #include "network/EventClient.h"
 #endif
+#include "threads/CriticalSection.h"
 #include "utils/StdString.h"
 
 class CKey;
@@ -43,7 +44,8 @@ struct CButtonAction
 };
 ///
 /// singleton class to map from buttons to actions
-/// Warning: _not_ threadsafe!
+/// Warning: _not_ threadsafe! Only loading the maps and adding or removing devices is locked,
+/// as keymaps are loaded during startup while peripherals may be added.
 class CButtonTranslator
 {
 #ifdef HAS_EVENT_SERVER
@@ -156,6 +158,7 @@ private:
   std::map<int, buttonMap> m_touchMap;
 
   bool m_Loaded;
+  CCriticalSection m_section;
 };
 
 #endif
@@ -27,6 +27,24 @@ class CGUIListItem;
 
 namespace INFO
 {
+/*!
+ \ingroup info
+ \brief Sources of change an info may depend on
+ An info is only re-evaluated once one of its sources has published a change.
+ \sa CGUIInfoManager::Invalidate
+ */
+enum InfoSource
+{
+  INFO_SOURCE_NONE    = 0,      ///< constant
+  INFO_SOURCE_FRAME   = 1 << 0, ///< may change at any time, re-evaluated every frame
+  INFO_SOURCE_PLAYER  = 1 << 1, ///< player state and speed
+  INFO_SOURCE_LIBRARY = 1 << 2, ///< library content
+  INFO_SOURCE_SKIN    = 1 << 3, ///< skin settings
+  INFO_SOURCE_PVR     = 1 << 4, ///< PVR recordings, timers and playing channel
+  INFO_SOURCE_TIME    = 1 << 5, ///< the clock, by the minute
+  INFO_SOURCE_COUNT   = 6
+};
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -73,11 +91,17 @@ public:
 
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
+
+  /*! \brief Get the sources this info bool depends on
+   \return a combination of InfoSource flags
+   */
+  unsigned int GetSources() const { return m_sources; }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
+  unsigned int m_sources;      ///< InfoSource flags, the bool is only set dirty when one of them changed
 
 private:
   std::string  m_expression;   ///< original expression
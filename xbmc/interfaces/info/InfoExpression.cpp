@@ -19,8 +19,11 @@
  */
 
 #include "InfoExpression.h"
+#include <algorithm>
+#include <limits.h>
 #include <stack>
 #include "utils/log.h"
+#include "utils/StringUtils.h"
 #include "GUIInfoManager.h"
 
 using namespace std;
@@ -30,10 +33,12 @@ InfoSingle::InfoSingle(const std::string &expression, int context)
 : InfoBool(expression, context)
 {
   m_condition = g_infoManager.TranslateSingleString(expression, m_listItemDependent);
+  m_sources = g_infoManager.GetInfoSources(m_condition);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
 {
+  g_infoManager.m_boolEvaluations++;
   m_value = g_infoManager.GetBool(m_condition, m_context, item);
 }
 
@@ -48,19 +53,13 @@ void InfoExpression::Update(const CGUIListItem *item)
   Evaluate(item, m_value);
 }
 
-#define OPERATOR_LB   5
-#define OPERATOR_RB   4
 #define OPERATOR_NOT  3
 #define OPERATOR_AND  2
 #define OPERATOR_OR   1
 
 short InfoExpression::GetOperator(const char ch) const
 {
-  if (ch == '[')
-    return OPERATOR_LB;
-  else if (ch == ']')
-    return OPERATOR_RB;
-  else if (ch == '!')
+  if (ch == '!')
     return OPERATOR_NOT;
   else if (ch == '+')
     return OPERATOR_AND;
@@ -70,119 +69,170 @@ short InfoExpression::GetOperator(const char ch) const
     return 0;
 }
 
+bool InfoExpression::AddOperand(const std::string &operand, vector<short> &postfix)
+{
+  InfoPtr info = g_infoManager.Register(operand, m_context);
+  if (!info)
+    return true; // whitespace between operators
+
+  m_listItemDependent |= info->ListItemDependent();
+  m_sources |= info->GetSources();
+
+  // an operand used more than once is evaluated only once
+  vector<InfoPtr>::const_iterator i = find(m_operands.begin(), m_operands.end(), info);
+  if (i == m_operands.end())
+  {
+    if (m_operands.size() >= SHRT_MAX)
+      return false;
+    i = m_operands.insert(m_operands.end(), info);
+  }
+  postfix.push_back(i - m_operands.begin());
+  return true;
+}
+
 void InfoExpression::Parse(const std::string &expression)
 {
+  // an expression changes only when one of its operands does
+  m_sources = INFO_SOURCE_NONE;
+
+  // brackets around the whole expression don't need an operand of their own
+  CStdString work(expression);
+  StringUtils::Trim(work);
+  while (!work.empty() && work[0] == '[' && StringUtils::FindEndBracket(work, '[', ']', 1) == (int)work.size() - 1)
+  {
+    work = work.substr(1, work.size() - 2);
+    StringUtils::Trim(work);
+  }
+
+  // convert to postfix, operand indices and negated operators
+  vector<short> postfix;
   stack<char> operators;
   std::string operand;
-  for (unsigned int i = 0; i < expression.size(); i++)
+  bool valid = true;
+  for (unsigned int i = 0; valid && i < work.size(); i++)
   {
-    if (GetOperator(expression[i]))
+    if (work[i] == '[')
     {
-      // cleanup any operand, translate and put into our expression list
-      if (!operand.empty())
+      // a bracketed subexpression is registered as an operand, so it is shared with
+      // all the other expressions using it
+      int end = StringUtils::FindEndBracket(work, '[', ']', i + 1);
+      valid = end != (int)CStdString::npos && operand.find_first_not_of(" \t\r\n") == std::string::npos &&
+              AddOperand(work.substr(i + 1, end - i - 1), postfix);
+      operand.clear();
+      i = end;
+    }
+    else if (work[i] == ']')
+      valid = false;
+    else if (GetOperator(work[i]))
+    {
+      valid = AddOperand(operand, postfix);
+      operand.clear();
+      // pop off the stack any operator that has a higher priority than the one we have.
+      while (!operators.empty() && GetOperator(operators.top()) > GetOperator(work[i]))
       {
-        InfoPtr info = g_infoManager.Register(operand, m_context);
-        if (info)
-        {
-          m_listItemDependent |= info->ListItemDependent();
-          m_postfix.push_back(m_operands.size());
-          m_operands.push_back(info);
-        }
-        operand.clear();
+        postfix.push_back(-GetOperator(operators.top()));  // negative denotes operator
+        operators.pop();
       }
-      // handle closing parenthesis
-      if (expression[i] == ']')
-      {
-        while (!operators.empty())
-        {
-          char oper = operators.top();
-          operators.pop();
+      operators.push(work[i]);
+    }
+    else
+      operand += work[i];
+  }
+  if (valid)
+    valid = AddOperand(operand, postfix);
 
-          if (oper == '[')
-            break;
+  // finish up by adding any operators
+  while (!operators.empty())
+  {
+    postfix.push_back(-GetOperator(operators.top()));  // negative denotes operator
+    operators.pop();
+  }
 
-          m_postfix.push_back(-GetOperator(oper)); // negative denotes operator
-        }
-      }
-      else
-      {
-        // all other operators we pop off the stack any operator
-        // that has a higher priority than the one we have.
-        while (!operators.empty() && GetOperator(operators.top()) > GetOperator(expression[i]))
-        {
-          // only handle parenthesis once they're closed.
-          if (operators.top() == '[' && expression[i] != ']')
-            break;
-
-          m_postfix.push_back(-GetOperator(operators.top()));  // negative denotes operator
-          operators.pop();
-        }
-        operators.push(expression[i]);
-      }
+  // build the syntax tree
+  vector<Node> nodes;
+  vector<int> roots;
+  for (vector<short>::const_iterator it = postfix.begin(); valid && it != postfix.end(); ++it)
+  {
+    if (*it >= 0)
+      nodes.push_back(Node(*it));
+    else if (*it == -OPERATOR_NOT)
+    {
+      if (roots.empty())
+        break;
+      nodes.push_back(Node(*it, roots.back()));
+      roots.pop_back();
     }
     else
     {
-      operand += expression[i];
+      if (roots.size() < 2)
+        break;
+      nodes.push_back(Node(*it, roots[roots.size() - 2], roots.back()));
+      roots.resize(roots.size() - 2);
     }
+    roots.push_back(nodes.size() - 1);
   }
-
-  if (!operand.empty())
+  if (!valid || roots.size() != 1 || nodes.size() != postfix.size())
   {
-    InfoPtr info = g_infoManager.Register(operand, m_context);
-    if (info)
-    {
-      m_listItemDependent |= info->ListItemDependent();
-      m_postfix.push_back(m_operands.size());
-      m_operands.push_back(info);
-    }
+    CLog::Log(LOGERROR, "Error parsing boolean expression %s", expression.c_str());
+    return;
   }
 
-  // finish up by adding any operators
-  while (!operators.empty())
+  Compile(nodes, roots.back());
+  if (m_code.size() > USHRT_MAX)
   {
-    m_postfix.push_back(-GetOperator(operators.top()));  // negative denotes operator
-    operators.pop();
+    CLog::Log(LOGERROR, "Error parsing boolean expression %s", expression.c_str());
+    m_code.clear();
   }
+}
 
-  // test evaluate
-  bool test;
-  if (!Evaluate(NULL, test))
-    CLog::Log(LOGERROR, "Error evaluating boolean expression %s", expression.c_str());
+void InfoExpression::Compile(const vector<Node> &nodes, int node)
+{
+  const Node &n = nodes[node];
+  if (n.op >= 0)
+    m_code.push_back(Instruction(OP_OPERAND, n.op));
+  else if (n.op == -OPERATOR_NOT)
+  {
+    Compile(nodes, n.left);
+    m_code.push_back(Instruction(OP_NOT));
+  }
+  else
+  { // the right hand side is skipped if the left hand side decides the result
+    Compile(nodes, n.left);
+    size_t jump = m_code.size();
+    m_code.push_back(Instruction(n.op == -OPERATOR_AND ? OP_JUMP_IF_FALSE : OP_JUMP_IF_TRUE));
+    Compile(nodes, n.right);
+    m_code[jump].arg = m_code.size();
+  }
 }
 
 bool InfoExpression::Evaluate(const CGUIListItem *item, bool &result)
 {
-  stack<bool> save;
-  for (vector<short>::const_iterator it = m_postfix.begin(); it != m_postfix.end(); ++it)
+  if (m_code.empty())
+    return false;
+
+  bool value = false;
+  size_t pc = 0;
+  while (pc < m_code.size())
   {
-    short expr = *it;
-    if (expr == -OPERATOR_NOT)
-    { // NOT the top item on the stack
-      if (save.empty()) return false;
-      bool expr = save.top();
-      save.pop();
-      save.push(!expr);
-    }
-    else if (expr == -OPERATOR_AND)
-    { // AND the top two items on the stack
-      if (save.size() < 2) return false;
-      bool right = save.top(); save.pop();
-      bool left = save.top(); save.pop();
-      save.push(left && right);
-    }
-    else if (expr == -OPERATOR_OR)
-    { // OR the top two items on the stack
-      if (save.size() < 2) return false;
-      bool right = save.top(); save.pop();
-      bool left = save.top(); save.pop();
-      save.push(left || right);
+    const Instruction &instruction = m_code[pc++];
+    switch (instruction.code)
+    {
+    case OP_OPERAND:
+      value = m_operands[instruction.arg]->Get(item);
+      break;
+    case OP_NOT:
+      value = !value;
+      break;
+    case OP_JUMP_IF_FALSE:
+      if (!value)
+        pc = instruction.arg;
+      break;
+    case OP_JUMP_IF_TRUE:
+      if (value)
+        pc = instruction.arg;
+      break;
     }
-    else if (expr >= 0) // operand
-      save.push(m_operands[expr]->Get(item));
   }
-  if (save.size() != 1)
-    return false;
-  result = save.top();
+  result = value;
   return true;
 }
-
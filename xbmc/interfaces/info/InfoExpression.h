@@ -41,6 +41,11 @@ private:
 };
 
 /*! \brief Class to wrap active boolean expressions
+
+ The expression is compiled to a short program run with a single accumulator.
+ Operands are registered with the info manager, so they are shared with every
+ other expression using them and evaluated at most once per frame. Bracketed
+ subexpressions are registered as operands of their own for the same reason.
  */
 class InfoExpression : public InfoBool
 {
@@ -50,12 +55,39 @@ public:
 
   virtual void Update(const CGUIListItem *item);
 private:
+  enum OpCode
+  {
+    OP_OPERAND = 0,      ///< load operand arg into the accumulator
+    OP_NOT,              ///< negate the accumulator
+    OP_JUMP_IF_FALSE,    ///< continue at arg if the accumulator is false (AND)
+    OP_JUMP_IF_TRUE      ///< continue at arg if the accumulator is true (OR)
+  };
+
+  struct Instruction
+  {
+    Instruction(OpCode code, unsigned short arg = 0) : code(code), arg(arg) {};
+    unsigned short code;
+    unsigned short arg;
+  };
+
+  /*! \brief Node of the syntax tree, only used while compiling
+   */
+  struct Node
+  {
+    Node(int op, int left = -1, int right = -1) : op(op), left(left), right(right) {};
+    int op;              ///< operator, or operand index if >= 0
+    int left;
+    int right;
+  };
+
   void Parse(const std::string &expression);
+  bool AddOperand(const std::string &operand, std::vector<short> &postfix);
+  void Compile(const std::vector<Node> &nodes, int node);
   bool Evaluate(const CGUIListItem *item, bool &result);
   short GetOperator(const char ch) const;
 
-  std::vector<short> m_postfix;         ///< the postfix form of the expression (operators and operand indicies)
-  std::vector<InfoPtr> m_operands;      ///< the operands in the expression
+  std::vector<Instruction> m_code;      ///< the compiled expression
+  std::vector<InfoPtr> m_operands;      ///< the distinct operands in the expression
 };
 
 };
@@ -1494,6 +1494,28 @@ JSONRPC_STATUS CPlayerOperations::GetPropertyValue(PlayerType player, const CStd
   }
   else if (property.Equals("live"))
     result = IsPVRChannel();
+  else if (property.Equals("buffer"))
+  {
+    SPlayerBufferInfo info;
+    switch (player)
+    {
+      case Video:
+      case Audio:
+        g_application.m_pPlayer->GetBufferInfo(info);
+        break;
+
+      case Picture:
+      default:
+        break;
+    }
+
+    result = CVariant(CVariant::VariantTypeObject);
+    result["seconds"] = info.seconds;
+    result["target"] = info.target;
+    result["bytes"] = info.bytes;
+    result["budget"] = info.budget;
+    result["rate"] = info.rate;
+  }
   else
     return InvalidParams;
 
@@ -27,6 +27,7 @@
 #include "LangInfo.h"
 #include "PasswordManager.h"
 #include "Util.h"
+#include "cores/dvdplayer/DVDProbeCache.h"
 #include "dialogs/GUIDialogYesNo.h"
 #include "filesystem/Directory.h"
 #include "filesystem/DirectoryCache.h"
@@ -236,6 +237,7 @@ bool CProfilesManager::LoadProfile(size_t index)
 
   // unload any old settings
   CSettings::Get().Unload();
+  CDVDProbeCache::Get().Unload();
 
   SetCurrentProfileId(index);
 
@@ -221,6 +221,9 @@ void CPVRGUIInfo::Process(void)
     if (!m_bStop && mLoop % 10 == 0)
       UpdateBackendCache();    /* updated every 10 iterations */
 
+    /* infos depending on the values above are re-evaluated on the next frame */
+    g_infoManager.Invalidate(INFO::INFO_SOURCE_PVR);
+
     if (++mLoop == 1000)
       mLoop = 0;
 
@@ -739,6 +742,7 @@ void CPVRGUIInfo::UpdateTimersCache(void)
   }
 
   UpdateTimersToggle();
+  g_infoManager.Invalidate(INFO::INFO_SOURCE_PVR);
 }
 
 void CPVRGUIInfo::UpdateNextTimer(void)
@@ -413,6 +413,7 @@ void CPVRManager::SetState(ManagerState state)
     m_managerState = state;
     SetChanged();
   }
+  g_infoManager.Invalidate(INFO::INFO_SOURCE_PVR);
 
   NotifyObservers(ObservableMessageManagerStateChanged);
 }
@@ -25,6 +25,7 @@
 #ifdef HAS_GL
 #include "system_gl.h"
 #include "GUIWindowTestPatternGL.h"
+#include "guilib/GUIRenderBatch.h"
 
 CGUIWindowTestPatternGL::CGUIWindowTestPatternGL(void) : CGUIWindowTestPattern()
 {
@@ -191,6 +192,7 @@ void CGUIWindowTestPatternGL::DrawCircle(int originX, int originY, int radius)
 
 void CGUIWindowTestPatternGL::BeginRender()
 {
+  CGUIRenderBatch::Get().Flush();
   glDisable(GL_TEXTURE_2D);
   glDisable(GL_BLEND);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -324,6 +324,7 @@ void CAdvancedSettings::Initialize()
   m_startFullScreen = false;
   m_showExitButton = true;
   m_splashImage = true;
+  m_startupTrace = false;
 
   m_playlistRetries = 100;
   m_playlistTimeout = 20; // 20 seconds timeout
@@ -365,6 +366,8 @@ void CAdvancedSettings::Initialize()
   m_measureRefreshrate = false;
 
   m_cacheMemBufferSize = 1024 * 1024 * 20;
+  m_bufferMemory = 1024 * 1024 * 64; // input cache and demuxed packets together
+  m_bufferSeconds = 8.0f;
   m_networkBufferMode = 0; // Default (buffer all internet streams/filesystems)
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
@@ -380,6 +383,9 @@ void CAdvancedSettings::Initialize()
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 3;
   m_guiDirtyRegionNoFlipTimeout = 0;
+  m_guiSkinCache = true;
+  m_guiLargeTextureMemory = 128;
+  m_guiPredecodeTextures = true;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
 
@@ -800,6 +806,8 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
     XMLUtils::GetUInt(pElement, "cachemembuffersize", m_cacheMemBufferSize);
+    XMLUtils::GetUInt(pElement, "buffermemory", m_bufferMemory);
+    XMLUtils::GetFloat(pElement, "bufferseconds", m_bufferSeconds, 2.0f, 600.0f);
     XMLUtils::GetUInt(pElement, "buffermode", m_networkBufferMode, 0, 3);
     XMLUtils::GetFloat(pElement, "readbufferfactor", m_readBufferFactor);
   }
@@ -860,6 +868,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   XMLUtils::GetBoolean(pRootElement, "fullscreen", m_startFullScreen);
 #endif
   XMLUtils::GetBoolean(pRootElement, "splash", m_splashImage);
+  XMLUtils::GetBoolean(pRootElement, "startuptrace", m_startupTrace);
   XMLUtils::GetBoolean(pRootElement, "showexitbutton", m_showExitButton);
   XMLUtils::GetBoolean(pRootElement, "canwindowed", m_canWindowed);
 
@@ -1180,6 +1189,9 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
     XMLUtils::GetInt(pElement, "nofliptimeout",             m_guiDirtyRegionNoFlipTimeout);
+    XMLUtils::GetBoolean(pElement, "skincache",             m_guiSkinCache);
+    XMLUtils::GetInt(pElement, "largetexturememory",        m_guiLargeTextureMemory, 16, 4096);
+    XMLUtils::GetBoolean(pElement, "predecodetextures",     m_guiPredecodeTextures);
   }
 
   // load in the settings overrides
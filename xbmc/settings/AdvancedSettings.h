@@ -330,6 +330,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_showExitButton; /* Ideal for appliances to hide a 'useless' button */
     bool m_canWindowed;
     bool m_splashImage;
+    bool m_startupTrace; /* writes the startup stages to xbmc-startup.json in the log folder */
     bool m_alwaysOnTop;  /* makes xbmc to run always on top .. osx/win32 only .. */
     int m_playlistRetries;
     int m_playlistTimeout;
@@ -378,9 +379,14 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
     int  m_guiDirtyRegionNoFlipTimeout;
+    bool m_guiSkinCache;
+    int  m_guiLargeTextureMemory;
+    bool m_guiPredecodeTextures;
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemBufferSize;
+    unsigned int m_bufferMemory;
+    float m_bufferSeconds;
     unsigned int m_networkBufferMode;
     float m_readBufferFactor;
 
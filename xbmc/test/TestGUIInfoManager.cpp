@@ -0,0 +1,262 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIInfoManager.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "guilib/GUIInfoTypes.h"
+#include "guilib/WindowIDs.h"
+#include "settings/SkinSettings.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace INFO;
+
+/* random expression over true and false, and its value */
+static std::string RandomExpression(int depth, bool &value)
+{
+  int type = depth ? rand() % 5 : rand() % 2;
+  if (type < 2)
+  {
+    value = type == 0;
+    return value ? "true" : "false";
+  }
+  if (type == 2)
+  {
+    std::string expression = "!" + RandomExpression(depth - 1, value);
+    value = !value;
+    return expression;
+  }
+  // bracket the operands so precedence doesn't matter for the value
+  bool left, right;
+  std::string expression = "[" + RandomExpression(depth - 1, left) + (type == 3 ? " + " : " | ") +
+                           RandomExpression(depth - 1, right) + "]";
+  value = type == 3 ? left && right : left || right;
+  return expression;
+}
+
+/* all the <visible> and <enable> conditions and condition attributes below an element */
+static void CollectConditions(const TiXmlElement *element, int context, std::vector<InfoPtr> &infos)
+{
+  if ((element->ValueStr() == "visible" || element->ValueStr() == "enable") && element->FirstChild())
+  {
+    InfoPtr info = g_infoManager.Register(element->FirstChild()->ValueStr(), context);
+    if (info)
+      infos.push_back(info);
+  }
+  if (const char *condition = element->Attribute("condition"))
+  {
+    InfoPtr info = g_infoManager.Register(condition, context);
+    if (info)
+      infos.push_back(info);
+  }
+  for (const TiXmlElement *child = element->FirstChildElement(); child; child = child->NextSiblingElement())
+    CollectConditions(child, context, infos);
+}
+
+TEST(TestGUIInfoManager, Sources)
+{
+  EXPECT_EQ((unsigned int)INFO_SOURCE_NONE, g_infoManager.Register("system.platform.linux")->GetSources());
+  EXPECT_EQ((unsigned int)INFO_SOURCE_SKIN, g_infoManager.Register("skin.hassetting(infotest)")->GetSources());
+  EXPECT_EQ((unsigned int)INFO_SOURCE_PLAYER, g_infoManager.Register("player.paused")->GetSources());
+  EXPECT_EQ((unsigned int)INFO_SOURCE_LIBRARY, g_infoManager.Register("library.hascontent(music)")->GetSources());
+  EXPECT_EQ((unsigned int)INFO_SOURCE_PVR, g_infoManager.Register("pvr.isrecording")->GetSources());
+  EXPECT_EQ((unsigned int)INFO_SOURCE_TIME, g_infoManager.Register("system.time(08:00,17:00)")->GetSources());
+  EXPECT_EQ((unsigned int)INFO_SOURCE_FRAME, g_infoManager.Register("window.isvisible(home)")->GetSources());
+
+  // expressions depend on all their operands
+  EXPECT_EQ((unsigned int)(INFO_SOURCE_SKIN | INFO_SOURCE_PLAYER),
+            g_infoManager.Register("[skin.hassetting(infotest) | !player.hasmedia] + system.platform.linux")->GetSources());
+}
+
+TEST(TestGUIInfoManager, Expressions)
+{
+  EXPECT_TRUE(g_infoManager.EvaluateBool("true + !false"));
+  EXPECT_TRUE(g_infoManager.EvaluateBool("false + false | true"));
+  EXPECT_FALSE(g_infoManager.EvaluateBool("false + [false | true]"));
+  EXPECT_TRUE(g_infoManager.EvaluateBool("![[false]]"));
+  EXPECT_FALSE(g_infoManager.EvaluateBool("!true | !true + true"));
+
+  // malformed expressions are false
+  EXPECT_FALSE(g_infoManager.EvaluateBool("true + "));
+  EXPECT_FALSE(g_infoManager.EvaluateBool("[true | false"));
+  EXPECT_FALSE(g_infoManager.EvaluateBool("true]"));
+  EXPECT_FALSE(g_infoManager.EvaluateBool("true [true]"));
+
+  srand(42);
+  for (int i = 0; i < 500; i++)
+  {
+    bool value;
+    std::string expression = RandomExpression(6, value);
+    EXPECT_EQ(value, g_infoManager.EvaluateBool(expression)) << expression;
+  }
+}
+
+TEST(TestGUIInfoManager, SharedOperands)
+{
+  int setting = CSkinSettings::Get().TranslateBool("infotest");
+  CSkinSettings::Get().SetBool(setting, true);
+  g_infoManager.ResetCache();
+
+  // the operand is evaluated once, and false is never needed
+  InfoPtr info = g_infoManager.Register("[skin.hassetting(infotest) | false] + [skin.hassetting(infotest) | false] + skin.hassetting(infotest)");
+  unsigned int bools, labels;
+  g_infoManager.GetEvaluations(bools, labels);
+  EXPECT_TRUE(info->Get());
+  g_infoManager.GetEvaluations(bools, labels);
+  EXPECT_EQ(1u, bools);
+
+  // the right hand side isn't evaluated if the left hand side decides the value
+  CSkinSettings::Get().SetBool(setting, false);
+  g_infoManager.ResetCache();
+  info = g_infoManager.Register("skin.hassetting(infotest) + [false | true]");
+  g_infoManager.GetEvaluations(bools, labels);
+  EXPECT_FALSE(info->Get());
+  g_infoManager.GetEvaluations(bools, labels);
+  EXPECT_EQ(1u, bools);
+}
+
+TEST(TestGUIInfoManager, SkinSettingBool)
+{
+  int setting = CSkinSettings::Get().TranslateBool("infotest");
+  CSkinSettings::Get().SetBool(setting, false);
+  g_infoManager.ResetCache();
+
+  InfoPtr info = g_infoManager.Register("!skin.hassetting(infotest) + true");
+  InfoPtr constant = g_infoManager.Register("true");
+  EXPECT_TRUE(info->Get());
+
+  // the change is picked up at the end of the frame
+  CSkinSettings::Get().SetBool(setting, true);
+  EXPECT_TRUE(info->Get());
+  g_infoManager.ResetFrameCache();
+  EXPECT_FALSE(info->Get());
+
+  // nothing changed, so nothing is evaluated again
+  unsigned int bools, labels;
+  g_infoManager.GetEvaluations(bools, labels);
+  g_infoManager.ResetFrameCache();
+  info->Get();
+  constant->Get();
+  g_infoManager.GetEvaluations(bools, labels);
+  EXPECT_EQ(0u, bools);
+
+  CSkinSettings::Get().SetBool(setting, false);
+  g_infoManager.ResetFrameCache();
+  EXPECT_TRUE(info->Get());
+}
+
+TEST(TestGUIInfoManager, SkinSettingLabel)
+{
+  int setting = CSkinSettings::Get().TranslateString("infotest");
+  CSkinSettings::Get().SetString(setting, "");
+  g_infoManager.ResetCache();
+
+  CGUIInfoLabel label("[$INFO[Skin.String(infotest)]]", "fallback");
+  EXPECT_STREQ("[]", label.GetLabel(0).c_str());
+
+  CSkinSettings::Get().SetString(setting, "value");
+  EXPECT_STREQ("[]", label.GetLabel(0).c_str());
+  g_infoManager.ResetFrameCache();
+  EXPECT_STREQ("[value]", label.GetLabel(0).c_str());
+
+  CSkinSettings::Get().SetString(setting, "");
+}
+
+/* run with --gtest_also_run_disabled_tests */
+TEST(TestGUIInfoManager, DISABLED_Benchmark)
+{
+  // the visibility conditions of the home window, without includes
+  CXBMCTinyXML doc;
+  ASSERT_TRUE(doc.LoadFile(XBMC_REF_FILE_PATH("/addons/skin.confluence/720p/Home.xml")));
+  std::vector<InfoPtr> infos;
+  std::vector<TiXmlElement *> elements(1, doc.RootElement());
+  while (!elements.empty())
+  {
+    TiXmlElement *element = elements.back();
+    elements.pop_back();
+    if (element->ValueStr() == "visible" && element->FirstChild())
+    {
+      InfoPtr info = g_infoManager.Register(element->FirstChild()->ValueStr(), WINDOW_HOME);
+      if (info)
+        infos.push_back(info);
+    }
+    for (TiXmlElement *child = element->FirstChildElement(); child; child = child->NextSiblingElement())
+      elements.push_back(child);
+  }
+
+  const int frames = 100;
+  unsigned int bools, labels;
+  for (int tracked = 0; tracked < 2; tracked++)
+  {
+    g_infoManager.ResetCache();
+    g_infoManager.GetEvaluations(bools, labels);
+    int64_t start = CurrentHostCounter();
+    for (int frame = 0; frame < frames; frame++)
+    {
+      for (std::vector<InfoPtr>::const_iterator i = infos.begin(); i != infos.end(); ++i)
+        (*i)->Get();
+      if (tracked)
+        g_infoManager.ResetFrameCache();
+      else
+        g_infoManager.ResetCache();
+    }
+    double time = (double)(CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency() / frames;
+    g_infoManager.GetEvaluations(bools, labels);
+    printf("%-10s %5d conditions, %8.1f evaluations and %.3fms per frame\n",
+           tracked ? "tracked" : "untracked", (int)infos.size(), (double)bools / frames, time);
+  }
+}
+
+/* run with --gtest_also_run_disabled_tests */
+TEST(TestGUIInfoManager, DISABLED_ExpressionBenchmark)
+{
+  // the conditions of all the skin windows, evaluated from scratch every frame
+  CFileItemList items;
+  ASSERT_TRUE(XFILE::CDirectory::GetDirectory(XBMC_REF_FILE_PATH("/addons/skin.confluence/720p"), items, ".xml"));
+  std::vector<InfoPtr> infos;
+  for (int i = 0; i < items.Size(); i++)
+  {
+    CXBMCTinyXML doc;
+    if (doc.LoadFile(items[i]->GetPath()))
+      CollectConditions(doc.RootElement(), WINDOW_HOME, infos);
+  }
+
+  const int frames = 100;
+  int64_t start = CurrentHostCounter();
+  for (int frame = 0; frame < frames; frame++)
+  {
+    g_infoManager.ResetCache();
+    for (std::vector<InfoPtr>::const_iterator i = infos.begin(); i != infos.end(); ++i)
+      (*i)->Get();
+  }
+  double time = (double)(CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency() / frames;
+  unsigned int bools, labels;
+  g_infoManager.GetEvaluations(bools, labels);
+  printf("%d conditions, %.1f single evaluations and %.3fms per frame\n",
+         (int)infos.size(), (double)bools / frames, time);
+}
@@ -0,0 +1,357 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUILargeTextureManager.h"
+#include "guilib/Texture.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+
+#define IMAGE_BYTES(size) ((uint64_t)(size) * (size) * 4)
+
+/* loads are held until the test completes them, and produce an empty image of the requested size */
+class CTestLargeTextureManager : public CGUILargeTextureManager
+{
+public:
+  CTestLargeTextureManager() : m_nextID(0) {}
+
+  ~CTestLargeTextureManager()
+  {
+    for (std::vector<std::pair<unsigned int, CImageLoader *> >::iterator i = m_loaders.begin(); i != m_loaders.end(); ++i)
+      delete i->second;
+  }
+
+  virtual unsigned int StartLoader(CImageLoader *loader)
+  {
+    m_loaders.push_back(std::make_pair(++m_nextID, loader));
+    m_started.push_back(loader->m_path);
+    return m_nextID;
+  }
+
+  virtual void CancelLoader(unsigned int jobID)
+  {
+    for (std::vector<std::pair<unsigned int, CImageLoader *> >::iterator i = m_loaders.begin(); i != m_loaders.end(); ++i)
+    {
+      if (i->first == jobID)
+      {
+        delete i->second;
+        m_loaders.erase(i);
+        return;
+      }
+    }
+  }
+
+  /* complete the oldest load */
+  bool Complete()
+  {
+    if (m_loaders.empty())
+      return false;
+    std::pair<unsigned int, CImageLoader *> job = m_loaders.front();
+    m_loaders.erase(m_loaders.begin());
+    unsigned int size = job.second->m_size ? job.second->m_size : 1024;
+    job.second->m_texture = new CTexture(size, size);
+    OnJobComplete(job.first, true, job.second);
+    delete job.second;
+    return true;
+  }
+
+  std::vector<std::pair<unsigned int, CImageLoader *> > m_loaders;
+  std::vector<std::string> m_started;
+  unsigned int m_nextID;
+};
+
+static std::string Path(int i)
+{
+  return StringUtils::Format("special://test/fanart%d.jpg", i);
+}
+
+TEST(TestGUILargeTextureManager, Priority)
+{
+  CTestLargeTextureManager manager;
+  CTextureArray texture;
+
+  // loads start once a frame, most important first
+  for (int i = 0; i < 7; i++)
+    manager.GetImage(Path(i), texture, true, true, 128, 100.0f * (7 - i));
+  EXPECT_EQ(0u, manager.m_started.size());
+  manager.ProcessQueue();
+  ASSERT_EQ(4u, manager.m_started.size());
+  EXPECT_EQ(Path(6), manager.m_started[0]);
+  EXPECT_EQ(Path(3), manager.m_started[3]);
+
+  // priorities follow the image as it moves
+  manager.GetImage(Path(0), texture, false, true, 128, 50.0f);
+
+  while (manager.Complete()) {}
+  ASSERT_EQ(7u, manager.m_started.size());
+  EXPECT_EQ(Path(0), manager.m_started[4]);
+  EXPECT_EQ(Path(2), manager.m_started[5]);
+  EXPECT_EQ(Path(1), manager.m_started[6]);
+
+  EXPECT_TRUE(manager.GetImage(Path(5), texture, false, true, 128));
+  EXPECT_EQ(1u, texture.size());
+  EXPECT_EQ(128, texture.m_width);
+
+  // the same image at another size is another image
+  manager.GetImage(Path(5), texture, true, true, 256);
+  manager.ProcessQueue();
+  EXPECT_EQ(8u, manager.m_started.size());
+  while (manager.Complete()) {}
+
+  for (int i = 0; i < 7; i++)
+    manager.ReleaseImage(Path(i), true, 128);
+  manager.ReleaseImage(Path(5), true, 256);
+
+  SLargeTextureStats stats;
+  manager.GetStats(stats);
+  EXPECT_EQ(0u, stats.loaded);
+  EXPECT_EQ(0u, stats.loadedBytes);
+}
+
+TEST(TestGUILargeTextureManager, Cancel)
+{
+  CTestLargeTextureManager manager;
+  CTextureArray texture;
+  for (int i = 0; i < 6; i++)
+    manager.GetImage(Path(i), texture, true, true, 128, (float)i);
+  manager.ProcessQueue();
+
+  SLargeTextureStats stats;
+  manager.GetStats(stats);
+  EXPECT_EQ(4u, stats.loading);
+  EXPECT_EQ(2u, stats.queued);
+
+  // released while waiting, so never loaded
+  manager.ReleaseImage(Path(5), false, 128);
+  // released while loading, so the load is cancelled and the next one starts
+  manager.ReleaseImage(Path(0), false, 128);
+  manager.GetStats(stats);
+  EXPECT_EQ(2u, stats.cancelled);
+  EXPECT_EQ(4u, stats.loading);
+  EXPECT_EQ(0u, stats.queued);
+  EXPECT_EQ(4u, manager.m_loaders.size());
+
+  // an image requested twice is only cancelled once both are done with it
+  manager.GetImage(Path(1), texture, true, true, 128);
+  manager.ReleaseImage(Path(1), false, 128);
+  manager.GetStats(stats);
+  EXPECT_EQ(4u, stats.loading);
+
+  while (manager.Complete()) {}
+  EXPECT_EQ(5u, manager.m_started.size());
+  for (int i = 1; i < 5; i++)
+    manager.ReleaseImage(Path(i), true, 128);
+}
+
+TEST(TestGUILargeTextureManager, Budget)
+{
+  CTestLargeTextureManager manager;
+  manager.SetBudget(IMAGE_BYTES(128) * 3);
+  CTextureArray texture;
+
+  for (int i = 0; i < 5; i++)
+    manager.GetImage(Path(i), texture, true, true, 128);
+  manager.ProcessQueue();
+  while (manager.Complete()) {}
+
+  // images in use are kept however much memory they take
+  SLargeTextureStats stats;
+  manager.GetStats(stats);
+  EXPECT_EQ(5u, stats.loaded);
+  EXPECT_EQ(IMAGE_BYTES(128) * 5, stats.loadedBytes);
+  manager.CleanupUnusedImages();
+  manager.GetStats(stats);
+  EXPECT_EQ(5u, stats.loaded);
+
+  // unused images are freed early, least recently used first
+  for (int i = 0; i < 5; i++)
+    manager.ReleaseImage(Path(i), false, 128);
+  manager.CleanupUnusedImages();
+  manager.GetStats(stats);
+  EXPECT_EQ(3u, stats.loaded);
+  EXPECT_EQ(3u, stats.unused);
+  EXPECT_EQ(2u, stats.evicted);
+  EXPECT_EQ(IMAGE_BYTES(128) * 3, stats.loadedBytes);
+  EXPECT_TRUE(manager.GetImage(Path(2), texture, true, true, 128));
+  EXPECT_EQ(1u, texture.size());
+  manager.ReleaseImage(Path(2), false, 128);
+
+  // with the budget used up by images in use, images off screen aren't loaded
+  manager.CleanupUnusedImages(true);
+  for (int i = 0; i < 3; i++)
+    manager.GetImage(Path(i), texture, true, true, 128);
+  manager.ProcessQueue();
+  while (manager.Complete()) {}
+  manager.GetImage(Path(3), texture, true, true, 128, 2000000.0f);
+  manager.ProcessQueue();
+  manager.GetStats(stats);
+  EXPECT_EQ(1u, stats.queued);
+  manager.GetImage(Path(4), texture, true, true, 128, 10.0f);
+  manager.ProcessQueue();
+  manager.GetStats(stats);
+  EXPECT_EQ(1u, stats.queued);
+  EXPECT_EQ(1u, stats.loading);
+
+  // until there's room again
+  while (manager.Complete()) {}
+  for (int i = 0; i < 3; i++)
+    manager.ReleaseImage(Path(i), true, 128);
+  manager.CleanupUnusedImages();
+  manager.GetStats(stats);
+  EXPECT_EQ(0u, stats.queued);
+  EXPECT_EQ(1u, stats.loading);
+
+  while (manager.Complete()) {}
+  manager.ReleaseImage(Path(3), true, 128);
+  manager.ReleaseImage(Path(4), true, 128);
+}
+
+TEST(TestGUILargeTextureManager, SizeAndPriority)
+{
+  EXPECT_EQ(128u, CGUILargeTextureManager::GetLoadSize(100.0f, 50.0f));
+  EXPECT_EQ(512u, CGUILargeTextureManager::GetLoadSize(300.0f, 400.0f));
+  EXPECT_EQ(0u, CGUILargeTextureManager::GetLoadSize(4000.0f, 4000.0f));
+  // auto sized, the image could be any size
+  EXPECT_EQ(0u, CGUILargeTextureManager::GetLoadSize(0.0f, 200.0f));
+  EXPECT_EQ(0u, CGUILargeTextureManager::GetLoadSize(300.0f, 0.0f));
+
+  CTestLargeTextureManager manager;
+  manager.SetFocus(CRect(100.0f, 100.0f, 200.0f, 200.0f));
+  EXPECT_EQ(0.0f, manager.GetPriority(CRect(100.0f, 100.0f, 200.0f, 200.0f)));
+  EXPECT_EQ(50.0f, manager.GetPriority(CRect(130.0f, 140.0f, 230.0f, 240.0f)));
+  EXPECT_LT(manager.GetPriority(CRect(400.0f, 400.0f, 500.0f, 500.0f)), manager.GetPriority(CRect(100.0f, -200.0f, 200.0f, -100.0f)));
+}
+
+/* a panel of fanart, 5 columns with 3 rows on screen and one more above and below kept loaded */
+class CPanelSimulation
+{
+public:
+  CPanelSimulation(CTestLargeTextureManager &manager, bool prioritize) : m_manager(manager), m_prioritize(prioritize)
+  {
+    m_top = 0;
+    m_missing = 0;
+    m_frames = 0;
+    m_peakBytes = 0;
+    m_loads = 0;
+  }
+
+  void Frame(int top)
+  {
+    // release the items that are no longer kept, and request the new ones
+    for (int row = m_top - 1; row <= m_top + 3; row++)
+    {
+      if (row >= 0 && (row < top - 1 || row > top + 3))
+      {
+        for (int column = 0; column < 5; column++)
+          m_manager.ReleaseImage(Path(row * 5 + column), false, SIZE);
+      }
+    }
+    m_manager.SetFocus(Rect(top + 1, 2, top));
+    for (int row = std::max(top - 1, 0); row <= top + 3; row++)
+    {
+      for (int column = 0; column < 5; column++)
+      {
+        bool first = row < m_top - 1 || row > m_top + 3 || m_frames == 0;
+        float priority = m_prioritize ? m_manager.GetPriority(Rect(row, column, top)) : 0.0f;
+        CTextureArray texture;
+        m_manager.GetImage(Path(row * 5 + column), texture, first, true, SIZE, priority);
+        if (row >= top && row < top + 3 && !texture.size())
+          m_missing++;
+      }
+    }
+    m_top = top;
+    m_frames++;
+    m_manager.ProcessQueue();
+
+    // images take about 4 frames each to decode, with 4 at a time
+    if (m_manager.Complete())
+      m_loads++;
+    m_manager.CleanupUnusedImages();
+
+    SLargeTextureStats stats;
+    m_manager.GetStats(stats);
+    m_peakBytes = std::max(m_peakBytes, stats.loadedBytes);
+  }
+
+  void Finish()
+  {
+    for (int row = std::max(m_top - 1, 0); row <= m_top + 3; row++)
+    {
+      for (int column = 0; column < 5; column++)
+        m_manager.ReleaseImage(Path(row * 5 + column), true, SIZE);
+    }
+    m_manager.CleanupUnusedImages(true);
+  }
+
+  static const unsigned int SIZE = 256;
+
+  static CRect Rect(int row, int column, int top)
+  {
+    return CRect(column * 144.0f, (row - top) * 192.0f, (column + 1) * 144.0f, (row - top + 1) * 192.0f);
+  }
+
+  CTestLargeTextureManager &m_manager;
+  bool m_prioritize;
+  int m_top;
+  int m_frames;
+  unsigned int m_missing;   ///< images on screen that weren't loaded, summed over the frames
+  unsigned int m_loads;
+  uint64_t m_peakBytes;
+};
+
+/* run with --gtest_also_run_disabled_tests */
+TEST(TestGUILargeTextureManager, DISABLED_Benchmark)
+{
+  const char *patterns[] = { "slow scroll", "fast scroll", "page down", "page up" };
+  for (int pattern = 0; pattern < 4; pattern++)
+  {
+    for (int prioritize = 0; prioritize < 2; prioritize++)
+    {
+      CTestLargeTextureManager manager;
+      manager.SetBudget(IMAGE_BYTES(CPanelSimulation::SIZE) * 40);
+      CPanelSimulation panel(manager, prioritize != 0);
+
+      // 200 frames of scrolling, then 100 frames to settle
+      for (int frame = 0; frame < 300; frame++)
+      {
+        int scroll = std::min(frame, 200);
+        int top;
+        if (pattern == 0)
+          top = scroll / 10;
+        else if (pattern == 1)
+          top = scroll / 2;
+        else if (pattern == 2)
+          top = scroll / 20 * 3;
+        else
+          top = 30 - scroll / 20 * 3;
+        panel.Frame(top);
+      }
+      SLargeTextureStats stats;
+      manager.GetStats(stats);
+      panel.Finish();
+
+      printf("%-12s %-8s %6u missing, %4u loads, %4u cancelled, %4u evicted, %5.1fMB peak\n",
+             patterns[pattern], prioritize ? "priority" : "fifo", panel.m_missing, panel.m_loads,
+             stats.cancelled, stats.evicted, (double)panel.m_peakBytes / (1024 * 1024));
+    }
+  }
+}
@@ -229,6 +229,11 @@ std::vector<CStdString> &CXBMCTestUtils::getGUISettingsFiles()
   return GUISettingsFiles;
 }
 
+CStdString &CXBMCTestUtils::getMediaSamplesDirectory()
+{
+  return MediaSamplesDirectory;
+}
+
 static const char usage[] =
 "XBMC Test Suite\n"
 "Usage: xbmc-test [options]\n"
@@ -266,6 +271,9 @@ static const char usage[] =
 "    Add multiple GUI settings files from a ',' delimited string of\n"
 "    files to be loaded in test cases that use them.\n"
 "\n"
+"  --set-media-samples-dir [DIR]\n"
+"    Set the directory of media files used by the (disabled) benchmark tests.\n"
+"\n"
 "  --set-probability [PROBABILITY]\n"
 "    Set the probability variable used by the file corrupting functions.\n"
 "    The variable should be a double type from 0.0 to 1.0. Values given\n"
@@ -332,6 +340,10 @@ void CXBMCTestUtils::ParseArgs(int argc, char **argv)
       for (it = urls.begin(); it < urls.end(); it++)
         GUISettingsFiles.push_back(*it);
     }
+    else if (arg == "--set-media-samples-dir")
+    {
+      MediaSamplesDirectory = argv[++i];
+    }
     else if (arg == "--set-probability")
     {
       probability = atof(argv[++i]);
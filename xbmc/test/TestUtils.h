@@ -75,6 +75,9 @@ public:
   /* Function to get GUI settings files. */
   std::vector<CStdString> &getGUISettingsFiles();
 
+  /* Function to get the directory of media files used by benchmarks. */
+  CStdString &getMediaSamplesDirectory();
+
   /* Function used in creating a corrupted file. The parameters are a URL
    * to the original file to be corrupted and a suffix to append to the
    * path of the newly created file. This will return a XFILE::CFile
@@ -101,6 +104,8 @@ private:
   std::vector<CStdString> AdvancedSettingsFiles;
   std::vector<CStdString> GUISettingsFiles;
 
+  CStdString MediaSamplesDirectory;
+
   double probability;
 };
 
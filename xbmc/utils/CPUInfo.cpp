@@ -170,6 +170,8 @@ CCPUInfo::CCPUInfo(void)
           m_cpuFeatures |= CPU_FEATURE_SSE4;
         else if (0 == strcmp(tok, "SSE4.2"))
           m_cpuFeatures |= CPU_FEATURE_SSE42;
+        else if (0 == strcmp(tok, "AVX1.0"))
+          m_cpuFeatures |= CPU_FEATURE_AVX;
         tok = strtok_r(NULL, " ", &save);
       }
     }
@@ -369,6 +371,10 @@ CCPUInfo::CCPUInfo(void)
               m_cpuFeatures |= CPU_FEATURE_SSE4;
             else if (0 == strcmp(tok, "sse4_2"))
               m_cpuFeatures |= CPU_FEATURE_SSE42;
+            else if (0 == strcmp(tok, "avx"))
+              m_cpuFeatures |= CPU_FEATURE_AVX;
+            else if (0 == strcmp(tok, "avx2"))
+              m_cpuFeatures |= CPU_FEATURE_AVX2;
             else if (0 == strcmp(tok, "3dnow"))
               m_cpuFeatures |= CPU_FEATURE_3DNOW;
             else if (0 == strcmp(tok, "3dnowext"))
@@ -166,6 +166,12 @@ bool CJobQueue::QueueEmpty() const
   return m_jobQueue.empty();
 }
 
+bool CJobQueue::IsProcessing() const
+{
+  CSingleLock lock(m_section);
+  return !m_processing.empty() || !m_jobQueue.empty();
+}
+
 CJobManager &CJobManager::GetInstance()
 {
   static CJobManager sJobManager;
@@ -135,6 +135,11 @@ public:
    */
   virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
 
+  /*!
+   \brief Returns if we still have jobs waiting to be processed or currently processing
+   */
+  bool IsProcessing() const;
+
 protected:
   /*!
    \brief Returns if we still have jobs waiting to be processed
@@ -0,0 +1,255 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SpectrumAnalyser.h"
+#include <math.h>
+
+#ifdef TARGET_WINDOWS
+#if _M_IX86_FP>0 && !defined(__SSE__)
+#define __SSE__
+#endif
+#endif
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* position of frequency k in the output of a decimation in frequency
+ * transform of the given size, radix-4 stages and a final radix-2 stage */
+static unsigned int OutputPosition(unsigned int k, unsigned int size)
+{
+  if (size <= 2)
+    return k;
+  return (k % 4) * (size / 4) + OutputPosition(k / 4, size / 4);
+}
+
+CSpectrumAnalyser::CSpectrumAnalyser(unsigned int size)
+{
+  m_size = size;
+  m_windowFrames = 0;
+  m_window.resize(m_size);
+  m_re.resize(m_size);
+  m_im.resize(m_size);
+  m_orderedRe.resize(m_size);
+  m_orderedIm.resize(m_size);
+
+  m_permutation.resize(m_size);
+  for (unsigned int k = 0; k < m_size; k++)
+    m_permutation[k] = OutputPosition(k, m_size);
+
+  for (unsigned int length = m_size; length >= 4; length /= 4)
+  {
+    unsigned int quarter = length / 4;
+    size_t offset = m_twiddles.size();
+    m_twiddles.resize(offset + 6 * quarter);
+    float *w = &m_twiddles[offset];
+    for (unsigned int j = 0; j < quarter; j++)
+    {
+      for (unsigned int n = 1; n <= 3; n++)
+      {
+        double angle = -2.0 * M_PI * n * j / length;
+        w[(2 * n - 2) * quarter + j] = (float)cos(angle);
+        w[(2 * n - 1) * quarter + j] = (float)sin(angle);
+      }
+    }
+  }
+}
+
+void CSpectrumAnalyser::PrepareWindow(unsigned int frames)
+{
+  if (frames == m_windowFrames)
+    return;
+
+  for (unsigned int i = 0; i < frames; i++)
+    m_window[i] = (float)(0.5 * (1.0 - cos(2.0 * M_PI * i / frames)));
+  m_windowFrames = frames;
+}
+
+void CSpectrumAnalyser::Transform()
+{
+  float *re = &m_re[0];
+  float *im = &m_im[0];
+  const float *twiddles = &m_twiddles[0];
+
+  unsigned int length = m_size;
+  for (; length >= 4; length /= 4)
+  {
+    const unsigned int q = length / 4;
+    const float *w1r = twiddles;
+    const float *w1i = w1r + q;
+    const float *w2r = w1i + q;
+    const float *w2i = w2r + q;
+    const float *w3r = w2i + q;
+    const float *w3i = w3r + q;
+    twiddles += 6 * q;
+
+    for (unsigned int block = 0; block < m_size; block += length)
+    {
+      float *r0 = re + block, *r1 = r0 + q, *r2 = r1 + q, *r3 = r2 + q;
+      float *i0 = im + block, *i1 = i0 + q, *i2 = i1 + q, *i3 = i2 + q;
+      unsigned int j = 0;
+#ifdef __SSE__
+      for (; j + 4 <= q; j += 4)
+      {
+        __m128 a0r = _mm_loadu_ps(r0 + j), a0i = _mm_loadu_ps(i0 + j);
+        __m128 a1r = _mm_loadu_ps(r1 + j), a1i = _mm_loadu_ps(i1 + j);
+        __m128 a2r = _mm_loadu_ps(r2 + j), a2i = _mm_loadu_ps(i2 + j);
+        __m128 a3r = _mm_loadu_ps(r3 + j), a3i = _mm_loadu_ps(i3 + j);
+
+        __m128 t0r = _mm_add_ps(a0r, a2r), t0i = _mm_add_ps(a0i, a2i);
+        __m128 t1r = _mm_sub_ps(a0r, a2r), t1i = _mm_sub_ps(a0i, a2i);
+        __m128 t2r = _mm_add_ps(a1r, a3r), t2i = _mm_add_ps(a1i, a3i);
+        // (a1 - a3) * -i
+        __m128 t3r = _mm_sub_ps(a1i, a3i), t3i = _mm_sub_ps(a3r, a1r);
+
+        _mm_storeu_ps(r0 + j, _mm_add_ps(t0r, t2r));
+        _mm_storeu_ps(i0 + j, _mm_add_ps(t0i, t2i));
+
+        __m128 yr, yi, wr, wi;
+        yr = _mm_add_ps(t1r, t3r); yi = _mm_add_ps(t1i, t3i);
+        wr = _mm_loadu_ps(w1r + j); wi = _mm_loadu_ps(w1i + j);
+        _mm_storeu_ps(r1 + j, _mm_sub_ps(_mm_mul_ps(yr, wr), _mm_mul_ps(yi, wi)));
+        _mm_storeu_ps(i1 + j, _mm_add_ps(_mm_mul_ps(yr, wi), _mm_mul_ps(yi, wr)));
+
+        yr = _mm_sub_ps(t0r, t2r); yi = _mm_sub_ps(t0i, t2i);
+        wr = _mm_loadu_ps(w2r + j); wi = _mm_loadu_ps(w2i + j);
+        _mm_storeu_ps(r2 + j, _mm_sub_ps(_mm_mul_ps(yr, wr), _mm_mul_ps(yi, wi)));
+        _mm_storeu_ps(i2 + j, _mm_add_ps(_mm_mul_ps(yr, wi), _mm_mul_ps(yi, wr)));
+
+        yr = _mm_sub_ps(t1r, t3r); yi = _mm_sub_ps(t1i, t3i);
+        wr = _mm_loadu_ps(w3r + j); wi = _mm_loadu_ps(w3i + j);
+        _mm_storeu_ps(r3 + j, _mm_sub_ps(_mm_mul_ps(yr, wr), _mm_mul_ps(yi, wi)));
+        _mm_storeu_ps(i3 + j, _mm_add_ps(_mm_mul_ps(yr, wi), _mm_mul_ps(yi, wr)));
+      }
+#endif
+      for (; j < q; j++)
+      {
+        float t0r = r0[j] + r2[j], t0i = i0[j] + i2[j];
+        float t1r = r0[j] - r2[j], t1i = i0[j] - i2[j];
+        float t2r = r1[j] + r3[j], t2i = i1[j] + i3[j];
+        float t3r = i1[j] - i3[j], t3i = r3[j] - r1[j];
+
+        r0[j] = t0r + t2r;
+        i0[j] = t0i + t2i;
+
+        float yr = t1r + t3r, yi = t1i + t3i;
+        r1[j] = yr * w1r[j] - yi * w1i[j];
+        i1[j] = yr * w1i[j] + yi * w1r[j];
+
+        yr = t0r - t2r; yi = t0i - t2i;
+        r2[j] = yr * w2r[j] - yi * w2i[j];
+        i2[j] = yr * w2i[j] + yi * w2r[j];
+
+        yr = t1r - t3r; yi = t1i - t3i;
+        r3[j] = yr * w3r[j] - yi * w3i[j];
+        i3[j] = yr * w3i[j] + yi * w3r[j];
+      }
+    }
+  }
+
+  // sizes that are not a power of 4 end with a radix-2 stage
+  if (length == 2)
+  {
+    for (unsigned int i = 0; i < m_size; i += 2)
+    {
+      float ar = re[i], ai = im[i];
+      re[i]     = ar + re[i + 1];
+      im[i]     = ai + im[i + 1];
+      re[i + 1] = ar - re[i + 1];
+      im[i + 1] = ai - im[i + 1];
+    }
+  }
+}
+
+void CSpectrumAnalyser::TwoChannelPower(const float *samples, unsigned int frames, float *power)
+{
+  if (frames > m_size)
+    frames = m_size;
+  PrepareWindow(frames);
+
+  // window and pack both channels into one complex transform
+  unsigned int i = 0;
+#ifdef __SSE__
+  for (; i + 4 <= frames; i += 4)
+  {
+    __m128 v0 = _mm_loadu_ps(samples + 2 * i);
+    __m128 v1 = _mm_loadu_ps(samples + 2 * i + 4);
+    __m128 w  = _mm_loadu_ps(&m_window[i]);
+    _mm_storeu_ps(&m_re[i], _mm_mul_ps(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0)), w));
+    _mm_storeu_ps(&m_im[i], _mm_mul_ps(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1)), w));
+  }
+#endif
+  for (; i < frames; i++)
+  {
+    m_re[i] = samples[2 * i] * m_window[i];
+    m_im[i] = samples[2 * i + 1] * m_window[i];
+  }
+  for (; i < m_size; i++)
+    m_re[i] = m_im[i] = 0.0f;
+
+  Transform();
+
+  float *re = &m_orderedRe[0];
+  float *im = &m_orderedIm[0];
+  for (unsigned int k = 0; k < m_size; k++)
+  {
+    re[k] = m_re[m_permutation[k]];
+    im[k] = m_im[m_permutation[k]];
+  }
+
+  const unsigned int n = m_size;
+  power[0] = re[0] * re[0];
+  power[1] = im[0] * im[0];
+  power[n] = re[n / 2] * re[n / 2];
+  power[n + 1] = im[n / 2] * im[n / 2];
+
+  // separate the channels, Z[k] and Z[n-k] give the spectra of both
+  unsigned int k = 1;
+#ifdef __SSE__
+  const __m128 half = _mm_set1_ps(0.5f);
+  for (; k + 4 <= n / 2; k += 4)
+  {
+    __m128 ar = _mm_loadu_ps(re + k);
+    __m128 ai = _mm_loadu_ps(im + k);
+    __m128 br = _mm_loadu_ps(re + n - k - 3);
+    __m128 bi = _mm_loadu_ps(im + n - k - 3);
+    br = _mm_shuffle_ps(br, br, _MM_SHUFFLE(0, 1, 2, 3));
+    bi = _mm_shuffle_ps(bi, bi, _MM_SHUFFLE(0, 1, 2, 3));
+
+    __m128 rep = _mm_add_ps(ar, br), rem = _mm_sub_ps(ar, br);
+    __m128 aip = _mm_add_ps(ai, bi), aim = _mm_sub_ps(ai, bi);
+    __m128 left  = _mm_mul_ps(half, _mm_add_ps(_mm_mul_ps(rep, rep), _mm_mul_ps(aim, aim)));
+    __m128 right = _mm_mul_ps(half, _mm_add_ps(_mm_mul_ps(rem, rem), _mm_mul_ps(aip, aip)));
+    _mm_storeu_ps(power + 2 * k,     _mm_unpacklo_ps(left, right));
+    _mm_storeu_ps(power + 2 * k + 4, _mm_unpackhi_ps(left, right));
+  }
+#endif
+  for (; k < n / 2; k++)
+  {
+    float rep = re[k] + re[n - k], rem = re[k] - re[n - k];
+    float aip = im[k] + im[n - k], aim = im[k] - im[n - k];
+    power[2 * k]     = 0.5f * (rep * rep + aim * aim);
+    power[2 * k + 1] = 0.5f * (rem * rem + aip * aip);
+  }
+}
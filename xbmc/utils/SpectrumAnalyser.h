@@ -0,0 +1,69 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+
+/*!
+ \brief Power spectrum of two interleaved audio channels
+
+ Drop in replacement for twochanwithwindow() in fft.h. Window, twiddle
+ factors and the output permutation are computed once for a transform
+ size, the transform itself is a radix-4 decimation in frequency FFT on
+ split real/imaginary arrays so that four butterflies run per SSE
+ instruction.
+ */
+class CSpectrumAnalyser
+{
+public:
+  /*!
+   \param size number of complex points of the transform, must be a power of 2 and at least 4
+   */
+  CSpectrumAnalyser(unsigned int size);
+
+  unsigned int GetSize() const { return m_size; }
+
+  /*!
+   \brief Compute the hann windowed power spectrum of two channels
+   Both channels are packed into one complex transform, left as real and
+   right as imaginary part, and separated afterwards.
+   \param samples interleaved left/right samples
+   \param frames number of sample pairs, at most GetSize(). The window spans
+          the frames given, the rest of the transform is zero padded.
+   \param power receives GetSize() + 2 values laid out like the output of
+          twochanwithwindow(): power[2k] is the left and power[2k+1] the
+          right channel of bin k, for 0 <= k <= GetSize() / 2.
+   */
+  void TwoChannelPower(const float *samples, unsigned int frames, float *power);
+
+private:
+  void Transform();
+  void PrepareWindow(unsigned int frames);
+
+  unsigned int m_size;
+  unsigned int m_windowFrames;
+  std::vector<float> m_window;
+  std::vector<float> m_re;
+  std::vector<float> m_im;
+  std::vector<float> m_orderedRe;
+  std::vector<float> m_orderedIm;
+  std::vector<unsigned int> m_permutation; //< transform position of frequency k
+  std::vector<float> m_twiddles; //< per radix-4 stage w1, w2, w3 as re/im arrays
+};
@@ -0,0 +1,331 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "StartupGraph.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+
+#if defined(TARGET_DARWIN)
+#include <mach/mach.h>
+#elif defined(TARGET_POSIX)
+#include <time.h>
+#endif
+
+/*! \brief The CPU time used by the calling thread, in microseconds */
+static int64_t GetThreadCPUTime()
+{
+#if defined(TARGET_WINDOWS)
+  FILETIME creationTime, exitTime, kernelTime, userTime;
+  if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime))
+    return 0;
+  uint64_t time = (((uint64_t)userTime.dwHighDateTime) << 32) + ((uint64_t)userTime.dwLowDateTime);
+  time += (((uint64_t)kernelTime.dwHighDateTime) << 32) + ((uint64_t)kernelTime.dwLowDateTime);
+  return time / 10;
+#elif defined(TARGET_DARWIN)
+  thread_basic_info threadInfo;
+  mach_msg_type_number_t threadInfoCount = THREAD_BASIC_INFO_COUNT;
+  mach_port_t thread = mach_thread_self();
+  kern_return_t ret = thread_info(thread, THREAD_BASIC_INFO, (thread_info_t)&threadInfo, &threadInfoCount);
+  mach_port_deallocate(mach_task_self(), thread);
+  if (ret != KERN_SUCCESS)
+    return 0;
+  return (int64_t)threadInfo.user_time.seconds * 1000000 + threadInfo.user_time.microseconds +
+         (int64_t)threadInfo.system_time.seconds * 1000000 + threadInfo.system_time.microseconds;
+#else
+  struct timespec tp;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &tp) != 0)
+    return 0;
+  return (int64_t)tp.tv_sec * 1000000 + tp.tv_nsec / 1000;
+#endif
+}
+
+/*! \brief Runs a stage of a startup graph on the job pool */
+class CStartupStageJob : public CJob
+{
+public:
+  CStartupStageJob(CStartupGraph &graph, size_t index) : m_graph(graph), m_index(index) {}
+
+  virtual const char *GetType() const { return "startupstage"; }
+  virtual bool DoWork()
+  {
+    m_graph.Run(m_index);
+    return true;
+  }
+
+private:
+  CStartupGraph &m_graph;
+  size_t m_index;
+};
+
+CStartupGraph::CStartupGraph()
+{
+  m_start = CurrentHostCounter();
+  m_threads.push_back(CThread::GetCurrentThreadId());
+}
+
+CStartupGraph::~CStartupGraph()
+{
+  // the jobs refer to us, so wait for the ones that are running
+  CSingleLock lock(m_section);
+  for (size_t i = 0; i < m_stages.size(); i++)
+  {
+    while (m_stages[i].function && m_stages[i].state == RUNNING)
+      m_changed.wait(lock);
+  }
+}
+
+void CStartupGraph::Add(const std::string &name, StageFunction function, const std::string &dependencies)
+{
+  Stage stage;
+  stage.name = name;
+  stage.function = function;
+  stage.state = WAITING;
+  stage.thread = 0;
+  stage.start = stage.end = 0;
+  stage.cpuStart = stage.cpuEnd = 0;
+
+  std::vector<std::string> names = StringUtils::Split(dependencies, ",");
+  for (std::vector<std::string>::iterator i = names.begin(); i != names.end(); ++i)
+  {
+    StringUtils::Trim(*i);
+    if (!i->empty())
+      stage.dependencies.push_back(*i);
+  }
+
+  CSingleLock lock(m_section);
+  m_stages.push_back(stage);
+  StartReadyStages();
+}
+
+void CStartupGraph::Begin(const std::string &name)
+{
+  Stage stage;
+  stage.name = name;
+  stage.function = NULL;
+  stage.state = WAITING;
+  stage.start = stage.end = 0;
+  stage.cpuStart = stage.cpuEnd = 0;
+
+  CSingleLock lock(m_section);
+  stage.thread = GetThread();
+  m_stages.push_back(stage);
+  StartStage(m_stages.size() - 1);
+}
+
+void CStartupGraph::End(const std::string &name, bool success)
+{
+  CSingleLock lock(m_section);
+  int index = Find(name);
+  if (index >= 0 && m_stages[index].state == RUNNING && !m_stages[index].function)
+    FinishStage(index, success);
+}
+
+bool CStartupGraph::Wait(const std::string &names)
+{
+  std::vector<std::string> stages = StringUtils::Split(names, ",");
+  bool success = true;
+
+  CSingleLock lock(m_section);
+  for (std::vector<std::string>::iterator i = stages.begin(); i != stages.end(); ++i)
+  {
+    StringUtils::Trim(*i);
+    int index = Find(*i);
+    if (index < 0)
+    {
+      CLog::Log(LOGERROR, "%s - unknown startup stage %s", __FUNCTION__, i->c_str());
+      success = false;
+      continue;
+    }
+    while (m_stages[index].state == WAITING || m_stages[index].state == RUNNING)
+      m_changed.wait(lock);
+    success &= m_stages[index].state == DONE;
+  }
+  return success;
+}
+
+int64_t CStartupGraph::GetElapsed() const
+{
+  return (CurrentHostCounter() - m_start) * 1000000 / CurrentHostFrequency();
+}
+
+void CStartupGraph::Log() const
+{
+  CSingleLock lock(m_section);
+  for (std::vector<Stage>::const_iterator i = m_stages.begin(); i != m_stages.end(); ++i)
+  {
+    if (i->state == DONE || i->state == FAILED)
+      CLog::Log(LOGDEBUG, "Startup stage %-12s thread %d, %8.1fms to %8.1fms, %7.1fms CPU%s", i->name.c_str(), i->thread,
+                i->start / 1000.0, i->end / 1000.0, (i->cpuEnd - i->cpuStart) / 1000.0, i->state == FAILED ? ", failed" : "");
+  }
+  CLog::Log(LOGNOTICE, "Startup took %.1fms", GetElapsed() / 1000.0);
+}
+
+bool CStartupGraph::WriteTrace(const std::string &file) const
+{
+  CVariant events(CVariant::VariantTypeArray);
+
+  CSingleLock lock(m_section);
+  for (size_t i = 0; i < m_threads.size(); i++)
+  {
+    CVariant thread;
+    thread["name"] = "thread_name";
+    thread["ph"] = "M";
+    thread["pid"] = 1;
+    thread["tid"] = (int)i;
+    thread["args"]["name"] = i ? StringUtils::Format("worker %d", (int)i) : "application";
+    events.push_back(thread);
+  }
+  for (std::vector<Stage>::const_iterator i = m_stages.begin(); i != m_stages.end(); ++i)
+  {
+    if (i->state != DONE && i->state != FAILED)
+      continue;
+
+    CVariant event;
+    event["name"] = i->name;
+    event["cat"] = "startup";
+    event["ph"] = "X";
+    event["pid"] = 1;
+    event["tid"] = i->thread;
+    event["ts"] = i->start;
+    event["dur"] = i->end - i->start;
+    event["args"]["cpu_ms"] = (i->cpuEnd - i->cpuStart) / 1000.0;
+    event["args"]["failed"] = i->state == FAILED;
+    events.push_back(event);
+  }
+  lock.Leave();
+
+  CVariant trace;
+  trace["traceEvents"] = events;
+  trace["displayTimeUnit"] = "ms";
+  std::string json = CJSONVariantWriter::Write(trace, true);
+
+  XFILE::CFile out;
+  if (!out.OpenForWrite(file, true))
+    return false;
+  bool written = out.Write(json.c_str(), json.size()) == (int)json.size();
+  out.Close();
+  return written;
+}
+
+void CStartupGraph::Run(size_t index)
+{
+  StageFunction function;
+  {
+    CSingleLock lock(m_section);
+    m_stages[index].thread = GetThread();
+    m_stages[index].start = GetElapsed();
+    m_stages[index].cpuStart = GetThreadCPUTime();
+    function = m_stages[index].function;
+  }
+
+  bool success = function();
+
+  CSingleLock lock(m_section);
+  FinishStage(index, success);
+}
+
+void CStartupGraph::StartStage(size_t index)
+{
+  Stage &stage = m_stages[index];
+  stage.state = RUNNING;
+  if (stage.function)
+    CJobManager::GetInstance().AddJob(new CStartupStageJob(*this, index), NULL, CJob::PRIORITY_HIGH);
+  else
+  {
+    stage.start = GetElapsed();
+    stage.cpuStart = GetThreadCPUTime();
+  }
+}
+
+void CStartupGraph::FinishStage(size_t index, bool success)
+{
+  Stage &stage = m_stages[index];
+  stage.end = GetElapsed();
+  stage.cpuEnd = GetThreadCPUTime();
+  stage.state = success ? DONE : FAILED;
+  if (!success)
+    CLog::Log(LOGERROR, "%s - startup stage %s failed", __FUNCTION__, stage.name.c_str());
+
+  StartReadyStages();
+  m_changed.notifyAll();
+}
+
+void CStartupGraph::StartReadyStages()
+{
+  // a failed stage fails the stages depending on it, which may fail others in turn
+  bool changed = true;
+  while (changed)
+  {
+    changed = false;
+    for (size_t i = 0; i < m_stages.size(); i++)
+    {
+      if (m_stages[i].state != WAITING || !m_stages[i].function)
+        continue;
+
+      bool ready = true, failed = false;
+      for (std::vector<std::string>::const_iterator j = m_stages[i].dependencies.begin(); j != m_stages[i].dependencies.end(); ++j)
+      {
+        int dependency = Find(*j);
+        if (dependency >= 0 && m_stages[dependency].state == FAILED)
+          failed = true;
+        else if (dependency < 0 || m_stages[dependency].state != DONE)
+          ready = false;
+      }
+
+      if (failed)
+      {
+        m_stages[i].state = FAILED;
+        CLog::Log(LOGERROR, "%s - startup stage %s not run, as a stage it needs failed", __FUNCTION__, m_stages[i].name.c_str());
+        changed = true;
+      }
+      else if (ready)
+        StartStage(i);
+    }
+  }
+}
+
+int CStartupGraph::Find(const std::string &name) const
+{
+  for (size_t i = 0; i < m_stages.size(); i++)
+  {
+    if (m_stages[i].name == name)
+      return (int)i;
+  }
+  return -1;
+}
+
+int CStartupGraph::GetThread()
+{
+  ThreadIdentifier thread = CThread::GetCurrentThreadId();
+  for (size_t i = 0; i < m_threads.size(); i++)
+  {
+    if (m_threads[i] == thread)
+      return (int)i;
+  }
+  m_threads.push_back(thread);
+  return (int)m_threads.size() - 1;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ \brief Runs the stages of the startup sequence and traces how long each one takes
+
+ Stages added with Add() run on the job pool as soon as the stages they depend on are done,
+ in parallel with the application thread. Code on the application thread is traced as a
+ stage between Begin() and End(), and waits for the stages it needs with Wait().
+
+ The trace holds the wall and CPU time of every stage, and can be written in the Chrome
+ trace event format (load it in chrome://tracing).
+ */
+class CStartupGraph
+{
+public:
+  typedef bool (*StageFunction)();
+
+  CStartupGraph();
+  ~CStartupGraph();
+
+  /*!
+   \brief Add a stage to run on the job pool
+   \param name the name of the stage
+   \param function the work of the stage, returning false if it failed
+   \param dependencies comma separated names of the stages that must be done first. If one of
+          them fails, the stage fails without being run.
+   */
+  void Add(const std::string &name, StageFunction function, const std::string &dependencies = "");
+
+  /*! \brief Start tracing a stage run on the calling thread */
+  void Begin(const std::string &name);
+
+  /*! \brief Stop tracing the stage started by Begin() */
+  void End(const std::string &name, bool success = true);
+
+  /*!
+   \brief Wait for stages to be done
+   \param names comma separated names of the stages
+   \return true if all of them succeeded
+   */
+  bool Wait(const std::string &names);
+
+  /*! \brief The time since the graph was created, in microseconds */
+  int64_t GetElapsed() const;
+
+  /*! \brief Log the times of the stages that are done */
+  void Log() const;
+
+  /*!
+   \brief Write the stages that are done as Chrome trace events
+   \param file the file to write
+   \return true if the file was written
+   */
+  bool WriteTrace(const std::string &file) const;
+
+private:
+  friend class CStartupStageJob;
+
+  enum STATE { WAITING, RUNNING, DONE, FAILED };
+
+  struct Stage
+  {
+    std::string name;
+    StageFunction function;
+    std::vector<std::string> dependencies;
+    STATE state;
+    int thread;       ///< index of the thread the stage ran on
+    int64_t start;    ///< wall time the stage started at, since the graph was created
+    int64_t end;
+    int64_t cpuStart; ///< CPU time of the thread when the stage started
+    int64_t cpuEnd;
+  };
+
+  void Run(size_t index);
+  void StartStage(size_t index);
+  void FinishStage(size_t index, bool success);
+  void StartReadyStages();
+  int Find(const std::string &name) const;
+  int GetThread();
+
+  std::vector<Stage> m_stages;
+  std::vector<ThreadIdentifier> m_threads; ///< the threads stages ran on, the creating thread first
+  int64_t m_start;
+  CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_changed;
+};
@@ -0,0 +1,136 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/StartupGraph.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "threads/SingleLock.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/URIUtils.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+#include <set>
+
+/* the order the stages ran in */
+static CCriticalSection s_section;
+static std::string s_order;
+
+static bool Record(char stage)
+{
+  CSingleLock lock(s_section);
+  s_order += stage;
+  return true;
+}
+
+static bool StageA() { Sleep(50); return Record('a'); }
+static bool StageB() { Sleep(20); return Record('b'); }
+static bool StageC() { return Record('c'); }
+static bool StageD() { return Record('d'); }
+static bool StageFail() { Record('f'); return false; }
+
+class TestStartupGraph : public testing::Test
+{
+protected:
+  TestStartupGraph()
+  {
+    s_order.clear();
+  }
+};
+
+TEST_F(TestStartupGraph, Dependencies)
+{
+  CStartupGraph graph;
+  graph.Add("c", StageC, "a, b");
+  graph.Add("b", StageB, "a");
+  graph.Add("a", StageA);
+  EXPECT_TRUE(graph.Wait("c"));
+  EXPECT_EQ("abc", s_order);
+
+  graph.Add("d", StageD);
+  EXPECT_TRUE(graph.Wait("a,b,c,d"));
+  EXPECT_EQ("abcd", s_order);
+}
+
+TEST_F(TestStartupGraph, Failure)
+{
+  CStartupGraph graph;
+  graph.Add("fail", StageFail);
+  graph.Add("child", StageC, "fail");
+  graph.Add("grandchild", StageD, "child");
+  graph.Add("other", StageA);
+  EXPECT_FALSE(graph.Wait("grandchild"));
+  EXPECT_FALSE(graph.Wait("child"));
+  EXPECT_TRUE(graph.Wait("other"));
+  EXPECT_FALSE(graph.Wait("fail,other"));
+  EXPECT_EQ("fa", s_order);
+
+  // unknown stages fail too
+  EXPECT_FALSE(graph.Wait("missing"));
+}
+
+TEST_F(TestStartupGraph, Trace)
+{
+  CStartupGraph graph;
+  graph.Begin("main");
+  graph.Add("a", StageA);
+  graph.Add("b", StageB, "a");
+  EXPECT_TRUE(graph.Wait("b"));
+  graph.End("main");
+  graph.Begin("unfinished");
+
+  std::string file = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), "startuptest.json");
+  ASSERT_TRUE(graph.WriteTrace(file));
+
+  XFILE::CFile in;
+  ASSERT_TRUE(in.Open(file));
+  std::string json((size_t)in.GetLength(), 0);
+  in.Read(&json[0], json.size());
+  in.Close();
+  XFILE::CFile::Delete(file);
+
+  CVariant trace = CJSONVariantParser::Parse((const unsigned char *)json.c_str(), json.size());
+  ASSERT_TRUE(trace["traceEvents"].isArray());
+
+  // the stages that are done, and names for the threads they ran on
+  std::set<std::string> names;
+  std::set<int64_t> threads;
+  for (unsigned int i = 0; i < trace["traceEvents"].size(); i++)
+  {
+    const CVariant &event = trace["traceEvents"][i];
+    if (event["ph"].asString() == "X")
+    {
+      names.insert(event["name"].asString());
+      EXPECT_LE(event["ts"].asInteger(), graph.GetElapsed());
+      EXPECT_GE(event["dur"].asInteger(), 0);
+      if (event["name"].asString() == "main")
+        EXPECT_GE(event["dur"].asInteger(), 70000);
+      else
+        EXPECT_NE(0, event["tid"].asInteger());
+    }
+    else if (event["ph"].asString() == "M")
+      threads.insert(event["tid"].asInteger());
+  }
+  EXPECT_EQ(3u, names.size());
+  EXPECT_EQ(0u, names.count("unfinished"));
+  EXPECT_EQ(1u, threads.count(0));
+  EXPECT_GE(threads.size(), 2u);
+}
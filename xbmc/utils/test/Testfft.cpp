@@ -19,11 +19,18 @@
  */
 
 #include "utils/fft.h"
+#include "utils/SpectrumAnalyser.h"
 #include "utils/StdString.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 
 #include "gtest/gtest.h"
 
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
 /* refdata[] below was generated using the following Python script.
 
 import math
@@ -317,3 +324,102 @@ TEST(Testfft, twochanwithwindow)
     EXPECT_STREQ(refstr.c_str(), varstr.c_str());
   }
 }
+
+static std::vector<float> RandomStereo(unsigned int frames)
+{
+  std::vector<float> samples(frames * 2);
+  for (unsigned int i = 0; i < samples.size(); i++)
+    samples[i] = (float)rand() / RAND_MAX * 2.0f - 1.0f;
+  return samples;
+}
+
+static float MaxValue(const std::vector<float> &data, unsigned int count)
+{
+  float max = 0.0f;
+  for (unsigned int i = 0; i < count; i++)
+    max = std::max(max, data[i]);
+  return max;
+}
+
+TEST(Testfft, SpectrumAnalyser_twochanwithwindow)
+{
+  srand(1);
+  // powers of 4 and the ones needing a radix-2 stage
+  for (unsigned int size = 4; size <= 4096; size *= 2)
+  {
+    std::vector<float> samples = RandomStereo(size);
+    std::vector<float> ref(samples);
+    twochanwithwindow(&ref[0], size);
+
+    CSpectrumAnalyser analyser(size);
+    std::vector<float> power(size + 2);
+    analyser.TwoChannelPower(&samples[0], size, &power[0]);
+
+    float tolerance = MaxValue(ref, size + 2) * 1e-5f;
+    for (unsigned int i = 0; i < size + 2; i++)
+      ASSERT_NEAR(ref[i], power[i], tolerance) << "size " << size << " index " << i;
+  }
+}
+
+TEST(Testfft, SpectrumAnalyser_ZeroPadded)
+{
+  srand(2);
+  const unsigned int size = 128;
+  const unsigned int frames = 100;
+  std::vector<float> samples = RandomStereo(frames);
+
+  CSpectrumAnalyser analyser(size);
+  std::vector<float> power(size + 2);
+  analyser.TwoChannelPower(&samples[0], frames, &power[0]);
+
+  // direct transform of each channel, twochanwithwindow reports 2|X|^2
+  std::vector<float> ref(size + 2);
+  for (unsigned int k = 0; k <= size / 2; k++)
+  {
+    for (unsigned int ch = 0; ch < 2; ch++)
+    {
+      double re = 0.0, im = 0.0;
+      for (unsigned int n = 0; n < frames; n++)
+      {
+        double x = samples[2 * n + ch] * 0.5 * (1.0 - cos(2.0 * M_PI * n / frames));
+        re += x * cos(2.0 * M_PI * k * n / size);
+        im -= x * sin(2.0 * M_PI * k * n / size);
+      }
+      double scale = (k == 0 || k == size / 2) ? 1.0 : 2.0;
+      ref[2 * k + ch] = (float)(scale * (re * re + im * im));
+    }
+  }
+  float tolerance = MaxValue(ref, size + 2) * 1e-5f;
+  for (unsigned int i = 0; i < size + 2; i++)
+    EXPECT_NEAR(ref[i], power[i], tolerance) << "index " << i;
+}
+
+/* run with --gtest_also_run_disabled_tests */
+TEST(Testfft, DISABLED_SpectrumAnalyser_Benchmark)
+{
+  const unsigned int sizes[] = { 512, 4096 };
+  for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+  {
+    const unsigned int size = sizes[s];
+    const int iterations = 20000 * 512 / size;
+    std::vector<float> samples = RandomStereo(size);
+    std::vector<float> data(size * 2);
+
+    int64_t start = CurrentHostCounter();
+    for (int i = 0; i < iterations; i++)
+    {
+      memcpy(&data[0], &samples[0], size * 2 * sizeof(float));
+      twochanwithwindow(&data[0], size);
+    }
+    double scalar = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+
+    CSpectrumAnalyser analyser(size);
+    start = CurrentHostCounter();
+    for (int i = 0; i < iterations; i++)
+      analyser.TwoChannelPower(&samples[0], size, &data[0]);
+    double simd = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+
+    printf("size %4u: twochanwithwindow %7.2f us, CSpectrumAnalyser %7.2f us, %.1fx\n",
+           size, scalar * 1e6 / iterations, simd * 1e6 / iterations, scalar / simd);
+  }
+}
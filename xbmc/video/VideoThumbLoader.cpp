@@ -36,15 +36,21 @@
 #include "video/VideoInfoTag.h"
 #include "video/VideoDatabase.h"
 #include "cores/dvdplayer/DVDFileInfo.h"
+#include "cores/dvdplayer/DVDProbeCache.h"
+#include "utils/CPUInfo.h"
 #include "video/VideoInfoScanner.h"
 #include "music/MusicDatabase.h"
 #include "utils/StringUtils.h"
 #include "settings/AdvancedSettings.h"
 
+#include <algorithm>
+
 using namespace XFILE;
 using namespace std;
 using namespace VIDEO;
 
+#define THUMB_MAX_PARALLEL_JOBS 4
+
 CThumbExtractor::CThumbExtractor(const CFileItem& item, const CStdString& listpath, bool thumb, const CStdString& target)
 {
   m_listpath = listpath;
@@ -156,8 +162,23 @@ bool CThumbExtractor::DoWork()
   return false;
 }
 
+CVideoThumbLoader::CRemoteProbeQueue::CRemoteProbeQueue(CVideoThumbLoader &loader) :
+  CJobQueue(true, 1, CJob::PRIORITY_LOW_PAUSABLE), m_loader(loader)
+{
+}
+
+void CVideoThumbLoader::CRemoteProbeQueue::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  m_loader.OnExtractorComplete(success, (CThumbExtractor*)job);
+  CJobQueue::OnJobComplete(jobID, success, job);
+
+  if (!IsProcessing() && !m_loader.IsProcessing())
+    CDVDProbeCache::Get().Save();
+}
+
 CVideoThumbLoader::CVideoThumbLoader() :
-  CThumbLoader(), CJobQueue(true, 1, CJob::PRIORITY_LOW_PAUSABLE)
+  CThumbLoader(), CJobQueue(true, std::max(1, std::min(g_cpuInfo.getCPUCount(), THUMB_MAX_PARALLEL_JOBS)), CJob::PRIORITY_LOW_PAUSABLE),
+  m_remoteProbes(*this)
 {
   m_videoDatabase = new CVideoDatabase();
 }
@@ -165,6 +186,7 @@ CVideoThumbLoader::CVideoThumbLoader() :
 CVideoThumbLoader::~CVideoThumbLoader()
 {
   StopThread();
+  m_remoteProbes.CancelJobs();
   delete m_videoDatabase;
 }
 
@@ -372,7 +394,7 @@ bool CVideoThumbLoader::LoadItemLookup(CFileItem* pItem)
           SetupRarOptions(item,path);
 
         CThumbExtractor* extract = new CThumbExtractor(item, path, true, thumbURL);
-        AddJob(extract);
+        AddExtractor(extract);
 
         m_videoDatabase->Close();
         return true;
@@ -389,7 +411,7 @@ bool CVideoThumbLoader::LoadItemLookup(CFileItem* pItem)
       if (URIUtils::IsInRAR(item.GetPath()))
         SetupRarOptions(item,path);
       CThumbExtractor* extract = new CThumbExtractor(item,path,false);
-      AddJob(extract);
+      AddExtractor(extract);
     }
   }
 
@@ -521,19 +543,34 @@ CStdString CVideoThumbLoader::GetEmbeddedThumbURL(const CFileItem &item)
 }
 
 void CVideoThumbLoader::OnJobComplete(unsigned int jobID, bool success, CJob* job)
+{
+  OnExtractorComplete(success, (CThumbExtractor*)job);
+  CJobQueue::OnJobComplete(jobID, success, job);
+
+  if (!IsProcessing() && !m_remoteProbes.IsProcessing())
+    CDVDProbeCache::Get().Save();
+}
+
+void CVideoThumbLoader::AddExtractor(CThumbExtractor *extract)
+{
+  if (URIUtils::IsRemote(extract->m_item.GetPath()))
+    m_remoteProbes.AddJob(extract);
+  else
+    AddJob(extract);
+}
+
+void CVideoThumbLoader::OnExtractorComplete(bool success, CThumbExtractor *extract)
 {
   if (success)
   {
-    CThumbExtractor* loader = (CThumbExtractor*)job;
-    loader->m_item.SetPath(loader->m_listpath);
+    extract->m_item.SetPath(extract->m_listpath);
 
     if (m_pObserver)
-      m_pObserver->OnItemLoaded(&loader->m_item);
-    CFileItemPtr pItem(new CFileItem(loader->m_item));
+      m_pObserver->OnItemLoaded(&extract->m_item);
+    CFileItemPtr pItem(new CFileItem(extract->m_item));
     CGUIMessage msg(GUI_MSG_NOTIFY_ALL, 0, 0, GUI_MSG_UPDATE_ITEM, 0, pItem);
     g_windowManager.SendThreadMessage(msg);
   }
-  CJobQueue::OnJobComplete(jobID, success, job);
 }
 
 void CVideoThumbLoader::DetectAndAddMissingItemData(CFileItem &item)
@@ -124,9 +124,29 @@ public:
   static void SetArt(CFileItem &item, const std::map<std::string, std::string> &artwork);
 
 protected:
+  /*! \brief Runs the extractors of files on network shares one at a time, as parallel probes only make them seek around
+   */
+  class CRemoteProbeQueue : public CJobQueue
+  {
+  public:
+    CRemoteProbeQueue(CVideoThumbLoader &loader);
+    virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+  private:
+    CVideoThumbLoader &m_loader;
+  };
+
+  /*! \brief Queue an extractor on the remote probe queue if its file is on a network share, on this queue otherwise
+   */
+  void AddExtractor(CThumbExtractor *extract);
+
+  /*! \brief Update the item of a completed extractor from either queue
+   */
+  void OnExtractorComplete(bool success, CThumbExtractor *extract);
+
   CVideoDatabase *m_videoDatabase;
   typedef std::map<int, std::map<std::string, std::string> > ArtCache;
   ArtCache m_showArt;
+  CRemoteProbeQueue m_remoteProbes;
 
   /*! \brief Tries to detect missing data/info from a file and adds those
    \param item The CFileItem to process